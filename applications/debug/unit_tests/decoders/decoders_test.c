@@ -0,0 +1,506 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include "../minunit.h"
+#include <toolbox/edge_trace.h>
+#include <toolbox/stream/file_stream.h>
+#include <toolbox/pulse_protocols/pulse_glue.h>
+#include <toolbox/protocols/protocol_dict.h>
+#include <flipper_format/flipper_format.h>
+#include <lib/subghz/receiver.h>
+#include <lib/subghz/protocols/protocol_items.h>
+#include <lfrfid/protocols/lfrfid_protocols.h>
+#include <ibutton/protocols/misc/protocol_group_misc_defs.h>
+#include <infrared.h>
+
+#define TAG "DecodersTest"
+
+#define SUBGHZ_TEST_DIR EXT_PATH("unit_tests/subghz/")
+#define INFRARED_TEST_DIR EXT_PATH("unit_tests/infrared/")
+#define EDGE_TRACE_TEST_FILE EXT_PATH("unit_tests/edge_trace.trace")
+
+#define LF_RFID_READ_TIMING_MULTIPLIER 8
+#define ENCODER_RECORD_EDGES 2048
+#define FUZZ_ITERATIONS 256
+#define FUZZ_INPUT_MAX_SIZE 512
+
+/** Decoder family: anything with level/duration feed */
+typedef struct {
+    const char* name;
+    void* (*alloc)(void);
+    void (*free)(void* decoder);
+    void (*reset)(void* decoder);
+    /* returns true if something was decoded on this edge */
+    bool (*feed)(void* decoder, bool level, uint32_t duration);
+} DecoderFamily;
+
+typedef struct {
+    size_t edges;
+    size_t detections;
+    uint32_t ns_per_edge;
+    int32_t heap_delta;
+} DecoderRunStats;
+
+/* SubGhz: receiver with all decodable protocols */
+
+typedef struct {
+    SubGhzEnvironment* environment;
+    SubGhzReceiver* receiver;
+    bool detected;
+} DecoderFamilySubGhz;
+
+static void decoder_family_subghz_callback(
+    SubGhzReceiver* receiver,
+    SubGhzProtocolDecoderBase* decoder_base,
+    void* context) {
+    UNUSED(decoder_base);
+    DecoderFamilySubGhz* instance = context;
+    instance->detected = true;
+    subghz_receiver_reset(receiver);
+}
+
+static void* decoder_family_subghz_alloc(void) {
+    DecoderFamilySubGhz* instance = malloc(sizeof(DecoderFamilySubGhz));
+    instance->environment = subghz_environment_alloc();
+    subghz_environment_set_protocol_registry(
+        instance->environment, (void*)&subghz_protocol_registry);
+    instance->receiver = subghz_receiver_alloc_init(instance->environment);
+    subghz_receiver_set_filter(instance->receiver, SubGhzProtocolFlag_Decodable);
+    subghz_receiver_set_rx_callback(
+        instance->receiver, decoder_family_subghz_callback, instance);
+    return instance;
+}
+
+static void decoder_family_subghz_free(void* decoder) {
+    DecoderFamilySubGhz* instance = decoder;
+    subghz_receiver_free(instance->receiver);
+    subghz_environment_free(instance->environment);
+    free(instance);
+}
+
+static void decoder_family_subghz_reset(void* decoder) {
+    DecoderFamilySubGhz* instance = decoder;
+    subghz_receiver_reset(instance->receiver);
+    instance->detected = false;
+}
+
+static bool decoder_family_subghz_feed(void* decoder, bool level, uint32_t duration) {
+    DecoderFamilySubGhz* instance = decoder;
+    subghz_receiver_decode(instance->receiver, level, duration);
+    bool detected = instance->detected;
+    instance->detected = false;
+    return detected;
+}
+
+/* Infrared: all protocols decoder */
+
+static void* decoder_family_infrared_alloc(void) {
+    return infrared_alloc_decoder();
+}
+
+static void decoder_family_infrared_free(void* decoder) {
+    infrared_free_decoder(decoder);
+}
+
+static void decoder_family_infrared_reset(void* decoder) {
+    infrared_reset_decoder(decoder);
+}
+
+static bool decoder_family_infrared_feed(void* decoder, bool level, uint32_t duration) {
+    return infrared_decode(decoder, level, duration) != NULL;
+}
+
+/* LFRFID and iButton misc: protocol dictionaries */
+
+static void* decoder_family_lfrfid_alloc(void) {
+    return protocol_dict_alloc(lfrfid_protocols, LFRFIDProtocolMax);
+}
+
+static void* decoder_family_ibutton_alloc(void) {
+    return protocol_dict_alloc(ibutton_protocols_misc, iButtonProtocolMiscMax);
+}
+
+static void decoder_family_dict_free(void* decoder) {
+    protocol_dict_free(decoder);
+}
+
+static void decoder_family_dict_reset(void* decoder) {
+    protocol_dict_decoders_start(decoder);
+}
+
+static bool decoder_family_dict_feed(void* decoder, bool level, uint32_t duration) {
+    return protocol_dict_decoders_feed(decoder, level, duration) != PROTOCOL_NO;
+}
+
+static const DecoderFamily decoder_family_subghz = {
+    .name = "subghz",
+    .alloc = decoder_family_subghz_alloc,
+    .free = decoder_family_subghz_free,
+    .reset = decoder_family_subghz_reset,
+    .feed = decoder_family_subghz_feed,
+};
+
+static const DecoderFamily decoder_family_infrared = {
+    .name = "infrared",
+    .alloc = decoder_family_infrared_alloc,
+    .free = decoder_family_infrared_free,
+    .reset = decoder_family_infrared_reset,
+    .feed = decoder_family_infrared_feed,
+};
+
+static const DecoderFamily decoder_family_lfrfid = {
+    .name = "lfrfid",
+    .alloc = decoder_family_lfrfid_alloc,
+    .free = decoder_family_dict_free,
+    .reset = decoder_family_dict_reset,
+    .feed = decoder_family_dict_feed,
+};
+
+static const DecoderFamily decoder_family_ibutton = {
+    .name = "ibutton",
+    .alloc = decoder_family_ibutton_alloc,
+    .free = decoder_family_dict_free,
+    .reset = decoder_family_dict_reset,
+    .feed = decoder_family_dict_feed,
+};
+
+/* Runner */
+
+static void decoder_family_run(
+    const DecoderFamily* family,
+    void* decoder,
+    const EdgeTrace* trace,
+    DecoderRunStats* stats) {
+    size_t count = edge_trace_get_count(trace);
+    size_t detections = 0;
+
+    family->reset(decoder);
+    size_t heap_before = memmgr_get_free_heap();
+    uint32_t cycles = DWT->CYCCNT;
+
+    for(size_t i = 0; i < count; i++) {
+        LevelDuration edge = edge_trace_get(trace, i);
+        if(family->feed(
+               decoder, level_duration_get_level(edge), level_duration_get_duration(edge))) {
+            detections++;
+        }
+    }
+
+    cycles = DWT->CYCCNT - cycles;
+    size_t heap_after = memmgr_get_free_heap();
+
+    stats->edges = count;
+    stats->detections = detections;
+    stats->heap_delta = (int32_t)heap_before - (int32_t)heap_after;
+    stats->ns_per_edge =
+        count ? ((uint64_t)cycles * 1000 / furi_hal_cortex_instructions_per_microsecond()) / count :
+                0;
+
+    printf(
+        "%s: %u edges, %lu ns/edge, %u detections, heap delta %ld\r\n",
+        family->name,
+        stats->edges,
+        stats->ns_per_edge,
+        stats->detections,
+        stats->heap_delta);
+}
+
+/** Fuzz smoke test input: any input must be survived.
+ * Coverage guided fuzzing runs on the host, see scripts/testing/decoders_fuzz.
+ */
+static int decoder_family_fuzz_one_input(
+    const DecoderFamily* family,
+    void* decoder,
+    EdgeTrace* scratch,
+    const uint8_t* data,
+    size_t size) {
+    edge_trace_reset(scratch);
+    edge_trace_parse(scratch, data, size);
+
+    family->reset(decoder);
+    for(size_t i = 0; i < edge_trace_get_count(scratch); i++) {
+        LevelDuration edge = edge_trace_get(scratch, i);
+        family->feed(decoder, level_duration_get_level(edge), level_duration_get_duration(edge));
+    }
+
+    return 0;
+}
+
+/* Trace sources */
+
+static bool decoders_test_import_subghz_raw(EdgeTrace* trace, const char* file_name) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    FuriString* path = furi_string_alloc_printf(SUBGHZ_TEST_DIR "%s", file_name);
+    bool success = false;
+
+    if(flipper_format_file_open_existing(ff, furi_string_get_cstr(path))) {
+        uint32_t count = 0;
+        while(flipper_format_get_value_count(ff, "RAW_Data", &count) && count) {
+            int32_t* samples = malloc(sizeof(int32_t) * count);
+            success = flipper_format_read_int32(ff, "RAW_Data", samples, count);
+            for(size_t i = 0; success && (i < count); i++) {
+                edge_trace_push(trace, samples[i] > 0, abs(samples[i]));
+            }
+            free(samples);
+            if(!success) break;
+        }
+    }
+
+    furi_string_free(path);
+    flipper_format_free(ff);
+    furi_record_close(RECORD_STORAGE);
+
+    return success && edge_trace_get_count(trace);
+}
+
+static bool decoders_test_import_infrared_raw(EdgeTrace* trace, const char* file_name) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FlipperFormat* ff = flipper_format_file_alloc(storage);
+    FuriString* path = furi_string_alloc_printf(INFRARED_TEST_DIR "%s", file_name);
+    bool success = false;
+
+    do {
+        if(!flipper_format_file_open_existing(ff, furi_string_get_cstr(path))) break;
+
+        /* first raw signal in file is decoder input */
+        bool is_raw = false;
+        while(!is_raw && flipper_format_read_string(ff, "type", path)) {
+            is_raw = !furi_string_cmp_str(path, "raw");
+        }
+        if(!is_raw) break;
+
+        uint32_t count = 0;
+        if(!flipper_format_get_value_count(ff, "data", &count) || !count) break;
+        uint32_t* timings = malloc(sizeof(uint32_t) * count);
+        success = flipper_format_read_uint32(ff, "data", timings, count);
+        bool level = false;
+        for(size_t i = 0; success && (i < count); i++) {
+            edge_trace_push(trace, level, timings[i]);
+            level = !level;
+        }
+        free(timings);
+    } while(false);
+
+    furi_string_free(path);
+    flipper_format_free(ff);
+    furi_record_close(RECORD_STORAGE);
+
+    return success;
+}
+
+/* Encoder output, glued into read timings the same way as in lfrfid worker */
+static void decoders_test_record_lfrfid(
+    EdgeTrace* trace,
+    LFRFIDProtocol protocol,
+    const uint8_t* data,
+    size_t data_size) {
+    ProtocolDict* dict = protocol_dict_alloc(lfrfid_protocols, LFRFIDProtocolMax);
+    protocol_dict_set_data(dict, protocol, data, data_size);
+    furi_check(protocol_dict_encoder_start(dict, protocol));
+    PulseGlue* pulse_glue = pulse_glue_alloc();
+
+    while(edge_trace_get_count(trace) < ENCODER_RECORD_EDGES) {
+        LevelDuration level_duration = protocol_dict_encoder_yield(dict, protocol);
+        bool pulse_pop = pulse_glue_push(
+            pulse_glue,
+            level_duration_get_level(level_duration),
+            level_duration_get_duration(level_duration) * LF_RFID_READ_TIMING_MULTIPLIER);
+
+        if(pulse_pop) {
+            uint32_t length, period;
+            pulse_glue_pop(pulse_glue, &length, &period);
+            edge_trace_push(trace, true, period);
+            edge_trace_push(trace, false, length - period);
+        }
+    }
+
+    pulse_glue_free(pulse_glue);
+    protocol_dict_free(dict);
+}
+
+static void decoders_test_record_ibutton(
+    EdgeTrace* trace,
+    iButtonProtocolMisc protocol,
+    const uint8_t* data,
+    size_t data_size) {
+    ProtocolDict* dict = protocol_dict_alloc(ibutton_protocols_misc, iButtonProtocolMiscMax);
+    protocol_dict_set_data(dict, protocol, data, data_size);
+    furi_check(protocol_dict_encoder_start(dict, protocol));
+
+    while(edge_trace_get_count(trace) < ENCODER_RECORD_EDGES) {
+        LevelDuration level_duration = protocol_dict_encoder_yield(dict, protocol);
+        edge_trace_push(
+            trace,
+            level_duration_get_level(level_duration),
+            level_duration_get_duration(level_duration));
+    }
+
+    protocol_dict_free(dict);
+}
+
+/* Tests */
+
+MU_TEST(edge_trace_save_load_test) {
+    EdgeTrace* trace = edge_trace_alloc();
+    EdgeTrace* loaded = edge_trace_alloc();
+
+    for(uint32_t i = 0; i < 1000; i++) {
+        edge_trace_push(trace, i & 1, (i * 7919) % 100000);
+    }
+    edge_trace_push(trace, true, UINT32_MAX);
+    mu_assert_int_eq(
+        EDGE_TRACE_MAX_DURATION,
+        level_duration_get_duration(edge_trace_get(trace, edge_trace_get_count(trace) - 1)));
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* stream = file_stream_alloc(storage);
+
+    mu_check(file_stream_open(stream, EDGE_TRACE_TEST_FILE, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(edge_trace_save(trace, stream));
+    mu_check(stream_rewind(stream));
+    mu_check(edge_trace_load(loaded, stream));
+    file_stream_close(stream);
+    stream_free(stream);
+    storage_simply_remove(storage, EDGE_TRACE_TEST_FILE);
+    furi_record_close(RECORD_STORAGE);
+
+    mu_assert_int_eq(edge_trace_get_count(trace), edge_trace_get_count(loaded));
+    for(size_t i = 0; i < edge_trace_get_count(trace); i++) {
+        LevelDuration expected = edge_trace_get(trace, i);
+        LevelDuration result = edge_trace_get(loaded, i);
+        mu_assert_int_eq(level_duration_get_level(expected), level_duration_get_level(result));
+        mu_assert_int_eq(
+            level_duration_get_duration(expected), level_duration_get_duration(result));
+    }
+
+    /* truncated varint is dropped */
+    const uint8_t truncated[] = {0x02, 0x81, 0x80};
+    edge_trace_reset(loaded);
+    mu_assert_int_eq(1, edge_trace_parse(loaded, truncated, sizeof(truncated)));
+
+    edge_trace_free(loaded);
+    edge_trace_free(trace);
+}
+
+MU_TEST(decoders_subghz_replay_test) {
+    const char* files[] = {"came_raw.sub", "nice_flo_raw.sub", "princeton_raw.sub"};
+    void* decoder = decoder_family_subghz.alloc();
+    EdgeTrace* trace = edge_trace_alloc();
+    DecoderRunStats stats;
+
+    for(size_t i = 0; i < COUNT_OF(files); i++) {
+        edge_trace_reset(trace);
+        mu_assert(decoders_test_import_subghz_raw(trace, files[i]), files[i]);
+        decoder_family_run(&decoder_family_subghz, decoder, trace, &stats);
+        mu_assert(stats.detections > 0, files[i]);
+        mu_assert_int_eq(0, stats.heap_delta);
+    }
+
+    edge_trace_free(trace);
+    decoder_family_subghz.free(decoder);
+}
+
+MU_TEST(decoders_infrared_replay_test) {
+    const char* files[] = {"test_nec.irtest", "test_rc6.irtest", "test_sirc.irtest"};
+    void* decoder = decoder_family_infrared.alloc();
+    EdgeTrace* trace = edge_trace_alloc();
+    DecoderRunStats stats;
+
+    for(size_t i = 0; i < COUNT_OF(files); i++) {
+        edge_trace_reset(trace);
+        mu_assert(decoders_test_import_infrared_raw(trace, files[i]), files[i]);
+        decoder_family_run(&decoder_family_infrared, decoder, trace, &stats);
+        mu_assert(stats.detections > 0, files[i]);
+        mu_assert_int_eq(0, stats.heap_delta);
+    }
+
+    edge_trace_free(trace);
+    decoder_family_infrared.free(decoder);
+}
+
+MU_TEST(decoders_lfrfid_replay_test) {
+    const uint8_t em4100_data[] = {0x58, 0x00, 0x85, 0x64, 0x02};
+    const uint8_t h10301_data[] = {0x8D, 0x48, 0xA8};
+    void* decoder = decoder_family_lfrfid.alloc();
+    EdgeTrace* trace = edge_trace_alloc();
+    DecoderRunStats stats;
+
+    decoders_test_record_lfrfid(trace, LFRFIDProtocolEM4100, em4100_data, sizeof(em4100_data));
+    decoder_family_run(&decoder_family_lfrfid, decoder, trace, &stats);
+    mu_assert(stats.detections > 0, "EM4100 not detected");
+    mu_assert_int_eq(0, stats.heap_delta);
+
+    edge_trace_reset(trace);
+    decoders_test_record_lfrfid(trace, LFRFIDProtocolH10301, h10301_data, sizeof(h10301_data));
+    decoder_family_run(&decoder_family_lfrfid, decoder, trace, &stats);
+    mu_assert(stats.detections > 0, "H10301 not detected");
+    mu_assert_int_eq(0, stats.heap_delta);
+
+    edge_trace_free(trace);
+    decoder_family_lfrfid.free(decoder);
+}
+
+MU_TEST(decoders_ibutton_replay_test) {
+    const uint8_t cyfral_data[] = {0xAB, 0xCD};
+    const uint8_t metakom_data[] = {0x12, 0x34, 0x56, 0x78};
+    void* decoder = decoder_family_ibutton.alloc();
+    EdgeTrace* trace = edge_trace_alloc();
+    DecoderRunStats stats;
+
+    /* encoder output is emulation side, so only throughput is measured */
+    decoders_test_record_ibutton(
+        trace, iButtonProtocolMiscCyfral, cyfral_data, sizeof(cyfral_data));
+    decoder_family_run(&decoder_family_ibutton, decoder, trace, &stats);
+    mu_assert_int_eq(0, stats.heap_delta);
+
+    edge_trace_reset(trace);
+    decoders_test_record_ibutton(
+        trace, iButtonProtocolMiscMetakom, metakom_data, sizeof(metakom_data));
+    decoder_family_run(&decoder_family_ibutton, decoder, trace, &stats);
+    mu_assert_int_eq(0, stats.heap_delta);
+
+    edge_trace_free(trace);
+    decoder_family_ibutton.free(decoder);
+}
+
+MU_TEST(decoders_fuzz_test) {
+    const DecoderFamily* families[] = {
+        &decoder_family_subghz,
+        &decoder_family_infrared,
+        &decoder_family_lfrfid,
+        &decoder_family_ibutton,
+    };
+    uint8_t* input = malloc(FUZZ_INPUT_MAX_SIZE);
+    EdgeTrace* scratch = edge_trace_alloc();
+
+    for(size_t f = 0; f < COUNT_OF(families); f++) {
+        void* decoder = families[f]->alloc();
+        /* same inputs for every family, reproducible between runs */
+        srand(0xF1F1);
+        for(size_t i = 0; i < FUZZ_ITERATIONS; i++) {
+            size_t size = rand() % FUZZ_INPUT_MAX_SIZE;
+            for(size_t j = 0; j < size; j++) {
+                input[j] = rand();
+            }
+            decoder_family_fuzz_one_input(families[f], decoder, scratch, input, size);
+        }
+        families[f]->free(decoder);
+    }
+
+    edge_trace_free(scratch);
+    free(input);
+}
+
+MU_TEST_SUITE(test_decoders_suite) {
+    MU_RUN_TEST(edge_trace_save_load_test);
+    MU_RUN_TEST(decoders_subghz_replay_test);
+    MU_RUN_TEST(decoders_infrared_replay_test);
+    MU_RUN_TEST(decoders_lfrfid_replay_test);
+    MU_RUN_TEST(decoders_ibutton_replay_test);
+    MU_RUN_TEST(decoders_fuzz_test);
+}
+
+int run_minunit_test_decoders() {
+    MU_RUN_SUITE(test_decoders_suite);
+    return MU_EXIT_CODE;
+}
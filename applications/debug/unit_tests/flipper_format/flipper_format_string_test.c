@@ -326,9 +326,47 @@ MU_TEST(flipper_format_file_test) {
     furi_record_close(RECORD_STORAGE);
 }
 
+MU_TEST(flipper_format_hex_masked_test) {
+    FlipperFormat* flipper_format = flipper_format_string_alloc();
+    Stream* stream = flipper_format_get_raw_stream(flipper_format);
+    stream_write_cstring(
+        stream,
+        "Block 0: DE ?? BE EF 00 11 22 33 44 55 66 77 88 99 ?? FF\r\n"
+        "Block 1: DE AD BE\n"
+        "Block 2: DE ?? BE\n"
+        "Block 3: DE A BE\n"
+        "Block 4: 01 02 03");
+
+    uint8_t data[16] = {};
+    uint8_t mask[2] = {};
+    mu_check(flipper_format_rewind(flipper_format));
+    mu_check(flipper_format_read_hex_array_masked(flipper_format, "Block 0", data, mask, 16));
+    mu_assert_int_eq(0xDE, data[0]);
+    mu_assert_int_eq(0x00, data[1]);
+    mu_assert_int_eq(0xFF, data[15]);
+    mu_assert_int_eq(0xFD, mask[0]);
+    mu_assert_int_eq(0xBF, mask[1]);
+
+    // Too few values on line
+    mu_check(!flipper_format_read_hex_array_masked(flipper_format, "Block 1", data, mask, 4));
+    mu_check(flipper_format_rewind(flipper_format));
+    memset(mask, 0, sizeof(mask));
+    mu_check(flipper_format_read_hex_array_masked(flipper_format, "Block 1", data, mask, 3));
+    mu_assert_int_eq(0x07, mask[0]);
+
+    // Unknown values are not allowed in plain hex
+    mu_check(!flipper_format_read_hex(flipper_format, "Block 2", data, 3));
+    mu_check(!flipper_format_read_hex(flipper_format, "Block 3", data, 3));
+    mu_check(flipper_format_read_hex(flipper_format, "Block 4", data, 3));
+    mu_assert_int_eq(0x03, data[2]);
+
+    flipper_format_free(flipper_format);
+}
+
 MU_TEST_SUITE(flipper_format_string_suite) {
     MU_RUN_TEST(flipper_format_string_test);
     MU_RUN_TEST(flipper_format_file_test);
+    MU_RUN_TEST(flipper_format_hex_masked_test);
 }
 
 int run_minunit_test_flipper_format_string() {
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include "../minunit.h"
+
+#define SPSC_RING_TEST_CAPACITY (64)
+#define SPSC_RING_TEST_WATERMARK (16)
+#define SPSC_RING_TEST_ITEMS (10000)
+
+static int32_t test_furi_spsc_ring_producer(void* context) {
+    FuriSpscRing* ring = context;
+
+    for(uint32_t i = 0; i < SPSC_RING_TEST_ITEMS;) {
+        if(furi_spsc_ring_push(ring, &i)) {
+            i++;
+        } else {
+            furi_delay_tick(1);
+        }
+    }
+
+    return 0;
+}
+
+void test_furi_spsc_ring() {
+    FuriSpscRing* ring = furi_spsc_ring_alloc(
+        sizeof(uint32_t), SPSC_RING_TEST_CAPACITY, SPSC_RING_TEST_WATERMARK);
+    FuriSpscRingStats stats;
+
+    // overrun and wrap around on single thread
+    for(uint32_t i = 0; i < SPSC_RING_TEST_CAPACITY; i++) {
+        mu_check(furi_spsc_ring_push(ring, &i));
+    }
+    uint32_t item = 0;
+    mu_check(!furi_spsc_ring_push(ring, &item));
+    furi_spsc_ring_get_stats(ring, &stats);
+    mu_assert_int_eq(1, stats.overruns);
+    mu_assert_int_eq(SPSC_RING_TEST_CAPACITY, stats.high_water);
+    mu_assert_int_eq(SPSC_RING_TEST_CAPACITY, furi_spsc_ring_wait(ring, 0));
+
+    uint32_t items[SPSC_RING_TEST_CAPACITY / 2];
+    mu_assert_int_eq(COUNT_OF(items), furi_spsc_ring_pop(ring, items, COUNT_OF(items)));
+    mu_assert_int_eq(0, items[0]);
+    mu_assert_int_eq(COUNT_OF(items) - 1, items[COUNT_OF(items) - 1]);
+    for(uint32_t i = 0; i < COUNT_OF(items); i++) {
+        mu_check(furi_spsc_ring_push(ring, &i));
+    }
+
+    // contiguous run ends at the end of buffer
+    const uint32_t* run;
+    mu_assert_int_eq(COUNT_OF(items), furi_spsc_ring_peek(ring, (const void**)&run));
+    mu_assert_int_eq(COUNT_OF(items), run[0]);
+    furi_spsc_ring_release(ring, COUNT_OF(items));
+    mu_assert_int_eq(COUNT_OF(items), furi_spsc_ring_pop(ring, items, SPSC_RING_TEST_CAPACITY));
+    mu_assert_int_eq(0, items[0]);
+    mu_assert_int_eq(0, furi_spsc_ring_count(ring));
+
+    furi_spsc_ring_reset_stats(ring);
+    furi_spsc_ring_get_stats(ring, &stats);
+    mu_assert_int_eq(0, stats.overruns);
+
+    // concurrent producer, every item arrives once and in order
+    FuriThread* producer =
+        furi_thread_alloc_ex("SpscRingTest", 1024, test_furi_spsc_ring_producer, ring);
+    furi_thread_start(producer);
+
+    uint32_t expected = 0;
+    while(expected < SPSC_RING_TEST_ITEMS) {
+        if(!furi_spsc_ring_wait(ring, 100)) break;
+
+        size_t count;
+        while((count = furi_spsc_ring_peek(ring, (const void**)&run))) {
+            for(size_t i = 0; i < count; i++) {
+                if(run[i] != expected) break;
+                expected++;
+            }
+            furi_spsc_ring_release(ring, count);
+        }
+    }
+
+    furi_thread_join(producer);
+    furi_thread_free(producer);
+    mu_assert_int_eq(SPSC_RING_TEST_ITEMS, expected);
+
+    furi_spsc_ring_free(ring);
+}
@@ -208,6 +208,17 @@ MU_TEST(mu_test_furi_string_appends) {
     mu_assert_string_eq(
         "test!testmoretest 1 two 3 0x04test 4 five 6 0x07", furi_string_get_cstr(string));
 
+    // test furi_string_cat_printf and furi_string_printf with the string itself as argument
+    furi_string_set(string, "abc");
+    furi_string_cat_printf(string, "%s", furi_string_get_cstr(string));
+    mu_assert_string_eq("abcabc", furi_string_get_cstr(string));
+    const char* self = furi_string_get_cstr(string);
+    // output outgrows inline storage while the argument is still read
+    furi_string_cat_printf(string, "%s-%s-%s-%s", self, self, self, self);
+    mu_assert_string_eq("abcabcabcabc-abcabc-abcabc-abcabc", furi_string_get_cstr(string));
+    furi_string_printf(string, "<%s>", furi_string_get_cstr(string));
+    mu_assert_string_eq("<abcabcabcabc-abcabc-abcabc-abcabc>", furi_string_get_cstr(string));
+
     furi_string_free(string);
 }
 
@@ -445,6 +456,70 @@ MU_TEST(mu_test_furi_string_utf8) {
     furi_string_free(utf8_string);
 }
 
+MU_TEST(mu_test_furi_string_arena) {
+    FuriStringArena* arena = furi_string_arena_alloc(64);
+    FuriString* heap = furi_string_alloc_set("heap");
+
+    for(size_t i = 0; i < 8; i++) {
+        FuriString* key = furi_string_arena_alloc_string(arena);
+        FuriString* value = furi_string_arena_alloc_string(arena);
+
+        furi_string_printf(key, "Key %zu", i);
+        // grow past inline storage and block size
+        for(size_t j = 0; j < 100; j++) {
+            furi_string_push_back(value, 'a' + j % 26);
+        }
+        furi_string_cat(value, key);
+        mu_assert_int_eq(105, furi_string_size(value));
+        mu_check(furi_string_end_with_str(value, "Key 7") == (i == 7));
+
+        // content crosses arena and heap domains
+        furi_string_swap(key, heap);
+        mu_assert_string_eq("heap", furi_string_get_cstr(key));
+        furi_string_swap(key, heap);
+        furi_string_move(heap, value);
+        mu_assert_int_eq(105, furi_string_size(heap));
+        furi_string_set(heap, "heap");
+
+        furi_string_free(key);
+        furi_string_arena_reset(arena);
+    }
+
+    furi_string_free(heap);
+    furi_string_arena_free(arena);
+}
+
+MU_TEST(mu_test_furi_string_allocations) {
+    FuriStringStats before, after;
+    const char* lines[] = {"Filetype", "Version", "Frequency", "Preset", "Protocol", "Key"};
+    const size_t rounds = 64;
+
+    // short strings live inline, only the header is allocated
+    furi_string_get_stats(&before);
+    for(size_t i = 0; i < rounds; i++) {
+        FuriString* tmp = furi_string_alloc_set(lines[i % COUNT_OF(lines)]);
+        furi_string_cat_printf(tmp, ": %zu", i);
+        furi_string_free(tmp);
+    }
+    furi_string_get_stats(&after);
+    // other threads may allocate meanwhile, heap buffers would make it 2 per round
+    mu_check(after.heap_allocs - before.heap_allocs < rounds * 2);
+
+    // arena temporaries do not touch the heap at all
+    FuriStringArena* arena = furi_string_arena_alloc(256);
+    furi_string_get_stats(&before);
+    for(size_t i = 0; i < rounds; i++) {
+        FuriString* tmp = furi_string_arena_alloc_string(arena);
+        furi_string_set(tmp, lines[i % COUNT_OF(lines)]);
+        furi_string_cat_printf(tmp, ": %zu", i);
+        furi_string_arena_reset(arena);
+    }
+    furi_string_get_stats(&after);
+    mu_check(after.heap_allocs - before.heap_allocs < rounds);
+    mu_check(after.arena_allocs - before.arena_allocs >= rounds);
+    furi_string_arena_free(arena);
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -460,6 +535,8 @@ MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(mu_test_furi_string_start_end);
     MU_RUN_TEST(mu_test_furi_string_trim);
     MU_RUN_TEST(mu_test_furi_string_utf8);
+    MU_RUN_TEST(mu_test_furi_string_arena);
+    MU_RUN_TEST(mu_test_furi_string_allocations);
 }
 
 int run_minunit_test_furi_string() {
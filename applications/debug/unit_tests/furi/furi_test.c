@@ -10,6 +10,10 @@ void test_furi_pubsub();
 
 void test_furi_memmgr();
 
+void test_furi_timer();
+
+void test_furi_spsc_ring();
+
 static int foo = 0;
 
 void test_setup(void) {
@@ -39,6 +43,14 @@ MU_TEST(mu_test_furi_memmgr) {
     test_furi_memmgr();
 }
 
+MU_TEST(mu_test_furi_timer) {
+    test_furi_timer();
+}
+
+MU_TEST(mu_test_furi_spsc_ring) {
+    test_furi_spsc_ring();
+}
+
 MU_TEST_SUITE(test_suite) {
     MU_SUITE_CONFIGURE(&test_setup, &test_teardown);
 
@@ -48,6 +60,8 @@ MU_TEST_SUITE(test_suite) {
     MU_RUN_TEST(mu_test_furi_create_open);
     MU_RUN_TEST(mu_test_furi_pubsub);
     MU_RUN_TEST(mu_test_furi_memmgr);
+    MU_RUN_TEST(mu_test_furi_timer);
+    MU_RUN_TEST(mu_test_furi_spsc_ring);
 }
 
 int run_minunit_test_furi() {
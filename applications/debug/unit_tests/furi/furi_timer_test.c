@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <string.h>
+#include <furi.h>
+#include "../minunit.h"
+
+#define TIMER_TEST_COUNT (8)
+#define TIMER_TEST_TICKS (200)
+#define TIMER_TEST_SLACK (64)
+// Beyond the wheel range of 32^4 ticks
+#define TIMER_TEST_FAR_TICKS (3600000)
+
+typedef struct {
+    FuriTimer* timer;
+    uint32_t deadline;
+    uint32_t fired_at;
+    volatile bool fired;
+} TimerTestContext;
+
+static void test_furi_timer_callback(void* context) {
+    TimerTestContext* test = context;
+    test->fired_at = furi_get_tick();
+    test->fired = true;
+}
+
+static uint32_t test_furi_timer_get_wakeups() {
+    FuriTimerStats* stats = malloc(sizeof(FuriTimerStats));
+    furi_timer_get_stats(stats);
+
+    const char* name = furi_thread_get_name(furi_thread_get_current_id());
+    uint32_t wakeups = 0;
+    for(size_t i = 0; i < stats->subsystems_count; i++) {
+        if(!strncmp(stats->subsystems[i].name, name, FURI_TIMER_STATS_NAME_SIZE - 1)) {
+            wakeups = stats->subsystems[i].wakeups;
+        }
+    }
+
+    free(stats);
+    return wakeups;
+}
+
+void test_furi_timer() {
+    TimerTestContext tests[TIMER_TEST_COUNT] = {};
+
+    // exact one shot timer
+    tests[0].timer = furi_timer_alloc(test_furi_timer_callback, FuriTimerTypeOnce, &tests[0]);
+    tests[0].deadline = furi_get_tick() + 10;
+    furi_timer_start(tests[0].timer, 10);
+    mu_assert_int_eq(1, furi_timer_is_running(tests[0].timer));
+    furi_delay_tick(20);
+    mu_check(tests[0].fired);
+    mu_check((int32_t)(tests[0].fired_at - tests[0].deadline) >= 0);
+    mu_assert_int_eq(0, furi_timer_is_running(tests[0].timer));
+
+    // stopped timer never fires
+    tests[0].fired = false;
+    furi_timer_start(tests[0].timer, 10);
+    mu_assert_int_eq(FuriStatusOk, furi_timer_stop(tests[0].timer));
+    mu_assert_int_eq(FuriStatusErrorResource, furi_timer_stop(tests[0].timer));
+    furi_delay_tick(20);
+    mu_check(!tests[0].fired);
+
+    // timer parked beyond the wheel range doesn't delay nearer timers
+    tests[1].timer = furi_timer_alloc(test_furi_timer_callback, FuriTimerTypeOnce, &tests[1]);
+    furi_timer_start(tests[1].timer, TIMER_TEST_FAR_TICKS);
+    tests[0].deadline = furi_get_tick() + 10;
+    furi_timer_start(tests[0].timer, 10);
+    furi_delay_tick(20);
+    mu_check(tests[0].fired);
+    mu_check((int32_t)(tests[0].fired_at - tests[0].deadline) >= 0);
+    mu_check((int32_t)(tests[0].fired_at - tests[0].deadline) <= 1);
+    mu_check(!tests[1].fired);
+    mu_assert_int_eq(1, furi_timer_is_running(tests[1].timer));
+    furi_timer_stop(tests[1].timer);
+    furi_timer_free(tests[1].timer);
+    furi_timer_free(tests[0].timer);
+
+    // timers with overlapping slack windows are served in shared wakeups
+    uint32_t wakeups = test_furi_timer_get_wakeups();
+    for(size_t i = 0; i < TIMER_TEST_COUNT; i++) {
+        tests[i].fired = false;
+        tests[i].timer = furi_timer_alloc(test_furi_timer_callback, FuriTimerTypeOnce, &tests[i]);
+        furi_timer_set_slack(tests[i].timer, TIMER_TEST_SLACK);
+        tests[i].deadline = furi_get_tick() + TIMER_TEST_TICKS;
+        furi_timer_start(tests[i].timer, TIMER_TEST_TICKS);
+        furi_delay_tick(1);
+    }
+    furi_delay_tick(TIMER_TEST_TICKS + TIMER_TEST_SLACK * 2);
+
+    for(size_t i = 0; i < TIMER_TEST_COUNT; i++) {
+        mu_check(tests[i].fired);
+        int32_t late = tests[i].fired_at - tests[i].deadline;
+        mu_check(late >= 0);
+        mu_check(late <= TIMER_TEST_SLACK + 1);
+        furi_timer_free(tests[i].timer);
+    }
+    wakeups = test_furi_timer_get_wakeups() - wakeups;
+    mu_check(wakeups < TIMER_TEST_COUNT / 2);
+}
@@ -3,6 +3,8 @@
 #include <storage/storage.h>
 #include <lib/flipper_format/flipper_format.h>
 #include <lib/nfc/protocols/nfca.h>
+#include <lib/nfc/protocols/crypto1.h>
+#include <lib/nfc/protocols/nfc_util.h>
 #include <lib/nfc/helpers/mf_classic_dict.h>
 #include <lib/digital_signal/digital_signal.h>
 #include <lib/nfc/nfc_device.h>
@@ -510,6 +512,109 @@ MU_TEST(mf_classic_4k_7b_file_test) {
     mf_classic_generator_test(7, MfClassicType4k);
 }
 
+static uint64_t crypto1_test_random_key() {
+    return ((uint64_t)rand() << 32 | rand()) & 0xFFFFFFFFFFFF;
+}
+
+// Bitwise reference, same as crypto1 byte and word before table driven engine
+static uint8_t crypto1_test_byte_reference(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    uint8_t out = 0;
+    for(uint8_t i = 0; i < 8; i++) {
+        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+    }
+    return out;
+}
+
+static uint32_t crypto1_test_word_reference(Crypto1* crypto1, uint32_t in, int is_encrypted) {
+    uint32_t out = 0;
+    for(uint8_t i = 0; i < 32; i++) {
+        out |= crypto1_bit(crypto1, FURI_BIT(in, i ^ 24), is_encrypted) << (24 ^ i);
+    }
+    return out;
+}
+
+MU_TEST(crypto1_cross_check_test) {
+    Crypto1 fast;
+    Crypto1 reference;
+    srand(0xC1C1);
+
+    for(size_t round = 0; round < 512; round++) {
+        uint64_t key = crypto1_test_random_key();
+        crypto1_init(&fast, key);
+        crypto1_init(&reference, key);
+
+        for(int is_encrypted = 0; is_encrypted < 2; is_encrypted++) {
+            uint32_t word = rand();
+            mu_assert(
+                crypto1_word(&fast, word, is_encrypted) ==
+                    crypto1_test_word_reference(&reference, word, is_encrypted),
+                "crypto1_word mismatch");
+            for(size_t i = 0; i < 4; i++) {
+                uint8_t byte = rand();
+                mu_assert(
+                    crypto1_byte(&fast, byte, is_encrypted) ==
+                        crypto1_test_byte_reference(&reference, byte, is_encrypted),
+                    "crypto1_byte mismatch");
+            }
+            mu_assert(
+                (fast.odd == reference.odd) && (fast.even == reference.even),
+                "crypto1 state mismatch");
+        }
+
+        uint8_t plain[18];
+        uint8_t encrypted[18];
+        uint8_t parity[3];
+        for(size_t i = 0; i < sizeof(plain); i++) {
+            plain[i] = rand();
+        }
+        crypto1_encrypt(&fast, NULL, plain, sizeof(plain) * 8, encrypted, parity);
+        for(size_t i = 0; i < sizeof(plain); i++) {
+            uint8_t keystream = crypto1_test_byte_reference(&reference, 0, 0);
+            mu_assert(encrypted[i] == (keystream ^ plain[i]), "crypto1_encrypt data mismatch");
+            uint8_t parity_bit = FURI_BIT(parity[i / 8], 7 - (i & 0x07));
+            uint8_t parity_ref = crypto1_filter(reference.odd) ^ nfc_util_odd_parity8(plain[i]);
+            mu_assert(parity_bit == (parity_ref & 0x01), "crypto1_encrypt parity mismatch");
+        }
+    }
+}
+
+MU_TEST(crypto1_throughput_test) {
+    // Whole MIFARE Classic 4K worth of 16 byte blocks with CRC
+    const size_t frame_size = 18;
+    const size_t frame_count = 256;
+    uint8_t encrypted[18] = {};
+    uint8_t decrypted[18];
+    Crypto1 crypto1;
+    uint64_t key = crypto1_test_random_key();
+
+    FURI_CRITICAL_ENTER();
+    crypto1_init(&crypto1, key);
+    uint32_t reference_cycles = DWT->CYCCNT;
+    for(size_t frame = 0; frame < frame_count; frame++) {
+        for(size_t i = 0; i < frame_size; i++) {
+            decrypted[i] = crypto1_test_byte_reference(&crypto1, 0, 0) ^ encrypted[i];
+        }
+    }
+    reference_cycles = DWT->CYCCNT - reference_cycles;
+
+    crypto1_init(&crypto1, key);
+    uint32_t fast_cycles = DWT->CYCCNT;
+    for(size_t frame = 0; frame < frame_count; frame++) {
+        crypto1_decrypt(&crypto1, encrypted, frame_size * 8, decrypted);
+    }
+    fast_cycles = DWT->CYCCNT - fast_cycles;
+    FURI_CRITICAL_EXIT();
+
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+    FURI_LOG_I(
+        TAG,
+        "Crypto1 %u bytes: bitwise %lu us, table driven %lu us",
+        frame_size * frame_count,
+        reference_cycles / cycles_per_us,
+        fast_cycles / cycles_per_us);
+    mu_assert(fast_cycles < reference_cycles, "Table driven crypto1 is slower than bitwise");
+}
+
 MU_TEST_SUITE(nfc) {
     nfc_test_alloc();
 
@@ -522,6 +627,8 @@ MU_TEST_SUITE(nfc) {
     MU_RUN_TEST(nfc_digital_signal_test);
     MU_RUN_TEST(mf_classic_dict_test);
     MU_RUN_TEST(mf_classic_dict_load_test);
+    MU_RUN_TEST(crypto1_cross_check_test);
+    MU_RUN_TEST(crypto1_throughput_test);
 
     nfc_test_free();
 }
@@ -254,6 +254,55 @@ MU_TEST_1(test_dirwalk_filter, Storage* storage) {
     storage_test_paths_free(paths);
 }
 
+// Small enough to need several calls, big enough for the longest path
+#define TEST_DIRWALK_ARENA_SIZE 128
+
+MU_TEST_1(test_dirwalk_batch, Storage* storage) {
+    FuriString* path = furi_string_alloc();
+    FuriString* parent = furi_string_alloc();
+    uint64_t* arena = malloc(TEST_DIRWALK_ARENA_SIZE);
+
+    StorageTestPathDict_t* paths =
+        storage_test_paths_alloc(storage_test_dirwalk_full, COUNT_OF(storage_test_dirwalk_full));
+
+    DirWalk* dir_walk = dir_walk_alloc(storage);
+    mu_check(dir_walk_open(dir_walk, EXT_PATH("dirwalk")));
+
+    size_t used;
+    size_t calls = 0;
+    while(dir_walk_read_batch(dir_walk, arena, TEST_DIRWALK_ARENA_SIZE, &used) == DirWalkOK) {
+        calls++;
+        for(size_t offset = 0; offset < used;) {
+            const DirWalkEntry* entry = (const DirWalkEntry*)((uint8_t*)arena + offset);
+            offset += entry->size;
+
+            furi_string_set(path, entry->path);
+            furi_string_right(path, strlen(EXT_PATH("dirwalk/")));
+
+            // Directory comes before its content
+            size_t last_char = furi_string_search_rchar(path, '/');
+            if(last_char != FURI_STRING_FAILURE) {
+                furi_string_set_n(parent, path, 0, last_char);
+                StorageTestPath* record = StorageTestPathDict_get(*paths, parent);
+                mu_check(record && record->visited);
+            }
+
+            mu_check(storage_test_paths_mark(paths, path, file_info_is_dir(&entry->fileinfo)));
+        }
+    }
+
+    mu_check(calls > 1);
+
+    dir_walk_free(dir_walk);
+    free(arena);
+    furi_string_free(parent);
+    furi_string_free(path);
+
+    mu_check(storage_test_paths_check(paths) == false);
+
+    storage_test_paths_free(paths);
+}
+
 MU_TEST_SUITE(test_dirwalk_suite) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     storage_dirs_create(storage, EXT_PATH("dirwalk"));
@@ -261,6 +310,7 @@ MU_TEST_SUITE(test_dirwalk_suite) {
     MU_RUN_TEST_1(test_dirwalk_full, storage);
     MU_RUN_TEST_1(test_dirwalk_no_recursive, storage);
     MU_RUN_TEST_1(test_dirwalk_filter, storage);
+    MU_RUN_TEST_1(test_dirwalk_batch, storage);
 
     storage_simply_remove_recursive(storage, EXT_PATH("dirwalk"));
     furi_record_close(RECORD_STORAGE);
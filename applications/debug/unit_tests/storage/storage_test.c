@@ -1,6 +1,10 @@
 #include "../minunit.h"
 #include <furi.h>
+#include <furi_hal.h>
 #include <storage/storage.h>
+#include <toolbox/saved_struct.h>
+#include <toolbox/stream/file_stream.h>
+#include <update_util/lfs_backup.h>
 
 // DO NOT USE THIS IN PRODUCTION CODE
 // This is a hack to access internal storage functions and definitions
@@ -13,6 +17,8 @@
 
 #define STORAGE_TEST_DIR UNIT_TESTS_PATH("test_dir")
 
+#define TAG "StorageTest"
+
 static bool storage_file_create(Storage* storage, const char* path, const char* data) {
     File* file = storage_file_alloc(storage);
     bool result = false;
@@ -115,10 +121,128 @@ MU_TEST(storage_file_open_close) {
     furi_record_close(RECORD_STORAGE);
 }
 
+#define STORAGE_MANY_FILES_COUNT 16
+
+MU_TEST(storage_file_open_many) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* files[STORAGE_MANY_FILES_COUNT];
+    FuriString* path = furi_string_alloc();
+
+    for(size_t i = 0; i < STORAGE_MANY_FILES_COUNT; i++) {
+        furi_string_printf(path, UNIT_TESTS_PATH("many_%u.test"), i);
+        files[i] = storage_file_alloc(storage);
+        mu_check(storage_file_open(
+            files[i], furi_string_get_cstr(path), FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    }
+
+    // Every open path is known to the storage
+    for(size_t i = 0; i < STORAGE_MANY_FILES_COUNT; i++) {
+        furi_string_printf(path, UNIT_TESTS_PATH("many_%u.test"), i);
+        const char* name = furi_string_get_cstr(path);
+        mu_assert_int_eq(FSE_ALREADY_OPEN, storage_common_remove(storage, name));
+    }
+
+    for(size_t i = 0; i < STORAGE_MANY_FILES_COUNT; i++) {
+        mu_assert_int_eq(1, storage_file_write(files[i], "x", 1));
+        mu_check(storage_file_close(files[i]));
+        storage_file_free(files[i]);
+    }
+
+    for(size_t i = 0; i < STORAGE_MANY_FILES_COUNT; i++) {
+        furi_string_printf(path, UNIT_TESTS_PATH("many_%u.test"), i);
+        mu_assert_int_eq(FSE_OK, storage_common_remove(storage, furi_string_get_cstr(path)));
+    }
+
+    furi_string_free(path);
+    furi_record_close(RECORD_STORAGE);
+}
+
+#define STORAGE_ASYNC_FILE UNIT_TESTS_PATH("async.test")
+#define STORAGE_ASYNC_BLOCK_SIZE 256
+
+typedef struct {
+    uint32_t completed;
+    uint32_t cancelled;
+    uint32_t bytes;
+} StorageAsyncTestContext;
+
+static void storage_async_test_callback(
+    File* file,
+    uint16_t bytes,
+    FS_Error error,
+    void* context) {
+    UNUSED(file);
+    StorageAsyncTestContext* test = context;
+    if(error == FSE_CANCELLED) {
+        test->cancelled++;
+    } else if(error == FSE_OK) {
+        test->completed++;
+        test->bytes += bytes;
+    }
+}
+
+MU_TEST(storage_file_async) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t* buffer = malloc(STORAGE_ASYNC_DEPTH * STORAGE_ASYNC_BLOCK_SIZE);
+    for(size_t i = 0; i < STORAGE_ASYNC_DEPTH * STORAGE_ASYNC_BLOCK_SIZE; i++) {
+        buffer[i] = i * 7;
+    }
+
+    // Queue is bounded, synchronous calls are served after the queued requests
+    StorageAsyncTestContext test = {0};
+    mu_check(storage_file_open(file, STORAGE_ASYNC_FILE, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    for(size_t i = 0; i < STORAGE_ASYNC_DEPTH; i++) {
+        mu_check(storage_file_write_async(
+            file,
+            &buffer[i * STORAGE_ASYNC_BLOCK_SIZE],
+            STORAGE_ASYNC_BLOCK_SIZE,
+            storage_async_test_callback,
+            &test));
+    }
+    mu_check(storage_file_sync(file));
+    mu_assert_int_eq(STORAGE_ASYNC_DEPTH, test.completed);
+    mu_assert_int_eq(STORAGE_ASYNC_DEPTH * STORAGE_ASYNC_BLOCK_SIZE, test.bytes);
+    mu_assert_int_eq(STORAGE_ASYNC_DEPTH * STORAGE_ASYNC_BLOCK_SIZE, storage_file_size(file));
+
+    // Read back, tell is a barrier like any other synchronous call
+    uint8_t* data = malloc(STORAGE_ASYNC_BLOCK_SIZE);
+    memset(&test, 0, sizeof(test));
+    mu_check(storage_file_seek(file, 0, true));
+    mu_check(storage_file_read_async(
+        file, data, STORAGE_ASYNC_BLOCK_SIZE, storage_async_test_callback, &test));
+    mu_assert_int_eq(STORAGE_ASYNC_BLOCK_SIZE, storage_file_tell(file));
+    mu_assert_int_eq(1, test.completed);
+    mu_assert_mem_eq(buffer, data, STORAGE_ASYNC_BLOCK_SIZE);
+
+    // Every request is either done or cancelled, and the callback knows which one
+    uint32_t queued = 0;
+    memset(&test, 0, sizeof(test));
+    for(size_t i = 0; i < STORAGE_ASYNC_DEPTH; i++) {
+        if(storage_file_read_async(
+               file, data, STORAGE_ASYNC_BLOCK_SIZE, storage_async_test_callback, &test)) {
+            queued++;
+        }
+    }
+    uint16_t cancelled = storage_file_async_cancel(file);
+    mu_assert_int_eq(cancelled, test.cancelled);
+    mu_assert_int_eq(queued, test.completed + test.cancelled);
+
+    mu_check(storage_file_close(file));
+    mu_assert_int_eq(FSE_OK, storage_common_remove(storage, STORAGE_ASYNC_FILE));
+
+    free(data);
+    free(buffer);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
 MU_TEST_SUITE(storage_file) {
     storage_file_open_lock_setup();
     MU_RUN_TEST(storage_file_open_close);
     MU_RUN_TEST(storage_file_open_lock);
+    MU_RUN_TEST(storage_file_open_many);
+    MU_RUN_TEST(storage_file_async);
     storage_file_open_lock_teardown();
 }
 
@@ -194,10 +318,68 @@ MU_TEST(storage_dir_exists_test) {
     furi_record_close(RECORD_STORAGE);
 }
 
+#define STORAGE_WATCH_FILE STORAGE_TEST_DIR "/watch.test"
+#define STORAGE_WATCH_RENAMED_FILE STORAGE_TEST_DIR "/watch_renamed.test"
+#define STORAGE_WATCH_SUBDIR STORAGE_TEST_DIR "/subdir"
+
+typedef struct {
+    uint32_t count[4]; /**< by StorageWatchEvent bit */
+    bool rename_old_path;
+    FuriThreadId test_thread;
+    bool test_thread_called; /**< callbacks must come from storage thread */
+} StorageWatchTestContext;
+
+static void storage_watch_test_callback(const StorageWatchMessage* message, void* context) {
+    StorageWatchTestContext* test = context;
+    test->count[__builtin_ctz(message->event)]++;
+    if(furi_thread_get_current_id() == test->test_thread) {
+        test->test_thread_called = true;
+    }
+    if(message->event == StorageWatchEventRename) {
+        test->rename_old_path = strcmp(message->old_path, STORAGE_WATCH_FILE) == 0;
+    }
+}
+
+MU_TEST(storage_dir_watch_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageWatchTestContext test = {.test_thread = furi_thread_get_current_id()};
+
+    mu_assert_int_eq(FSE_OK, storage_common_mkdir(storage, STORAGE_TEST_DIR));
+    StorageWatch* watch = storage_watch_dir(
+        storage,
+        STORAGE_TEST_DIR "/",
+        STORAGE_WATCH_EVENT_ALL,
+        storage_watch_test_callback,
+        &test);
+
+    mu_check(storage_file_create(storage, STORAGE_WATCH_FILE, "watch"));
+    mu_assert_int_eq(FSE_OK, storage_common_mkdir(storage, STORAGE_WATCH_SUBDIR));
+    // Not a direct child
+    mu_check(storage_file_create(storage, STORAGE_WATCH_SUBDIR "/file.test", "watch"));
+    mu_assert_int_eq(
+        FSE_OK, storage_common_rename(storage, STORAGE_WATCH_FILE, STORAGE_WATCH_RENAMED_FILE));
+    mu_check(storage_simply_remove_recursive(storage, STORAGE_WATCH_SUBDIR));
+    mu_assert_int_eq(FSE_OK, storage_common_remove(storage, STORAGE_WATCH_RENAMED_FILE));
+
+    storage_unwatch_dir(watch);
+    mu_assert_int_eq(FSE_OK, storage_common_remove(storage, STORAGE_TEST_DIR));
+
+    // Rename is a copy, a remove and then the rename itself
+    mu_assert_int_eq(3, test.count[__builtin_ctz(StorageWatchEventCreate)]);
+    mu_assert_int_eq(2, test.count[__builtin_ctz(StorageWatchEventModify)]);
+    mu_assert_int_eq(3, test.count[__builtin_ctz(StorageWatchEventDelete)]);
+    mu_assert_int_eq(1, test.count[__builtin_ctz(StorageWatchEventRename)]);
+    mu_check(test.rename_old_path);
+    mu_check(!test.test_thread_called);
+
+    furi_record_close(RECORD_STORAGE);
+}
+
 MU_TEST_SUITE(storage_dir) {
     MU_RUN_TEST(storage_dir_open_close);
     MU_RUN_TEST(storage_dir_open_lock);
     MU_RUN_TEST(storage_dir_exists_test);
+    MU_RUN_TEST(storage_dir_watch_test);
 }
 
 static const char* const storage_copy_test_paths[] = {
@@ -346,6 +528,545 @@ MU_TEST_SUITE(storage_rename) {
     furi_record_close(RECORD_STORAGE);
 }
 
+#define STORAGE_SEEK_FILE UNIT_TESTS_PATH("seek.test")
+#define STORAGE_SEEK_GAP_FILE UNIT_TESTS_PATH("seek_gap.test")
+#define STORAGE_SEEK_FILE_SIZE (1024 * 1024)
+#define STORAGE_SEEK_BLOCK_SIZE 512
+#define STORAGE_SEEK_GAP_PERIOD (4 * 1024)
+#define STORAGE_SEEK_COUNT 64
+
+// Every word of the test file holds its own offset
+static void storage_seek_fill(uint32_t* buffer, uint32_t offset) {
+    for(size_t i = 0; i < STORAGE_SEEK_BLOCK_SIZE / sizeof(uint32_t); i++) {
+        buffer[i] = offset + i * sizeof(uint32_t);
+    }
+}
+
+static bool storage_seek_write(File* file, const uint32_t* buffer) {
+    return storage_file_write(file, buffer, STORAGE_SEEK_BLOCK_SIZE) == STORAGE_SEEK_BLOCK_SIZE;
+}
+
+static bool storage_seek_check(File* file, uint32_t offset) {
+    uint32_t value = 0;
+    if(!storage_file_seek(file, offset, true)) return false;
+    if(storage_file_read(file, &value, sizeof(value)) != sizeof(value)) return false;
+    return value == offset;
+}
+
+static void storage_seek_setup() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    File* gap = storage_file_alloc(storage);
+    uint32_t* buffer = malloc(STORAGE_SEEK_BLOCK_SIZE);
+
+    // Gap file grows in between, so the test file is fragmented
+    mu_check(storage_file_open(file, STORAGE_SEEK_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(storage_file_open(gap, STORAGE_SEEK_GAP_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    for(uint32_t offset = 0; offset < STORAGE_SEEK_FILE_SIZE; offset += STORAGE_SEEK_BLOCK_SIZE) {
+        storage_seek_fill(buffer, offset);
+        mu_check(storage_seek_write(file, buffer));
+        if((offset % STORAGE_SEEK_GAP_PERIOD) == 0) {
+            mu_check(storage_seek_write(gap, buffer));
+        }
+    }
+    mu_check(storage_file_close(file));
+    mu_check(storage_file_close(gap));
+
+    free(buffer);
+    storage_file_free(gap);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void storage_seek_teardown() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_remove(storage, STORAGE_SEEK_FILE);
+    storage_simply_remove(storage, STORAGE_SEEK_GAP_FILE);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_file_seek_latency) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    mu_check(storage_file_open(file, STORAGE_SEEK_FILE, FSAM_READ, FSOM_OPEN_EXISTING));
+
+    uint32_t seed = 0x5EEC;
+    uint32_t first_time = 0;
+    uint32_t total_time = 0;
+    uint32_t max_time = 0;
+    for(size_t i = 0; i < STORAGE_SEEK_COUNT; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t offset = ((seed >> 8) % (STORAGE_SEEK_FILE_SIZE / sizeof(uint32_t))) *
+                          sizeof(uint32_t);
+
+        uint32_t time = DWT->CYCCNT;
+        bool result = storage_seek_check(file, offset);
+        time = (DWT->CYCCNT - time) / furi_hal_cortex_instructions_per_microsecond();
+        mu_assert(result, "wrong data after seek");
+
+        // First seek also builds the link map
+        if(i == 0) {
+            first_time = time;
+        } else {
+            total_time += time;
+            max_time = MAX(max_time, time);
+        }
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Seek and read: first %lu us, average %lu us, max %lu us",
+        first_time,
+        total_time / (STORAGE_SEEK_COUNT - 1),
+        max_time);
+
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_file_seek_append) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint32_t* buffer = malloc(STORAGE_SEEK_BLOCK_SIZE);
+    mu_check(storage_file_open(file, STORAGE_SEEK_FILE, FSAM_READ_WRITE, FSOM_OPEN_EXISTING));
+
+    mu_check(storage_seek_check(file, STORAGE_SEEK_FILE_SIZE / 2));
+
+    // File grows past the clusters known at the first seek
+    storage_seek_fill(buffer, STORAGE_SEEK_FILE_SIZE);
+    mu_check(storage_file_seek(file, STORAGE_SEEK_FILE_SIZE, true));
+    for(size_t i = 0; i < STORAGE_SEEK_GAP_PERIOD / STORAGE_SEEK_BLOCK_SIZE * 16; i++) {
+        mu_check(storage_seek_write(file, buffer));
+    }
+    mu_check(storage_seek_check(file, STORAGE_SEEK_FILE_SIZE / 4));
+    mu_check(storage_seek_check(file, STORAGE_SEEK_FILE_SIZE + 8));
+
+    // And shrinks back
+    mu_check(storage_file_seek(file, STORAGE_SEEK_FILE_SIZE, true));
+    mu_check(storage_file_truncate(file));
+    mu_assert_int_eq(STORAGE_SEEK_FILE_SIZE, storage_file_size(file));
+    mu_check(storage_seek_check(file, STORAGE_SEEK_FILE_SIZE - 4));
+
+    storage_file_close(file);
+    free(buffer);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_file_preallocate_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint32_t* buffer = malloc(STORAGE_SEEK_BLOCK_SIZE);
+
+    mu_check(storage_file_open(file, STORAGE_SEEK_GAP_FILE, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(storage_file_preallocate(file, STORAGE_SEEK_FILE_SIZE / 4));
+    mu_assert_int_eq(0, storage_file_size(file));
+    // Only empty file can be prepared
+    storage_seek_fill(buffer, 0);
+    mu_check(storage_seek_write(file, buffer));
+    mu_check(!storage_file_preallocate(file, STORAGE_SEEK_FILE_SIZE / 4));
+    mu_check(storage_seek_check(file, 4));
+    storage_file_close(file);
+
+    // Internal storage has nothing to prepare
+    mu_check(
+        storage_file_open(file, INT_PATH("preallocate.test"), FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_check(!storage_file_preallocate(file, STORAGE_SEEK_BLOCK_SIZE));
+    mu_assert_int_eq(FSE_NOT_IMPLEMENTED, storage_file_get_error(file));
+    storage_file_close(file);
+    storage_simply_remove(storage, INT_PATH("preallocate.test"));
+
+    free(buffer);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST_SUITE(storage_seek) {
+    storage_seek_setup();
+    MU_RUN_TEST(storage_file_seek_latency);
+    MU_RUN_TEST(storage_file_seek_append);
+    MU_RUN_TEST(storage_file_preallocate_test);
+    storage_seek_teardown();
+}
+
+#define STORAGE_BORROW_FILE INT_PATH("borrow.test")
+#define STORAGE_BORROW_INLINE_FILE INT_PATH("borrow_inline.test")
+#define STORAGE_BORROW_FILE_SIZE (2 * 4096 + 100)
+#define STORAGE_SETTINGS_FILE INT_PATH(".settings.test")
+#define STORAGE_SETTINGS_SIZE 1024
+#define STORAGE_SETTINGS_MAGIC 0x5E
+#define STORAGE_SETTINGS_COUNT 16
+#define STORAGE_BACKUP_FILE UNIT_TESTS_PATH("backup.tar")
+#define STORAGE_BORROW_EXT_FILE UNIT_TESTS_PATH("borrow.test")
+
+static uint32_t storage_time_us(uint32_t start) {
+    return (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+}
+
+static void storage_borrow_setup() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t* buffer = malloc(STORAGE_BORROW_FILE_SIZE);
+
+    for(size_t i = 0; i < STORAGE_BORROW_FILE_SIZE; i++) {
+        buffer[i] = i * 7 + (i >> 8);
+    }
+    mu_check(storage_file_open(file, STORAGE_BORROW_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS));
+    mu_assert_int_eq(
+        STORAGE_BORROW_FILE_SIZE, storage_file_write(file, buffer, STORAGE_BORROW_FILE_SIZE));
+    storage_file_close(file);
+
+    storage_simply_remove(storage, STORAGE_BORROW_INLINE_FILE);
+    storage_simply_remove(storage, STORAGE_BORROW_EXT_FILE);
+    mu_check(storage_file_create(storage, STORAGE_BORROW_INLINE_FILE, "tiny"));
+    mu_check(storage_file_create(storage, STORAGE_BORROW_EXT_FILE, "not mapped"));
+
+    free(buffer);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void storage_borrow_teardown() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_remove(storage, STORAGE_BORROW_FILE);
+    storage_simply_remove(storage, STORAGE_BORROW_INLINE_FILE);
+    storage_simply_remove(storage, STORAGE_BORROW_EXT_FILE);
+    storage_simply_remove(storage, STORAGE_SETTINGS_FILE);
+    storage_simply_remove(storage, STORAGE_BACKUP_FILE);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_file_borrow_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    File* file = storage_file_alloc(storage);
+    uint8_t* expected = malloc(STORAGE_BORROW_FILE_SIZE);
+
+    mu_check(storage_file_open(file, STORAGE_BORROW_FILE, FSAM_READ, FSOM_OPEN_EXISTING));
+    mu_assert_int_eq(
+        STORAGE_BORROW_FILE_SIZE, storage_file_read(file, expected, STORAGE_BORROW_FILE_SIZE));
+
+    // Borrowed pieces end at flash page boundaries and cover the whole file
+    mu_check(storage_file_seek(file, 10, true));
+    size_t position = 10;
+    while(position < STORAGE_BORROW_FILE_SIZE) {
+        size_t size = STORAGE_BORROW_FILE_SIZE;
+        const uint8_t* data = storage_file_borrow(file, &size);
+        mu_check(data != NULL);
+        if(data == NULL) break;
+        mu_check(size > 0 && size <= furi_hal_flash_get_page_size());
+        mu_check(memcmp(data, &expected[position], size) == 0);
+        position += size;
+        mu_assert_int_eq(position, storage_file_tell(file));
+    }
+
+    size_t size = 16;
+    mu_check(storage_file_borrow(file, &size) == NULL);
+    mu_assert_int_eq(0, size);
+    storage_file_close(file);
+
+    // Inline files have no pages of their own
+    mu_check(storage_file_open(file, STORAGE_BORROW_INLINE_FILE, FSAM_READ, FSOM_OPEN_EXISTING));
+    size = 4;
+    mu_check(storage_file_borrow(file, &size) == NULL);
+    mu_assert_int_eq(FSE_NOT_IMPLEMENTED, storage_file_get_error(file));
+    mu_assert_int_eq(0, storage_file_tell(file));
+    storage_file_close(file);
+
+    // SD card is not memory mapped
+    mu_check(storage_file_open(file, STORAGE_BORROW_EXT_FILE, FSAM_READ, FSOM_OPEN_EXISTING));
+    size = 4;
+    mu_check(storage_file_borrow(file, &size) == NULL);
+    mu_assert_int_eq(FSE_NOT_IMPLEMENTED, storage_file_get_error(file));
+    storage_file_close(file);
+
+    free(expected);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_settings_benchmark) {
+    uint8_t* settings = malloc(STORAGE_SETTINGS_SIZE);
+    uint8_t* loaded = malloc(STORAGE_SETTINGS_SIZE);
+    for(size_t i = 0; i < STORAGE_SETTINGS_SIZE; i++) {
+        settings[i] = i * 13;
+    }
+
+    uint32_t save_time = 0;
+    uint32_t load_time = 0;
+    for(size_t i = 0; i < STORAGE_SETTINGS_COUNT; i++) {
+        settings[0] = i;
+        uint32_t start = DWT->CYCCNT;
+        mu_check(saved_struct_save(
+            STORAGE_SETTINGS_FILE, settings, STORAGE_SETTINGS_SIZE, STORAGE_SETTINGS_MAGIC, 1));
+        save_time += storage_time_us(start);
+
+        start = DWT->CYCCNT;
+        mu_check(saved_struct_load(
+            STORAGE_SETTINGS_FILE, loaded, STORAGE_SETTINGS_SIZE, STORAGE_SETTINGS_MAGIC, 1));
+        load_time += storage_time_us(start);
+        mu_check(memcmp(settings, loaded, STORAGE_SETTINGS_SIZE) == 0);
+    }
+
+    FURI_LOG_I(
+        TAG,
+        "Settings %d bytes: save %lu us, load %lu us",
+        STORAGE_SETTINGS_SIZE,
+        save_time / STORAGE_SETTINGS_COUNT,
+        load_time / STORAGE_SETTINGS_COUNT);
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    uint32_t start = DWT->CYCCNT;
+    mu_check(lfs_backup_create(storage, STORAGE_BACKUP_FILE));
+    uint32_t backup_time = storage_time_us(start);
+    FileInfo info;
+    mu_assert_int_eq(FSE_OK, storage_common_stat(storage, STORAGE_BACKUP_FILE, &info));
+    FURI_LOG_I(
+        TAG,
+        "Backup %lu bytes: %lu ms, %lu KiB/s",
+        (uint32_t)info.size,
+        backup_time / 1000,
+        (uint32_t)(info.size * 1000 / 1024 / MAX(backup_time / 1000, 1UL)));
+    furi_record_close(RECORD_STORAGE);
+
+    free(loaded);
+    free(settings);
+}
+
+MU_TEST_SUITE(storage_borrow) {
+    storage_borrow_setup();
+    MU_RUN_TEST(storage_file_borrow_test);
+    MU_RUN_TEST(storage_settings_benchmark);
+    storage_borrow_teardown();
+}
+
+#define STORAGE_COPY_DIR UNIT_TESTS_PATH("copy")
+#define STORAGE_COPY_SOURCE UNIT_TESTS_PATH("copy/source.test")
+#define STORAGE_COPY_DESTINATION UNIT_TESTS_PATH("copy/destination.test")
+#define STORAGE_COPY_STREAM_DESTINATION UNIT_TESTS_PATH("copy/stream.test")
+#define STORAGE_COPY_SIZE (256 * 1024 + 100)
+#define STORAGE_COPY_SMALL_DIR UNIT_TESTS_PATH("copy/small")
+#define STORAGE_COPY_SMALL_DESTINATION UNIT_TESTS_PATH("copy/small_copy")
+#define STORAGE_COPY_SMALL_COUNT 32
+#define STORAGE_COPY_SMALL_SIZE 1000
+#define STORAGE_COPY_CHUNK 4096
+
+typedef struct {
+    uint32_t calls;
+    uint32_t cancel_at; /**< call to return false at, 0 to never cancel */
+    StorageCopyProgress last;
+} StorageCopyTest;
+
+static bool storage_copy_test_callback(const StorageCopyProgress* progress, void* context) {
+    StorageCopyTest* test = context;
+    test->calls++;
+    test->last = *progress;
+    return test->calls != test->cancel_at;
+}
+
+static bool storage_copy_test_write(Storage* storage, const char* path, size_t size) {
+    File* file = storage_file_alloc(storage);
+    uint8_t* buffer = malloc(STORAGE_COPY_CHUNK);
+    bool result = storage_file_open(file, path, FSAM_WRITE, FSOM_CREATE_ALWAYS);
+
+    for(size_t offset = 0; result && offset < size; offset += STORAGE_COPY_CHUNK) {
+        size_t chunk = MIN(size - offset, (size_t)STORAGE_COPY_CHUNK);
+        for(size_t i = 0; i < chunk; i++) {
+            buffer[i] = (offset + i) * 7 + ((offset + i) >> 8);
+        }
+        result = storage_file_write(file, buffer, chunk) == chunk;
+    }
+
+    storage_file_close(file);
+    free(buffer);
+    storage_file_free(file);
+    return result;
+}
+
+static bool storage_copy_test_check(Storage* storage, const char* path, size_t size) {
+    File* file = storage_file_alloc(storage);
+    uint8_t* buffer = malloc(STORAGE_COPY_CHUNK);
+    bool result = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                  storage_file_size(file) == size;
+
+    for(size_t offset = 0; result && offset < size; offset += STORAGE_COPY_CHUNK) {
+        size_t chunk = MIN(size - offset, (size_t)STORAGE_COPY_CHUNK);
+        result = storage_file_read(file, buffer, chunk) == chunk;
+        for(size_t i = 0; result && i < chunk; i++) {
+            result = buffer[i] == (uint8_t)((offset + i) * 7 + ((offset + i) >> 8));
+        }
+    }
+
+    storage_file_close(file);
+    free(buffer);
+    storage_file_free(file);
+    return result;
+}
+
+static void storage_copy_setup() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FuriString* path = furi_string_alloc();
+
+    storage_simply_remove_recursive(storage, STORAGE_COPY_DIR);
+    mu_check(storage_simply_mkdir(storage, STORAGE_COPY_DIR));
+    mu_check(storage_copy_test_write(storage, STORAGE_COPY_SOURCE, STORAGE_COPY_SIZE));
+
+    mu_check(storage_simply_mkdir(storage, STORAGE_COPY_SMALL_DIR));
+    for(uint32_t i = 0; i < STORAGE_COPY_SMALL_COUNT; i++) {
+        furi_string_printf(path, "%s/%lu.test", STORAGE_COPY_SMALL_DIR, i);
+        mu_check(storage_copy_test_write(
+            storage, furi_string_get_cstr(path), STORAGE_COPY_SMALL_SIZE));
+    }
+
+    furi_string_free(path);
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void storage_copy_teardown() {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_remove_recursive(storage, STORAGE_COPY_DIR);
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_copy_progress_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageCopyTest test = {0};
+
+    storage_simply_remove(storage, STORAGE_COPY_DESTINATION);
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_copy_ex(
+            storage,
+            STORAGE_COPY_SOURCE,
+            STORAGE_COPY_DESTINATION,
+            storage_copy_test_callback,
+            &test));
+    mu_check(storage_copy_test_check(storage, STORAGE_COPY_DESTINATION, STORAGE_COPY_SIZE));
+
+    // Called after every chunk, the file is counted once it is closed
+    mu_check(test.calls > 1);
+    mu_assert_int_eq(STORAGE_COPY_SIZE, test.last.file_size);
+    mu_assert_int_eq(STORAGE_COPY_SIZE, test.last.file_copied);
+    mu_assert_int_eq(STORAGE_COPY_SIZE, test.last.total_copied);
+    mu_assert_int_eq(0, test.last.files);
+
+    // Existing destination is not touched
+    mu_assert_int_eq(
+        FSE_EXIST,
+        storage_common_copy(storage, STORAGE_COPY_SMALL_DIR "/0.test", STORAGE_COPY_DESTINATION));
+    mu_check(storage_copy_test_check(storage, STORAGE_COPY_DESTINATION, STORAGE_COPY_SIZE));
+
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST(storage_copy_cancel_test) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageCopyTest test = {.cancel_at = 1};
+
+    storage_simply_remove(storage, STORAGE_COPY_DESTINATION);
+    mu_assert_int_eq(
+        FSE_CANCELLED,
+        storage_common_copy_ex(
+            storage,
+            STORAGE_COPY_SOURCE,
+            STORAGE_COPY_DESTINATION,
+            storage_copy_test_callback,
+            &test));
+    mu_assert_int_eq(1, test.calls);
+    mu_assert_int_eq(FSE_NOT_EXIST, storage_common_stat(storage, STORAGE_COPY_DESTINATION, NULL));
+
+    // Directory copy stops on the cancelled file, files copied before it are kept
+    test.calls = 0;
+    test.cancel_at = 3;
+    mu_assert_int_eq(
+        FSE_CANCELLED,
+        storage_common_copy_ex(
+            storage,
+            STORAGE_COPY_SMALL_DIR,
+            STORAGE_COPY_SMALL_DESTINATION,
+            storage_copy_test_callback,
+            &test));
+    mu_assert_int_eq(3, test.calls);
+    mu_assert_int_eq(2, test.last.files);
+    mu_assert_int_eq(
+        FSE_NOT_EXIST,
+        storage_common_stat(storage, STORAGE_COPY_SMALL_DESTINATION "/2.test", NULL));
+    storage_simply_remove_recursive(storage, STORAGE_COPY_SMALL_DESTINATION);
+
+    furi_record_close(RECORD_STORAGE);
+}
+
+static bool storage_copy_stream(Storage* storage, const char* old_path, const char* new_path) {
+    Stream* source = file_stream_alloc(storage);
+    Stream* destination = file_stream_alloc(storage);
+    bool result = file_stream_open(source, old_path, FSAM_READ, FSOM_OPEN_EXISTING) &&
+                  file_stream_open(destination, new_path, FSAM_WRITE, FSOM_CREATE_NEW) &&
+                  stream_copy_full(source, destination) > 0;
+    stream_free(destination);
+    stream_free(source);
+    return result;
+}
+
+MU_TEST(storage_copy_benchmark) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    StorageCopyTest test = {0};
+
+    // Stream copy is what storage_common_copy used to do
+    storage_simply_remove(storage, STORAGE_COPY_STREAM_DESTINATION);
+    uint32_t start = DWT->CYCCNT;
+    mu_check(storage_copy_stream(storage, STORAGE_COPY_SOURCE, STORAGE_COPY_STREAM_DESTINATION));
+    uint32_t stream_time = storage_time_us(start);
+
+    storage_simply_remove(storage, STORAGE_COPY_DESTINATION);
+    start = DWT->CYCCNT;
+    mu_assert_int_eq(
+        FSE_OK, storage_common_copy(storage, STORAGE_COPY_SOURCE, STORAGE_COPY_DESTINATION));
+    uint32_t copy_time = storage_time_us(start);
+    mu_check(storage_copy_test_check(storage, STORAGE_COPY_DESTINATION, STORAGE_COPY_SIZE));
+
+    FURI_LOG_I(
+        TAG,
+        "Copy %d bytes: stream %lu KiB/s, engine %lu KiB/s",
+        STORAGE_COPY_SIZE,
+        (uint32_t)(STORAGE_COPY_SIZE * 1000ULL / 1024 / MAX(stream_time / 1000, 1UL)),
+        (uint32_t)(STORAGE_COPY_SIZE * 1000ULL / 1024 / MAX(copy_time / 1000, 1UL)));
+
+    storage_simply_remove_recursive(storage, STORAGE_COPY_SMALL_DESTINATION);
+    start = DWT->CYCCNT;
+    mu_assert_int_eq(
+        FSE_OK,
+        storage_common_copy_ex(
+            storage,
+            STORAGE_COPY_SMALL_DIR,
+            STORAGE_COPY_SMALL_DESTINATION,
+            storage_copy_test_callback,
+            &test));
+    copy_time = storage_time_us(start);
+    mu_assert_int_eq(STORAGE_COPY_SMALL_COUNT, test.calls);
+    mu_assert_int_eq(STORAGE_COPY_SMALL_COUNT - 1, test.last.files);
+    mu_assert_int_eq(STORAGE_COPY_SMALL_COUNT * STORAGE_COPY_SMALL_SIZE, test.last.total_copied);
+    mu_check(storage_copy_test_check(
+        storage, STORAGE_COPY_SMALL_DESTINATION "/0.test", STORAGE_COPY_SMALL_SIZE));
+
+    FURI_LOG_I(
+        TAG,
+        "Copy %d files of %d bytes: %lu ms, %lu files/s",
+        STORAGE_COPY_SMALL_COUNT,
+        STORAGE_COPY_SMALL_SIZE,
+        copy_time / 1000,
+        STORAGE_COPY_SMALL_COUNT * 1000 / MAX(copy_time / 1000, 1UL));
+
+    furi_record_close(RECORD_STORAGE);
+}
+
+MU_TEST_SUITE(storage_copy) {
+    storage_copy_setup();
+    MU_RUN_TEST(storage_copy_progress_test);
+    MU_RUN_TEST(storage_copy_cancel_test);
+    MU_RUN_TEST(storage_copy_benchmark);
+    storage_copy_teardown();
+}
+
 #define APPSDATA_APP_PATH(path) APPS_DATA_PATH "/" path
 
 static const char* storage_test_apps[] = {
@@ -595,6 +1316,9 @@ int run_minunit_test_storage() {
     MU_RUN_SUITE(storage_file);
     MU_RUN_SUITE(storage_dir);
     MU_RUN_SUITE(storage_rename);
+    MU_RUN_SUITE(storage_seek);
+    MU_RUN_SUITE(storage_borrow);
+    MU_RUN_SUITE(storage_copy);
     MU_RUN_SUITE(test_data_path);
     MU_RUN_SUITE(test_storage_common);
     return MU_EXIT_CODE;
@@ -5,8 +5,10 @@
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_keystore.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_raw_binary.h>
 #include <lib/subghz/protocols/protocol_items.h>
 #include <flipper_format/flipper_format_i.h>
+#include <toolbox/stream/string_stream.h>
 
 #define TAG "SubGhz TEST"
 #define KEYSTORE_DIR_NAME EXT_PATH("subghz/assets/keeloq_mfcodes")
@@ -358,6 +360,63 @@ MU_TEST(subghz_hal_async_tx_test) {
         "Test furi_hal_async_tx reset end");
 }
 
+#define SUBGHZ_RAW_BINARY_TEST_BLOCKS 1500
+
+static const char* subghz_raw_binary_test_text = "Filetype: Flipper SubGhz RAW File\n"
+                                                 "Version: 1\n"
+                                                 "Frequency: 433920000\n"
+                                                 "Preset: FuriHalSubGhzPresetOok650Async\n"
+                                                 "Protocol: RAW\n"
+                                                 "RAW_Data: 100 -200 300 -65535 1\n"
+                                                 "RAW_Data: -2 32700 -32700\n";
+
+MU_TEST(subghz_raw_binary_test) {
+    Stream* text = string_stream_alloc();
+    Stream* binary = string_stream_alloc();
+    Stream* result = string_stream_alloc();
+    int32_t* durations = malloc(SUBGHZ_RAW_BINARY_BLOCK_SIZE * sizeof(int32_t));
+
+    // text -> compressed binary -> text keeps file intact
+    stream_write_cstring(text, subghz_raw_binary_test_text);
+    stream_rewind(text);
+    mu_check(subghz_raw_binary_convert(text, binary, true, true));
+    stream_rewind(binary);
+    mu_check(subghz_raw_binary_convert(binary, result, false, false));
+    mu_assert_int_eq(strlen(subghz_raw_binary_test_text), stream_size(result));
+
+    stream_rewind(result);
+    stream_read(result, (uint8_t*)durations, stream_size(result));
+    mu_assert_mem_eq(subghz_raw_binary_test_text, durations, stream_size(result));
+
+    // index stays bounded and seek lands on requested block
+    stream_clean(binary);
+    SubGhzRawBinaryWriter* writer = subghz_raw_binary_writer_alloc(binary, false);
+    for(int32_t i = 0; i < SUBGHZ_RAW_BINARY_TEST_BLOCKS; i++) {
+        int32_t block[2] = {i + 1, -(i + 1)};
+        mu_check(subghz_raw_binary_writer_write(writer, block, COUNT_OF(block)));
+    }
+    mu_check(subghz_raw_binary_writer_finish(writer));
+    subghz_raw_binary_writer_free(writer);
+
+    stream_rewind(binary);
+    SubGhzRawBinaryReader* reader = subghz_raw_binary_reader_alloc(binary);
+    const size_t blocks[] = {0, 1, 777, SUBGHZ_RAW_BINARY_TEST_BLOCKS - 1};
+    for(size_t i = 0; i < COUNT_OF(blocks); i++) {
+        mu_check(subghz_raw_binary_reader_seek(reader, blocks[i]));
+        mu_assert_int_eq(2, subghz_raw_binary_reader_read(reader, durations));
+        mu_assert_int_eq(blocks[i] + 1, durations[0]);
+        mu_assert_int_eq(-(int32_t)(blocks[i] + 1), durations[1]);
+    }
+    mu_assert_int_eq(0, subghz_raw_binary_reader_read(reader, durations));
+    mu_check(!subghz_raw_binary_reader_seek(reader, SUBGHZ_RAW_BINARY_TEST_BLOCKS));
+    subghz_raw_binary_reader_free(reader);
+
+    free(durations);
+    stream_free(result);
+    stream_free(binary);
+    stream_free(text);
+}
+
 //test decoders
 MU_TEST(subghz_decoder_came_atomo_test) {
     mu_assert(
@@ -805,6 +864,7 @@ MU_TEST_SUITE(subghz) {
     MU_RUN_TEST(subghz_keystore_test);
 
     MU_RUN_TEST(subghz_hal_async_tx_test);
+    MU_RUN_TEST(subghz_raw_binary_test);
 
     MU_RUN_TEST(subghz_decoder_came_atomo_test);
     MU_RUN_TEST(subghz_decoder_came_test);
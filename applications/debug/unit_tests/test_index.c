@@ -27,6 +27,7 @@ int run_minunit_test_nfc();
 int run_minunit_test_bit_lib();
 int run_minunit_test_float_tools();
 int run_minunit_test_bt();
+int run_minunit_test_decoders();
 
 typedef int (*UnitTestEntry)();
 
@@ -55,6 +56,7 @@ const UnitTest unit_tests[] = {
     {.name = "bit_lib", .entry = run_minunit_test_bit_lib},
     {.name = "float_tools", .entry = run_minunit_test_float_tools},
     {.name = "bt", .entry = run_minunit_test_bt},
+    {.name = "decoders", .entry = run_minunit_test_decoders},
 };
 
 void minunit_print_progress() {
@@ -14,7 +14,7 @@
 #define DAP_CONFIG_DEFAULT_CLOCK 4200000 // Hz
 
 #define DAP_CONFIG_PACKET_SIZE 64
-#define DAP_CONFIG_PACKET_COUNT 1
+#define DAP_CONFIG_PACKET_COUNT 4
 
 #define DAP_CONFIG_JTAG_DEV_COUNT 8
 
@@ -65,11 +65,53 @@ typedef enum {
     DAPThreadEventUSBConnect = (1 << 3),
     DAPThreadEventUSBDisconnect = (1 << 4),
     DAPThreadEventApplyConfig = (1 << 5),
+    DAPThreadEventTxV1 = (1 << 6),
+    DAPThreadEventTxV2 = (1 << 7),
     DAPThreadEventAll = DAPThreadEventStop | DAPThreadEventRxV1 | DAPThreadEventRxV2 |
                         DAPThreadEventUSBConnect | DAPThreadEventUSBDisconnect |
-                        DAPThreadEventApplyConfig,
+                        DAPThreadEventApplyConfig | DAPThreadEventTxV1 | DAPThreadEventTxV2,
 } DAPThreadEvent;
 
+typedef struct {
+    size_t (*rx)(uint8_t* buffer, size_t size);
+    int32_t (*tx)(uint8_t* buffer, uint8_t size);
+    bool (*tx_is_ready)();
+    bool tx_full_packet;
+} DapTransport;
+
+static const DapTransport dap_transport_v1 = {
+    .rx = dap_v1_usb_rx,
+    .tx = dap_v1_usb_tx,
+    .tx_is_ready = dap_v1_usb_tx_is_ready,
+    // HID reports are always of full size
+    .tx_full_packet = true,
+};
+
+static const DapTransport dap_transport_v2 = {
+    .rx = dap_v2_usb_rx,
+    .tx = dap_v2_usb_tx,
+    .tx_is_ready = dap_v2_usb_tx_is_ready,
+    .tx_full_packet = false,
+};
+
+/* Requests are taken out of the OUT endpoint as soon as they arrive, so the host can send
+ * the next one while the current one is executed, and responses are queued to the IN
+ * endpoint without waiting for the previous transfer to complete.
+ * Counters are free running, slot is counter % DAP_CONFIG_PACKET_COUNT. */
+typedef struct {
+    const DapTransport* transport;
+    DapPacket request[DAP_CONFIG_PACKET_COUNT];
+    DapPacket response[DAP_CONFIG_PACKET_COUNT];
+    uint8_t received;
+    uint8_t executed;
+    uint8_t sent;
+    bool rx_pending;
+} DapPacketPool;
+
+_Static_assert(
+    (DAP_CONFIG_PACKET_COUNT & (DAP_CONFIG_PACKET_COUNT - 1)) == 0,
+    "DAP_CONFIG_PACKET_COUNT must be power of 2");
+
 #define USB_SERIAL_NUMBER_LEN 16
 char usb_serial_number[USB_SERIAL_NUMBER_LEN] = {0};
 
@@ -90,6 +132,18 @@ static void dap_app_rx2_callback(void* context) {
     furi_thread_flags_set(thread_id, DAPThreadEventRxV2);
 }
 
+static void dap_app_tx1_callback(void* context) {
+    furi_assert(context);
+    FuriThreadId thread_id = (FuriThreadId)context;
+    furi_thread_flags_set(thread_id, DAPThreadEventTxV1);
+}
+
+static void dap_app_tx2_callback(void* context) {
+    furi_assert(context);
+    FuriThreadId thread_id = (FuriThreadId)context;
+    furi_thread_flags_set(thread_id, DAPThreadEventTxV2);
+}
+
 static void dap_app_usb_state_callback(bool state, void* context) {
     furi_assert(context);
     FuriThreadId thread_id = (FuriThreadId)context;
@@ -100,23 +154,57 @@ static void dap_app_usb_state_callback(bool state, void* context) {
     }
 }
 
-static void dap_app_process_v1() {
-    DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
-    rx_packet.size = dap_v1_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_process_request(rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v1_usb_tx(tx_packet.data, DAP_CONFIG_PACKET_SIZE);
+static void dap_packet_pool_reset(DapPacketPool* pool) {
+    pool->received = 0;
+    pool->executed = 0;
+    pool->sent = 0;
+    pool->rx_pending = false;
 }
 
-static void dap_app_process_v2() {
-    DapPacket tx_packet;
-    DapPacket rx_packet;
-    memset(&tx_packet, 0, sizeof(DapPacket));
-    rx_packet.size = dap_v2_usb_rx(rx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    size_t len = dap_process_request(
-        rx_packet.data, rx_packet.size, tx_packet.data, DAP_CONFIG_PACKET_SIZE);
-    dap_v2_usb_tx(tx_packet.data, len);
+static uint32_t dap_packet_pool_process(DapPacketPool* pool) {
+    const DapTransport* transport = pool->transport;
+    uint32_t executed = 0;
+    bool progress;
+
+    do {
+        progress = false;
+
+        // Free the OUT endpoint first, host may already have the next packet
+        if(pool->rx_pending &&
+           (uint8_t)(pool->received - pool->sent) < DAP_CONFIG_PACKET_COUNT) {
+            DapPacket* request = &pool->request[pool->received % DAP_CONFIG_PACKET_COUNT];
+            pool->rx_pending = false;
+            request->size = transport->rx(request->data, DAP_CONFIG_PACKET_SIZE);
+            if(request->size > 0) {
+                pool->received++;
+            }
+            progress = true;
+        }
+
+        // Start transfer before executing next request, it runs in background
+        if(pool->sent != pool->executed && transport->tx_is_ready()) {
+            DapPacket* response = &pool->response[pool->sent % DAP_CONFIG_PACKET_COUNT];
+            transport->tx(
+                response->data,
+                transport->tx_full_packet ? DAP_CONFIG_PACKET_SIZE : response->size);
+            pool->sent++;
+            progress = true;
+        }
+
+        if(pool->executed != pool->received) {
+            size_t slot = pool->executed % DAP_CONFIG_PACKET_COUNT;
+            DapPacket* request = &pool->request[slot];
+            DapPacket* response = &pool->response[slot];
+            memset(response->data, 0, DAP_CONFIG_PACKET_SIZE);
+            response->size = dap_process_request(
+                request->data, request->size, response->data, DAP_CONFIG_PACKET_SIZE);
+            pool->executed++;
+            executed++;
+            progress = true;
+        }
+    } while(progress);
+
+    return executed;
 }
 
 void dap_app_vendor_cmd(uint8_t cmd) {
@@ -188,6 +276,11 @@ static int32_t dap_process(void* p) {
     // init dap
     dap_init();
 
+    DapPacketPool* pool_v1 = malloc(sizeof(DapPacketPool));
+    DapPacketPool* pool_v2 = malloc(sizeof(DapPacketPool));
+    pool_v1->transport = &dap_transport_v1;
+    pool_v2->transport = &dap_transport_v2;
+
     // get name
     const char* name = furi_hal_version_get_name_ptr();
     if(!name) {
@@ -201,6 +294,8 @@ static int32_t dap_process(void* p) {
     dap_common_usb_set_context(furi_thread_get_id(furi_thread_get_current()));
     dap_v1_usb_set_rx_callback(dap_app_rx1_callback);
     dap_v2_usb_set_rx_callback(dap_app_rx2_callback);
+    dap_v1_usb_set_tx_callback(dap_app_tx1_callback);
+    dap_v2_usb_set_tx_callback(dap_app_tx2_callback);
     dap_common_usb_set_state_callback(dap_app_usb_state_callback);
     furi_hal_usb_set_config(&dap_v2_usb_hid, NULL);
 
@@ -211,17 +306,23 @@ static int32_t dap_process(void* p) {
 
         if(!(events & FuriFlagError)) {
             if(events & DAPThreadEventRxV1) {
-                dap_app_process_v1();
-                dap_state->dap_counter++;
+                pool_v1->rx_pending = true;
                 dap_state->dap_version = DapVersionV1;
             }
 
             if(events & DAPThreadEventRxV2) {
-                dap_app_process_v2();
-                dap_state->dap_counter++;
+                pool_v2->rx_pending = true;
                 dap_state->dap_version = DapVersionV2;
             }
 
+            if(events & (DAPThreadEventRxV1 | DAPThreadEventTxV1)) {
+                dap_state->dap_counter += dap_packet_pool_process(pool_v1);
+            }
+
+            if(events & (DAPThreadEventRxV2 | DAPThreadEventTxV2)) {
+                dap_state->dap_counter += dap_packet_pool_process(pool_v2);
+            }
+
             if(events & DAPThreadEventUSBConnect) {
                 dap_state->usb_connected = true;
             }
@@ -229,6 +330,8 @@ static int32_t dap_process(void* p) {
             if(events & DAPThreadEventUSBDisconnect) {
                 dap_state->usb_connected = false;
                 dap_state->dap_version = DapVersionUnknown;
+                dap_packet_pool_reset(pool_v1);
+                dap_packet_pool_reset(pool_v2);
             }
 
             if(events & DAPThreadEventApplyConfig) {
@@ -249,6 +352,8 @@ static int32_t dap_process(void* p) {
     furi_hal_usb_set_config(usb_config_prev, NULL);
     dap_common_usb_free_name();
     dap_deinit_gpio(swd_pins_prev);
+    free(pool_v1);
+    free(pool_v2);
     return 0;
 }
 
@@ -268,6 +373,7 @@ typedef enum {
 
 typedef struct {
     FuriStreamBuffer* rx_stream;
+    volatile bool rx_notified;
     FuriThreadId thread_id;
     FuriHalUartId uart_id;
     struct usb_cdc_line_coding line_coding;
@@ -278,7 +384,11 @@ static void cdc_uart_irq_cb(UartIrqEvent ev, uint8_t data, void* ctx) {
 
     if(ev == UartIrqEventRXNE) {
         furi_stream_buffer_send(app->rx_stream, &data, 1, 0);
-        furi_thread_flags_set(app->thread_id, CDCThreadEventUARTRx);
+        // Wake thread once per burst, it drains everything received till then
+        if(!app->rx_notified) {
+            app->rx_notified = true;
+            furi_thread_flags_set(app->thread_id, CDCThreadEventUARTRx);
+        }
     }
 }
 
@@ -390,13 +500,16 @@ static int32_t cdc_process(void* p) {
             }
 
             if(events & CDCThreadEventUARTRx) {
-                size_t len =
-                    furi_stream_buffer_receive(app->rx_stream, rx_buffer, rx_buffer_size, 0);
-
-                if(len > 0) {
-                    dap_cdc_usb_tx(rx_buffer, len);
-                }
-                dap_state->cdc_rx_counter += len;
+                // Rearm notification before draining, so no byte is left behind
+                app->rx_notified = false;
+                size_t len;
+                do {
+                    len = furi_stream_buffer_receive(app->rx_stream, rx_buffer, rx_buffer_size, 0);
+                    if(len > 0) {
+                        dap_cdc_usb_tx(rx_buffer, len);
+                    }
+                    dap_state->cdc_rx_counter += len;
+                } while(len == rx_buffer_size);
             }
 
             if(events & CDCThreadEventCDCRx) {
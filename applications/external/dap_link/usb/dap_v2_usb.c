@@ -449,6 +449,8 @@ typedef struct {
     DapRxCallback rx_callback_v1;
     DapRxCallback rx_callback_v2;
     DapRxCallback rx_callback_cdc;
+    DapTxCallback tx_callback_v1;
+    DapTxCallback tx_callback_v2;
     DapCDCControlLineCallback control_line_callback_cdc;
     DapCDCConfigCallback config_callback_cdc;
     void* context;
@@ -465,6 +467,8 @@ static DAPState dap_state = {
     .rx_callback_v1 = NULL,
     .rx_callback_v2 = NULL,
     .rx_callback_cdc = NULL,
+    .tx_callback_v1 = NULL,
+    .tx_callback_v2 = NULL,
     .control_line_callback_cdc = NULL,
     .config_callback_cdc = NULL,
     .context = NULL,
@@ -541,6 +545,28 @@ void dap_v2_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_v2 = callback;
 }
 
+void dap_v1_usb_set_tx_callback(DapTxCallback callback) {
+    dap_state.tx_callback_v1 = callback;
+}
+
+void dap_v2_usb_set_tx_callback(DapTxCallback callback) {
+    dap_state.tx_callback_v2 = callback;
+}
+
+static bool dap_usb_tx_is_ready(FuriSemaphore* semaphore) {
+    // Nothing will be sent while disconnected, tx returns immediately
+    if((semaphore == NULL) || (dap_state.connected == false)) return true;
+    return furi_semaphore_get_count(semaphore) > 0;
+}
+
+bool dap_v1_usb_tx_is_ready() {
+    return dap_usb_tx_is_ready(dap_state.semaphore_v1);
+}
+
+bool dap_v2_usb_tx_is_ready() {
+    return dap_usb_tx_is_ready(dap_state.semaphore_v2);
+}
+
 void dap_cdc_usb_set_rx_callback(DapRxCallback callback) {
     dap_state.rx_callback_cdc = callback;
 }
@@ -696,6 +722,9 @@ static void hid_txrx_ep_callback(usbd_device* dev, uint8_t event, uint8_t ep) {
     case usbd_evt_eptx:
         furi_semaphore_release(dap_state.semaphore_v1);
         furi_console_log_printf("hid tx complete");
+        if(dap_state.tx_callback_v1 != NULL) {
+            dap_state.tx_callback_v1(dap_state.context);
+        }
         break;
     case usbd_evt_eprx:
         if(dap_state.rx_callback_v1 != NULL) {
@@ -716,6 +745,9 @@ static void hid_txrx_ep_bulk_callback(usbd_device* dev, uint8_t event, uint8_t e
     case usbd_evt_eptx:
         furi_semaphore_release(dap_state.semaphore_v2);
         furi_console_log_printf("bulk tx complete");
+        if(dap_state.tx_callback_v2 != NULL) {
+            dap_state.tx_callback_v2(dap_state.context);
+        }
         break;
     case usbd_evt_eprx:
         if(dap_state.rx_callback_v2 != NULL) {
@@ -7,6 +7,9 @@ extern FuriHalUsbInterface dap_v2_usb_hid;
 // receive callback type
 typedef void (*DapRxCallback)(void* context);
 
+// transmit complete callback type
+typedef void (*DapTxCallback)(void* context);
+
 typedef void (*DapStateCallback)(bool state, void* context);
 
 /************************************ V1 ***************************************/
@@ -17,6 +20,10 @@ size_t dap_v1_usb_rx(uint8_t* buffer, size_t size);
 
 void dap_v1_usb_set_rx_callback(DapRxCallback callback);
 
+void dap_v1_usb_set_tx_callback(DapTxCallback callback);
+
+bool dap_v1_usb_tx_is_ready();
+
 /************************************ V2 ***************************************/
 
 int32_t dap_v2_usb_tx(uint8_t* buffer, uint8_t size);
@@ -25,6 +32,10 @@ size_t dap_v2_usb_rx(uint8_t* buffer, size_t size);
 
 void dap_v2_usb_set_rx_callback(DapRxCallback callback);
 
+void dap_v2_usb_set_tx_callback(DapTxCallback callback);
+
+bool dap_v2_usb_tx_is_ready();
+
 /************************************ CDC **************************************/
 
 typedef void (*DapCDCControlLineCallback)(uint8_t state, void* context);
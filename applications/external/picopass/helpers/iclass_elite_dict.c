@@ -14,22 +14,25 @@
 
 struct IclassEliteDict {
     Stream* stream;
+    FuriString* next_line;
     uint32_t total_keys;
 };
 
-bool iclass_elite_dict_check_presence(IclassEliteDictType dict_type) {
-    Storage* storage = furi_record_open(RECORD_STORAGE);
-
-    bool dict_present = false;
+const char* iclass_elite_dict_get_path(IclassEliteDictType dict_type) {
     if(dict_type == IclassEliteDictTypeFlipper) {
-        dict_present =
-            (storage_common_stat(storage, ICLASS_ELITE_DICT_FLIPPER_NAME, NULL) == FSE_OK);
+        return ICLASS_ELITE_DICT_FLIPPER_NAME;
     } else if(dict_type == IclassEliteDictTypeUser) {
-        dict_present = (storage_common_stat(storage, ICLASS_ELITE_DICT_USER_NAME, NULL) == FSE_OK);
-    } else if(dict_type == IclassStandardDictTypeFlipper) {
-        dict_present =
-            (storage_common_stat(storage, ICLASS_STANDARD_DICT_FLIPPER_NAME, NULL) == FSE_OK);
+        return ICLASS_ELITE_DICT_USER_NAME;
+    } else {
+        return ICLASS_STANDARD_DICT_FLIPPER_NAME;
     }
+}
+
+bool iclass_elite_dict_check_presence(IclassEliteDictType dict_type) {
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+
+    bool dict_present =
+        (storage_common_stat(storage, iclass_elite_dict_get_path(dict_type), NULL) == FSE_OK);
 
     furi_record_close(RECORD_STORAGE);
 
@@ -40,7 +43,8 @@ IclassEliteDict* iclass_elite_dict_alloc(IclassEliteDictType dict_type) {
     IclassEliteDict* dict = malloc(sizeof(IclassEliteDict));
     Storage* storage = furi_record_open(RECORD_STORAGE);
     dict->stream = buffered_file_stream_alloc(storage);
-    FuriString* next_line = furi_string_alloc();
+    dict->next_line = furi_string_alloc();
+    FuriString* next_line = dict->next_line;
 
     bool dict_loaded = false;
     do {
@@ -83,12 +87,12 @@ IclassEliteDict* iclass_elite_dict_alloc(IclassEliteDictType dict_type) {
 
     if(!dict_loaded) { //-V547
         buffered_file_stream_close(dict->stream);
+        furi_string_free(dict->next_line);
         free(dict);
         dict = NULL;
     }
 
     furi_record_close(RECORD_STORAGE);
-    furi_string_free(next_line);
 
     return dict;
 }
@@ -99,6 +103,7 @@ void iclass_elite_dict_free(IclassEliteDict* dict) {
 
     buffered_file_stream_close(dict->stream);
     stream_free(dict->stream);
+    furi_string_free(dict->next_line);
     free(dict);
 }
 
@@ -113,7 +118,7 @@ bool iclass_elite_dict_get_next_key(IclassEliteDict* dict, uint8_t* key) {
     furi_assert(dict->stream);
 
     uint8_t key_byte_tmp = 0;
-    FuriString* next_line = furi_string_alloc();
+    FuriString* next_line = dict->next_line;
 
     bool key_read = false;
     *key = 0ULL;
@@ -131,7 +136,6 @@ bool iclass_elite_dict_get_next_key(IclassEliteDict* dict, uint8_t* key) {
         key_read = true;
     }
 
-    furi_string_free(next_line);
     return key_read;
 }
 
@@ -14,6 +14,8 @@ typedef enum {
 
 typedef struct IclassEliteDict IclassEliteDict;
 
+const char* iclass_elite_dict_get_path(IclassEliteDictType dict_type);
+
 bool iclass_elite_dict_check_presence(IclassEliteDictType dict_type);
 
 IclassEliteDict* iclass_elite_dict_alloc(IclassEliteDictType dict_type);
@@ -0,0 +1,189 @@
+#include "iclass_key_cache.h"
+
+#include <furi.h>
+#include <storage/storage.h>
+#include <optimized_cipher.h>
+
+#define TAG "IclassKeyCache"
+
+#define ICLASS_KEY_CACHE_FOLDER APP_DATA_PATH("cache")
+#define ICLASS_KEY_CACHE_MAGIC (0x434B5049)
+#define ICLASS_KEY_CACHE_VERSION (1)
+#define ICLASS_KEY_CACHE_BATCH_SIZE (16)
+#define ICLASS_KEY_LEN (8)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t dict_type;
+    uint16_t reserved;
+    uint8_t csn[ICLASS_KEY_LEN];
+    uint32_t dict_size;
+    uint32_t dict_timestamp;
+    uint32_t total_keys;
+} IclassKeyCacheHeader;
+
+struct IclassKeyCache {
+    IclassEliteDict* dict;
+    bool elite;
+    uint8_t csn[ICLASS_KEY_LEN];
+
+    Storage* storage;
+    File* file;
+    bool file_valid;
+    // Diversified keys stored in file
+    uint32_t cached;
+    // Keys taken from dictionary
+    uint32_t position;
+
+    uint8_t keys[ICLASS_KEY_CACHE_BATCH_SIZE][ICLASS_KEY_LEN];
+    uint8_t div_keys[ICLASS_KEY_CACHE_BATCH_SIZE][ICLASS_KEY_LEN];
+    size_t batch_count;
+    size_t batch_index;
+};
+
+static bool iclass_key_cache_open(
+    IclassKeyCache* cache,
+    IclassEliteDictType dict_type,
+    const IclassKeyCacheHeader* expected) {
+    FuriString* path = furi_string_alloc_set_str(ICLASS_KEY_CACHE_FOLDER "/");
+    for(size_t i = 0; i < ICLASS_KEY_LEN; i++) {
+        furi_string_cat_printf(path, "%02X", cache->csn[i]);
+    }
+    furi_string_cat_printf(path, "_%d.bin", dict_type);
+
+    bool opened = false;
+    do {
+        if(!storage_simply_mkdir(cache->storage, ICLASS_KEY_CACHE_FOLDER)) break;
+        if(!storage_file_open(
+               cache->file, furi_string_get_cstr(path), FSAM_READ_WRITE, FSOM_OPEN_ALWAYS))
+            break;
+
+        IclassKeyCacheHeader header;
+        uint64_t size = storage_file_size(cache->file);
+        if(size >= sizeof(header) &&
+           storage_file_read(cache->file, &header, sizeof(header)) == sizeof(header) &&
+           memcmp(&header, expected, sizeof(header)) == 0) {
+            cache->cached = (size - sizeof(header)) / ICLASS_KEY_LEN;
+            // Partial entry of an interrupted write is overwritten by the next append
+            if(cache->cached <= expected->total_keys) {
+                opened = true;
+                break;
+            }
+        }
+
+        // Missing, outdated or broken cache, start over
+        cache->cached = 0;
+        if(!storage_file_seek(cache->file, 0, true)) break;
+        if(!storage_file_truncate(cache->file)) break;
+        if(storage_file_write(cache->file, expected, sizeof(IclassKeyCacheHeader)) !=
+           sizeof(IclassKeyCacheHeader))
+            break;
+        opened = true;
+    } while(false);
+
+    if(!opened) {
+        storage_file_close(cache->file);
+    }
+
+    FURI_LOG_D(
+        TAG, "%s: %lu keys cached", furi_string_get_cstr(path), opened ? cache->cached : 0);
+    furi_string_free(path);
+    return opened;
+}
+
+IclassKeyCache* iclass_key_cache_alloc(
+    IclassEliteDict* dict,
+    IclassEliteDictType dict_type,
+    const uint8_t* csn) {
+    furi_assert(dict);
+    furi_assert(csn);
+
+    IclassKeyCache* cache = malloc(sizeof(IclassKeyCache));
+    cache->dict = dict;
+    cache->elite = (dict_type != IclassStandardDictTypeFlipper);
+    memcpy(cache->csn, csn, ICLASS_KEY_LEN);
+    cache->storage = furi_record_open(RECORD_STORAGE);
+    cache->file = storage_file_alloc(cache->storage);
+
+    iclass_elite_dict_rewind(dict);
+
+    IclassKeyCacheHeader expected = {
+        .magic = ICLASS_KEY_CACHE_MAGIC,
+        .version = ICLASS_KEY_CACHE_VERSION,
+        .dict_type = dict_type,
+        .total_keys = iclass_elite_dict_get_total_keys(dict),
+    };
+    memcpy(expected.csn, csn, ICLASS_KEY_LEN);
+
+    // Any change of dictionary file invalidates the cache
+    const char* dict_path = iclass_elite_dict_get_path(dict_type);
+    FileInfo dict_info;
+    if(storage_common_stat(cache->storage, dict_path, &dict_info) == FSE_OK &&
+       storage_common_timestamp(cache->storage, dict_path, &expected.dict_timestamp) ==
+           FSE_OK) {
+        expected.dict_size = dict_info.size;
+        cache->file_valid = iclass_key_cache_open(cache, dict_type, &expected);
+    }
+
+    return cache;
+}
+
+void iclass_key_cache_free(IclassKeyCache* cache) {
+    furi_assert(cache);
+
+    storage_file_free(cache->file);
+    furi_record_close(RECORD_STORAGE);
+    free(cache);
+}
+
+static bool iclass_key_cache_fill(IclassKeyCache* cache) {
+    cache->batch_index = 0;
+    cache->batch_count = 0;
+    while(cache->batch_count < ICLASS_KEY_CACHE_BATCH_SIZE &&
+          iclass_elite_dict_get_next_key(cache->dict, cache->keys[cache->batch_count])) {
+        cache->batch_count++;
+    }
+    if(cache->batch_count == 0) return false;
+
+    size_t from_cache = 0;
+    if(cache->file_valid && cache->position < cache->cached) {
+        from_cache = MIN(cache->batch_count, cache->cached - cache->position);
+        size_t size = from_cache * ICLASS_KEY_LEN;
+        if(storage_file_read(cache->file, cache->div_keys, size) != size) {
+            FURI_LOG_E(TAG, "Cache read failed");
+            from_cache = 0;
+            cache->file_valid = false;
+        }
+    }
+
+    for(size_t i = from_cache; i < cache->batch_count; i++) {
+        loclass_iclass_calc_div_key(cache->csn, cache->keys[i], cache->div_keys[i], cache->elite);
+    }
+
+    if(cache->file_valid && from_cache < cache->batch_count) {
+        size_t size = (cache->batch_count - from_cache) * ICLASS_KEY_LEN;
+        if(storage_file_write(cache->file, cache->div_keys[from_cache], size) == size) {
+            cache->cached += cache->batch_count - from_cache;
+        } else {
+            FURI_LOG_E(TAG, "Cache write failed");
+            cache->file_valid = false;
+        }
+    }
+
+    cache->position += cache->batch_count;
+    return true;
+}
+
+bool iclass_key_cache_get_next(IclassKeyCache* cache, uint8_t* key, uint8_t* div_key) {
+    furi_assert(cache);
+
+    if(cache->batch_index >= cache->batch_count) {
+        if(!iclass_key_cache_fill(cache)) return false;
+    }
+
+    memcpy(key, cache->keys[cache->batch_index], ICLASS_KEY_LEN);
+    memcpy(div_key, cache->div_keys[cache->batch_index], ICLASS_KEY_LEN);
+    cache->batch_index++;
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iclass_elite_dict.h"
+
+/** Dictionary keys together with their diversified keys for one card
+ *
+ * Diversified keys are stored on SD card per CSN and dictionary, so the next
+ * attack on the same card reads them instead of running key diversification.
+ * Keys are taken from the dictionary and the cache file in batches.
+ * Cache is dropped when the dictionary file is changed.
+ */
+typedef struct IclassKeyCache IclassKeyCache;
+
+/** Allocate key cache, dictionary is rewound
+ *
+ * @param dict      - dictionary to take keys from, owned by caller
+ * @param dict_type - dictionary type, elite dictionaries use elite diversification
+ * @param csn       - card serial number
+ * @return IclassKeyCache*
+ */
+IclassKeyCache* iclass_key_cache_alloc(
+    IclassEliteDict* dict,
+    IclassEliteDictType dict_type,
+    const uint8_t* csn);
+
+/** Free key cache
+ *
+ * @param cache - IclassKeyCache instance
+ */
+void iclass_key_cache_free(IclassKeyCache* cache);
+
+/** Get next dictionary key and its diversified key
+ *
+ * @param cache     - IclassKeyCache instance
+ * @param key       - 8 byte dictionary key output
+ * @param div_key   - 8 byte diversified key output
+ * @return false when dictionary is over
+ */
+bool iclass_key_cache_get_next(IclassKeyCache* cache, uint8_t* key, uint8_t* div_key);
@@ -76,6 +76,15 @@
   -- iceman 2020
 **/
 
+/**
+  Table driven successor for the dictionary attack on the device:
+  * Only the lowest bit of Tt and opt_B is used, both are parity of a masked register,
+    taken from the parity table instead of the shift/xor chains
+  * opt_select folded into a single xor with the select table
+  * Input consumed one byte per iteration with the 8 bit steps unrolled, cipher state is
+    kept in a local copy so it stays in registers for the whole byte
+**/
+
 #include "optimized_cipher.h"
 #include "optimized_elite.h"
 #include "optimized_ikeys.h"
@@ -115,76 +124,87 @@ static void init_opt_select_LUT(void) {
         (2 & ((((r) | (r) << 2) >> 6) ^ (((r) | (r) << 2) >> 1) ^ ((r) >> 5) ^ (r) ^ (((x) ^ (y)) << 1))) | \
         (1 & ((((r) & ~((r) << 2)) >> 4) ^ (((r) & ((r) << 2)) >> 3) ^ (r) ^ (x)))
 
-static void loclass_opt_successor(const uint8_t* k, LoclassState_t* s, uint8_t y) {
-    uint16_t Tt = s->t & 0xc533;
-    Tt = Tt ^ (Tt >> 1);
-    Tt = Tt ^ (Tt >> 4);
-    Tt = Tt ^ (Tt >> 10);
-    Tt = Tt ^ (Tt >> 8);
-
-    s->t = (s->t >> 1);
-    s->t |= (Tt ^ (s->r >> 7) ^ (s->r >> 3)) << 15;
+/* Parity of a byte */
+#define LOCLASS_P2(n) n, n ^ 1, n ^ 1, n
+#define LOCLASS_P4(n) LOCLASS_P2(n), LOCLASS_P2(n ^ 1), LOCLASS_P2(n ^ 1), LOCLASS_P2(n)
+#define LOCLASS_P6(n) LOCLASS_P4(n), LOCLASS_P4(n ^ 1), LOCLASS_P4(n ^ 1), LOCLASS_P4(n)
+static const uint8_t loclass_opt_parity_LUT[256] = {
+    LOCLASS_P6(0),
+    LOCLASS_P6(1),
+    LOCLASS_P6(1),
+    LOCLASS_P6(0)};
 
-    uint8_t opt_B = s->b;
-    opt_B ^= s->b >> 6;
-    opt_B ^= s->b >> 5;
-    opt_B ^= s->b >> 4;
+static inline __attribute__((always_inline)) void
+    loclass_opt_successor(const uint8_t* k, LoclassState_t* s, uint8_t y) {
+    // Tt = t0 ^ t1 ^ t4 ^ t5 ^ t8 ^ t10 ^ t14 ^ t15
+    uint8_t Tt = loclass_opt_parity_LUT[((s->t >> 8) & 0xc5) ^ (s->t & 0x33)];
+    // opt_B = b0 ^ b4 ^ b5 ^ b6
+    uint8_t opt_B = loclass_opt_parity_LUT[s->b & 0x71];
 
-    s->b = s->b >> 1;
-    s->b |= (opt_B ^ s->r) << 7;
+    s->t = (s->t >> 1) | (((Tt ^ (s->r >> 7) ^ (s->r >> 3)) & 1) << 15);
+    s->b = (s->b >> 1) | (((opt_B ^ s->r) & 1) << 7);
 
-    uint8_t opt_select = loclass_opt_select_LUT[s->r] & 0x04;
-    opt_select |= (loclass_opt_select_LUT[s->r] ^ ((Tt ^ y) << 1)) & 0x02;
-    opt_select |= (loclass_opt_select_LUT[s->r] ^ Tt) & 0x01;
+    uint8_t opt_select = loclass_opt_select_LUT[s->r] ^ (Tt * 3) ^ ((y & 1) << 1);
 
     uint8_t r = s->r;
     s->r = (k[opt_select] ^ s->b) + s->l;
     s->l = s->r + r;
 }
 
+static inline __attribute__((always_inline)) void
+    loclass_opt_successor_byte(const uint8_t* k, LoclassState_t* s, uint8_t head) {
+    loclass_opt_successor(k, s, head);
+    loclass_opt_successor(k, s, head >> 1);
+    loclass_opt_successor(k, s, head >> 2);
+    loclass_opt_successor(k, s, head >> 3);
+    loclass_opt_successor(k, s, head >> 4);
+    loclass_opt_successor(k, s, head >> 5);
+    loclass_opt_successor(k, s, head >> 6);
+    loclass_opt_successor(k, s, head >> 7);
+}
+
 static void loclass_opt_suc(
     const uint8_t* k,
     LoclassState_t* s,
     const uint8_t* in,
     uint8_t length,
     bool add32Zeroes) {
+    LoclassState_t state = *s;
     for(int i = 0; i < length; i++) {
-        uint8_t head = in[i];
-        for(int j = 0; j < 8; j++) {
-            loclass_opt_successor(k, s, head);
-            head >>= 1;
-        }
+        loclass_opt_successor_byte(k, &state, in[i]);
     }
     //For tag MAC, an additional 32 zeroes
     if(add32Zeroes) {
-        for(int i = 0; i < 16; i++) {
-            loclass_opt_successor(k, s, 0);
-            loclass_opt_successor(k, s, 0);
+        for(int i = 0; i < 4; i++) {
+            loclass_opt_successor_byte(k, &state, 0);
         }
     }
+    *s = state;
 }
 
 static void loclass_opt_output(const uint8_t* k, LoclassState_t* s, uint8_t* buffer) {
+    LoclassState_t state = *s;
     for(uint8_t times = 0; times < 4; times++) {
         uint8_t bout = 0;
-        bout |= (s->r & 0x4) >> 2;
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4) >> 1;
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4);
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4) << 1;
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4) << 2;
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4) << 3;
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4) << 4;
-        loclass_opt_successor(k, s, 0);
-        bout |= (s->r & 0x4) << 5;
-        loclass_opt_successor(k, s, 0);
+        bout |= (state.r & 0x4) >> 2;
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4) >> 1;
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4);
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4) << 1;
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4) << 2;
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4) << 3;
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4) << 4;
+        loclass_opt_successor(k, &state, 0);
+        bout |= (state.r & 0x4) << 5;
+        loclass_opt_successor(k, &state, 0);
         buffer[times] = bout;
     }
+    *s = state;
 }
 
 static void loclass_opt_MAC(uint8_t* k, uint8_t* input, uint8_t* out) {
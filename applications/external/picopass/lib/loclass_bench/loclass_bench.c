@@ -0,0 +1,152 @@
+/**
+ * Host benchmark for the loclass cipher core, not a part of the application build.
+ *
+ * Checks MAC results against the previous successor implementation and measures
+ * MAC and key diversification speed:
+ *
+ *   cd ../loclass
+ *   cc -O2 -I. -o loclass_bench ../loclass_bench/loclass_bench.c optimized_cipher.c \
+ *       optimized_cipherutils.c optimized_elite.c optimized_ikeys.c -lmbedcrypto
+ *   ./loclass_bench [iterations]
+ */
+#include <optimized_cipher.h>
+#include <optimized_elite.h>
+#include <optimized_ikeys.h>
+
+#include <stdio.h>
+#include <time.h>
+
+#define LOCLASS_BENCH_ITERATIONS (100000)
+
+/* Successor step as it was before the table driven version, reference for the results */
+static void ref_successor(const uint8_t* k, LoclassState_t* s, uint8_t y) {
+    uint16_t Tt = s->t & 0xc533;
+    Tt = Tt ^ (Tt >> 1);
+    Tt = Tt ^ (Tt >> 4);
+    Tt = Tt ^ (Tt >> 10);
+    Tt = Tt ^ (Tt >> 8);
+
+    s->t = (s->t >> 1);
+    s->t |= (Tt ^ (s->r >> 7) ^ (s->r >> 3)) << 15;
+
+    uint8_t opt_B = s->b;
+    opt_B ^= s->b >> 6;
+    opt_B ^= s->b >> 5;
+    opt_B ^= s->b >> 4;
+
+    s->b = s->b >> 1;
+    s->b |= (opt_B ^ s->r) << 7;
+
+    uint8_t r = s->r;
+    uint8_t r_ls2 = r << 2;
+    uint8_t r_and_ls2 = r & r_ls2;
+    uint8_t r_or_ls2 = r | r_ls2;
+    uint8_t z0 = (r_and_ls2 >> 5) ^ ((r & ~r_ls2) >> 4) ^ (r_or_ls2 >> 3);
+    uint8_t z1 = (r_or_ls2 >> 6) ^ (r_or_ls2 >> 1) ^ (r >> 5) ^ r ^ ((Tt ^ y) << 1);
+    uint8_t z2 = ((r & ~r_ls2) >> 4) ^ (r_and_ls2 >> 3) ^ r ^ Tt;
+    uint8_t opt_select = (z0 & 4) | (z1 & 2) | (z2 & 1);
+
+    s->r = (k[opt_select] ^ s->b) + s->l;
+    s->l = s->r + r;
+}
+
+static void ref_mac(const uint8_t* k, const uint8_t* in, uint8_t length, bool tag, uint8_t* mac) {
+    LoclassState_t s = {
+        ((k[0] ^ 0x4c) + 0xEC) & 0xFF,
+        ((k[0] ^ 0x4c) + 0x21) & 0xFF,
+        0x4c,
+        0xE012,
+    };
+    for(uint8_t i = 0; i < length; i++) {
+        for(uint8_t j = 0; j < 8; j++) ref_successor(k, &s, in[i] >> j);
+    }
+    if(tag) {
+        for(uint8_t i = 0; i < 32; i++) ref_successor(k, &s, 0);
+    }
+    for(uint8_t i = 0; i < 4; i++) {
+        uint8_t bout = 0;
+        for(uint8_t j = 0; j < 8; j++) {
+            bout |= ((s.r >> 2) & 1) << j;
+            ref_successor(k, &s, 0);
+        }
+        mac[i] = bout;
+    }
+}
+
+static uint32_t bench_random(void) {
+    static uint32_t state = 0x12345678;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static void bench_fill(uint8_t* data, size_t size) {
+    for(size_t i = 0; i < size; i++) data[i] = bench_random();
+}
+
+static double bench_seconds(clock_t start) {
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char** argv) {
+    long iterations = (argc > 1) ? atol(argv[1]) : LOCLASS_BENCH_ITERATIONS;
+    uint8_t key[8], csn[8], ccnr[12] = {0}, mac[4], ref[4];
+
+    for(int i = 0; i < 10000; i++) {
+        bench_fill(key, sizeof(key));
+        bench_fill(ccnr, sizeof(ccnr));
+        loclass_opt_doReaderMAC(ccnr, key, mac);
+        ref_mac(key, ccnr, 12, false, ref);
+        if(memcmp(mac, ref, sizeof(mac)) != 0) {
+            printf("Reader MAC mismatch at %d\r\n", i);
+            return 1;
+        }
+        loclass_opt_doTagMAC(ccnr, key, mac);
+        ref_mac(key, ccnr, 12, true, ref);
+        if(memcmp(mac, ref, sizeof(mac)) != 0) {
+            printf("Tag MAC mismatch at %d\r\n", i);
+            return 1;
+        }
+    }
+    printf("MAC results match the reference\r\n");
+
+    uint8_t sink = 0;
+    clock_t start = clock();
+    for(long i = 0; i < iterations; i++) {
+        ref_mac(key, ccnr, 12, false, ref);
+        key[i & 7] ^= ref[0];
+        sink ^= ref[1];
+    }
+    double ref_time = bench_seconds(start);
+
+    start = clock();
+    for(long i = 0; i < iterations; i++) {
+        loclass_opt_doReaderMAC(ccnr, key, mac);
+        key[i & 7] ^= mac[0];
+        sink ^= mac[1];
+    }
+    double mac_time = bench_seconds(start);
+
+    long div_iterations = iterations / 10;
+    bench_fill(csn, sizeof(csn));
+    start = clock();
+    for(long i = 0; i < div_iterations; i++) {
+        loclass_iclass_calc_div_key(csn, key, key, false);
+    }
+    double standard_time = bench_seconds(start);
+
+    start = clock();
+    for(long i = 0; i < div_iterations; i++) {
+        loclass_iclass_calc_div_key(csn, key, key, true);
+    }
+    double elite_time = bench_seconds(start);
+
+    printf("Reader MAC, reference: %.3f us\r\n", ref_time * 1e6 / iterations);
+    printf("Reader MAC, optimized: %.3f us\r\n", mac_time * 1e6 / iterations);
+    printf("Standard key diversification: %.3f us\r\n", standard_time * 1e6 / div_iterations);
+    printf("Elite key diversification: %.3f us\r\n", elite_time * 1e6 / div_iterations);
+    printf("%02x\r\n", sink ^ key[0]);
+
+    return 0;
+}
@@ -203,7 +203,8 @@ static ReturnCode
     }
 
     FURI_LOG_D(TAG, "Loaded %lu keys", iclass_elite_dict_get_total_keys(dict));
-    while(iclass_elite_dict_get_next_key(dict, key)) {
+    IclassKeyCache* key_cache = iclass_key_cache_alloc(dict, dict_type, csn);
+    while(iclass_key_cache_get_next(key_cache, key, div_key)) {
         FURI_LOG_D(
             TAG,
             "Try to %s auth with key %zu %02x%02x%02x%02x%02x%02x%02x%02x",
@@ -225,7 +226,6 @@ static ReturnCode
         }
         memcpy(ccnr, rcRes.CCNR, sizeof(rcRes.CCNR)); // last 4 bytes left 0
 
-        loclass_iclass_calc_div_key(csn, key, div_key, elite);
         loclass_opt_doReaderMAC(ccnr, div_key, mac);
 
         err = rfalPicoPassPollerCheck(mac, &chkRes);
@@ -237,6 +237,7 @@ static ReturnCode
         if(picopass_worker->state != PicopassWorkerStateDetect) break;
     }
 
+    iclass_key_cache_free(key_cache);
     iclass_elite_dict_free(dict);
 
     return err;
@@ -474,7 +475,6 @@ void picopass_worker_elite_dict_attack(PicopassWorker* picopass_worker) {
 
     IclassEliteDictAttackData* dict_attack_data =
         &picopass_worker->dev_data->iclass_elite_dict_attack_data;
-    bool elite = (dict_attack_data->type != IclassStandardDictTypeFlipper);
 
     rfalPicoPassReadCheckRes rcRes;
     rfalPicoPassCheckRes chkRes;
@@ -526,7 +526,10 @@ void picopass_worker_elite_dict_attack(PicopassWorker* picopass_worker) {
 
     FURI_LOG_D(
         TAG, "Start Dictionary attack, Key Count %lu", iclass_elite_dict_get_total_keys(dict));
-    while(iclass_elite_dict_get_next_key(dict, key)) {
+    uint8_t* div_key = AA1[PICOPASS_KD_BLOCK_INDEX].data;
+    IclassKeyCache* key_cache =
+        iclass_key_cache_alloc(dict, dict_attack_data->type, AA1[PICOPASS_CSN_BLOCK_INDEX].data);
+    while(iclass_key_cache_get_next(key_cache, key, div_key)) {
         FURI_LOG_T(TAG, "Key %zu", index);
         if(++index % PICOPASS_DICT_KEY_BATCH_SIZE == 0) {
             picopass_worker->callback(
@@ -540,10 +543,6 @@ void picopass_worker_elite_dict_attack(PicopassWorker* picopass_worker) {
         }
         memcpy(ccnr, rcRes.CCNR, sizeof(rcRes.CCNR)); // last 4 bytes left 0
 
-        uint8_t* csn = AA1[PICOPASS_CSN_BLOCK_INDEX].data;
-        uint8_t* div_key = AA1[PICOPASS_KD_BLOCK_INDEX].data;
-
-        loclass_iclass_calc_div_key(csn, key, div_key, elite);
         loclass_opt_doReaderMAC(ccnr, div_key, mac);
 
         err = rfalPicoPassPollerCheck(mac, &chkRes);
@@ -576,6 +575,7 @@ void picopass_worker_elite_dict_attack(PicopassWorker* picopass_worker) {
 
         if(picopass_worker->state != PicopassWorkerStateEliteDictAttack) break;
     }
+    iclass_key_cache_free(key_cache);
     FURI_LOG_D(TAG, "Dictionary complete");
     if(picopass_worker->state == PicopassWorkerStateEliteDictAttack) {
         picopass_worker->callback(PicopassWorkerEventSuccess, picopass_worker->context);
@@ -13,6 +13,8 @@
 
 #include <platform.h>
 
+#include "helpers/iclass_key_cache.h"
+
 struct PicopassWorker {
     FuriThread* thread;
     Storage* storage;
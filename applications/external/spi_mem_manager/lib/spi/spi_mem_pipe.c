@@ -0,0 +1,100 @@
+#include "spi_mem_pipe.h"
+
+#define SPI_MEM_PIPE_STOP (0xFF)
+
+typedef struct {
+    uint8_t slot;
+    bool success;
+} SPIMemPipeResult;
+
+struct SPIMemPipe {
+    FuriThread* thread;
+    FuriMessageQueue* jobs;
+    FuriMessageQueue* results;
+    SPIMemPipeIoCallback callback;
+    void* context;
+    uint8_t* buffer[SPI_MEM_PIPE_DEPTH];
+    size_t size[SPI_MEM_PIPE_DEPTH];
+    size_t head;
+    size_t tail;
+};
+
+static int32_t spi_mem_pipe_thread(void* context) {
+    SPIMemPipe* pipe = context;
+    uint8_t slot;
+    while(true) {
+        furi_check(furi_message_queue_get(pipe->jobs, &slot, FuriWaitForever) == FuriStatusOk);
+        if(slot == SPI_MEM_PIPE_STOP) break;
+        SPIMemPipeResult result = {
+            .slot = slot,
+            .success = pipe->callback(pipe->context, pipe->buffer[slot], pipe->size[slot]),
+        };
+        furi_check(
+            furi_message_queue_put(pipe->results, &result, FuriWaitForever) == FuriStatusOk);
+    }
+    return 0;
+}
+
+SPIMemPipe* spi_mem_pipe_alloc(size_t block_size, SPIMemPipeIoCallback callback, void* context) {
+    SPIMemPipe* pipe = malloc(sizeof(SPIMemPipe));
+    pipe->callback = callback;
+    pipe->context = context;
+    for(size_t i = 0; i < SPI_MEM_PIPE_DEPTH; i++) {
+        pipe->buffer[i] = malloc(block_size);
+    }
+    pipe->jobs = furi_message_queue_alloc(SPI_MEM_PIPE_DEPTH + 1, sizeof(uint8_t));
+    pipe->results = furi_message_queue_alloc(SPI_MEM_PIPE_DEPTH, sizeof(SPIMemPipeResult));
+    pipe->thread = furi_thread_alloc_ex("SPIMemPipe", 2048, spi_mem_pipe_thread, pipe);
+    furi_thread_start(pipe->thread);
+    return pipe;
+}
+
+void spi_mem_pipe_free(SPIMemPipe* pipe) {
+    // Jobs in flight are finished before stop, their buffers must stay alive
+    spi_mem_pipe_flush(pipe);
+    uint8_t stop = SPI_MEM_PIPE_STOP;
+    furi_check(furi_message_queue_put(pipe->jobs, &stop, FuriWaitForever) == FuriStatusOk);
+    furi_thread_join(pipe->thread);
+    furi_thread_free(pipe->thread);
+    furi_message_queue_free(pipe->jobs);
+    furi_message_queue_free(pipe->results);
+    for(size_t i = 0; i < SPI_MEM_PIPE_DEPTH; i++) {
+        free(pipe->buffer[i]);
+    }
+    free(pipe);
+}
+
+size_t spi_mem_pipe_get_pending(SPIMemPipe* pipe) {
+    return pipe->head - pipe->tail;
+}
+
+uint8_t* spi_mem_pipe_get_buffer(SPIMemPipe* pipe) {
+    if(spi_mem_pipe_get_pending(pipe) == SPI_MEM_PIPE_DEPTH) return NULL;
+    return pipe->buffer[pipe->head % SPI_MEM_PIPE_DEPTH];
+}
+
+void spi_mem_pipe_submit(SPIMemPipe* pipe, size_t size) {
+    furi_check(spi_mem_pipe_get_pending(pipe) < SPI_MEM_PIPE_DEPTH);
+    uint8_t slot = pipe->head % SPI_MEM_PIPE_DEPTH;
+    pipe->size[slot] = size;
+    pipe->head++;
+    furi_check(furi_message_queue_put(pipe->jobs, &slot, FuriWaitForever) == FuriStatusOk);
+}
+
+uint8_t* spi_mem_pipe_wait(SPIMemPipe* pipe) {
+    furi_check(spi_mem_pipe_get_pending(pipe));
+    SPIMemPipeResult result;
+    furi_check(
+        furi_message_queue_get(pipe->results, &result, FuriWaitForever) == FuriStatusOk);
+    furi_assert(result.slot == pipe->tail % SPI_MEM_PIPE_DEPTH);
+    pipe->tail++;
+    return result.success ? pipe->buffer[result.slot] : NULL;
+}
+
+bool spi_mem_pipe_flush(SPIMemPipe* pipe) {
+    bool success = true;
+    while(spi_mem_pipe_get_pending(pipe)) {
+        if(!spi_mem_pipe_wait(pipe)) success = false;
+    }
+    return success;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <furi.h>
+
+#define SPI_MEM_PIPE_DEPTH 2
+
+/** Double buffered file I/O running in its own thread, so FatFs and SD card
+ * busy time overlap with chip commands, status polling and program/erase.
+ * Bulk DMA transfers of both buses still take turns on the shared DMA lock.
+ *
+ * Write-behind: get buffer, fill it from chip, submit, wait when full.
+ * Read-ahead: submit buffers to be filled from file, wait, use, resubmit.
+ * Jobs are completed in submission order.
+ */
+typedef struct SPIMemPipe SPIMemPipe;
+
+typedef bool (*SPIMemPipeIoCallback)(void* context, uint8_t* data, size_t size);
+
+SPIMemPipe* spi_mem_pipe_alloc(size_t block_size, SPIMemPipeIoCallback callback, void* context);
+void spi_mem_pipe_free(SPIMemPipe* pipe);
+size_t spi_mem_pipe_get_pending(SPIMemPipe* pipe);
+uint8_t* spi_mem_pipe_get_buffer(SPIMemPipe* pipe);
+void spi_mem_pipe_submit(SPIMemPipe* pipe, size_t size);
+uint8_t* spi_mem_pipe_wait(SPIMemPipe* pipe);
+bool spi_mem_pipe_flush(SPIMemPipe* pipe);
@@ -84,22 +84,29 @@ bool spi_mem_tools_check_chip_info(SPIMemChip* chip) {
     return false;
 }
 
+static bool spi_mem_tools_read_buffer(uint8_t* data, size_t size, size_t offset) {
+    furi_hal_spi_acquire(&furi_hal_spi_bus_handle_external);
+    uint8_t cmd[4] = {(uint8_t)SPIMemChipCMDReadData};
+    uint8_t cmd_size = 1 + spi_mem_tools_addr_to_byte_arr(offset, &cmd[1]);
+    bool success = false;
+    do {
+        if(!furi_hal_spi_bus_tx(
+               &furi_hal_spi_bus_handle_external, cmd, cmd_size, SPI_MEM_SPI_TIMEOUT))
+            break;
+        // Chip streams data as long as CS is held, whole block goes in one DMA transfer
+        if(!furi_hal_spi_bus_trx_dma(
+               &furi_hal_spi_bus_handle_external, NULL, data, size, SPI_MEM_SPI_TIMEOUT))
+            break;
+        success = true;
+    } while(0);
+    furi_hal_spi_release(&furi_hal_spi_bus_handle_external);
+    return success;
+}
+
 bool spi_mem_tools_read_block(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
     if(!spi_mem_tools_check_chip_info(chip)) return false;
-    for(size_t i = 0; i < block_size; i += SPI_MEM_MAX_BLOCK_SIZE) {
-        uint8_t cmd[4];
-        if((offset + SPI_MEM_MAX_BLOCK_SIZE) > chip->size) return false;
-        if(!spi_mem_tools_trx(
-               SPIMemChipCMDReadData,
-               cmd,
-               spi_mem_tools_addr_to_byte_arr(offset, cmd),
-               data,
-               SPI_MEM_MAX_BLOCK_SIZE))
-            return false;
-        offset += SPI_MEM_MAX_BLOCK_SIZE;
-        data += SPI_MEM_MAX_BLOCK_SIZE;
-    }
-    return true;
+    if((offset + block_size) > chip->size) return false;
+    return spi_mem_tools_read_buffer(data, block_size, offset);
 }
 
 size_t spi_mem_tools_get_file_max_block_size(SPIMemChip* chip) {
@@ -140,6 +147,22 @@ bool spi_mem_tools_erase_chip(SPIMemChip* chip) {
     return true;
 }
 
+bool spi_mem_tools_erase_sector(SPIMemChip* chip, size_t offset) {
+    uint8_t address[4];
+    do {
+        if(!spi_mem_tools_set_write_enabled(chip, true)) break;
+        if(!spi_mem_tools_trx(
+               SPIMemChipCMDSectorErase,
+               address,
+               spi_mem_tools_addr_to_byte_arr(offset, address),
+               NULL,
+               0))
+            break;
+        return true;
+    } while(0);
+    return false;
+}
+
 bool spi_mem_tools_write_bytes(SPIMemChip* chip, size_t offset, uint8_t* data, size_t block_size) {
     do {
         if(!spi_mem_tools_check_chip_info(chip)) break;
@@ -1,6 +1,7 @@
 #include "spi_mem_worker_i.h"
 #include "spi_mem_chip.h"
 #include "spi_mem_tools.h"
+#include "spi_mem_pipe.h"
 #include "../../spi_mem_files.h"
 
 static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker);
@@ -8,6 +9,7 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker);
 static void spi_mem_worker_verify_process(SPIMemWorker* worker);
 static void spi_mem_worker_erase_process(SPIMemWorker* worker);
 static void spi_mem_worker_write_process(SPIMemWorker* worker);
+static void spi_mem_worker_write_diff_process(SPIMemWorker* worker);
 
 const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeIdle] = {.process = NULL},
@@ -15,7 +17,8 @@ const SPIMemWorkerModeType spi_mem_worker_modes[] = {
     [SPIMemWorkerModeRead] = {.process = spi_mem_worker_read_process},
     [SPIMemWorkerModeVerify] = {.process = spi_mem_worker_verify_process},
     [SPIMemWorkerModeErase] = {.process = spi_mem_worker_erase_process},
-    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process}};
+    [SPIMemWorkerModeWrite] = {.process = spi_mem_worker_write_process},
+    [SPIMemWorkerModeWriteDiff] = {.process = spi_mem_worker_write_diff_process}};
 
 static void spi_mem_worker_run_callback(SPIMemWorker* worker, SPIMemCustomEventWorker event) {
     if(worker->callback) {
@@ -42,6 +45,29 @@ static size_t spi_mem_worker_modes_get_total_size(SPIMemWorker* worker) {
     return total_size;
 }
 
+static bool spi_mem_worker_file_write(void* context, uint8_t* data, size_t size) {
+    return spi_mem_file_write_block(context, data, size);
+}
+
+static bool spi_mem_worker_file_read(void* context, uint8_t* data, size_t size) {
+    return spi_mem_file_read_block(context, data, size);
+}
+
+static size_t spi_mem_worker_get_block_size(size_t offset, size_t total_size) {
+    size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
+    if((offset + block_size) > total_size) block_size = total_size - offset;
+    return block_size;
+}
+
+// Keep file read-ahead queue full, blocks are submitted in order till total_size
+static void spi_mem_worker_prefetch(SPIMemPipe* pipe, size_t* submitted, size_t total_size) {
+    while(*submitted < total_size && spi_mem_pipe_get_buffer(pipe)) {
+        size_t block_size = spi_mem_worker_get_block_size(*submitted, total_size);
+        spi_mem_pipe_submit(pipe, block_size);
+        *submitted += block_size;
+    }
+}
+
 // ChipDetect
 static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
     SPIMemCustomEventWorker event;
@@ -59,28 +85,32 @@ static void spi_mem_worker_chip_detect_process(SPIMemWorker* worker) {
 
 // Read
 static bool spi_mem_worker_read(SPIMemWorker* worker, SPIMemCustomEventWorker* event) {
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t chip_size = spi_mem_chip_get_size(worker->chip_info);
+    SPIMemPipe* pipe =
+        spi_mem_pipe_alloc(SPI_MEM_FILE_BUFFER_SIZE, spi_mem_worker_file_write, worker->cb_ctx);
     size_t offset = 0;
     bool success = true;
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= chip_size) break;
-        if((offset + block_size) > chip_size) block_size = chip_size - offset;
-        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer, block_size)) {
-            *event = SPIMemCustomEventWorkerChipFail;
+        size_t block_size = spi_mem_worker_get_block_size(offset, chip_size);
+        // Chip is read into one buffer while the other one is written to file
+        if(!spi_mem_pipe_get_buffer(pipe) && !spi_mem_pipe_wait(pipe)) {
             success = false;
             break;
         }
-        if(!spi_mem_file_write_block(worker->cb_ctx, data_buffer, block_size)) {
+        uint8_t* data_buffer = spi_mem_pipe_get_buffer(pipe);
+        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer, block_size)) {
+            *event = SPIMemCustomEventWorkerChipFail;
             success = false;
             break;
         }
+        spi_mem_pipe_submit(pipe, block_size);
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    if(!spi_mem_pipe_flush(pipe)) success = false;
+    spi_mem_pipe_free(pipe);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -90,6 +120,7 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker) {
     do {
         if(!spi_mem_worker_await_chip_busy(worker)) break;
         if(!spi_mem_file_create_open(worker->cb_ctx)) break;
+        spi_mem_file_preallocate(worker->cb_ctx, spi_mem_chip_get_size(worker->chip_info));
         if(!spi_mem_worker_read(worker, &event)) break;
     } while(0);
     spi_mem_file_close(worker->cb_ctx);
@@ -100,21 +131,23 @@ static void spi_mem_worker_read_process(SPIMemWorker* worker) {
 static bool
     spi_mem_worker_verify(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
     uint8_t data_buffer_chip[SPI_MEM_FILE_BUFFER_SIZE];
-    uint8_t data_buffer_file[SPI_MEM_FILE_BUFFER_SIZE];
+    SPIMemPipe* pipe =
+        spi_mem_pipe_alloc(SPI_MEM_FILE_BUFFER_SIZE, spi_mem_worker_file_read, worker->cb_ctx);
     size_t offset = 0;
+    size_t submitted = 0;
     bool success = true;
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= total_size) break;
-        if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer_chip, block_size)) {
-            *event = SPIMemCustomEventWorkerChipFail;
+        size_t block_size = spi_mem_worker_get_block_size(offset, total_size);
+        spi_mem_worker_prefetch(pipe, &submitted, total_size);
+        uint8_t* data_buffer_file = spi_mem_pipe_wait(pipe);
+        if(!data_buffer_file) {
             success = false;
             break;
         }
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer_file, block_size)) {
+        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer_chip, block_size)) {
+            *event = SPIMemCustomEventWorkerChipFail;
             success = false;
             break;
         }
@@ -126,6 +159,7 @@ static bool
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_pipe_free(pipe);
     if(success) *event = SPIMemCustomEventWorkerDone;
     return success;
 }
@@ -173,16 +207,18 @@ static bool spi_mem_worker_write_block_by_page(
 static bool
     spi_mem_worker_write(SPIMemWorker* worker, size_t total_size, SPIMemCustomEventWorker* event) {
     bool success = true;
-    uint8_t data_buffer[SPI_MEM_FILE_BUFFER_SIZE];
     size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
+    SPIMemPipe* pipe =
+        spi_mem_pipe_alloc(SPI_MEM_FILE_BUFFER_SIZE, spi_mem_worker_file_read, worker->cb_ctx);
     size_t offset = 0;
+    size_t submitted = 0;
     while(true) {
-        furi_delay_tick(10); // to give some time to OS
-        size_t block_size = SPI_MEM_FILE_BUFFER_SIZE;
         if(spi_mem_worker_check_for_stop(worker)) break;
         if(offset >= total_size) break;
-        if((offset + block_size) > total_size) block_size = total_size - offset;
-        if(!spi_mem_file_read_block(worker->cb_ctx, data_buffer, block_size)) {
+        size_t block_size = spi_mem_worker_get_block_size(offset, total_size);
+        spi_mem_worker_prefetch(pipe, &submitted, total_size);
+        uint8_t* data_buffer = spi_mem_pipe_wait(pipe);
+        if(!data_buffer) {
             *event = SPIMemCustomEventWorkerFileFail;
             success = false;
             break;
@@ -195,6 +231,7 @@ static bool
         offset += block_size;
         spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
     }
+    spi_mem_pipe_free(pipe);
     return success;
 }
 
@@ -212,3 +249,93 @@ static void spi_mem_worker_write_process(SPIMemWorker* worker) {
     spi_mem_file_close(worker->cb_ctx);
     spi_mem_worker_run_callback(worker, event);
 }
+
+// Differential write
+// Program can only clear bits, sector is erased only if some bit has to go from 0 to 1
+static bool
+    spi_mem_worker_sector_needs_erase(const uint8_t* chip, const uint8_t* file, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        if((chip[i] & file[i]) != file[i]) return true;
+    }
+    return false;
+}
+
+static bool spi_mem_worker_write_sector_diff(
+    SPIMemWorker* worker,
+    size_t offset,
+    uint8_t* data_chip,
+    uint8_t* data_file,
+    size_t block_size,
+    size_t page_size) {
+    if(spi_mem_worker_sector_needs_erase(data_chip, data_file, block_size)) {
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_tools_erase_sector(worker->chip_info, offset)) return false;
+        memset(data_chip, 0xFF, block_size);
+    }
+    for(size_t i = 0; i < block_size; i += page_size) {
+        size_t size = MIN(page_size, block_size - i);
+        if(memcmp(&data_chip[i], &data_file[i], size) == 0) continue;
+        if(!spi_mem_worker_await_chip_busy(worker)) return false;
+        if(!spi_mem_tools_write_bytes(worker->chip_info, offset + i, &data_file[i], size))
+            return false;
+    }
+    return true;
+}
+
+static bool spi_mem_worker_write_diff(
+    SPIMemWorker* worker,
+    size_t total_size,
+    SPIMemCustomEventWorker* event) {
+    uint8_t data_buffer_chip[SPI_MEM_SECTOR_SIZE];
+    size_t page_size = spi_mem_chip_get_page_size(worker->chip_info);
+    SPIMemPipe* pipe =
+        spi_mem_pipe_alloc(SPI_MEM_SECTOR_SIZE, spi_mem_worker_file_read, worker->cb_ctx);
+    size_t offset = 0;
+    size_t submitted = 0;
+    bool success = true;
+    while(true) {
+        if(spi_mem_worker_check_for_stop(worker)) break;
+        if(offset >= total_size) break;
+        size_t block_size = spi_mem_worker_get_block_size(offset, total_size);
+        spi_mem_worker_prefetch(pipe, &submitted, total_size);
+        uint8_t* data_buffer_file = spi_mem_pipe_wait(pipe);
+        if(!data_buffer_file) {
+            *event = SPIMemCustomEventWorkerFileFail;
+            success = false;
+            break;
+        }
+        if(!spi_mem_worker_await_chip_busy(worker)) {
+            success = false;
+            break;
+        }
+        if(!spi_mem_tools_read_block(worker->chip_info, offset, data_buffer_chip, block_size)) {
+            success = false;
+            break;
+        }
+        // Sectors that already match are left untouched
+        if(memcmp(data_buffer_chip, data_buffer_file, block_size) != 0 &&
+           !spi_mem_worker_write_sector_diff(
+               worker, offset, data_buffer_chip, data_buffer_file, block_size, page_size)) {
+            success = false;
+            break;
+        }
+        offset += block_size;
+        spi_mem_worker_run_callback(worker, SPIMemCustomEventWorkerBlockReaded);
+    }
+    spi_mem_pipe_free(pipe);
+    return success;
+}
+
+static void spi_mem_worker_write_diff_process(SPIMemWorker* worker) {
+    SPIMemCustomEventWorker event = SPIMemCustomEventWorkerChipFail;
+    size_t total_size =
+        spi_mem_worker_modes_get_total_size(worker); // need to be executed before opening file
+    do {
+        if(!spi_mem_file_open(worker->cb_ctx)) break;
+        if(!spi_mem_worker_write_diff(worker, total_size, &event)) break;
+        if(!spi_mem_worker_await_chip_busy(worker)) break;
+        event = SPIMemCustomEventWorkerDone;
+    } while(0);
+    spi_mem_file_close(worker->cb_ctx);
+    spi_mem_worker_run_callback(worker, event);
+}
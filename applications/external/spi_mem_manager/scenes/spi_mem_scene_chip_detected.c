@@ -54,6 +54,8 @@ static void spi_mem_scene_chip_detected_set_next_scene(SPIMemApp* app) {
     uint32_t scene = SPIMemSceneStart;
     if(app->mode == SPIMemModeRead) scene = SPIMemSceneReadFilename;
     if(app->mode == SPIMemModeWrite) scene = SPIMemSceneErase;
+    // Differential write erases only changed sectors by itself
+    if(app->mode == SPIMemModeWrite && app->write_diff) scene = SPIMemSceneWrite;
     if(app->mode == SPIMemModeErase) scene = SPIMemSceneErase;
     if(app->mode == SPIMemModeCompare) scene = SPIMemSceneVerify;
     scene_manager_next_scene(app->scene_manager, scene);
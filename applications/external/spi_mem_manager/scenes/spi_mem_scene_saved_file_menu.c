@@ -2,6 +2,7 @@
 
 typedef enum {
     SPIMemSceneSavedFileMenuSubmenuIndexWrite,
+    SPIMemSceneSavedFileMenuSubmenuIndexWriteDiff,
     SPIMemSceneSavedFileMenuSubmenuIndexCompare,
     SPIMemSceneSavedFileMenuSubmenuIndexInfo,
     SPIMemSceneSavedFileMenuSubmenuIndexDelete,
@@ -20,6 +21,12 @@ void spi_mem_scene_saved_file_menu_on_enter(void* context) {
         SPIMemSceneSavedFileMenuSubmenuIndexWrite,
         spi_mem_scene_saved_file_menu_submenu_callback,
         app);
+    submenu_add_item(
+        app->submenu,
+        "Write Changes",
+        SPIMemSceneSavedFileMenuSubmenuIndexWriteDiff,
+        spi_mem_scene_saved_file_menu_submenu_callback,
+        app);
     submenu_add_item(
         app->submenu,
         "Compare",
@@ -50,6 +57,13 @@ bool spi_mem_scene_saved_file_menu_on_event(void* context, SceneManagerEvent eve
         scene_manager_set_scene_state(app->scene_manager, SPIMemSceneSavedFileMenu, event.event);
         if(event.event == SPIMemSceneSavedFileMenuSubmenuIndexWrite) {
             app->mode = SPIMemModeWrite;
+            app->write_diff = false;
+            scene_manager_next_scene(app->scene_manager, SPIMemSceneChipDetect);
+            success = true;
+        }
+        if(event.event == SPIMemSceneSavedFileMenuSubmenuIndexWriteDiff) {
+            app->mode = SPIMemModeWrite;
+            app->write_diff = true;
             scene_manager_next_scene(app->scene_manager, SPIMemSceneChipDetect);
             success = true;
         }
@@ -57,6 +57,7 @@ struct SPIMemApp {
     SPIMemDetectView* view_detect;
     TextInput* text_input;
     SPIMemMode mode;
+    bool write_diff;
     char text_buffer[SPI_MEM_TEXT_BUFFER_SIZE + 1];
 };
 
@@ -44,6 +44,11 @@ bool spi_mem_file_open(SPIMemApp* app) {
     return true;
 }
 
+void spi_mem_file_preallocate(SPIMemApp* app, size_t size) {
+    // Only a hint for the file system, dump is written even if it fails
+    storage_file_preallocate(app->file, size);
+}
+
 bool spi_mem_file_write_block(SPIMemApp* app, uint8_t* data, size_t size) {
     if(storage_file_write(app->file, data, size) != size) return false;
     return true;
@@ -6,6 +6,7 @@ bool spi_mem_file_create(SPIMemApp* app, const char* file_name);
 bool spi_mem_file_delete(SPIMemApp* app);
 bool spi_mem_file_create_open(SPIMemApp* app);
 bool spi_mem_file_open(SPIMemApp* app);
+void spi_mem_file_preallocate(SPIMemApp* app, size_t size);
 bool spi_mem_file_write_block(SPIMemApp* app, uint8_t* data, size_t size);
 bool spi_mem_file_read_block(SPIMemApp* app, uint8_t* data, size_t size);
 void spi_mem_file_close(SPIMemApp* app);
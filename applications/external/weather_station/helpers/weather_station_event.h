@@ -11,4 +11,6 @@ typedef enum {
     WSCustomEventViewReceiverBack,
     WSCustomEventViewReceiverOffDisplay,
     WSCustomEventViewReceiverUnlock,
+
+    WSCustomEventViewReceiverInfoHistory,
 } WSCustomEvent;
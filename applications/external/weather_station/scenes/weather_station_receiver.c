@@ -74,8 +74,16 @@ static void weather_station_scene_receiver_add_to_history_callback(
     FuriString* str_buff;
     str_buff = furi_string_alloc();
 
-    if(ws_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
-       WSHistoryStateAddKeyNewDada) {
+    WSHistoryStateAddKey state =
+        ws_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset);
+    if((state == WSHistoryStateAddKeyNewDada) || (state == WSHistoryStateAddKeyUpdateData)) {
+        ws_series_add(
+            app->txrx->series,
+            ws_history_get_raw_data(
+                app->txrx->history, ws_history_get_last_index(app->txrx->history)));
+    }
+
+    if(state == WSHistoryStateAddKeyNewDada) {
         furi_string_reset(str_buff);
 
         ws_history_get_text_item_menu(
@@ -14,8 +14,16 @@ static void weather_station_scene_receiver_info_add_to_history_callback(
     furi_assert(context);
     WeatherStationApp* app = context;
 
-    if(ws_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset) ==
-       WSHistoryStateAddKeyUpdateData) {
+    WSHistoryStateAddKey state =
+        ws_history_add_to_history(app->txrx->history, decoder_base, app->txrx->preset);
+    if((state == WSHistoryStateAddKeyNewDada) || (state == WSHistoryStateAddKeyUpdateData)) {
+        ws_series_add(
+            app->txrx->series,
+            ws_history_get_raw_data(
+                app->txrx->history, ws_history_get_last_index(app->txrx->history)));
+    }
+
+    if(state == WSHistoryStateAddKeyUpdateData) {
         ws_view_receiver_info_update(
             app->ws_receiver_info,
             ws_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen));
@@ -26,9 +34,31 @@ static void weather_station_scene_receiver_info_add_to_history_callback(
     }
 }
 
+static void weather_station_scene_receiver_info_update_history(WeatherStationApp* app) {
+    WSSeriesPeriod period;
+    uint16_t page;
+    if(!ws_view_receiver_info_get_history_page(app->ws_receiver_info, &period, &page)) return;
+
+    WSSeriesKey key;
+    if(!ws_series_key_load(
+           &key, ws_history_get_raw_data(app->txrx->history, app->txrx->idx_menu_chosen))) {
+        return;
+    }
+
+    // Page 0 ends with the current period, every next one is older
+    WSSeriesRollup rollups[WS_RECEIVER_INFO_HISTORY_ROWS];
+    uint32_t rows = WS_RECEIVER_INFO_HISTORY_ROWS;
+    uint32_t from = furi_hal_rtc_get_timestamp() -
+                    (page * rows + rows - 1) * ws_series_get_period_duration(period);
+    ws_series_get_rollups(app->txrx->series, &key, period, from, rollups, rows);
+    ws_view_receiver_info_set_history(app->ws_receiver_info, rollups, rows);
+}
+
 void weather_station_scene_receiver_info_on_enter(void* context) {
     WeatherStationApp* app = context;
 
+    ws_view_receiver_info_set_callback(
+        app->ws_receiver_info, weather_station_scene_receiver_info_callback, app);
     subghz_receiver_set_rx_callback(
         app->txrx->receiver, weather_station_scene_receiver_info_add_to_history_callback, app);
     ws_view_receiver_info_update(
@@ -40,8 +70,12 @@ void weather_station_scene_receiver_info_on_enter(void* context) {
 bool weather_station_scene_receiver_info_on_event(void* context, SceneManagerEvent event) {
     WeatherStationApp* app = context;
     bool consumed = false;
-    UNUSED(app);
-    UNUSED(event);
+    if(event.type == SceneManagerEventTypeCustom) {
+        if(event.event == WSCustomEventViewReceiverInfoHistory) {
+            weather_station_scene_receiver_info_update_history(app);
+            consumed = true;
+        }
+    }
     return consumed;
 }
 
@@ -6,17 +6,39 @@
 #include <gui/elements.h>
 #include <float_tools.h>
 
+typedef enum {
+    WSReceiverInfoPageLive,
+    WSReceiverInfoPageHourly,
+    WSReceiverInfoPageDaily,
+} WSReceiverInfoPage;
+
 struct WSReceiverInfo {
     View* view;
     FuriTimer* timer;
+    WSReceiverInfoCallback callback;
+    void* context;
 };
 
 typedef struct {
     uint32_t curr_ts;
     FuriString* protocol_name;
     WSBlockGeneric* generic;
+    WSReceiverInfoPage page;
+    uint16_t history_page;
+    size_t history_count;
+    WSSeriesRollup history[WS_RECEIVER_INFO_HISTORY_ROWS];
 } WSReceiverInfoModel;
 
+void ws_view_receiver_info_set_callback(
+    WSReceiverInfo* ws_receiver_info,
+    WSReceiverInfoCallback callback,
+    void* context) {
+    furi_assert(ws_receiver_info);
+    furi_assert(callback);
+    ws_receiver_info->callback = callback;
+    ws_receiver_info->context = context;
+}
+
 void ws_view_receiver_info_update(WSReceiverInfo* ws_receiver_info, FlipperFormat* fff) {
     furi_assert(ws_receiver_info);
     furi_assert(fff);
@@ -37,12 +59,117 @@ void ws_view_receiver_info_update(WSReceiverInfo* ws_receiver_info, FlipperForma
         true);
 }
 
+bool ws_view_receiver_info_get_history_page(
+    WSReceiverInfo* ws_receiver_info,
+    WSSeriesPeriod* period,
+    uint16_t* page) {
+    furi_assert(ws_receiver_info);
+    bool history = false;
+    with_view_model(
+        ws_receiver_info->view,
+        WSReceiverInfoModel * model,
+        {
+            history = (model->page != WSReceiverInfoPageLive);
+            *period = (model->page == WSReceiverInfoPageDaily) ? WSSeriesPeriodDay :
+                                                                 WSSeriesPeriodHour;
+            *page = model->history_page;
+        },
+        false);
+    return history;
+}
+
+void ws_view_receiver_info_set_history(
+    WSReceiverInfo* ws_receiver_info,
+    const WSSeriesRollup* rollups,
+    size_t count) {
+    furi_assert(ws_receiver_info);
+    furi_assert(count <= WS_RECEIVER_INFO_HISTORY_ROWS);
+    with_view_model(
+        ws_receiver_info->view,
+        WSReceiverInfoModel * model,
+        {
+            memcpy(model->history, rollups, count * sizeof(WSSeriesRollup));
+            model->history_count = count;
+        },
+        true);
+}
+
+static void ws_view_receiver_info_get_date(uint32_t timestamp, uint8_t* day, uint8_t* month) {
+    // Days since epoch to civil date, March based year keeps leap day at the end
+    uint32_t days = timestamp / 86400 + 719468;
+    uint32_t day_of_era = days % 146097;
+    uint32_t year_of_era =
+        (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    uint32_t month_index = (5 * day_of_year + 2) / 153;
+    *day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    *month = (month_index < 10) ? month_index + 3 : month_index - 9;
+}
+
+static void ws_view_receiver_info_draw_temp(Canvas* canvas, uint8_t x, uint8_t y, float temp) {
+    char buffer[16];
+    if(furi_hal_rtc_get_locale_units() != FuriHalRtcLocaleUnitsMetric) {
+        temp = locale_celsius_to_fahrenheit(temp);
+    }
+    snprintf(buffer, sizeof(buffer), "%3.1f", (double)temp);
+    canvas_draw_str_aligned(canvas, x, y, AlignRight, AlignBottom, buffer);
+}
+
+static void ws_view_receiver_info_draw_history(Canvas* canvas, WSReceiverInfoModel* model) {
+    char buffer[16];
+    bool hourly = (model->page == WSReceiverInfoPageHourly);
+
+    canvas_draw_str(canvas, 0, 8, hourly ? "Hourly" : "Daily");
+    canvas_draw_str_aligned(canvas, 54, 8, AlignRight, AlignBottom, "Min");
+    canvas_draw_str_aligned(canvas, 80, 8, AlignRight, AlignBottom, "Avg");
+    canvas_draw_str_aligned(canvas, 106, 8, AlignRight, AlignBottom, "Max");
+    canvas_draw_str_aligned(canvas, 127, 8, AlignRight, AlignBottom, "Hum");
+    canvas_draw_line(canvas, 0, 10, 127, 10);
+
+    for(size_t i = 0; i < model->history_count; i++) {
+        const WSSeriesRollup* rollup = &model->history[i];
+        uint8_t y = 20 + i * 11;
+
+        if(hourly) {
+            snprintf(buffer, sizeof(buffer), "%02lu:00", (rollup->start % 86400) / 3600);
+        } else {
+            uint8_t day, month;
+            ws_view_receiver_info_get_date(rollup->start, &day, &month);
+            snprintf(buffer, sizeof(buffer), "%02u.%02u", day, month);
+        }
+        canvas_draw_str(canvas, 0, y, buffer);
+
+        if(rollup->temp_count) {
+            ws_view_receiver_info_draw_temp(canvas, 54, y, rollup->temp_min / 10.0f);
+            ws_view_receiver_info_draw_temp(
+                canvas, 80, y, rollup->temp_sum / 10.0f / rollup->temp_count);
+            ws_view_receiver_info_draw_temp(canvas, 106, y, rollup->temp_max / 10.0f);
+        } else {
+            canvas_draw_str_aligned(canvas, 80, y, AlignRight, AlignBottom, "--");
+        }
+
+        if(rollup->humidity_count) {
+            snprintf(
+                buffer,
+                sizeof(buffer),
+                "%lu%%",
+                rollup->humidity_sum / rollup->humidity_count);
+            canvas_draw_str_aligned(canvas, 127, y, AlignRight, AlignBottom, buffer);
+        }
+    }
+}
+
 void ws_view_receiver_info_draw(Canvas* canvas, WSReceiverInfoModel* model) {
     char buffer[64];
     canvas_clear(canvas);
     canvas_set_color(canvas, ColorBlack);
     canvas_set_font(canvas, FontSecondary);
 
+    if(model->page != WSReceiverInfoPageLive) {
+        ws_view_receiver_info_draw_history(canvas, model);
+        return;
+    }
+
     snprintf(
         buffer,
         sizeof(buffer),
@@ -150,11 +277,46 @@ void ws_view_receiver_info_draw(Canvas* canvas, WSReceiverInfoModel* model) {
 
 bool ws_view_receiver_info_input(InputEvent* event, void* context) {
     furi_assert(context);
-    //WSReceiverInfo* ws_receiver_info = context;
+    WSReceiverInfo* ws_receiver_info = context;
 
     if(event->key == InputKeyBack) {
         return false;
     }
+    if((event->type != InputTypeShort) && (event->type != InputTypeRepeat)) {
+        return true;
+    }
+
+    // Left and Right switch live data and history, Up and Down page through history
+    bool changed = false;
+    with_view_model(
+        ws_receiver_info->view,
+        WSReceiverInfoModel * model,
+        {
+            if((event->key == InputKeyRight) && (model->page < WSReceiverInfoPageDaily)) {
+                model->page++;
+                model->history_page = 0;
+                changed = true;
+            } else if((event->key == InputKeyLeft) && (model->page > WSReceiverInfoPageLive)) {
+                model->page--;
+                model->history_page = 0;
+                changed = true;
+            } else if(model->page != WSReceiverInfoPageLive) {
+                if((event->key == InputKeyUp) && (model->history_page < UINT16_MAX)) {
+                    model->history_page++;
+                    changed = true;
+                } else if((event->key == InputKeyDown) && (model->history_page > 0)) {
+                    model->history_page--;
+                    changed = true;
+                }
+            }
+            if(changed) model->history_count = 0;
+        },
+        changed);
+
+    if(changed && ws_receiver_info->callback) {
+        ws_receiver_info->callback(
+            WSCustomEventViewReceiverInfoHistory, ws_receiver_info->context);
+    }
 
     return true;
 }
@@ -175,7 +337,12 @@ static void ws_view_receiver_info_exit(void* context) {
     with_view_model(
         ws_receiver_info->view,
         WSReceiverInfoModel * model,
-        { furi_string_reset(model->protocol_name); },
+        {
+            furi_string_reset(model->protocol_name);
+            model->page = WSReceiverInfoPageLive;
+            model->history_page = 0;
+            model->history_count = 0;
+        },
         false);
 }
 
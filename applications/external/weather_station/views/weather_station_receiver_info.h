@@ -3,12 +3,45 @@
 #include <gui/view.h>
 #include "../helpers/weather_station_types.h"
 #include "../helpers/weather_station_event.h"
+#include "../weather_station_series.h"
 #include <lib/flipper_format/flipper_format.h>
 
+#define WS_RECEIVER_INFO_HISTORY_ROWS (5)
+
 typedef struct WSReceiverInfo WSReceiverInfo;
 
+typedef void (*WSReceiverInfoCallback)(WSCustomEvent event, void* context);
+
+void ws_view_receiver_info_set_callback(
+    WSReceiverInfo* ws_receiver_info,
+    WSReceiverInfoCallback callback,
+    void* context);
+
 void ws_view_receiver_info_update(WSReceiverInfo* ws_receiver_info, FlipperFormat* fff);
 
+/** Get history page shown by the view
+ *
+ * @param ws_receiver_info  - WSReceiverInfo instance
+ * @param period            - rollup period of the page
+ * @param page              - page number, 0 is the latest
+ * @return false if the view shows live data
+ */
+bool ws_view_receiver_info_get_history_page(
+    WSReceiverInfo* ws_receiver_info,
+    WSSeriesPeriod* period,
+    uint16_t* page);
+
+/** Set history page rows, oldest first
+ *
+ * @param ws_receiver_info  - WSReceiverInfo instance
+ * @param rollups           - rollups array
+ * @param count             - amount of rollups, up to WS_RECEIVER_INFO_HISTORY_ROWS
+ */
+void ws_view_receiver_info_set_history(
+    WSReceiverInfo* ws_receiver_info,
+    const WSSeriesRollup* rollups,
+    size_t count);
+
 WSReceiverInfo* ws_view_receiver_info_alloc();
 
 void ws_view_receiver_info_free(WSReceiverInfo* ws_receiver_info);
@@ -19,6 +19,7 @@ static bool weather_station_app_back_event_callback(void* context) {
 static void weather_station_app_tick_event_callback(void* context) {
     furi_assert(context);
     WeatherStationApp* app = context;
+    ws_series_process(app->txrx->series);
     scene_manager_handle_tick_event(app->scene_manager);
 }
 
@@ -92,6 +93,7 @@ WeatherStationApp* weather_station_app_alloc() {
 
     app->txrx->hopper_state = WSHopperStateOFF;
     app->txrx->history = ws_history_alloc();
+    app->txrx->series = ws_series_alloc();
     app->txrx->worker = subghz_worker_alloc();
     app->txrx->environment = subghz_environment_alloc();
     subghz_environment_set_protocol_registry(
@@ -145,6 +147,7 @@ void weather_station_app_free(WeatherStationApp* app) {
     subghz_receiver_free(app->txrx->receiver);
     subghz_environment_free(app->txrx->environment);
     ws_history_free(app->txrx->history);
+    ws_series_free(app->txrx->series);
     subghz_worker_free(app->txrx->worker);
     furi_string_free(app->txrx->preset->name);
     free(app->txrx->preset);
@@ -13,6 +13,7 @@
 #include "views/weather_station_receiver.h"
 #include "views/weather_station_receiver_info.h"
 #include "weather_station_history.h"
+#include "weather_station_series.h"
 
 #include <lib/subghz/subghz_setting.h>
 #include <lib/subghz/subghz_worker.h>
@@ -29,6 +30,7 @@ struct WeatherStationTxRx {
     SubGhzReceiver* receiver;
     SubGhzRadioPreset* preset;
     WSHistory* history;
+    WSSeries* series;
     uint16_t idx_menu_chosen;
     WSTxRxState txrx_state;
     WSHopperState hopper_state;
@@ -28,6 +28,7 @@ typedef struct {
 struct WSHistory {
     uint32_t last_update_timestamp;
     uint16_t last_index_write;
+    uint16_t last_index_update;
     uint8_t code_last_hash_data;
     FuriString* tmp_string;
     WSHistoryStruct* history;
@@ -88,6 +89,7 @@ void ws_history_reset(WSHistory* instance) {
         }
     WSHistoryItemArray_reset(instance->history->data);
     instance->last_index_write = 0;
+    instance->last_index_update = 0;
     instance->code_last_hash_data = 0;
 }
 
@@ -96,6 +98,11 @@ uint16_t ws_history_get_item(WSHistory* instance) {
     return instance->last_index_write;
 }
 
+uint16_t ws_history_get_last_index(WSHistory* instance) {
+    furi_assert(instance);
+    return instance->last_index_update;
+}
+
 uint8_t ws_history_get_type_protocol(WSHistory* instance, uint16_t idx) {
     furi_assert(instance);
     WSHistoryItem* item = WSHistoryItemArray_get(instance->history->data, idx);
@@ -181,6 +188,7 @@ WSHistoryStateAddKey
             Stream* flipper_string_stream = flipper_format_get_raw_stream(item->flipper_string);
             stream_clean(flipper_string_stream);
             subghz_protocol_decoder_base_serialize(decoder_base, item->flipper_string, preset);
+            instance->last_index_update = i;
             return WSHistoryStateAddKeyUpdateData;
         }
     }
@@ -238,6 +246,7 @@ WSHistoryStateAddKey
                 item->item_str, "%s %llX", furi_string_get_cstr(instance->tmp_string), data);
 
         } while(false);
+        instance->last_index_update = instance->last_index_write;
         instance->last_index_write++;
         return WSHistoryStateAddKeyNewDada;
     }
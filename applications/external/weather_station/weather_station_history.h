@@ -61,6 +61,13 @@ const char* ws_history_get_preset(WSHistory* instance, uint16_t idx);
  */
 uint16_t ws_history_get_item(WSHistory* instance);
 
+/** Get index of the record added or updated last
+ * 
+ * @param instance  - WSHistory instance
+ * @return idx      - record index  
+ */
+uint16_t ws_history_get_last_index(WSHistory* instance);
+
 /** Get type protocol to history[idx]
  * 
  * @param instance  - WSHistory instance
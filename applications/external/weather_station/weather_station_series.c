@@ -0,0 +1,763 @@
+#include "weather_station_series.h"
+#include "protocols/ws_generic.h"
+
+#include <storage/storage.h>
+#include <float_tools.h>
+#include <math.h>
+
+#define TAG "WSSeries"
+
+#define WS_SERIES_FOLDER APP_DATA_PATH("history")
+#define WS_SERIES_DATA_EXTENSION ".wsd"
+#define WS_SERIES_INDEX_EXTENSION ".wsi"
+
+#define WS_SERIES_BLOCK_SIZE (256)
+#define WS_SERIES_BLOCK_MAGIC (0x5357U) /* "WS" */
+#define WS_SERIES_INDEX_MAGIC (0x49535357UL) /* "WSSI" */
+#define WS_SERIES_INDEX_VERSION (1)
+
+#define WS_SERIES_HOURLY_MAX (24 * 31)
+#define WS_SERIES_DAILY_MAX (366)
+
+/** Sensors with open block kept in RAM */
+#define WS_SERIES_SENSORS_MAX (8)
+#define WS_SERIES_QUEUE_SIZE (16)
+#define WS_SERIES_SYNC_INTERVAL_MS (30000)
+
+/** Worst case of encoded reading: timestamp, temperature, humidity */
+#define WS_SERIES_POINT_BITS_MAX ((4 + 32) + (2 + 5 + 5 + 32) + (1 + 8))
+
+typedef struct {
+    uint16_t magic;
+    uint16_t count;
+    uint16_t bits;
+    uint16_t reserved;
+    uint32_t ts_first;
+    uint32_t ts_last;
+} WSSeriesBlockHeader;
+_Static_assert(sizeof(WSSeriesBlockHeader) == 16, "Incorrect WSSeriesBlockHeader size");
+
+#define WS_SERIES_BLOCK_PAYLOAD_SIZE (WS_SERIES_BLOCK_SIZE - sizeof(WSSeriesBlockHeader))
+#define WS_SERIES_BLOCK_PAYLOAD_BITS (WS_SERIES_BLOCK_PAYLOAD_SIZE * 8)
+
+typedef struct {
+    WSSeriesBlockHeader header;
+    uint8_t payload[WS_SERIES_BLOCK_PAYLOAD_SIZE];
+} WSSeriesBlock;
+_Static_assert(sizeof(WSSeriesBlock) == WS_SERIES_BLOCK_SIZE, "Incorrect WSSeriesBlock size");
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t hourly_max;
+    uint16_t daily_max;
+    uint16_t reserved;
+} WSSeriesIndexHeader;
+_Static_assert(sizeof(WSSeriesIndexHeader) == 12, "Incorrect WSSeriesIndexHeader size");
+_Static_assert(sizeof(WSSeriesRollup) == 24, "Incorrect WSSeriesRollup size");
+
+/** Encoder and decoder state, reset at the start of every block */
+typedef struct {
+    uint32_t timestamp;
+    uint32_t delta;
+    uint32_t temp;
+    uint8_t humidity;
+    uint8_t leading;
+    uint8_t trailing;
+    uint16_t bit;
+} WSSeriesCodec;
+
+typedef struct {
+    WSSeriesKey key;
+    bool used;
+    bool block_dirty;
+    bool rollup_dirty[2];
+    uint32_t block_index;
+    uint32_t last_timestamp;
+    uint32_t last_access;
+    WSSeriesCodec codec;
+    WSSeriesRollup rollup[2];
+    WSSeriesBlock block;
+} WSSeriesSensor;
+
+typedef struct {
+    WSSeriesKey key;
+    WSSeriesPoint point;
+} WSSeriesMessage;
+
+struct WSSeries {
+    Storage* storage;
+    File* file;
+    FuriMessageQueue* queue;
+    FuriString* path;
+    uint32_t last_sync;
+    uint32_t access;
+    WSSeriesSensor sensor[WS_SERIES_SENSORS_MAX];
+    WSSeriesBlock scratch;
+};
+
+static void ws_series_bits_write(uint8_t* data, uint16_t* bit, uint32_t value, uint8_t count) {
+    for(uint8_t i = count; i > 0; i--) {
+        uint8_t mask = 0x80 >> (*bit & 7);
+        if((value >> (i - 1)) & 1) {
+            data[*bit >> 3] |= mask;
+        } else {
+            data[*bit >> 3] &= ~mask;
+        }
+        (*bit)++;
+    }
+}
+
+static uint32_t ws_series_bits_read(const uint8_t* data, uint16_t* bit, uint8_t count) {
+    uint32_t value = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        // Broken block can't make us read past the payload
+        if(*bit >= WS_SERIES_BLOCK_PAYLOAD_BITS) return value;
+        value = (value << 1) | ((data[*bit >> 3] >> (7 - (*bit & 7))) & 1);
+        (*bit)++;
+    }
+    return value;
+}
+
+static uint32_t ws_series_sign_extend(uint32_t value, uint8_t bits) {
+    if(value & (1UL << (bits - 1))) value |= ~((1UL << bits) - 1);
+    return value;
+}
+
+static uint32_t ws_series_float_to_bits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float ws_series_bits_to_float(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void ws_series_encode_dod(uint8_t* data, uint16_t* bit, uint32_t dod) {
+    int32_t value = (int32_t)dod;
+    if(value == 0) {
+        ws_series_bits_write(data, bit, 0b0, 1);
+    } else if(value >= -64 && value <= 63) {
+        ws_series_bits_write(data, bit, 0b10, 2);
+        ws_series_bits_write(data, bit, dod, 7);
+    } else if(value >= -256 && value <= 255) {
+        ws_series_bits_write(data, bit, 0b110, 3);
+        ws_series_bits_write(data, bit, dod, 9);
+    } else if(value >= -2048 && value <= 2047) {
+        ws_series_bits_write(data, bit, 0b1110, 4);
+        ws_series_bits_write(data, bit, dod, 12);
+    } else {
+        ws_series_bits_write(data, bit, 0b1111, 4);
+        ws_series_bits_write(data, bit, dod, 32);
+    }
+}
+
+static uint32_t ws_series_decode_dod(const uint8_t* data, uint16_t* bit) {
+    if(!ws_series_bits_read(data, bit, 1)) return 0;
+    if(!ws_series_bits_read(data, bit, 1)) {
+        return ws_series_sign_extend(ws_series_bits_read(data, bit, 7), 7);
+    }
+    if(!ws_series_bits_read(data, bit, 1)) {
+        return ws_series_sign_extend(ws_series_bits_read(data, bit, 9), 9);
+    }
+    if(!ws_series_bits_read(data, bit, 1)) {
+        return ws_series_sign_extend(ws_series_bits_read(data, bit, 12), 12);
+    }
+    return ws_series_bits_read(data, bit, 32);
+}
+
+static void ws_series_encode_xor(WSSeriesCodec* codec, uint8_t* data, uint32_t value) {
+    uint32_t xor = value ^ codec->temp;
+    if(!xor) {
+        ws_series_bits_write(data, &codec->bit, 0b0, 1);
+        return;
+    }
+
+    uint8_t leading = __builtin_clz(xor);
+    uint8_t trailing = __builtin_ctz(xor);
+    if((codec->leading != UINT8_MAX) && (leading >= codec->leading) &&
+       (trailing >= codec->trailing)) {
+        // Meaningful bits fit into the previous window
+        ws_series_bits_write(data, &codec->bit, 0b10, 2);
+        ws_series_bits_write(
+            data, &codec->bit, xor >> codec->trailing, 32 - codec->leading - codec->trailing);
+    } else {
+        uint8_t length = 32 - leading - trailing;
+        ws_series_bits_write(data, &codec->bit, 0b11, 2);
+        ws_series_bits_write(data, &codec->bit, leading, 5);
+        ws_series_bits_write(data, &codec->bit, length - 1, 5);
+        ws_series_bits_write(data, &codec->bit, xor >> trailing, length);
+        codec->leading = leading;
+        codec->trailing = trailing;
+    }
+}
+
+static uint32_t ws_series_decode_xor(WSSeriesCodec* codec, const uint8_t* data) {
+    if(!ws_series_bits_read(data, &codec->bit, 1)) return codec->temp;
+
+    if(ws_series_bits_read(data, &codec->bit, 1)) {
+        codec->leading = ws_series_bits_read(data, &codec->bit, 5);
+        uint8_t length = ws_series_bits_read(data, &codec->bit, 5) + 1;
+        codec->trailing = MAX(32 - codec->leading - length, 0);
+    } else if(codec->leading == UINT8_MAX) {
+        // Broken block, there is no previous window
+        return codec->temp;
+    }
+    uint8_t length = 32 - codec->leading - codec->trailing;
+    return codec->temp ^ (ws_series_bits_read(data, &codec->bit, length) << codec->trailing);
+}
+
+static void ws_series_block_encode(
+    WSSeriesBlock* block,
+    WSSeriesCodec* codec,
+    const WSSeriesPoint* point) {
+    uint8_t* data = block->payload;
+    uint32_t temp = ws_series_float_to_bits(point->temp);
+
+    if(block->header.count == 0) {
+        block->header.ts_first = point->timestamp;
+        ws_series_bits_write(data, &codec->bit, temp, 32);
+        ws_series_bits_write(data, &codec->bit, point->humidity, 8);
+        codec->delta = 0;
+        codec->leading = UINT8_MAX;
+    } else {
+        uint32_t delta = point->timestamp - codec->timestamp;
+        ws_series_encode_dod(data, &codec->bit, delta - codec->delta);
+        ws_series_encode_xor(codec, data, temp);
+        if(point->humidity == codec->humidity) {
+            ws_series_bits_write(data, &codec->bit, 0b0, 1);
+        } else {
+            ws_series_bits_write(data, &codec->bit, 0b1, 1);
+            ws_series_bits_write(data, &codec->bit, point->humidity ^ codec->humidity, 8);
+        }
+        codec->delta = delta;
+    }
+
+    codec->timestamp = point->timestamp;
+    codec->temp = temp;
+    codec->humidity = point->humidity;
+
+    block->header.count++;
+    block->header.bits = codec->bit;
+    block->header.ts_last = point->timestamp;
+}
+
+static void ws_series_block_decode(
+    const WSSeriesBlock* block,
+    WSSeriesCodec* codec,
+    uint16_t index,
+    WSSeriesPoint* point) {
+    const uint8_t* data = block->payload;
+
+    if(index == 0) {
+        memset(codec, 0, sizeof(WSSeriesCodec));
+        codec->timestamp = block->header.ts_first;
+        codec->temp = ws_series_bits_read(data, &codec->bit, 32);
+        codec->humidity = ws_series_bits_read(data, &codec->bit, 8);
+        codec->leading = UINT8_MAX;
+    } else {
+        codec->delta += ws_series_decode_dod(data, &codec->bit);
+        codec->timestamp += codec->delta;
+        codec->temp = ws_series_decode_xor(codec, data);
+        if(ws_series_bits_read(data, &codec->bit, 1)) {
+            codec->humidity ^= ws_series_bits_read(data, &codec->bit, 8);
+        }
+    }
+
+    point->timestamp = codec->timestamp;
+    point->temp = ws_series_bits_to_float(codec->temp);
+    point->humidity = codec->humidity;
+}
+
+static bool ws_series_block_is_valid(const WSSeriesBlockHeader* header) {
+    return (header->magic == WS_SERIES_BLOCK_MAGIC) && (header->count > 0) &&
+           (header->bits <= WS_SERIES_BLOCK_PAYLOAD_BITS);
+}
+
+static void ws_series_block_reset(WSSeriesSensor* sensor) {
+    memset(&sensor->block, 0, sizeof(WSSeriesBlock));
+    memset(&sensor->codec, 0, sizeof(WSSeriesCodec));
+    sensor->block.header.magic = WS_SERIES_BLOCK_MAGIC;
+}
+
+static void ws_series_get_path(WSSeries* instance, const WSSeriesKey* key, const char* extension) {
+    furi_string_printf(instance->path, "%s/", WS_SERIES_FOLDER);
+    for(const char* c = key->protocol; *c; c++) {
+        bool keep = (*c >= '0' && *c <= '9') || (*c >= 'A' && *c <= 'Z') ||
+                    (*c >= 'a' && *c <= 'z') || (*c == '-');
+        furi_string_push_back(instance->path, keep ? *c : '_');
+    }
+    furi_string_cat_printf(instance->path, "_%08lX_%02X%s", key->id, key->channel, extension);
+}
+
+uint32_t ws_series_get_period_duration(WSSeriesPeriod period) {
+    return (period == WSSeriesPeriodHour) ? 3600 : 86400;
+}
+
+static uint32_t ws_series_rollup_offset(WSSeriesPeriod period, uint32_t start) {
+    uint32_t slot = start / ws_series_get_period_duration(period);
+    if(period == WSSeriesPeriodHour) {
+        slot %= WS_SERIES_HOURLY_MAX;
+    } else {
+        slot = WS_SERIES_HOURLY_MAX + slot % WS_SERIES_DAILY_MAX;
+    }
+    return sizeof(WSSeriesIndexHeader) + slot * sizeof(WSSeriesRollup);
+}
+
+/** Open index file of the sensor, create it if asked to write */
+static bool ws_series_index_open(WSSeries* instance, const WSSeriesKey* key, bool write) {
+    ws_series_get_path(instance, key, WS_SERIES_INDEX_EXTENSION);
+    const char* path = furi_string_get_cstr(instance->path);
+    bool result = false;
+
+    do {
+        if(!storage_file_open(
+               instance->file,
+               path,
+               write ? FSAM_READ_WRITE : FSAM_READ,
+               write ? FSOM_OPEN_ALWAYS : FSOM_OPEN_EXISTING)) {
+            break;
+        }
+
+        WSSeriesIndexHeader header = {0};
+        size_t size = storage_file_read(instance->file, &header, sizeof(header));
+        if((size == sizeof(header)) && (header.magic == WS_SERIES_INDEX_MAGIC) &&
+           (header.version == WS_SERIES_INDEX_VERSION) &&
+           (header.hourly_max == WS_SERIES_HOURLY_MAX) &&
+           (header.daily_max == WS_SERIES_DAILY_MAX)) {
+            result = true;
+            break;
+        }
+        if(!write) break;
+
+        // New or foreign index: every slot must start empty
+        FURI_LOG_I(TAG, "Creating %s", path);
+        header.magic = WS_SERIES_INDEX_MAGIC;
+        header.version = WS_SERIES_INDEX_VERSION;
+        header.hourly_max = WS_SERIES_HOURLY_MAX;
+        header.daily_max = WS_SERIES_DAILY_MAX;
+        header.reserved = 0;
+        if(!storage_file_seek(instance->file, 0, true)) break;
+        if(!storage_file_truncate(instance->file)) break;
+        if(storage_file_write(instance->file, &header, sizeof(header)) != sizeof(header)) break;
+
+        memset(&instance->scratch, 0, sizeof(WSSeriesBlock));
+        size_t left = (WS_SERIES_HOURLY_MAX + WS_SERIES_DAILY_MAX) * sizeof(WSSeriesRollup);
+        while(left) {
+            size_t chunk = MIN(left, sizeof(WSSeriesBlock));
+            if(storage_file_write(instance->file, &instance->scratch, chunk) != chunk) break;
+            left -= chunk;
+        }
+        result = (left == 0);
+    } while(false);
+
+    if(!result) storage_file_close(instance->file);
+    return result;
+}
+
+static bool ws_series_rollup_read(
+    WSSeries* instance,
+    WSSeriesPeriod period,
+    uint32_t start,
+    WSSeriesRollup* rollup) {
+    WSSeriesRollup stored = {0};
+    bool result =
+        storage_file_seek(instance->file, ws_series_rollup_offset(period, start), true) &&
+        (storage_file_read(instance->file, &stored, sizeof(stored)) == sizeof(stored)) &&
+        (stored.start == start);
+
+    if(result) {
+        *rollup = stored;
+    } else {
+        memset(rollup, 0, sizeof(WSSeriesRollup));
+        rollup->start = start;
+    }
+    return result;
+}
+
+static void ws_series_sensor_flush(WSSeries* instance, WSSeriesSensor* sensor) {
+    if(sensor->block_dirty) {
+        ws_series_get_path(instance, &sensor->key, WS_SERIES_DATA_EXTENSION);
+        // Only the last block is ever rewritten, sealed blocks stay as they are
+        if(storage_file_open(
+               instance->file,
+               furi_string_get_cstr(instance->path),
+               FSAM_WRITE,
+               FSOM_OPEN_ALWAYS) &&
+           storage_file_seek(instance->file, sensor->block_index * WS_SERIES_BLOCK_SIZE, true) &&
+           (storage_file_write(instance->file, &sensor->block, WS_SERIES_BLOCK_SIZE) ==
+            WS_SERIES_BLOCK_SIZE)) {
+            sensor->block_dirty = false;
+        } else {
+            FURI_LOG_E(TAG, "Block write failed: %s", furi_string_get_cstr(instance->path));
+        }
+        storage_file_close(instance->file);
+    }
+
+    if(sensor->rollup_dirty[WSSeriesPeriodHour] || sensor->rollup_dirty[WSSeriesPeriodDay]) {
+        if(ws_series_index_open(instance, &sensor->key, true)) {
+            for(size_t period = 0; period < COUNT_OF(sensor->rollup); period++) {
+                if(!sensor->rollup_dirty[period]) continue;
+                WSSeriesRollup* rollup = &sensor->rollup[period];
+                if(storage_file_seek(
+                       instance->file, ws_series_rollup_offset(period, rollup->start), true) &&
+                   (storage_file_write(instance->file, rollup, sizeof(WSSeriesRollup)) ==
+                    sizeof(WSSeriesRollup))) {
+                    sensor->rollup_dirty[period] = false;
+                }
+            }
+            storage_file_close(instance->file);
+        }
+        if(sensor->rollup_dirty[WSSeriesPeriodHour] || sensor->rollup_dirty[WSSeriesPeriodDay]) {
+            FURI_LOG_E(TAG, "Index write failed: %s", furi_string_get_cstr(instance->path));
+        }
+    }
+}
+
+static void
+    ws_series_sensor_load(WSSeries* instance, WSSeriesSensor* sensor, const WSSeriesKey* key) {
+    memset(sensor, 0, sizeof(WSSeriesSensor));
+    sensor->key = *key;
+    sensor->used = true;
+    ws_series_block_reset(sensor);
+
+    ws_series_get_path(instance, key, WS_SERIES_DATA_EXTENSION);
+    if(storage_file_open(
+           instance->file, furi_string_get_cstr(instance->path), FSAM_READ, FSOM_OPEN_EXISTING)) {
+        // Partially written block at the end is overwritten by the next one
+        uint32_t block_count = storage_file_size(instance->file) / WS_SERIES_BLOCK_SIZE;
+        sensor->block_index = block_count;
+        if(block_count &&
+           storage_file_seek(instance->file, (block_count - 1) * WS_SERIES_BLOCK_SIZE, true) &&
+           (storage_file_read(instance->file, &sensor->block, WS_SERIES_BLOCK_SIZE) ==
+            WS_SERIES_BLOCK_SIZE) &&
+           ws_series_block_is_valid(&sensor->block.header)) {
+            sensor->last_timestamp = sensor->block.header.ts_last;
+            // Decoding whole block restores encoder state
+            WSSeriesPoint point;
+            for(uint16_t i = 0; i < sensor->block.header.count; i++) {
+                ws_series_block_decode(&sensor->block, &sensor->codec, i, &point);
+            }
+            if((sensor->codec.bit == sensor->block.header.bits) &&
+               (sensor->codec.bit + WS_SERIES_POINT_BITS_MAX <= WS_SERIES_BLOCK_PAYLOAD_BITS)) {
+                sensor->block_index = block_count - 1;
+            } else {
+                ws_series_block_reset(sensor);
+            }
+        } else {
+            ws_series_block_reset(sensor);
+        }
+        FURI_LOG_D(
+            TAG,
+            "Opened %s, block %lu",
+            furi_string_get_cstr(instance->path),
+            sensor->block_index);
+    }
+    storage_file_close(instance->file);
+}
+
+static WSSeriesSensor* ws_series_sensor_get(WSSeries* instance, const WSSeriesKey* key) {
+    WSSeriesSensor* victim = &instance->sensor[0];
+    for(size_t i = 0; i < WS_SERIES_SENSORS_MAX; i++) {
+        WSSeriesSensor* sensor = &instance->sensor[i];
+        if(sensor->used && (sensor->key.id == key->id) &&
+           (sensor->key.channel == key->channel) &&
+           (strcmp(sensor->key.protocol, key->protocol) == 0)) {
+            sensor->last_access = ++instance->access;
+            return sensor;
+        }
+        if(!sensor->used) {
+            victim = sensor;
+        } else if(victim->used && (sensor->last_access < victim->last_access)) {
+            victim = sensor;
+        }
+    }
+
+    if(victim->used) ws_series_sensor_flush(instance, victim);
+    ws_series_sensor_load(instance, victim, key);
+    victim->last_access = ++instance->access;
+    return victim;
+}
+
+static void ws_series_sensor_rollup_add(
+    WSSeries* instance,
+    WSSeriesSensor* sensor,
+    WSSeriesPeriod period,
+    const WSSeriesPoint* point) {
+    WSSeriesRollup* rollup = &sensor->rollup[period];
+    uint32_t start = point->timestamp - point->timestamp % ws_series_get_period_duration(period);
+
+    if(rollup->start != start) {
+        // Period changed: write the old one, continue the stored one if any
+        ws_series_sensor_flush(instance, sensor);
+        if(ws_series_index_open(instance, &sensor->key, false)) {
+            ws_series_rollup_read(instance, period, start, rollup);
+            storage_file_close(instance->file);
+        } else {
+            memset(rollup, 0, sizeof(WSSeriesRollup));
+            rollup->start = start;
+        }
+    }
+
+    if(!float_is_equal(point->temp, WS_NO_TEMPERATURE) && (rollup->temp_count < UINT16_MAX)) {
+        int16_t temp = CLAMP(roundf(point->temp * 10.0f), (float)INT16_MAX, (float)INT16_MIN);
+        if(rollup->temp_count == 0) {
+            rollup->temp_min = temp;
+            rollup->temp_max = temp;
+        } else {
+            rollup->temp_min = MIN(rollup->temp_min, temp);
+            rollup->temp_max = MAX(rollup->temp_max, temp);
+        }
+        rollup->temp_sum += temp;
+        rollup->temp_count++;
+    }
+
+    if((point->humidity != WS_NO_HUMIDITY) && (rollup->humidity_count < UINT16_MAX)) {
+        if(rollup->humidity_count == 0) {
+            rollup->humidity_min = point->humidity;
+            rollup->humidity_max = point->humidity;
+        } else {
+            rollup->humidity_min = MIN(rollup->humidity_min, point->humidity);
+            rollup->humidity_max = MAX(rollup->humidity_max, point->humidity);
+        }
+        rollup->humidity_sum += point->humidity;
+        rollup->humidity_count++;
+    }
+
+    sensor->rollup_dirty[period] = true;
+}
+
+static void ws_series_append(WSSeries* instance, const WSSeriesMessage* message) {
+    WSSeriesSensor* sensor = ws_series_sensor_get(instance, &message->key);
+    const WSSeriesPoint* point = &message->point;
+
+    // Blocks are searched by time, so the log must stay ordered
+    if(point->timestamp < sensor->last_timestamp) {
+        FURI_LOG_W(TAG, "Reading is older than the last one, skipped");
+        return;
+    }
+
+    if(sensor->codec.bit + WS_SERIES_POINT_BITS_MAX > WS_SERIES_BLOCK_PAYLOAD_BITS) {
+        ws_series_sensor_flush(instance, sensor);
+        sensor->block_index++;
+        ws_series_block_reset(sensor);
+    }
+
+    ws_series_block_encode(&sensor->block, &sensor->codec, point);
+    sensor->block_dirty = true;
+    sensor->last_timestamp = point->timestamp;
+
+    ws_series_sensor_rollup_add(instance, sensor, WSSeriesPeriodHour, point);
+    ws_series_sensor_rollup_add(instance, sensor, WSSeriesPeriodDay, point);
+}
+
+WSSeries* ws_series_alloc(void) {
+    WSSeries* instance = malloc(sizeof(WSSeries));
+    instance->storage = furi_record_open(RECORD_STORAGE);
+    instance->file = storage_file_alloc(instance->storage);
+    instance->queue = furi_message_queue_alloc(WS_SERIES_QUEUE_SIZE, sizeof(WSSeriesMessage));
+    instance->path = furi_string_alloc();
+    instance->last_sync = furi_get_tick();
+
+    storage_simply_mkdir(instance->storage, WS_SERIES_FOLDER);
+    return instance;
+}
+
+void ws_series_free(WSSeries* instance) {
+    furi_assert(instance);
+    ws_series_sync(instance);
+
+    furi_string_free(instance->path);
+    furi_message_queue_free(instance->queue);
+    storage_file_free(instance->file);
+    furi_record_close(RECORD_STORAGE);
+    free(instance);
+}
+
+bool ws_series_key_load(WSSeriesKey* key, FlipperFormat* fff) {
+    furi_assert(key);
+    furi_assert(fff);
+
+    bool result = false;
+    FuriString* protocol = furi_string_alloc();
+    uint32_t temp_data = 0;
+
+    do {
+        if(!flipper_format_rewind(fff)) {
+            FURI_LOG_E(TAG, "Rewind error");
+            break;
+        }
+        if(!flipper_format_read_string(fff, "Protocol", protocol)) {
+            FURI_LOG_E(TAG, "Missing Protocol");
+            break;
+        }
+        if(!flipper_format_read_uint32(fff, "Id", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Missing Id");
+            break;
+        }
+        key->id = temp_data;
+        if(!flipper_format_read_uint32(fff, "Ch", &temp_data, 1)) {
+            FURI_LOG_E(TAG, "Missing Channel");
+            break;
+        }
+        key->channel = temp_data;
+        strlcpy(key->protocol, furi_string_get_cstr(protocol), sizeof(key->protocol));
+        result = true;
+    } while(false);
+
+    furi_string_free(protocol);
+    return result;
+}
+
+bool ws_series_add(WSSeries* instance, FlipperFormat* fff) {
+    furi_assert(instance);
+    furi_assert(fff);
+
+    WSSeriesMessage message = {0};
+    WSBlockGeneric generic = {0};
+    if(!ws_series_key_load(&message.key, fff)) return false;
+    if(ws_block_generic_deserialize(&generic, fff) != SubGhzProtocolStatusOk) return false;
+    if(float_is_equal(generic.temp, WS_NO_TEMPERATURE) && (generic.humidity == WS_NO_HUMIDITY)) {
+        return false;
+    }
+
+    message.point.timestamp = generic.timestamp;
+    message.point.temp = generic.temp;
+    message.point.humidity = generic.humidity;
+    if(furi_message_queue_put(instance->queue, &message, 0) != FuriStatusOk) {
+        FURI_LOG_W(TAG, "Queue is full, reading dropped");
+        return false;
+    }
+    return true;
+}
+
+static void ws_series_flush(WSSeries* instance) {
+    for(size_t i = 0; i < WS_SERIES_SENSORS_MAX; i++) {
+        if(instance->sensor[i].used) ws_series_sensor_flush(instance, &instance->sensor[i]);
+    }
+    instance->last_sync = furi_get_tick();
+}
+
+void ws_series_process(WSSeries* instance) {
+    furi_assert(instance);
+
+    WSSeriesMessage message;
+    while(furi_message_queue_get(instance->queue, &message, 0) == FuriStatusOk) {
+        ws_series_append(instance, &message);
+    }
+
+    if(furi_get_tick() - instance->last_sync >= furi_ms_to_ticks(WS_SERIES_SYNC_INTERVAL_MS)) {
+        ws_series_flush(instance);
+    }
+}
+
+void ws_series_sync(WSSeries* instance) {
+    furi_assert(instance);
+
+    WSSeriesMessage message;
+    while(furi_message_queue_get(instance->queue, &message, 0) == FuriStatusOk) {
+        ws_series_append(instance, &message);
+    }
+    ws_series_flush(instance);
+}
+
+size_t ws_series_get_points(
+    WSSeries* instance,
+    const WSSeriesKey* key,
+    uint32_t from,
+    uint32_t to,
+    WSSeriesPoint* points,
+    size_t max) {
+    furi_assert(instance);
+    furi_assert(key);
+    furi_assert(points);
+
+    ws_series_sync(instance);
+
+    size_t count = 0;
+    ws_series_get_path(instance, key, WS_SERIES_DATA_EXTENSION);
+    do {
+        if(!storage_file_open(
+               instance->file,
+               furi_string_get_cstr(instance->path),
+               FSAM_READ,
+               FSOM_OPEN_EXISTING)) {
+            break;
+        }
+        uint32_t block_count = storage_file_size(instance->file) / WS_SERIES_BLOCK_SIZE;
+
+        // Blocks are ordered by time: find the first one that ends after from
+        WSSeriesBlockHeader* header = &instance->scratch.header;
+        uint32_t low = 0;
+        uint32_t high = block_count;
+        while(low < high) {
+            uint32_t middle = low + (high - low) / 2;
+            if(!storage_file_seek(instance->file, middle * WS_SERIES_BLOCK_SIZE, true) ||
+               (storage_file_read(instance->file, header, sizeof(WSSeriesBlockHeader)) !=
+                sizeof(WSSeriesBlockHeader))) {
+                break;
+            }
+            if(ws_series_block_is_valid(header) && (header->ts_last >= from)) {
+                high = middle;
+            } else {
+                low = middle + 1;
+            }
+        }
+
+        WSSeriesCodec codec;
+        WSSeriesPoint point;
+        for(uint32_t block = low; (block < block_count) && (count < max); block++) {
+            if(!storage_file_seek(instance->file, block * WS_SERIES_BLOCK_SIZE, true) ||
+               (storage_file_read(instance->file, &instance->scratch, WS_SERIES_BLOCK_SIZE) !=
+                WS_SERIES_BLOCK_SIZE)) {
+                break;
+            }
+            if(!ws_series_block_is_valid(header)) continue;
+            if(header->ts_first >= to) break;
+
+            for(uint16_t i = 0; (i < header->count) && (count < max); i++) {
+                ws_series_block_decode(&instance->scratch, &codec, i, &point);
+                if(point.timestamp >= to) break;
+                if(point.timestamp >= from) points[count++] = point;
+            }
+        }
+    } while(false);
+    storage_file_close(instance->file);
+
+    return count;
+}
+
+size_t ws_series_get_rollups(
+    WSSeries* instance,
+    const WSSeriesKey* key,
+    WSSeriesPeriod period,
+    uint32_t from,
+    WSSeriesRollup* rollups,
+    size_t count) {
+    furi_assert(instance);
+    furi_assert(key);
+    furi_assert(rollups);
+
+    ws_series_sync(instance);
+
+    uint32_t duration = ws_series_get_period_duration(period);
+    uint32_t start = from - from % duration;
+    bool index_open = ws_series_index_open(instance, key, false);
+
+    size_t found = 0;
+    for(size_t i = 0; i < count; i++) {
+        if(index_open && ws_series_rollup_read(instance, period, start, &rollups[i])) {
+            found++;
+        } else {
+            memset(&rollups[i], 0, sizeof(WSSeriesRollup));
+            rollups[i].start = start;
+        }
+        start += duration;
+    }
+
+    if(index_open) storage_file_close(instance->file);
+    return found;
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <furi.h>
+#include <lib/flipper_format/flipper_format.h>
+
+/** Sensor history on SD card
+ *
+ * Every sensor has its own append-only data file made of fixed size blocks.
+ * Block keeps readings compressed: timestamps as delta-of-delta, temperature
+ * and humidity XOR-ed with the previous value. Only the last block of a sensor
+ * is kept in RAM and rewritten in place until it is full.
+ *
+ * Hourly and daily min/max/avg rollups are kept in a separate index file,
+ * slot of the period is its number modulo ring size, so no scan is needed.
+ */
+
+#define WS_SERIES_PROTOCOL_LEN (24)
+
+typedef struct WSSeries WSSeries;
+
+/** Sensor identity */
+typedef struct {
+    char protocol[WS_SERIES_PROTOCOL_LEN];
+    uint32_t id;
+    uint8_t channel;
+} WSSeriesKey;
+
+/** Single reading */
+typedef struct {
+    uint32_t timestamp;
+    float temp;
+    uint8_t humidity;
+} WSSeriesPoint;
+
+/** Rollup period */
+typedef enum {
+    WSSeriesPeriodHour,
+    WSSeriesPeriodDay,
+} WSSeriesPeriod;
+
+/** Rollup of one period, temperature is in 0.1 C, no data if count is 0 */
+typedef struct {
+    uint32_t start;
+    int32_t temp_sum;
+    uint32_t humidity_sum;
+    uint16_t temp_count;
+    int16_t temp_min;
+    int16_t temp_max;
+    uint16_t humidity_count;
+    uint8_t humidity_min;
+    uint8_t humidity_max;
+    uint16_t reserved;
+} WSSeriesRollup;
+
+/** Allocate WSSeries
+ *
+ * @return WSSeries*
+ */
+WSSeries* ws_series_alloc(void);
+
+/** Free WSSeries, pending readings are written
+ *
+ * @param instance - WSSeries instance
+ */
+void ws_series_free(WSSeries* instance);
+
+/** Fill sensor key from serialized decoder
+ *
+ * @param key       - WSSeriesKey output
+ * @param fff       - FlipperFormat with serialized decoder
+ * @return true on success
+ */
+bool ws_series_key_load(WSSeriesKey* key, FlipperFormat* fff);
+
+/** Queue reading, safe to call from receiver callback, no storage access
+ *
+ * @param instance  - WSSeries instance
+ * @param fff       - FlipperFormat with serialized decoder
+ * @return true if reading is queued
+ */
+bool ws_series_add(WSSeries* instance, FlipperFormat* fff);
+
+/** Write queued readings into sensor blocks, flush them periodically
+ *
+ * @param instance  - WSSeries instance
+ */
+void ws_series_process(WSSeries* instance);
+
+/** Write queued readings and flush everything to storage
+ *
+ * @param instance  - WSSeries instance
+ */
+void ws_series_sync(WSSeries* instance);
+
+/** Get readings in range, oldest first. Next page starts after last timestamp.
+ *
+ * @param instance  - WSSeries instance
+ * @param key       - sensor key
+ * @param from      - first timestamp, inclusive
+ * @param to        - last timestamp, exclusive
+ * @param points    - output array
+ * @param max       - output array size
+ * @return amount of readings
+ */
+size_t ws_series_get_points(
+    WSSeries* instance,
+    const WSSeriesKey* key,
+    uint32_t from,
+    uint32_t to,
+    WSSeriesPoint* points,
+    size_t max);
+
+/** Get consecutive rollups, starting with the period that includes from
+ *
+ * @param instance  - WSSeries instance
+ * @param key       - sensor key
+ * @param period    - WSSeriesPeriod
+ * @param from      - timestamp inside of the first period
+ * @param rollups   - output array, one item for each period
+ * @param count     - amount of periods
+ * @return amount of periods with data
+ */
+size_t ws_series_get_rollups(
+    WSSeries* instance,
+    const WSSeriesKey* key,
+    WSSeriesPeriod period,
+    uint32_t from,
+    WSSeriesRollup* rollups,
+    size_t count);
+
+/** Get period duration
+ *
+ * @param period    - WSSeriesPeriod
+ * @return duration in seconds
+ */
+uint32_t ws_series_get_period_duration(WSSeriesPeriod period);
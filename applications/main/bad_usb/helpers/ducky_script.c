@@ -12,9 +12,6 @@
 #define TAG "BadUSB"
 #define WORKER_TAG TAG "Worker"
 
-#define BADUSB_ASCII_TO_KEY(script, x) \
-    (((uint8_t)x < 128) ? (script->layout[(uint8_t)x]) : HID_KEYBOARD_NONE)
-
 typedef enum {
     WorkerEvtToggle = (1 << 0),
     WorkerEvtEnd = (1 << 1),
@@ -70,56 +67,16 @@ bool ducky_get_number(const char* param, uint32_t* val) {
     return false;
 }
 
-void ducky_numlock_on() {
+static void ducky_numlock_on() {
     if((furi_hal_hid_get_led_state() & HID_KB_LED_NUM) == 0) {
         furi_hal_hid_kb_press(HID_KEYBOARD_LOCK_NUM_LOCK);
         furi_hal_hid_kb_release(HID_KEYBOARD_LOCK_NUM_LOCK);
     }
 }
-bool ducky_numpad_press(const char num) {
-    if((num < '0') || (num > '9')) return false;
-
-    uint16_t key = numpad_keys[num - '0'];
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release(key);
-
-    return true;
-}
-
-bool ducky_altchar(const char* charcode) {
-    uint8_t i = 0;
-    bool state = false;
-
-    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT);
-
-    while(!ducky_is_line_end(charcode[i])) {
-        state = ducky_numpad_press(charcode[i]);
-        if(state == false) break;
-        i++;
-    }
-
-    furi_hal_hid_kb_release(KEY_MOD_LEFT_ALT);
-    return state;
-}
-
-bool ducky_altstring(const char* param) {
-    uint32_t i = 0;
-    bool state = false;
-
-    while(param[i] != '\0') {
-        if((param[i] < ' ') || (param[i] > '~')) {
-            i++;
-            continue; // Skip non-printable chars
-        }
-
-        char temp_str[4];
-        snprintf(temp_str, 4, "%u", param[i]);
 
-        state = ducky_altchar(temp_str);
-        if(state == false) break;
-        i++;
-    }
-    return state;
+uint16_t ducky_get_numpad_key(const char num) {
+    if((num < '0') || (num > '9')) return HID_KEYBOARD_NONE;
+    return numpad_keys[num - '0'];
 }
 
 int32_t ducky_error(BadUsbScript* bad_usb, const char* text, ...) {
@@ -132,77 +89,115 @@ int32_t ducky_error(BadUsbScript* bad_usb, const char* text, ...) {
     return SCRIPT_STATE_ERROR;
 }
 
-bool ducky_string(BadUsbScript* bad_usb, const char* param) {
-    uint32_t i = 0;
-
-    while(param[i] != '\0') {
-        if(param[i] != '\n') {
-            uint16_t keycode = BADUSB_ASCII_TO_KEY(bad_usb, param[i]);
-            if(keycode != HID_KEYBOARD_NONE) {
-                furi_hal_hid_kb_press(keycode);
-                furi_hal_hid_kb_release(keycode);
-            }
-        } else {
-            furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-            furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
-        }
-        i++;
+static void ducky_press_keys(const uint16_t* keys, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        furi_hal_hid_kb_press(keys[i]);
+        furi_hal_hid_kb_release(keys[i]);
     }
-    bad_usb->stringdelay = 0;
-    return true;
 }
 
 static bool ducky_string_next(BadUsbScript* bad_usb) {
-    if(bad_usb->string_print_pos >= furi_string_size(bad_usb->string_print)) {
+    if(bad_usb->string_print_pos >= bad_usb->string_print_end) {
         return true;
     }
 
-    char print_char = furi_string_get_char(bad_usb->string_print, bad_usb->string_print_pos);
-
-    if(print_char != '\n') {
-        uint16_t keycode = BADUSB_ASCII_TO_KEY(bad_usb, print_char);
-        if(keycode != HID_KEYBOARD_NONE) {
-            furi_hal_hid_kb_press(keycode);
-            furi_hal_hid_kb_release(keycode);
-        }
-    } else {
-        furi_hal_hid_kb_press(HID_KEYBOARD_RETURN);
-        furi_hal_hid_kb_release(HID_KEYBOARD_RETURN);
-    }
-
+    ducky_press_keys(&bad_usb->program->pool[bad_usb->string_print_pos], 1);
     bad_usb->string_print_pos++;
 
     return false;
 }
 
-static int32_t ducky_parse_line(BadUsbScript* bad_usb, FuriString* line) {
-    uint32_t line_len = furi_string_size(line);
-    const char* line_tmp = furi_string_get_cstr(line);
-
-    if(line_len == 0) {
-        return SCRIPT_STATE_NEXT_LINE; // Skip empty lines
+static int32_t
+    ducky_execute_instr(BadUsbScript* bad_usb, const DuckyInstr* instr, int32_t* delay_val) {
+    const uint16_t* pool = bad_usb->program->pool;
+
+    switch(instr->op) {
+    case DuckyOpError:
+        return SCRIPT_STATE_ERROR;
+    case DuckyOpDelay:
+        *delay_val = instr->value;
+        break;
+    case DuckyOpDefaultDelay:
+        bad_usb->defdelay = instr->value;
+        break;
+    case DuckyOpStringDelay:
+        bad_usb->stringdelay = instr->value;
+        break;
+    case DuckyOpString:
+        if(bad_usb->stringdelay == 0) { // stringdelay not set - run command immidiately
+            ducky_press_keys(&pool[instr->value], instr->key);
+        } else { // stringdelay is set - run command in thread to keep handling external events
+            bad_usb->string_print_pos = instr->value;
+            bad_usb->string_print_end = instr->value + instr->key;
+            return SCRIPT_STATE_STRING_START;
+        }
+        break;
+    case DuckyOpRepeat:
+        bad_usb->repeat_cnt = instr->value;
+        bad_usb->repeat_start = instr->key;
+        break;
+    case DuckyOpKey:
+        furi_hal_hid_kb_press(instr->key);
+        furi_hal_hid_kb_release(instr->key);
+        break;
+    case DuckyOpSysrq:
+        furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
+        furi_hal_hid_kb_press(instr->key);
+        furi_hal_hid_kb_release_all();
+        break;
+    case DuckyOpNumlock:
+        ducky_numlock_on();
+        break;
+    case DuckyOpAltCode:
+        furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT);
+        ducky_press_keys(&pool[instr->value], instr->key);
+        furi_hal_hid_kb_release(KEY_MOD_LEFT_ALT);
+        break;
+    case DuckyOpHold:
+        bad_usb->key_hold_nb++;
+        if(bad_usb->key_hold_nb > (HID_KB_MAX_KEYS - 1)) {
+            return ducky_error(bad_usb, "Too many keys are hold");
+        }
+        furi_hal_hid_kb_press(instr->key);
+        break;
+    case DuckyOpRelease:
+        if(bad_usb->key_hold_nb == 0) {
+            return ducky_error(bad_usb, "No keys are hold");
+        }
+        bad_usb->key_hold_nb--;
+        furi_hal_hid_kb_release(instr->key);
+        break;
+    case DuckyOpWaitForButton:
+        return SCRIPT_STATE_WAIT_FOR_BTN;
+    default:
+        break;
     }
-    FURI_LOG_D(WORKER_TAG, "line:%s", line_tmp);
 
-    // Ducky Lang Functions
-    int32_t cmd_result = ducky_execute_cmd(bad_usb, line_tmp);
-    if(cmd_result != SCRIPT_STATE_CMD_UNKNOWN) {
-        return cmd_result;
-    }
+    return 0;
+}
+
+static int32_t ducky_execute_line(BadUsbScript* bad_usb, size_t* pc) {
+    const DuckyInstr* instr = bad_usb->program->instr;
+    const DuckyInstr* line = &instr[*pc];
+    furi_assert(line->op == DuckyOpLine);
 
-    // Special keys + modifiers
-    uint16_t key = ducky_get_keycode(bad_usb, line_tmp, false);
-    if(key == HID_KEYBOARD_NONE) {
-        return ducky_error(bad_usb, "No keycode defined for %s", line_tmp);
+    int32_t delay_val = 0;
+    int32_t result = 0;
+    size_t i = *pc + 1;
+    for(; (instr[i].op != DuckyOpLine) && (instr[i].op != DuckyOpEnd); i++) {
+        if(result == 0) {
+            result = ducky_execute_instr(bad_usb, &instr[i], &delay_val);
+        }
     }
-    if((key & 0xFF00) != 0) {
-        // It's a modifier key
-        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
-        key |= ducky_get_keycode(bad_usb, line_tmp, true);
+    *pc = i;
+
+    if(result != 0) {
+        return result;
+    } else if(line->flags & DuckyLineFlagNoDefaultDelay) {
+        return 0;
+    } else {
+        return (delay_val + bad_usb->defdelay);
     }
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release(key);
-    return 0;
 }
 
 static bool ducky_set_usb_id(BadUsbScript* bad_usb, const char* line) {
@@ -275,73 +270,48 @@ static bool ducky_script_preload(BadUsbScript* bad_usb, File* script_file) {
     return true;
 }
 
+static void ducky_script_start(BadUsbScript* bad_usb, File* script_file) {
+    bad_usb->st.line_cur = 0;
+    bad_usb->defdelay = 0;
+    bad_usb->stringdelay = 0;
+    bad_usb->repeat_cnt = 0;
+    bad_usb->key_hold_nb = 0;
+
+    if(bad_usb->program->valid && bad_usb->program->whole_script) {
+        bad_usb->pc = 0; // Whole script is already compiled
+    } else {
+        ducky_compile_chunk(bad_usb, script_file, true);
+    }
+}
+
 static int32_t ducky_script_execute_next(BadUsbScript* bad_usb, File* script_file) {
+    DuckyProgram* program = bad_usb->program;
     int32_t delay_val = 0;
 
     if(bad_usb->repeat_cnt > 0) {
         bad_usb->repeat_cnt--;
-        delay_val = ducky_parse_line(bad_usb, bad_usb->line_prev);
-        if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-            return 0;
-        } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
-            return delay_val;
-        } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
-            return delay_val;
-        } else if(delay_val < 0) { // Script error
+        size_t pc = bad_usb->repeat_start;
+        delay_val = ducky_execute_line(bad_usb, &pc);
+        if(delay_val == SCRIPT_STATE_ERROR) { // Script error
             bad_usb->st.error_line = bad_usb->st.line_cur - 1;
             FURI_LOG_E(WORKER_TAG, "Unknown command at line %u", bad_usb->st.line_cur - 1U);
-            return SCRIPT_STATE_ERROR;
-        } else {
-            return (delay_val + bad_usb->defdelay);
         }
+        return delay_val;
     }
 
-    furi_string_set(bad_usb->line_prev, bad_usb->line);
-    furi_string_reset(bad_usb->line);
-
-    while(1) {
-        if(bad_usb->buf_len == 0) {
-            bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
-            if(storage_file_eof(script_file)) {
-                if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
-                    bad_usb->file_buf[bad_usb->buf_len] = '\n';
-                    bad_usb->buf_len++;
-                    bad_usb->file_end = true;
-                }
-            }
-
-            bad_usb->buf_start = 0;
-            if(bad_usb->buf_len == 0) return SCRIPT_STATE_END;
-        }
-        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
-            if(bad_usb->file_buf[i] == '\n' && furi_string_size(bad_usb->line) > 0) {
-                bad_usb->st.line_cur++;
-                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
-                bad_usb->buf_start = i + 1;
-                furi_string_trim(bad_usb->line);
-                delay_val = ducky_parse_line(bad_usb, bad_usb->line);
-                if(delay_val == SCRIPT_STATE_NEXT_LINE) { // Empty line
-                    return 0;
-                } else if(delay_val == SCRIPT_STATE_STRING_START) { // Print string with delays
-                    return delay_val;
-                } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // wait for button
-                    return delay_val;
-                } else if(delay_val < 0) {
-                    bad_usb->st.error_line = bad_usb->st.line_cur;
-                    FURI_LOG_E(WORKER_TAG, "Unknown command at line %u", bad_usb->st.line_cur);
-                    return SCRIPT_STATE_ERROR;
-                } else {
-                    return (delay_val + bad_usb->defdelay);
-                }
-            } else {
-                furi_string_push_back(bad_usb->line, bad_usb->file_buf[i]);
-            }
-        }
-        bad_usb->buf_len = 0;
-        if(bad_usb->file_end) return SCRIPT_STATE_END;
+    while(program->instr[bad_usb->pc].op == DuckyOpEnd) {
+        if(program->instr[bad_usb->pc].value) return SCRIPT_STATE_END;
+        // Compile next part of the script
+        ducky_compile_chunk(bad_usb, script_file, false);
     }
 
-    return 0;
+    bad_usb->st.line_cur++;
+    delay_val = ducky_execute_line(bad_usb, &bad_usb->pc);
+    if(delay_val == SCRIPT_STATE_ERROR) {
+        bad_usb->st.error_line = bad_usb->st.line_cur;
+        FURI_LOG_E(WORKER_TAG, "Unknown command at line %u", bad_usb->st.line_cur);
+    }
+    return delay_val;
 }
 
 static void bad_usb_hid_state_callback(bool state, void* context) {
@@ -378,7 +348,6 @@ static int32_t bad_usb_worker(void* context) {
     File* script_file = storage_file_alloc(furi_record_open(RECORD_STORAGE));
     bad_usb->line = furi_string_alloc();
     bad_usb->line_prev = furi_string_alloc();
-    bad_usb->string_print = furi_string_alloc();
 
     furi_hal_hid_set_state_callback(bad_usb_hid_state_callback, bad_usb);
 
@@ -426,14 +395,7 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtToggle) { // Start executing script
                 DOLPHIN_DEED(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
-                bad_usb->st.line_cur = 0;
-                bad_usb->defdelay = 0;
-                bad_usb->stringdelay = 0;
-                bad_usb->repeat_cnt = 0;
-                bad_usb->key_hold_nb = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                ducky_script_start(bad_usb, script_file);
                 worker_state = BadUsbStateRunning;
             } else if(flags & WorkerEvtDisconnect) {
                 worker_state = BadUsbStateNotConnected; // USB disconnected
@@ -449,13 +411,7 @@ static int32_t bad_usb_worker(void* context) {
             } else if(flags & WorkerEvtConnect) { // Start executing script
                 DOLPHIN_DEED(DolphinDeedBadUsbPlayScript);
                 delay_val = 0;
-                bad_usb->buf_len = 0;
-                bad_usb->st.line_cur = 0;
-                bad_usb->defdelay = 0;
-                bad_usb->stringdelay = 0;
-                bad_usb->repeat_cnt = 0;
-                bad_usb->file_end = false;
-                storage_file_seek(script_file, 0, true);
+                ducky_script_start(bad_usb, script_file);
                 // extra time for PC to recognize Flipper as keyboard
                 flags = furi_thread_flags_wait(
                     WorkerEvtEnd | WorkerEvtDisconnect | WorkerEvtToggle,
@@ -513,7 +469,6 @@ static int32_t bad_usb_worker(void* context) {
                     continue;
                 } else if(delay_val == SCRIPT_STATE_STRING_START) { // Start printing string with delays
                     delay_val = bad_usb->defdelay;
-                    bad_usb->string_print_pos = 0;
                     worker_state = BadUsbStateStringDelay;
                 } else if(delay_val == SCRIPT_STATE_WAIT_FOR_BTN) { // set state to wait for user input
                     worker_state = BadUsbStateWaitForBtn;
@@ -589,7 +544,6 @@ static int32_t bad_usb_worker(void* context) {
     storage_file_free(script_file);
     furi_string_free(bad_usb->line);
     furi_string_free(bad_usb->line_prev);
-    furi_string_free(bad_usb->string_print);
 
     FURI_LOG_I(WORKER_TAG, "End");
 
@@ -609,6 +563,7 @@ BadUsbScript* bad_usb_script_open(FuriString* file_path) {
     bad_usb->file_path = furi_string_alloc();
     furi_string_set(bad_usb->file_path, file_path);
     bad_usb_script_set_default_keyboard_layout(bad_usb);
+    bad_usb->program = ducky_program_alloc();
 
     bad_usb->st.state = BadUsbStateInit;
     bad_usb->st.error[0] = '\0';
@@ -624,6 +579,7 @@ void bad_usb_script_close(BadUsbScript* bad_usb) {
     furi_thread_join(bad_usb->thread);
     furi_thread_free(bad_usb->thread);
     furi_string_free(bad_usb->file_path);
+    ducky_program_free(bad_usb->program);
     free(bad_usb);
 }
 
@@ -643,10 +599,13 @@ void bad_usb_script_set_keyboard_layout(BadUsbScript* bad_usb, FuriString* layou
             if(storage_file_read(layout_file, layout, sizeof(layout)) == sizeof(layout)) {
                 memcpy(bad_usb->layout, layout, sizeof(layout));
             }
+            // Strings are compiled with layout applied
+            bad_usb->program->valid = false;
         }
         storage_file_close(layout_file);
     } else {
         bad_usb_script_set_default_keyboard_layout(bad_usb);
+        bad_usb->program->valid = false;
     }
     storage_file_free(layout_file);
 }
@@ -18,7 +18,8 @@ static int32_t ducky_fnc_delay(BadUsbScript* bad_usb, const char* line, int32_t
     uint32_t delay_val = 0;
     bool state = ducky_get_number(line, &delay_val);
     if((state) && (delay_val > 0)) {
-        return (int32_t)delay_val;
+        ducky_emit(bad_usb, DuckyOpDelay, 0, delay_val);
+        return 0;
     }
 
     return ducky_error(bad_usb, "Invalid number %s", line);
@@ -28,10 +29,12 @@ static int32_t ducky_fnc_defdelay(BadUsbScript* bad_usb, const char* line, int32
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_usb->defdelay);
+    uint32_t delay_val = 0;
+    bool state = ducky_get_number(line, &delay_val);
     if(!state) {
         return ducky_error(bad_usb, "Invalid number %s", line);
     }
+    ducky_emit(bad_usb, DuckyOpDefaultDelay, 0, delay_val);
     return 0;
 }
 
@@ -39,29 +42,41 @@ static int32_t ducky_fnc_strdelay(BadUsbScript* bad_usb, const char* line, int32
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_usb->stringdelay);
+    uint32_t delay_val = 0;
+    bool state = ducky_get_number(line, &delay_val);
     if(!state) {
         return ducky_error(bad_usb, "Invalid number %s", line);
     }
+    ducky_emit(bad_usb, DuckyOpStringDelay, 0, delay_val);
     return 0;
 }
 
 static int32_t ducky_fnc_string(BadUsbScript* bad_usb, const char* line, int32_t param) {
     line = &line[ducky_get_command_len(line) + 1];
-    furi_string_set_str(bad_usb->string_print, line);
-    if(param == 1) {
-        furi_string_cat(bad_usb->string_print, "\n");
+    size_t len = strlen(line);
+    if(param == 1) len++;
+    if(len > UINT16_MAX) {
+        return ducky_error(bad_usb, "String is too long");
     }
 
-    if(bad_usb->stringdelay == 0) { // stringdelay not set - run command immidiately
-        bool state = ducky_string(bad_usb, furi_string_get_cstr(bad_usb->string_print));
-        if(!state) {
-            return ducky_error(bad_usb, "Invalid string %s", line);
+    uint32_t offset = 0;
+    uint16_t* keys = ducky_emit_pool(bad_usb, len, &offset);
+    if(!keys) return 0;
+
+    // Characters without keycode in the current layout are dropped here
+    size_t key_nb = 0;
+    for(size_t i = 0; line[i] != '\0'; i++) {
+        uint16_t keycode = BADUSB_ASCII_TO_KEY(bad_usb, line[i]);
+        if(keycode != HID_KEYBOARD_NONE) {
+            keys[key_nb++] = keycode;
         }
-    } else { // stringdelay is set - run command in thread to keep handling external events
-        return SCRIPT_STATE_STRING_START;
     }
+    if(param == 1) {
+        keys[key_nb++] = HID_KEYBOARD_RETURN;
+    }
+    bad_usb->program->pool_size -= len - key_nb;
 
+    ducky_emit(bad_usb, DuckyOpString, key_nb, offset);
     return 0;
 }
 
@@ -69,10 +84,17 @@ static int32_t ducky_fnc_repeat(BadUsbScript* bad_usb, const char* line, int32_t
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    bool state = ducky_get_number(line, &bad_usb->repeat_cnt);
-    if((!state) || (bad_usb->repeat_cnt == 0)) {
+    uint32_t repeat_cnt = 0;
+    bool state = ducky_get_number(line, &repeat_cnt);
+    if((!state) || (repeat_cnt == 0)) {
         return ducky_error(bad_usb, "Invalid number %s", line);
     }
+
+    // REPEAT after REPEAT repeats the same line again
+    bad_usb->program->line_is_repeat = true;
+    if(bad_usb->program->repeat_target != SIZE_MAX) {
+        ducky_emit(bad_usb, DuckyOpRepeat, bad_usb->program->repeat_target, repeat_cnt);
+    }
     return 0;
 }
 
@@ -81,18 +103,35 @@ static int32_t ducky_fnc_sysrq(BadUsbScript* bad_usb, const char* line, int32_t
 
     line = &line[ducky_get_command_len(line) + 1];
     uint16_t key = ducky_get_keycode(bad_usb, line, true);
-    furi_hal_hid_kb_press(KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
-    furi_hal_hid_kb_press(key);
-    furi_hal_hid_kb_release_all();
+    ducky_emit(bad_usb, DuckyOpSysrq, key, 0);
     return 0;
 }
 
+static bool ducky_altchar(BadUsbScript* bad_usb, const char* charcode) {
+    size_t len = 0;
+    while(!ducky_is_line_end(charcode[len])) {
+        if(ducky_get_numpad_key(charcode[len]) == HID_KEYBOARD_NONE) return false;
+        len++;
+    }
+    if(len == 0) return false;
+
+    uint32_t offset = 0;
+    uint16_t* keys = ducky_emit_pool(bad_usb, len, &offset);
+    if(keys) {
+        for(size_t i = 0; i < len; i++) {
+            keys[i] = ducky_get_numpad_key(charcode[i]);
+        }
+        ducky_emit(bad_usb, DuckyOpAltCode, len, offset);
+    }
+    return true;
+}
+
 static int32_t ducky_fnc_altchar(BadUsbScript* bad_usb, const char* line, int32_t param) {
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    ducky_numlock_on();
-    bool state = ducky_altchar(line);
+    ducky_emit(bad_usb, DuckyOpNumlock, 0, 0);
+    bool state = ducky_altchar(bad_usb, line);
     if(!state) {
         return ducky_error(bad_usb, "Invalid altchar %s", line);
     }
@@ -103,8 +142,18 @@ static int32_t ducky_fnc_altstring(BadUsbScript* bad_usb, const char* line, int3
     UNUSED(param);
 
     line = &line[ducky_get_command_len(line) + 1];
-    ducky_numlock_on();
-    bool state = ducky_altstring(line);
+    ducky_emit(bad_usb, DuckyOpNumlock, 0, 0);
+    bool state = false;
+    for(size_t i = 0; line[i] != '\0'; i++) {
+        if((line[i] < ' ') || (line[i] > '~')) {
+            continue; // Skip non-printable chars
+        }
+
+        char temp_str[4];
+        snprintf(temp_str, 4, "%u", line[i]);
+
+        state = ducky_altchar(bad_usb, temp_str);
+    }
     if(!state) {
         return ducky_error(bad_usb, "Invalid altstring %s", line);
     }
@@ -119,11 +168,7 @@ static int32_t ducky_fnc_hold(BadUsbScript* bad_usb, const char* line, int32_t p
     if(key == HID_KEYBOARD_NONE) {
         return ducky_error(bad_usb, "No keycode defined for %s", line);
     }
-    bad_usb->key_hold_nb++;
-    if(bad_usb->key_hold_nb > (HID_KB_MAX_KEYS - 1)) {
-        return ducky_error(bad_usb, "Too many keys are hold");
-    }
-    furi_hal_hid_kb_press(key);
+    ducky_emit(bad_usb, DuckyOpHold, key, 0);
     return 0;
 }
 
@@ -135,20 +180,16 @@ static int32_t ducky_fnc_release(BadUsbScript* bad_usb, const char* line, int32_
     if(key == HID_KEYBOARD_NONE) {
         return ducky_error(bad_usb, "No keycode defined for %s", line);
     }
-    if(bad_usb->key_hold_nb == 0) {
-        return ducky_error(bad_usb, "No keys are hold");
-    }
-    bad_usb->key_hold_nb--;
-    furi_hal_hid_kb_release(key);
+    ducky_emit(bad_usb, DuckyOpRelease, key, 0);
     return 0;
 }
 
 static int32_t ducky_fnc_waitforbutton(BadUsbScript* bad_usb, const char* line, int32_t param) {
     UNUSED(param);
-    UNUSED(bad_usb);
     UNUSED(line);
 
-    return SCRIPT_STATE_WAIT_FOR_BTN;
+    ducky_emit(bad_usb, DuckyOpWaitForButton, 0, 0);
+    return 0;
 }
 
 static const DuckyCmd ducky_commands[] = {
@@ -171,10 +212,7 @@ static const DuckyCmd ducky_commands[] = {
     {"WAIT_FOR_BUTTON_PRESS", ducky_fnc_waitforbutton, -1},
 };
 
-#define TAG "BadUSB"
-#define WORKER_TAG TAG "Worker"
-
-int32_t ducky_execute_cmd(BadUsbScript* bad_usb, const char* line) {
+int32_t ducky_compile_cmd(BadUsbScript* bad_usb, const char* line) {
     for(size_t i = 0; i < COUNT_OF(ducky_commands); i++) {
         if(strncmp(line, ducky_commands[i].name, strlen(ducky_commands[i].name)) == 0) {
             if(ducky_commands[i].callback == NULL) {
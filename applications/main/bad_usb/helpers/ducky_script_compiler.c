@@ -0,0 +1,236 @@
+#include <furi.h>
+#include <furi_hal.h>
+#include <furi_hal_usb_hid.h>
+#include <storage/storage.h>
+#include "ducky_script.h"
+#include "ducky_script_i.h"
+
+#define TAG "BadUSB"
+#define WORKER_TAG TAG "Worker"
+
+DuckyProgram* ducky_program_alloc() {
+    DuckyProgram* program = malloc(sizeof(DuckyProgram));
+    program->instr_max = DUCKY_PROGRAM_INSTR_MAX;
+    program->pool_max = DUCKY_PROGRAM_POOL_MAX;
+    program->instr = malloc(program->instr_max * sizeof(DuckyInstr));
+    program->pool = malloc(program->pool_max * sizeof(uint16_t));
+    return program;
+}
+
+void ducky_program_free(DuckyProgram* program) {
+    furi_assert(program);
+    free(program->instr);
+    free(program->pool);
+    free(program);
+}
+
+static void ducky_program_resize(DuckyProgram* program, size_t instr_max, size_t pool_max) {
+    if(program->instr_max != instr_max) {
+        program->instr_max = instr_max;
+        program->instr = realloc(program->instr, instr_max * sizeof(DuckyInstr)); //-V701
+    }
+    if(program->pool_max != pool_max) {
+        program->pool_max = pool_max;
+        program->pool = realloc(program->pool, pool_max * sizeof(uint16_t)); //-V701
+    }
+}
+
+DuckyInstr* ducky_emit(BadUsbScript* bad_usb, DuckyOp op, uint16_t key, uint32_t value) {
+    DuckyProgram* program = bad_usb->program;
+    // Last slot is kept for DuckyOpEnd
+    if(program->instr_count >= program->instr_max - 1) {
+        if(!program->may_grow) {
+            program->overflow = true;
+            return NULL;
+        }
+        ducky_program_resize(program, program->instr_max * 2, program->pool_max);
+    }
+
+    DuckyInstr* instr = &program->instr[program->instr_count++];
+    instr->op = op;
+    instr->flags = 0;
+    instr->key = key;
+    instr->value = value;
+    return instr;
+}
+
+uint16_t* ducky_emit_pool(BadUsbScript* bad_usb, size_t size, uint32_t* offset) {
+    DuckyProgram* program = bad_usb->program;
+    if(program->pool_size + size > program->pool_max) {
+        if(!program->may_grow) {
+            program->overflow = true;
+            return NULL;
+        }
+        ducky_program_resize(
+            program, program->instr_max, MAX(program->pool_max * 2, program->pool_size + size));
+    }
+
+    *offset = program->pool_size;
+    program->pool_size += size;
+    return &program->pool[*offset];
+}
+
+static bool ducky_script_read_line(BadUsbScript* bad_usb, File* script_file) {
+    furi_string_reset(bad_usb->line);
+
+    while(1) {
+        if(bad_usb->buf_len == 0) {
+            bad_usb->buf_len = storage_file_read(script_file, bad_usb->file_buf, FILE_BUFFER_LEN);
+            if(storage_file_eof(script_file)) {
+                if((bad_usb->buf_len < FILE_BUFFER_LEN) && (bad_usb->file_end == false)) {
+                    bad_usb->file_buf[bad_usb->buf_len] = '\n';
+                    bad_usb->buf_len++;
+                    bad_usb->file_end = true;
+                }
+            }
+
+            bad_usb->buf_start = 0;
+            if(bad_usb->buf_len == 0) return false;
+        }
+        for(uint8_t i = bad_usb->buf_start; i < (bad_usb->buf_start + bad_usb->buf_len); i++) {
+            if(bad_usb->file_buf[i] == '\n' && furi_string_size(bad_usb->line) > 0) {
+                bad_usb->buf_len = bad_usb->buf_len + bad_usb->buf_start - (i + 1);
+                bad_usb->buf_start = i + 1;
+                furi_string_trim(bad_usb->line);
+                return true;
+            } else {
+                furi_string_push_back(bad_usb->line, bad_usb->file_buf[i]);
+            }
+        }
+        bad_usb->buf_len = 0;
+        if(bad_usb->file_end) return false;
+    }
+}
+
+static int32_t ducky_compile_line(BadUsbScript* bad_usb, FuriString* line) {
+    const char* line_tmp = furi_string_get_cstr(line);
+    bad_usb->program->line_is_repeat = false;
+
+    DuckyInstr* line_instr = ducky_emit(bad_usb, DuckyOpLine, 0, 0);
+    if(furi_string_size(line) == 0) {
+        // Empty line takes no default delay
+        if(line_instr) line_instr->flags = DuckyLineFlagNoDefaultDelay;
+        return 0;
+    }
+
+    // Ducky Lang Functions
+    int32_t cmd_result = ducky_compile_cmd(bad_usb, line_tmp);
+    if(cmd_result != SCRIPT_STATE_CMD_UNKNOWN) {
+        return cmd_result;
+    }
+
+    // Special keys + modifiers
+    uint16_t key = ducky_get_keycode(bad_usb, line_tmp, false);
+    if(key == HID_KEYBOARD_NONE) {
+        return ducky_error(bad_usb, "No keycode defined for %s", line_tmp);
+    }
+    if((key & 0xFF00) != 0) {
+        // It's a modifier key
+        line_tmp = &line_tmp[ducky_get_command_len(line_tmp) + 1];
+        key |= ducky_get_keycode(bad_usb, line_tmp, true);
+    }
+    ducky_emit(bad_usb, DuckyOpKey, key, 0);
+    return 0;
+}
+
+/** Compile line, growing the program only when the line doesn't fit into an empty one */
+static int32_t ducky_compile_line_fit(BadUsbScript* bad_usb, FuriString* line, size_t first) {
+    DuckyProgram* program = bad_usb->program;
+    size_t line_start = program->instr_count;
+    size_t pool_start = program->pool_size;
+
+    int32_t result = ducky_compile_line(bad_usb, line);
+    if(program->overflow && (line_start == first)) {
+        program->instr_count = line_start;
+        program->pool_size = pool_start;
+        program->overflow = false;
+        program->may_grow = true;
+        result = ducky_compile_line(bad_usb, line);
+        program->may_grow = false;
+    }
+    return result;
+}
+
+void ducky_compile_chunk(BadUsbScript* bad_usb, File* script_file, bool from_start) {
+    DuckyProgram* program = bad_usb->program;
+    // Give back memory taken by the long line of the previous chunk
+    ducky_program_resize(program, DUCKY_PROGRAM_INSTR_MAX, DUCKY_PROGRAM_POOL_MAX);
+    program->instr_count = 0;
+    program->pool_size = 0;
+    program->overflow = false;
+    program->repeat_target = SIZE_MAX;
+    program->whole_script = from_start;
+    program->valid = true;
+
+    if(from_start) {
+        storage_file_seek(script_file, 0, true);
+        bad_usb->buf_len = 0;
+        bad_usb->file_end = false;
+        bad_usb->line_pending = false;
+        furi_string_reset(bad_usb->line_prev);
+    } else if(!furi_string_empty(bad_usb->line_prev)) {
+        // Previous line goes first, so REPEAT at the start of the chunk has its target
+        ducky_compile_line_fit(bad_usb, bad_usb->line_prev, 0);
+        program->repeat_target = 0;
+    }
+    bad_usb->pc = program->instr_count;
+
+    bool script_end = false;
+    while(1) {
+        if(!bad_usb->line_pending) {
+            if(!ducky_script_read_line(bad_usb, script_file)) {
+                script_end = true;
+                break;
+            }
+            bad_usb->line_pending = true;
+        }
+
+        size_t line_start = program->instr_count;
+        size_t pool_start = program->pool_size;
+        int32_t result = ducky_compile_line_fit(bad_usb, bad_usb->line, bad_usb->pc);
+
+        if((result == SCRIPT_STATE_ERROR) || program->overflow) {
+            program->instr_count = line_start;
+            program->pool_size = pool_start;
+            if(result != SCRIPT_STATE_ERROR) {
+                // Line will start the next chunk
+                program->overflow = false;
+                program->whole_script = false;
+                break;
+            }
+
+            // Execution stops on this line, nothing to compile after it
+            program->overflow = false;
+            ducky_emit(bad_usb, DuckyOpLine, 0, 0);
+            ducky_emit(bad_usb, DuckyOpError, 0, 0);
+            if(program->overflow) {
+                program->instr_count = line_start;
+                program->overflow = false;
+                program->whole_script = false;
+                break;
+            }
+            FURI_LOG_D(WORKER_TAG, "Compile error: %s", bad_usb->st.error);
+            bad_usb->line_pending = false;
+            script_end = true;
+            break;
+        }
+        bad_usb->line_pending = false;
+
+        if(!program->line_is_repeat) {
+            program->repeat_target = line_start;
+            furi_string_set(bad_usb->line_prev, bad_usb->line);
+        }
+    }
+
+    DuckyInstr* end = &program->instr[program->instr_count++];
+    end->op = DuckyOpEnd;
+    end->flags = 0;
+    end->key = 0;
+    end->value = script_end;
+
+    FURI_LOG_D(
+        WORKER_TAG,
+        "Compiled %zu instructions, %zu pool",
+        program->instr_count,
+        program->pool_size);
+}
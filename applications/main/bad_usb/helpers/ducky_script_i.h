@@ -6,16 +6,69 @@ extern "C" {
 
 #include <furi.h>
 #include <furi_hal.h>
+#include <storage/storage.h>
 #include "ducky_script.h"
 
 #define SCRIPT_STATE_ERROR (-1)
 #define SCRIPT_STATE_END (-2)
-#define SCRIPT_STATE_NEXT_LINE (-3)
 #define SCRIPT_STATE_CMD_UNKNOWN (-4)
 #define SCRIPT_STATE_STRING_START (-5)
 #define SCRIPT_STATE_WAIT_FOR_BTN (-6)
 
-#define FILE_BUFFER_LEN 16
+#define FILE_BUFFER_LEN 64
+
+#define BADUSB_ASCII_TO_KEY(script, x) \
+    (((uint8_t)x < 128) ? (script->layout[(uint8_t)x]) : HID_KEYBOARD_NONE)
+
+#define DUCKY_PROGRAM_INSTR_MAX 512
+#define DUCKY_PROGRAM_POOL_MAX 2048
+
+typedef enum {
+    DuckyOpLine, /**< Start of script line, flags: DuckyLineFlag */
+    DuckyOpEnd, /**< End of compiled chunk, value: end of script */
+    DuckyOpError, /**< Compile error, text is in BadUsbState */
+    DuckyOpDelay, /**< value: delay */
+    DuckyOpDefaultDelay, /**< value: delay */
+    DuckyOpStringDelay, /**< value: delay */
+    DuckyOpString, /**< value: pool offset, key: length */
+    DuckyOpRepeat, /**< value: count, key: start of the repeated line */
+    DuckyOpKey, /**< key: keycode with modifiers */
+    DuckyOpSysrq, /**< key: keycode */
+    DuckyOpNumlock,
+    DuckyOpAltCode, /**< value: pool offset, key: length */
+    DuckyOpHold, /**< key: keycode */
+    DuckyOpRelease, /**< key: keycode */
+    DuckyOpWaitForButton,
+} DuckyOp;
+
+typedef enum {
+    DuckyLineFlagNoDefaultDelay = (1 << 0),
+} DuckyLineFlag;
+
+typedef struct {
+    uint8_t op;
+    uint8_t flags;
+    uint16_t key;
+    uint32_t value;
+} DuckyInstr;
+
+/** Compiled part of the script, keycodes are already mapped with the keyboard layout.
+ * Pool holds keycodes for strings and numpad keycodes for alt codes.
+ * Arrays only grow past the default size for a line that doesn't fit otherwise. */
+typedef struct {
+    DuckyInstr* instr;
+    uint16_t* pool;
+    size_t instr_max;
+    size_t pool_max;
+    size_t instr_count;
+    size_t pool_size;
+    bool overflow;
+    bool may_grow;
+    bool line_is_repeat;
+    size_t repeat_target;
+    bool whole_script; /**< Compiled from the start of the file till its end */
+    bool valid;
+} DuckyProgram;
 
 struct BadUsbScript {
     FuriHalUsbHidConfig hid_cfg;
@@ -32,13 +85,18 @@ struct BadUsbScript {
     uint32_t stringdelay;
     uint16_t layout[128];
 
+    DuckyProgram* program;
+    size_t pc;
+    size_t repeat_start;
+    bool line_pending;
+
     FuriString* line;
     FuriString* line_prev;
     uint32_t repeat_cnt;
     uint8_t key_hold_nb;
 
-    FuriString* string_print;
     size_t string_print_pos;
+    size_t string_print_end;
 };
 
 uint16_t ducky_get_keycode(BadUsbScript* bad_usb, const char* param, bool accept_chars);
@@ -51,17 +109,19 @@ uint16_t ducky_get_keycode_by_name(const char* param);
 
 bool ducky_get_number(const char* param, uint32_t* val);
 
-void ducky_numlock_on(void);
+uint16_t ducky_get_numpad_key(const char num);
+
+DuckyInstr* ducky_emit(BadUsbScript* bad_usb, DuckyOp op, uint16_t key, uint32_t value);
 
-bool ducky_numpad_press(const char num);
+uint16_t* ducky_emit_pool(BadUsbScript* bad_usb, size_t size, uint32_t* offset);
 
-bool ducky_altchar(const char* charcode);
+DuckyProgram* ducky_program_alloc();
 
-bool ducky_altstring(const char* param);
+void ducky_program_free(DuckyProgram* program);
 
-bool ducky_string(BadUsbScript* bad_usb, const char* param);
+void ducky_compile_chunk(BadUsbScript* bad_usb, File* script_file, bool from_start);
 
-int32_t ducky_execute_cmd(BadUsbScript* bad_usb, const char* line);
+int32_t ducky_compile_cmd(BadUsbScript* bad_usb, const char* line);
 
 int32_t ducky_error(BadUsbScript* bad_usb, const char* text, ...);
 
@@ -4,11 +4,13 @@
 #include <furi_hal.h>
 
 #include <lib/toolbox/args.h>
+#include <lib/toolbox/stream/buffered_file_stream.h>
 #include <lib/subghz/subghz_keystore.h>
 
 #include <lib/subghz/receiver.h>
 #include <lib/subghz/transmitter.h>
 #include <lib/subghz/subghz_file_encoder_worker.h>
+#include <lib/subghz/subghz_raw_binary.h>
 #include <lib/subghz/protocols/protocol_items.h>
 
 #include "helpers/subghz_chat.h"
@@ -513,6 +515,8 @@ static void subghz_cli_command_print_usage() {
     printf("\trx <frequency:in Hz>\t - Receive\r\n");
     printf("\trx_raw <frequency:in Hz>\t - Receive RAW\r\n");
     printf("\tdecode_raw <file_name: path_RAW_file>\t - Testing\r\n");
+    printf(
+        "\traw_convert <path_RAW_file> <path_converted_file> <text|bin|binz>\t - Convert RAW data\r\n");
 
     if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
         printf("\r\n");
@@ -526,6 +530,67 @@ static void subghz_cli_command_print_usage() {
     }
 }
 
+static void subghz_cli_command_raw_convert(Cli* cli, FuriString* args) {
+    UNUSED(cli);
+
+    FuriString* source = furi_string_alloc();
+    FuriString* destination = furi_string_alloc();
+    FuriString* format = furi_string_alloc();
+
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    Stream* source_stream = buffered_file_stream_alloc(storage);
+    Stream* destination_stream = buffered_file_stream_alloc(storage);
+
+    do {
+        if(!args_read_string_and_trim(args, source) ||
+           !args_read_string_and_trim(args, destination) ||
+           !args_read_string_and_trim(args, format)) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        bool binary = furi_string_cmp_str(format, "text") != 0;
+        bool compress = furi_string_cmp_str(format, "binz") == 0;
+        if(binary && !compress && furi_string_cmp_str(format, "bin") != 0) {
+            subghz_cli_command_print_usage();
+            break;
+        }
+
+        if(!buffered_file_stream_open(
+               source_stream, furi_string_get_cstr(source), FSAM_READ, FSOM_OPEN_EXISTING)) {
+            printf("Failed to open %s\r\n", furi_string_get_cstr(source));
+            break;
+        }
+        if(!buffered_file_stream_open(
+               destination_stream,
+               furi_string_get_cstr(destination),
+               FSAM_WRITE,
+               FSOM_CREATE_ALWAYS)) {
+            printf("Failed to open %s\r\n", furi_string_get_cstr(destination));
+            break;
+        }
+
+        if(!subghz_raw_binary_convert(source_stream, destination_stream, binary, compress)) {
+            printf("Failed to convert RAW file\r\n");
+            break;
+        }
+        printf(
+            "Converted %zu bytes to %zu\r\n",
+            stream_size(source_stream),
+            stream_size(destination_stream));
+    } while(false);
+
+    buffered_file_stream_close(destination_stream);
+    buffered_file_stream_close(source_stream);
+    stream_free(destination_stream);
+    stream_free(source_stream);
+    furi_record_close(RECORD_STORAGE);
+
+    furi_string_free(format);
+    furi_string_free(destination);
+    furi_string_free(source);
+}
+
 static void subghz_cli_command_encrypt_keeloq(Cli* cli, FuriString* args) {
     UNUSED(cli);
     uint8_t iv[16];
@@ -823,6 +888,11 @@ static void subghz_cli_command(Cli* cli, FuriString* args, void* context) {
             break;
         }
 
+        if(furi_string_cmp_str(cmd, "raw_convert") == 0) {
+            subghz_cli_command_raw_convert(cli, args);
+            break;
+        }
+
         if(furi_hal_rtc_is_flag_set(FuriHalRtcFlagDebug)) {
             if(furi_string_cmp_str(cmd, "encrypt_keeloq") == 0) {
                 subghz_cli_command_encrypt_keeloq(cli, args);
@@ -191,6 +191,14 @@ void cli_command_log(Cli* cli, FuriString* args, void* context) {
     uint8_t buffer[CLI_COMMAND_LOG_BUFFER_SIZE];
     FuriLogLevel previous_level = furi_log_get_level();
     bool restore_log_level = false;
+    bool previous_deferred = furi_log_deferred_is_enabled();
+
+    // Deferred records are printed as `#L` lines, decode with scripts/log_decode.py
+    if(furi_string_start_with_str(args, "deferred")) {
+        furi_string_right(args, strlen("deferred"));
+        furi_string_trim(args);
+        furi_log_deferred_enable(true);
+    }
 
     if(furi_string_size(args) > 0) {
         cli_command_log_level_set_from_string(args);
@@ -211,6 +219,7 @@ void cli_command_log(Cli* cli, FuriString* args, void* context) {
         // There will be strange behaviour if log level is set from settings while log command is running
         furi_log_set_level(previous_level);
     }
+    furi_log_deferred_enable(previous_deferred);
 
     furi_stream_buffer_free(ring);
 }
@@ -415,6 +424,52 @@ void cli_command_free_blocks(Cli* cli, FuriString* args, void* context) {
     memmgr_heap_printf_free_blocks();
 }
 
+#define CLI_COMMAND_TIMERS_DEFAULT_PERIOD_S 10
+
+// Rate with two decimals, x100
+static uint32_t cli_command_timers_rate(uint32_t count, uint32_t ticks) {
+    return (uint64_t)count * 100 * furi_kernel_get_tick_frequency() / MAX(ticks, 1UL);
+}
+
+void cli_command_timers(Cli* cli, FuriString* args, void* context) {
+    UNUSED(context);
+
+    int period = CLI_COMMAND_TIMERS_DEFAULT_PERIOD_S;
+    if(furi_string_size(args) && (!args_read_int_and_trim(args, &period) || period <= 0)) {
+        cli_print_usage("timers", "<period_s>", furi_string_get_cstr(args));
+        return;
+    }
+
+    printf("Sampling timer wakeups for %d s, press CTRL+C to stop...\r\n", period);
+    furi_timer_reset_stats();
+    uint32_t end = furi_get_tick() + furi_ms_to_ticks(period * 1000);
+    while(!cli_cmd_interrupt_received(cli) && ((int32_t)(end - furi_get_tick()) > 0)) {
+        furi_delay_ms(100);
+    }
+
+    FuriTimerStats* stats = malloc(sizeof(FuriTimerStats));
+    furi_timer_get_stats(stats);
+
+    uint32_t rate = cli_command_timers_rate(stats->wakeups, stats->ticks);
+    printf("Wakeups: %lu, %lu.%02lu/s\r\n", stats->wakeups, rate / 100, rate % 100);
+    printf("%-16s %-12s %s\r\n", "Subsystem", "Wakeups/s", "Expirations/s");
+    for(size_t i = 0; i < stats->subsystems_count; i++) {
+        const FuriTimerSubsystemStats* subsystem = &stats->subsystems[i];
+        if(!subsystem->expirations) continue;
+        uint32_t wakeups = cli_command_timers_rate(subsystem->wakeups, stats->ticks);
+        uint32_t expirations = cli_command_timers_rate(subsystem->expirations, stats->ticks);
+        printf(
+            "%-16s %5lu.%02lu     %5lu.%02lu\r\n",
+            subsystem->name,
+            wakeups / 100,
+            wakeups % 100,
+            expirations / 100,
+            expirations % 100);
+    }
+
+    free(stats);
+}
+
 void cli_command_i2c(Cli* cli, FuriString* args, void* context) {
     UNUSED(cli);
     UNUSED(args);
@@ -452,6 +507,7 @@ void cli_commands_init(Cli* cli) {
     cli_add_command(cli, "ps", CliCommandFlagParallelSafe, cli_command_ps, NULL);
     cli_add_command(cli, "free", CliCommandFlagParallelSafe, cli_command_free, NULL);
     cli_add_command(cli, "free_blocks", CliCommandFlagParallelSafe, cli_command_free_blocks, NULL);
+    cli_add_command(cli, "timers", CliCommandFlagParallelSafe, cli_command_timers, NULL);
 
     cli_add_command(cli, "vibro", CliCommandFlagDefault, cli_command_vibro, NULL);
     cli_add_command(cli, "led", CliCommandFlagDefault, cli_command_led, NULL);
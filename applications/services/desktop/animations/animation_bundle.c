@@ -0,0 +1,159 @@
+#include "animation_bundle.h"
+
+#include <furi.h>
+
+#define TAG "AnimationBundle"
+
+struct AnimationBundle {
+    File* file;
+    AnimationBundleHeader header;
+    AnimationBundleFrame* frame_table;
+    /* Paged in frames, kept until bundle is freed */
+    uint8_t** frames;
+};
+
+static bool animation_bundle_validate(AnimationBundle* bundle, uint64_t file_size) {
+    const AnimationBundleHeader* header = &bundle->header;
+    bool valid = false;
+
+    do {
+        if(header->magic != ANIMATION_BUNDLE_MAGIC) break;
+        if(header->version != ANIMATION_BUNDLE_VERSION) break;
+        if(!header->width || (header->width > 128)) break;
+        if(!header->height || (header->height > 128)) break;
+        if(!header->frame_count || !header->passive_frames) break;
+        if(!header->frame_rate) break;
+        if(header->bubble_count && !header->bubble_slots) break;
+
+        uint64_t table_end = (uint64_t)header->frame_table_offset +
+                             sizeof(AnimationBundleFrame) * header->frame_count;
+        if(table_end > file_size) break;
+        valid = true;
+    } while(0);
+
+    return valid;
+}
+
+static bool animation_bundle_validate_frame_table(AnimationBundle* bundle, uint64_t file_size) {
+    const AnimationBundleHeader* header = &bundle->header;
+    /* bitmap is either compressed or raw with 1 byte header,
+     * compressed one is used only if it is smaller */
+    size_t max_frame_size = ROUND_UP_TO(header->width, 8) * header->height + 1;
+
+    for(size_t i = 0; i < header->frame_count; ++i) {
+        const AnimationBundleFrame* frame = &bundle->frame_table[i];
+        if(!frame->size || (frame->size > max_frame_size)) return false;
+        if((uint64_t)frame->offset + frame->size > file_size) return false;
+    }
+
+    return true;
+}
+
+AnimationBundle* animation_bundle_open(Storage* storage, const char* path) {
+    furi_assert(storage);
+    furi_assert(path);
+
+    AnimationBundle* bundle = malloc(sizeof(AnimationBundle));
+    bundle->file = storage_file_alloc(storage);
+    bundle->frame_table = NULL;
+    bundle->frames = NULL;
+
+    bool success = false;
+    do {
+        if(!storage_file_open(bundle->file, path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
+        uint64_t file_size = storage_file_size(bundle->file);
+
+        if(storage_file_read(bundle->file, &bundle->header, sizeof(AnimationBundleHeader)) !=
+           sizeof(AnimationBundleHeader))
+            break;
+        if(!animation_bundle_validate(bundle, file_size)) {
+            FURI_LOG_E(TAG, "Malformed header: \'%s\'", path);
+            break;
+        }
+
+        size_t table_size = sizeof(AnimationBundleFrame) * bundle->header.frame_count;
+        bundle->frame_table = malloc(table_size);
+        if(!storage_file_seek(bundle->file, bundle->header.frame_table_offset, true)) break;
+        if(storage_file_read(bundle->file, bundle->frame_table, table_size) != table_size) break;
+        if(!animation_bundle_validate_frame_table(bundle, file_size)) {
+            FURI_LOG_E(TAG, "Malformed frame table: \'%s\'", path);
+            break;
+        }
+
+        if(!storage_file_seek(bundle->file, sizeof(AnimationBundleHeader), true)) break;
+        bundle->frames = malloc(sizeof(uint8_t*) * bundle->header.frame_count);
+        success = true;
+    } while(0);
+
+    if(!success) {
+        animation_bundle_free(bundle);
+        bundle = NULL;
+    }
+
+    return bundle;
+}
+
+void animation_bundle_free(AnimationBundle* bundle) {
+    furi_assert(bundle);
+
+    if(bundle->frames) {
+        for(size_t i = 0; i < bundle->header.frame_count; ++i) {
+            if(bundle->frames[i]) {
+                free(bundle->frames[i]);
+            }
+        }
+        free(bundle->frames);
+    }
+    if(bundle->frame_table) {
+        free(bundle->frame_table);
+    }
+    storage_file_close(bundle->file);
+    storage_file_free(bundle->file);
+    free(bundle);
+}
+
+const AnimationBundleHeader* animation_bundle_get_header(AnimationBundle* bundle) {
+    furi_assert(bundle);
+    return &bundle->header;
+}
+
+bool animation_bundle_read(AnimationBundle* bundle, void* buffer, size_t size) {
+    furi_assert(bundle);
+    furi_assert(buffer);
+    return storage_file_read(bundle->file, buffer, size) == size;
+}
+
+const uint8_t* animation_bundle_get_frame(AnimationBundle* bundle, uint8_t index) {
+    furi_assert(bundle);
+    furi_assert(bundle->frames);
+
+    if(index >= bundle->header.frame_count) {
+        return NULL;
+    }
+
+    return bundle->frames[index];
+}
+
+bool animation_bundle_load_frame(AnimationBundle* bundle, uint8_t index) {
+    furi_assert(bundle);
+    furi_assert(bundle->frames);
+
+    if(index >= bundle->header.frame_count) {
+        return false;
+    }
+
+    if(!bundle->frames[index]) {
+        const AnimationBundleFrame* frame = &bundle->frame_table[index];
+        uint8_t* data = malloc(frame->size);
+        if(!storage_file_seek(bundle->file, frame->offset, true) ||
+           (storage_file_read(bundle->file, data, frame->size) != frame->size)) {
+            FURI_LOG_E(TAG, "Failed to page in frame %u", index);
+            free(data);
+            return false;
+        }
+        /* published only when complete, readers may run concurrently */
+        bundle->frames[index] = data;
+    }
+
+    return true;
+}
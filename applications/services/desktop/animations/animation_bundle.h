@@ -0,0 +1,134 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <storage/storage.h>
+
+/**
+ * Animation bundle is a packed binary form of external animation:
+ * meta, manifest info, bubbles and all frames in a single file.
+ * It is produced by `scripts/assets.py dolphin` next to meta.txt.
+ *
+ * Layout (little endian):
+ *
+ *  AnimationBundleHeader
+ *  uint8_t frame_order[passive_frames + active_frames]
+ *  AnimationBundleBubble + text[text_length], repeated bubble_count times
+ *  AnimationBundleFrame[frame_count]   (at frame_table_offset)
+ *  frame data                          (referenced by frame table)
+ *
+ * Frames are not loaded on open. They are paged in one by one with
+ * animation_bundle_load_frame() while animation is playing and stay
+ * resident until bundle is freed: animation loops over the same frames,
+ * so after the first cycle there is no file I/O at all. Resident frames
+ * take no more memory than frames of a meta.txt animation loaded upfront.
+ */
+
+#define ANIMATION_BUNDLE_FILE "animation.bundle"
+#define ANIMATION_BUNDLE_MAGIC (0x42414446UL) /* "FDAB" */
+#define ANIMATION_BUNDLE_VERSION (1)
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t width;
+    uint8_t height;
+    uint8_t frame_count;
+    uint8_t passive_frames;
+    uint8_t active_frames;
+    uint8_t active_cycles;
+    uint8_t frame_rate;
+    uint16_t duration;
+    uint16_t active_cooldown;
+    uint8_t min_butthurt;
+    uint8_t max_butthurt;
+    uint8_t min_level;
+    uint8_t max_level;
+    uint8_t weight;
+    uint8_t bubble_slots;
+    uint8_t bubble_count;
+    uint8_t reserved;
+    uint32_t frame_table_offset;
+} AnimationBundleHeader;
+_Static_assert(sizeof(AnimationBundleHeader) == 28, "Incorrect AnimationBundleHeader size");
+
+typedef struct {
+    uint8_t slot;
+    uint8_t x;
+    uint8_t y;
+    /* 'L', 'R', 'T', 'B' or 'C' */
+    uint8_t align_h;
+    uint8_t align_v;
+    uint8_t start_frame;
+    uint8_t end_frame;
+    uint8_t text_length;
+} AnimationBundleBubble;
+_Static_assert(sizeof(AnimationBundleBubble) == 8, "Incorrect AnimationBundleBubble size");
+
+typedef struct {
+    uint32_t offset;
+    uint32_t size;
+} AnimationBundleFrame;
+_Static_assert(sizeof(AnimationBundleFrame) == 8, "Incorrect AnimationBundleFrame size");
+
+#pragma pack(pop)
+
+typedef struct AnimationBundle AnimationBundle;
+
+/**
+ * Open bundle, validate header and load frame table.
+ * File stays open until bundle is freed, read position is
+ * set right after header.
+ *
+ * @storage     storage instance
+ * @path        path to bundle file
+ * @return      bundle instance, NULL if file is missing or malformed
+ */
+AnimationBundle* animation_bundle_open(Storage* storage, const char* path);
+
+/**
+ * Close bundle file and release all resident frames.
+ *
+ * @bundle      bundle instance
+ */
+void animation_bundle_free(AnimationBundle* bundle);
+
+/**
+ * Get header of opened bundle.
+ *
+ * @bundle      bundle instance
+ * @return      header, never NULL
+ */
+const AnimationBundleHeader* animation_bundle_get_header(AnimationBundle* bundle);
+
+/**
+ * Read next chunk of sequential sections (frame order, bubbles).
+ *
+ * @bundle      bundle instance
+ * @buffer      destination
+ * @size        amount of bytes to read
+ * @return      true if exactly size bytes were read
+ */
+bool animation_bundle_read(AnimationBundle* bundle, void* buffer, size_t size);
+
+/**
+ * Get resident frame bitmap, never touches the file.
+ * Safe to call while another thread pages frames in.
+ * Returned pointer is valid until bundle free.
+ *
+ * @bundle      bundle instance
+ * @index       frame index
+ * @return      frame bitmap, NULL if frame is not paged in yet
+ */
+const uint8_t* animation_bundle_get_frame(AnimationBundle* bundle, uint8_t index);
+
+/**
+ * Page frame in from file, if it is not resident yet.
+ * Does file I/O, calls must be serialized by the caller.
+ *
+ * @bundle      bundle instance
+ * @index       frame index
+ * @return      true if frame is resident
+ */
+bool animation_bundle_load_frame(AnimationBundle* bundle, uint8_t index);
@@ -15,6 +15,8 @@
 
 #define TAG "AnimationManager"
 
+#define IDLE_ANIMATION_TIMER_SLACK_MS 1000
+
 #define HARDCODED_ANIMATION_NAME "L1_Tv_128x47"
 #define NO_SD_ANIMATION_NAME "L1_NoSd_128x49"
 #define BAD_BATTERY_ANIMATION_NAME "L1_BadBattery_128x47"
@@ -287,6 +289,8 @@ AnimationManager* animation_manager_alloc(void) {
 
     animation_manager->idle_animation_timer =
         furi_timer_alloc(animation_manager_timer_callback, FuriTimerTypeOnce, animation_manager);
+    furi_timer_set_slack(
+        animation_manager->idle_animation_timer, furi_ms_to_ticks(IDLE_ANIMATION_TIMER_SLACK_MS));
     bubble_animation_view_set_interact_callback(
         animation_manager->animation_view, animation_manager_interact_callback, animation_manager);
 
@@ -450,7 +454,7 @@ void animation_manager_unload_and_stall_animation(AnimationManager* animation_ma
         animation_manager->state = AnimationManagerStateFreezedIdle;
 
         animation_manager->freezed_animation_time_left =
-            xTimerGetExpiryTime(animation_manager->idle_animation_timer) - xTaskGetTickCount();
+            furi_timer_get_expire_time(animation_manager->idle_animation_timer) - furi_get_tick();
         if(animation_manager->freezed_animation_time_left < 0) {
             animation_manager->freezed_animation_time_left = 0;
         }
@@ -4,6 +4,7 @@
 #include <gui/icon_i.h>
 #include <stdint.h>
 #include <dolphin/dolphin.h>
+#include "animation_bundle.h"
 
 typedef struct AnimationManager AnimationManager;
 
@@ -32,6 +33,9 @@ typedef struct {
     uint8_t active_cycles;
     uint16_t duration;
     uint16_t active_cooldown;
+    /* Frames source for bundled external animations,
+     * NULL if frames are in icon_animation */
+    AnimationBundle* bundle;
 } BubbleAnimation;
 
 typedef void (*AnimationManagerSetNewIdleAnimationCallback)(void* context);
@@ -21,6 +21,9 @@ static void animation_storage_free_bubbles(BubbleAnimation* animation);
 static void animation_storage_free_frames(BubbleAnimation* animation);
 static void animation_storage_free_animation(BubbleAnimation** storage_animation);
 static BubbleAnimation* animation_storage_load_animation(const char* name);
+static BubbleAnimation* animation_storage_load_bundle(
+    const char* name,
+    StorageAnimationManifestInfo* manifest_info);
 
 static bool animation_storage_load_single_manifest_info(
     StorageAnimationManifestInfo* manifest_info,
@@ -163,10 +166,17 @@ StorageAnimation* animation_storage_find_animation(const char* name) {
         storage_animation = malloc(sizeof(StorageAnimation));
         storage_animation->external = true;
 
-        bool result = false;
-        result =
-            animation_storage_load_single_manifest_info(&storage_animation->manifest_info, name);
-        if(result) {
+        storage_animation->manifest_info.name = NULL;
+
+        /* bundle carries manifest info, so no need to parse manifest.txt */
+        storage_animation->animation =
+            animation_storage_load_bundle(name, &storage_animation->manifest_info);
+        bool result = !!storage_animation->animation;
+        if(!result) {
+            result = animation_storage_load_single_manifest_info(
+                &storage_animation->manifest_info, name);
+        }
+        if(result && !storage_animation->animation) {
             storage_animation->animation = animation_storage_load_animation(name);
             result = !!storage_animation->animation;
         }
@@ -194,6 +204,10 @@ void animation_storage_cache_animation(StorageAnimation* storage_animation) {
     furi_assert(storage_animation);
 
     if(storage_animation->external) {
+        if(!storage_animation->animation) {
+            storage_animation->animation =
+                animation_storage_load_bundle(storage_animation->manifest_info.name, NULL);
+        }
         if(!storage_animation->animation) {
             storage_animation->animation =
                 animation_storage_load_animation(storage_animation->manifest_info.name);
@@ -201,12 +215,36 @@ void animation_storage_cache_animation(StorageAnimation* storage_animation) {
     }
 }
 
+const uint8_t* animation_storage_get_frame(const BubbleAnimation* animation, uint8_t index) {
+    furi_assert(animation);
+
+    if(animation->bundle) {
+        return animation_bundle_get_frame(animation->bundle, index);
+    } else {
+        furi_assert(index < animation->icon_animation.frame_count);
+        return animation->icon_animation.frames[index];
+    }
+}
+
+bool animation_storage_load_frame(const BubbleAnimation* animation, uint8_t index) {
+    furi_assert(animation);
+
+    if(animation->bundle) {
+        return animation_bundle_load_frame(animation->bundle, index);
+    } else {
+        return true;
+    }
+}
+
 static void animation_storage_free_animation(BubbleAnimation** animation) {
     furi_assert(animation);
 
     if(*animation) {
         animation_storage_free_bubbles(*animation);
         animation_storage_free_frames(*animation);
+        if((*animation)->bundle) {
+            animation_bundle_free((*animation)->bundle);
+        }
         if((*animation)->frame_order) {
             free((void*)(*animation)->frame_order);
         }
@@ -253,6 +291,8 @@ static void animation_storage_free_frames(BubbleAnimation* animation) {
     furi_assert(animation);
 
     const Icon* icon = &animation->icon_animation;
+    if(!icon->frames) return;
+
     for(int i = 0; i < icon->frame_count; ++i) {
         if(icon->frames[i]) {
             free((void*)icon->frames[i]);
@@ -260,6 +300,7 @@ static void animation_storage_free_frames(BubbleAnimation* animation) {
     }
 
     free((void*)icon->frames);
+    FURI_CONST_ASSIGN_PTR(icon->frames, NULL);
 }
 
 static bool animation_storage_load_frames(
@@ -431,6 +472,7 @@ static bool animation_storage_load_bubbles(BubbleAnimation* animation, FlipperFo
 static BubbleAnimation* animation_storage_load_animation(const char* name) {
     furi_assert(name);
     BubbleAnimation* animation = malloc(sizeof(BubbleAnimation));
+    animation->bundle = NULL;
 
     uint32_t height = 0;
     uint32_t width = 0;
@@ -510,6 +552,180 @@ static BubbleAnimation* animation_storage_load_animation(const char* name) {
     return animation;
 }
 
+static bool animation_storage_cast_bundle_align(uint8_t align_char, Align* align) {
+    switch(align_char) {
+    case 'B':
+        *align = AlignBottom;
+        break;
+    case 'T':
+        *align = AlignTop;
+        break;
+    case 'L':
+        *align = AlignLeft;
+        break;
+    case 'R':
+        *align = AlignRight;
+        break;
+    case 'C':
+        *align = AlignCenter;
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+static bool animation_storage_load_bundle_bubbles(
+    BubbleAnimation* animation,
+    AnimationBundle* bundle,
+    const AnimationBundleHeader* header) {
+    bool success = false;
+    furi_assert(!animation->frame_bubble_sequences);
+
+    do {
+        if(header->bubble_slots > 20) break;
+        animation->frame_bubble_sequences_count = header->bubble_slots;
+        if(animation->frame_bubble_sequences_count == 0) {
+            success = (header->bubble_count == 0);
+            break;
+        }
+        animation->frame_bubble_sequences =
+            malloc(sizeof(FrameBubble*) * animation->frame_bubble_sequences_count);
+        for(int i = 0; i < animation->frame_bubble_sequences_count; ++i) {
+            FURI_CONST_ASSIGN_PTR(
+                animation->frame_bubble_sequences[i], malloc(sizeof(FrameBubble)));
+        }
+
+        const FrameBubble* bubble = animation->frame_bubble_sequences[0];
+        int8_t index = -1;
+        size_t bubble_number = 0;
+        for(; bubble_number < header->bubble_count; ++bubble_number) {
+            AnimationBundleBubble record;
+            if(!animation_bundle_read(bundle, &record, sizeof(record))) break;
+            if((record.slot != 0) && (index == -1)) break;
+
+            if(record.slot == index) {
+                FURI_CONST_ASSIGN_PTR(bubble->next_bubble, malloc(sizeof(FrameBubble)));
+                bubble = bubble->next_bubble;
+            } else if(record.slot == index + 1) {
+                ++index;
+                if(index >= animation->frame_bubble_sequences_count) break;
+                bubble = animation->frame_bubble_sequences[index];
+            } else {
+                /* same rules as for meta.txt bubbles */
+                break;
+            }
+
+            FURI_CONST_ASSIGN(bubble->bubble.x, record.x);
+            FURI_CONST_ASSIGN(bubble->bubble.y, record.y);
+            FURI_CONST_ASSIGN(bubble->start_frame, record.start_frame);
+            FURI_CONST_ASSIGN(bubble->end_frame, record.end_frame);
+            if(!animation_storage_cast_bundle_align(
+                   record.align_h, (Align*)&bubble->bubble.align_h))
+                break;
+            if(!animation_storage_cast_bundle_align(
+                   record.align_v, (Align*)&bubble->bubble.align_v))
+                break;
+
+            if(!record.text_length || (record.text_length > 100)) break;
+            char* text = malloc(record.text_length + 1);
+            FURI_CONST_ASSIGN_PTR(bubble->bubble.text, text);
+            if(!animation_bundle_read(bundle, text, record.text_length)) break;
+            text[record.text_length] = '\0';
+        }
+        success = (bubble_number == header->bubble_count) &&
+                  ((index + 1) == animation->frame_bubble_sequences_count);
+    } while(0);
+
+    if(!success) {
+        if(animation->frame_bubble_sequences) {
+            FURI_LOG_E(TAG, "Failed to load bundle bubbles");
+            animation_storage_free_bubbles(animation);
+        }
+    }
+
+    return success;
+}
+
+static BubbleAnimation* animation_storage_load_bundle(
+    const char* name,
+    StorageAnimationManifestInfo* manifest_info) {
+    furi_assert(name);
+
+    BubbleAnimation* animation = NULL;
+    AnimationBundle* bundle = NULL;
+    Storage* storage = furi_record_open(RECORD_STORAGE);
+    FuriString* path = furi_string_alloc_printf(ANIMATION_DIR "/%s/" ANIMATION_BUNDLE_FILE, name);
+
+    bool success = false;
+    do {
+        if(FSE_OK != storage_sd_status(storage)) break;
+        bundle = animation_bundle_open(storage, furi_string_get_cstr(path));
+        if(!bundle) break;
+
+        const AnimationBundleHeader* header = animation_bundle_get_header(bundle);
+        animation = malloc(sizeof(BubbleAnimation));
+        animation->passive_frames = header->passive_frames;
+        animation->active_frames = header->active_frames;
+        animation->active_cycles = header->active_cycles;
+        animation->duration = header->duration;
+        animation->active_cooldown = header->active_cooldown;
+
+        Icon* icon = (Icon*)&animation->icon_animation;
+        FURI_CONST_ASSIGN(icon->width, header->width);
+        FURI_CONST_ASSIGN(icon->height, header->height);
+        FURI_CONST_ASSIGN(icon->frame_count, header->frame_count);
+        FURI_CONST_ASSIGN(icon->frame_rate, header->frame_rate);
+        icon->frames = NULL;
+
+        uint16_t frames = animation->passive_frames + animation->active_frames;
+        uint8_t* frame_order = malloc(frames);
+        animation->frame_order = frame_order;
+        if(!animation_bundle_read(bundle, frame_order, frames)) break;
+        bool frame_order_ok = true;
+        for(size_t i = 0; i < frames; ++i) {
+            frame_order_ok &= (frame_order[i] < header->frame_count);
+        }
+        if(!frame_order_ok) {
+            FURI_LOG_E(TAG, "Error loading bundle: frames order");
+            break;
+        }
+
+        if(!animation_storage_load_bundle_bubbles(animation, bundle, header)) break;
+
+        if(manifest_info) {
+            manifest_info->name = strdup(name);
+            manifest_info->min_butthurt = header->min_butthurt;
+            manifest_info->max_butthurt = header->max_butthurt;
+            manifest_info->min_level = header->min_level;
+            manifest_info->max_level = header->max_level;
+            manifest_info->weight = header->weight;
+        }
+
+        animation->bundle = bundle;
+        success = true;
+    } while(0);
+
+    if(!success) {
+        if(animation) {
+            if(animation->frame_order) {
+                free((void*)animation->frame_order);
+            }
+            free(animation);
+            animation = NULL;
+        }
+        if(bundle) {
+            animation_bundle_free(bundle);
+        }
+    }
+
+    furi_string_free(path);
+    furi_record_close(RECORD_STORAGE);
+
+    return animation;
+}
+
 static void animation_storage_free_bubbles(BubbleAnimation* animation) {
     if(!animation->frame_bubble_sequences) return;
 
@@ -54,6 +54,29 @@ const BubbleAnimation* animation_storage_get_bubble_animation(StorageAnimation*
  */
 void animation_storage_cache_animation(StorageAnimation* storage_animation);
 
+/**
+ * Get frame bitmap of bubble animation, no storage access.
+ * Bundled external animations page frames in on demand,
+ * so frame data should be taken through this call
+ * instead of accessing icon frames directly.
+ *
+ * @animation   bubble animation
+ * @index       frame index (not an index in frame order)
+ * @return      frame bitmap, NULL if frame is not paged in yet
+ */
+const uint8_t* animation_storage_get_frame(const BubbleAnimation* animation, uint8_t index);
+
+/**
+ * Page frame of bubble animation in, so animation_storage_get_frame()
+ * finds it. May read SD card, so never call it from a draw callback
+ * or with view model locked. Calls must be serialized by the caller.
+ *
+ * @animation   bubble animation
+ * @index       frame index (not an index in frame order)
+ * @return      true if frame is available
+ */
+bool animation_storage_load_frame(const BubbleAnimation* animation, uint8_t index);
+
 /**
  * Find animation by name.
  * Search through the inner flash, and SD-card if has.
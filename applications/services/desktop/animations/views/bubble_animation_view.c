@@ -14,6 +14,7 @@
 #include <core/dangerous_defines.h>
 
 #define ACTIVE_SHIFT 2
+#define FRAME_TIMER_SLACK_MS 16
 
 typedef struct {
     const BubbleAnimation* current;
@@ -25,11 +26,15 @@ typedef struct {
     uint8_t active_shift;
     TickType_t active_ended_at;
     Icon* freeze_frame;
+    /* last drawn frame, shown while the current one is not paged in */
+    const uint8_t* last_frame;
 } BubbleAnimationViewModel;
 
 struct BubbleAnimationView {
     View* view;
     FuriTimer* timer;
+    /* serializes frame paging with animation switch and freeze */
+    FuriMutex* frames_mutex;
     BubbleAnimationInteractCallback interact_callback;
     void* interact_callback_context;
 };
@@ -77,8 +82,16 @@ static void bubble_animation_draw_callback(Canvas* canvas, void* model_) {
     uint8_t width = icon_get_width(&animation->icon_animation);
     uint8_t height = icon_get_height(&animation->icon_animation);
     uint8_t y_offset = canvas_height(canvas) - height;
-    canvas_draw_bitmap(
-        canvas, 0, y_offset, width, height, animation->icon_animation.frames[index]);
+    /* Frames are paged in by timer callback, draw never touches storage */
+    const uint8_t* frame = animation_storage_get_frame(animation, index);
+    if(frame) {
+        model->last_frame = frame;
+    } else {
+        frame = model->last_frame;
+    }
+    if(frame) {
+        canvas_draw_bitmap(canvas, 0, y_offset, width, height, frame);
+    }
 
     const FrameBubble* bubble = model->current_bubble;
     if(bubble) {
@@ -226,11 +239,31 @@ static void bubble_animation_next_frame(BubbleAnimationViewModel* model) {
     }
 }
 
+/* Frame index of the next tick, to page it in ahead of time */
+static uint8_t
+    bubble_animation_get_next_frame_index(const BubbleAnimationViewModel* model, bool activate) {
+    BubbleAnimationViewModel next = *model;
+
+    if(activate && next.current->active_frames) {
+        next.current_frame = next.current->passive_frames;
+        bubble_animation_next_frame(&next);
+    } else if(next.active_shift == 1) {
+        next.current_frame = next.current->passive_frames;
+    } else {
+        bubble_animation_next_frame(&next);
+    }
+
+    return bubble_animation_get_frame_index(&next);
+}
+
 static void bubble_animation_timer_callback(void* context) {
     furi_assert(context);
     BubbleAnimationView* view = context;
     bool activate = false;
+    const BubbleAnimation* animation = NULL;
+    uint8_t next_index = 0;
 
+    furi_check(furi_mutex_acquire(view->frames_mutex, FuriWaitForever) == FuriStatusOk);
     BubbleAnimationViewModel* model = view_get_model(view->view);
 
     if(model->active_shift > 0) {
@@ -241,8 +274,19 @@ static void bubble_animation_timer_callback(void* context) {
         bubble_animation_next_frame(model);
     }
 
+    if(model->current && !model->freeze_frame) {
+        animation = model->current;
+        next_index = bubble_animation_get_next_frame_index(model, activate);
+    }
+
     view_commit_model(view->view, !activate);
 
+    /* SD card is read here, with model unlocked, so GUI is never stalled by it */
+    if(animation) {
+        animation_storage_load_frame(animation, next_index);
+    }
+    furi_mutex_release(view->frames_mutex);
+
     if(activate) {
         bubble_animation_activate_right_now(view);
     }
@@ -252,10 +296,10 @@ static void bubble_animation_timer_callback(void* context) {
  * animation is always activated at unfreezing and played
  * passive frame first, and 2 frames after - active
  */
-static Icon* bubble_animation_clone_first_frame(const Icon* icon_orig) {
-    furi_assert(icon_orig);
-    furi_assert(icon_orig->frames);
-    furi_assert(icon_orig->frames[0]);
+static Icon* bubble_animation_clone_first_frame(const BubbleAnimation* animation) {
+    furi_assert(animation);
+    const Icon* icon_orig = &animation->icon_animation;
+    const uint8_t* first_frame = animation_storage_get_frame(animation, 0);
 
     Icon* icon_clone = malloc(sizeof(Icon));
     memcpy(icon_clone, icon_orig, sizeof(Icon));
@@ -268,7 +312,15 @@ static Icon* bubble_animation_clone_first_frame(const Icon* icon_orig) {
      */
     size_t max_bitmap_size = ROUND_UP_TO(icon_orig->width, 8) * icon_orig->height + 1;
     FURI_CONST_ASSIGN_PTR(icon_clone->frames[0], malloc(max_bitmap_size));
-    memcpy((void*)icon_clone->frames[0], icon_orig->frames[0], max_bitmap_size);
+    if(first_frame) {
+        /* bundled frames are paged in with their exact size, so don't
+         * copy past compressed data: 0x01, 0x00, size (le16), data */
+        size_t bitmap_size = max_bitmap_size;
+        if(first_frame[0] == 0x01) {
+            bitmap_size = MIN(bitmap_size, 4U + (first_frame[2] | (first_frame[3] << 8)));
+        }
+        memcpy((void*)icon_clone->frames[0], first_frame, bitmap_size);
+    }
     FURI_CONST_ASSIGN(icon_clone->frame_count, 1);
 
     return icon_clone;
@@ -312,6 +364,8 @@ BubbleAnimationView* bubble_animation_view_alloc(void) {
     view->view = view_alloc();
     view->interact_callback = NULL;
     view->timer = furi_timer_alloc(bubble_animation_timer_callback, FuriTimerTypePeriodic, view);
+    view->frames_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    furi_timer_set_slack(view->timer, furi_ms_to_ticks(FRAME_TIMER_SLACK_MS));
 
     view_allocate_model(view->view, ViewModelTypeLocking, sizeof(BubbleAnimationViewModel));
     view_set_context(view->view, view);
@@ -332,6 +386,7 @@ void bubble_animation_view_free(BubbleAnimationView* view) {
 
     view_free(view->view);
     view->view = NULL;
+    furi_mutex_free(view->frames_mutex);
     free(view);
 }
 
@@ -351,9 +406,14 @@ void bubble_animation_view_set_animation(
     furi_assert(view);
     furi_assert(new_animation);
 
+    furi_check(furi_mutex_acquire(view->frames_mutex, FuriWaitForever) == FuriStatusOk);
+    /* First frame is paged in by the caller, timer takes care of the rest */
+    animation_storage_load_frame(new_animation, new_animation->frame_order[0]);
+
     BubbleAnimationViewModel* model = view_get_model(view->view);
     furi_assert(model);
     model->current = new_animation;
+    model->last_frame = NULL;
 
     model->active_ended_at = xTaskGetTickCount() - (model->current->active_cooldown * 1000);
     model->active_bubbles = 0;
@@ -371,6 +431,7 @@ void bubble_animation_view_set_animation(
     model->current_frame = 0;
     model->active_cycle = 0;
     view_commit_model(view->view, true);
+    furi_mutex_release(view->frames_mutex);
 
     furi_timer_start(view->timer, 1000 / new_animation->icon_animation.frame_rate);
 }
@@ -378,12 +439,21 @@ void bubble_animation_view_set_animation(
 void bubble_animation_freeze(BubbleAnimationView* view) {
     furi_assert(view);
 
+    furi_check(furi_mutex_acquire(view->frames_mutex, FuriWaitForever) == FuriStatusOk);
     BubbleAnimationViewModel* model = view_get_model(view->view);
     furi_assert(model->current);
     furi_assert(!model->freeze_frame);
-    model->freeze_frame = bubble_animation_clone_first_frame(&model->current->icon_animation);
+    const BubbleAnimation* animation = model->current;
+    view_commit_model(view->view, false);
+
+    animation_storage_load_frame(animation, 0);
+
+    model = view_get_model(view->view);
+    model->freeze_frame = bubble_animation_clone_first_frame(animation);
     model->current = NULL;
+    model->last_frame = NULL;
     view_commit_model(view->view, false);
+    furi_mutex_release(view->frames_mutex);
     furi_timer_stop(view->timer);
 }
 
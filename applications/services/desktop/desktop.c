@@ -19,6 +19,8 @@
 
 #define TAG "Desktop"
 
+#define DESKTOP_AUTO_LOCK_SLACK_MS 1000
+
 static void desktop_auto_lock_arm(Desktop*);
 static void desktop_auto_lock_inhibit(Desktop*);
 static void desktop_start_auto_lock_timer(Desktop*);
@@ -260,6 +262,7 @@ Desktop* desktop_alloc() {
 
     desktop->auto_lock_timer =
         furi_timer_alloc(desktop_auto_lock_timer_callback, FuriTimerTypeOnce, desktop);
+    furi_timer_set_slack(desktop->auto_lock_timer, furi_ms_to_ticks(DESKTOP_AUTO_LOCK_SLACK_MS));
 
     return desktop;
 }
@@ -3,6 +3,8 @@
 
 #include <furi.h>
 
+#define ICON_ANIMATION_SLACK_DIVIDER (8)
+
 IconAnimation* icon_animation_alloc(const Icon* icon) {
     furi_assert(icon);
     IconAnimation* instance = malloc(sizeof(IconAnimation));
@@ -15,7 +17,6 @@ IconAnimation* icon_animation_alloc(const Icon* icon) {
 void icon_animation_free(IconAnimation* instance) {
     furi_assert(instance);
     icon_animation_stop(instance);
-    while(xTimerIsTimerActive(instance->timer) == pdTRUE) furi_delay_tick(1);
     furi_timer_free(instance->timer);
     free(instance);
 }
@@ -66,11 +67,10 @@ void icon_animation_start(IconAnimation* instance) {
     if(!instance->animating) {
         instance->animating = true;
         furi_assert(instance->icon->frame_rate);
-        furi_check(
-            xTimerChangePeriod(
-                instance->timer,
-                (furi_kernel_get_tick_frequency() / instance->icon->frame_rate),
-                portMAX_DELAY) == pdPASS);
+        uint32_t period = furi_kernel_get_tick_frequency() / instance->icon->frame_rate;
+        // Frame jitter is invisible, let frames of all animations share wakeups
+        furi_timer_set_slack(instance->timer, period / ICON_ANIMATION_SLACK_DIVIDER);
+        furi_check(furi_timer_start(instance->timer, period) == FuriStatusOk);
     }
 }
 
@@ -78,7 +78,7 @@ void icon_animation_stop(IconAnimation* instance) {
     furi_assert(instance);
     if(instance->animating) {
         instance->animating = false;
-        furi_check(xTimerStop(instance->timer, portMAX_DELAY) == pdPASS);
+        furi_timer_stop(instance->timer);
         instance->frame = 0;
     }
 }
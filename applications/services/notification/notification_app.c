@@ -9,6 +9,8 @@
 
 #define TAG "NotificationSrv"
 
+#define NOTIFICATION_DISPLAY_TIMER_SLACK_MS 500
+
 static const uint8_t minimal_delay = 100;
 static const uint8_t led_off_values[NOTIFICATION_LED_COUNT] = {0x00, 0x00, 0x00};
 
@@ -487,6 +489,8 @@ static NotificationApp* notification_app_alloc() {
     NotificationApp* app = malloc(sizeof(NotificationApp));
     app->queue = furi_message_queue_alloc(8, sizeof(NotificationAppMessage));
     app->display_timer = furi_timer_alloc(notification_display_timer, FuriTimerTypeOnce, app);
+    furi_timer_set_slack(
+        app->display_timer, furi_ms_to_ticks(NOTIFICATION_DISPLAY_TIMER_SLACK_MS));
 
     app->settings.speaker_volume = 1.0f;
     app->settings.display_brightness = 1.0f;
@@ -30,6 +30,9 @@ const char* filesystem_api_error_get_desc(FS_Error error_id) {
     case(FSE_NOT_IMPLEMENTED):
         result = "function not implemented";
         break;
+    case(FSE_CANCELLED):
+        result = "request cancelled";
+        break;
     case(FSE_ALREADY_OPEN):
         result = "file is already open";
         break;
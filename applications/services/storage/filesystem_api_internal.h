@@ -20,6 +20,8 @@ struct File {
     FS_Error error_id; /**< Standard API error from FS_Error enum */
     int32_t internal_error_id; /**< Internal API error value */
     void* storage;
+    volatile bool async_cancel; /**< Drop queued asynchronous requests */
+    uint16_t async_cancelled; /**< Requests dropped, storage thread only */
 };
 
 /** File api structure
@@ -43,6 +45,12 @@ struct File {
  *      @param bytes_to_read how many bytes to read, must be smaller or equal to buffer size 
  *      @return how many bytes actually has been read
  * 
+ *  @var FS_File_Api::borrow
+ *      @brief Get pointer to file data at r/w pointer and move r/w pointer past it
+ *      @param file pointer to file object
+ *      @param size in: how many bytes are wanted, out: how many bytes are borrowed
+ *      @return pointer to data, NULL if not supported for this file
+ * 
  *  @var FS_File_Api::write
  *      @brief Write bytes from buffer to file
  *      @param file pointer to file object
@@ -67,6 +75,12 @@ struct File {
  *      @param file pointer to file object
  *      @return success flag
  * 
+ *  @var FS_File_Api::preallocate
+ *      @brief Prepare contiguous space for empty file, size is not changed
+ *      @param file pointer to file object
+ *      @param size expected file size
+ *      @return success flag
+ * 
  *  @var FS_File_Api::size
  *      @brief Fet file size
  *      @param file pointer to file object
@@ -91,10 +105,12 @@ typedef struct {
         FS_OpenMode open_mode);
     bool (*const close)(void* context, File* file);
     uint16_t (*read)(void* context, File* file, void* buff, uint16_t bytes_to_read);
+    const void* (*const borrow)(void* context, File* file, size_t* size);
     uint16_t (*write)(void* context, File* file, const void* buff, uint16_t bytes_to_write);
     bool (*const seek)(void* context, File* file, uint32_t offset, bool from_start);
     uint64_t (*tell)(void* context, File* file);
     bool (*const truncate)(void* context, File* file);
+    bool (*const preallocate)(void* context, File* file, uint64_t size);
     uint64_t (*size)(void* context, File* file);
     bool (*const sync)(void* context, File* file);
     bool (*const eof)(void* context, File* file);
@@ -165,6 +181,18 @@ typedef struct {
  *      @param total_space pointer to total space value
  *      @param free_space pointer to free space value
  *      @return FS_Error error info
+ *
+ *  @var FS_Common_Api::get_mtime
+ *      @brief Get modification time, optional
+ *      @param path path to file/directory
+ *      @param mtime pointer to modification time, filesystem specific format
+ *      @return FS_Error error info
+ *
+ *  @var FS_Common_Api::set_mtime
+ *      @brief Set modification time, optional
+ *      @param path path to file/directory, must not be opened
+ *      @param mtime modification time from get_mtime of the same filesystem api
+ *      @return FS_Error error info
  */
 typedef struct {
     FS_Error (*const stat)(void* context, const char* path, FileInfo* fileinfo);
@@ -175,6 +203,8 @@ typedef struct {
         const char* fs_path,
         uint64_t* total_space,
         uint64_t* free_space);
+    FS_Error (*const get_mtime)(void* context, const char* path, uint32_t* mtime);
+    FS_Error (*const set_mtime)(void* context, const char* path, uint32_t mtime);
 } FS_Common_Api;
 
 /** Full filesystem api structure */
@@ -8,6 +8,8 @@
 #include <assets_icons.h>
 
 #define STORAGE_TICK 1000
+// Asynchronous requests take no more than a half of the queue
+#define STORAGE_QUEUE_SIZE (STORAGE_ASYNC_DEPTH * 2)
 
 #define ICON_SD_MOUNTED &I_SDcardMounted_11x8
 #define ICON_SD_ERROR &I_SDcardFail_11x8
@@ -34,8 +36,11 @@ static void storage_app_sd_icon_draw_callback(Canvas* canvas, void* context) {
 
 Storage* storage_app_alloc() {
     Storage* app = malloc(sizeof(Storage));
-    app->message_queue = furi_message_queue_alloc(8, sizeof(StorageMessage));
+    app->message_queue = furi_message_queue_alloc(STORAGE_QUEUE_SIZE, sizeof(StorageMessage));
     app->pubsub = furi_pubsub_alloc();
+    app->watch_pubsub = furi_pubsub_alloc();
+    app->stats = malloc(sizeof(StorageCommandStats) * STORAGE_COMMAND_COUNT);
+    app->trace = storage_trace_alloc();
 
     for(uint8_t i = 0; i < STORAGE_COUNT; i++) {
         storage_data_init(&app->storage[i]);
@@ -52,6 +52,63 @@ typedef struct {
  */
 FuriPubSub* storage_get_pubsub(Storage* storage);
 
+/******************* Watch Functions *******************/
+
+typedef enum {
+    StorageWatchEventCreate = (1 << 0), /**< file or directory created */
+    StorageWatchEventModify = (1 << 1), /**< file written and closed */
+    StorageWatchEventDelete = (1 << 2), /**< file or directory removed */
+    StorageWatchEventRename = (1 << 3), /**< file or directory moved, path is the new one */
+} StorageWatchEvent;
+
+#define STORAGE_WATCH_EVENT_ALL                                                    \
+    (StorageWatchEventCreate | StorageWatchEventModify | StorageWatchEventDelete | \
+     StorageWatchEventRename)
+
+typedef struct {
+    StorageWatchEvent event;
+    const char* path; /**< full path with the real storage prefix, "/ext/..." or "/int/..." */
+    const char* old_path; /**< previous path for StorageWatchEventRename, NULL otherwise */
+} StorageWatchMessage;
+
+/** Watch callback
+ * Called from the storage thread, must be short and must not call storage functions.
+ * Paths are valid only during the call.
+ */
+typedef void (*StorageWatchCallback)(const StorageWatchMessage* message, void* context);
+
+typedef struct StorageWatch StorageWatch;
+
+/** Starts watching a directory for changes of its direct children
+ * Rename is done with copy and remove, so it comes after the create, modify and delete
+ * events of the copied and removed entries.
+ * @param storage pointer to the api
+ * @param path directory path, aliases like "/data" are resolved
+ * @param mask StorageWatchEvent bits to report
+ * @param callback watch callback
+ * @param context callback context
+ * @return StorageWatch* watch instance
+ */
+StorageWatch* storage_watch_dir(
+    Storage* storage,
+    const char* path,
+    uint32_t mask,
+    StorageWatchCallback callback,
+    void* context);
+
+/** Stops watching and frees the watch
+ * @param watch watch instance
+ */
+void storage_unwatch_dir(StorageWatch* watch);
+
+/**
+ * Get storage watch pubsub.
+ * Storage will send StorageWatchMessage messages for all paths.
+ * @param storage 
+ * @return FuriPubSub* 
+ */
+FuriPubSub* storage_get_watch_pubsub(Storage* storage);
+
 /******************* File Functions *******************/
 
 /** Opens an existing file or create a new one.
@@ -93,6 +150,16 @@ bool storage_file_is_dir(File* file);
  */
 uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read);
 
+/** Borrows file data at the r/w pointer without copying it
+ * Works for files on internal storage whose data is stored in their own flash pages,
+ * small files stored inline in directory records are not supported.
+ * Data is valid until the file is closed, r/w pointer is moved past the borrowed bytes.
+ * @param file pointer to file object, opened for reading
+ * @param size in: how many bytes are wanted, out: how many bytes are borrowed
+ * @return const void* pointer to data, NULL if data can't be borrowed, use storage_file_read then
+ */
+const void* storage_file_borrow(File* file, size_t* size);
+
 /** Writes bytes from a buffer to a file
  * @param file pointer to file object.
  * @param buff pointer to buffer, for writing
@@ -121,6 +188,16 @@ uint64_t storage_file_tell(File* file);
  */
 bool storage_file_truncate(File* file);
 
+/** Prepares contiguous free space for the file that is about to be written.
+ * Clusters of the file will follow each other, so writing and seeking are faster.
+ * Space is not reserved and file size is not changed.
+ * Supported by external storage only.
+ * @param file pointer to file object, empty file opened for writing
+ * @param size expected file size
+ * @return bool success flag
+ */
+bool storage_file_preallocate(File* file, uint64_t size);
+
 /** Gets the size of the file
  * @param file pointer to file object.
  * @return uint64_t size of the file
@@ -139,6 +216,62 @@ bool storage_file_sync(File* file);
  */
 bool storage_file_eof(File* file);
 
+/******************* Asynchronous File Functions *******************/
+
+/** How many asynchronous requests can be queued at once, for all files */
+#define STORAGE_ASYNC_DEPTH 8
+
+/** Asynchronous request completion callback
+ * Called from the storage thread, must be short and must not call storage functions.
+ * @param file pointer to file object
+ * @param bytes how many bytes were read or written
+ * @param error request result, FSE_CANCELLED if the request was cancelled
+ * @param context callback context
+ */
+typedef void (*StorageAsyncCallback)(File* file, uint16_t bytes, FS_Error error, void* context);
+
+/** Queues reading from a file and returns without waiting for it
+ * Requests are done in order, together with the synchronous ones: any synchronous call
+ * on the file returns after its queued requests are completed.
+ * @param file pointer to file object
+ * @param buff pointer to a buffer, must stay valid until the callback
+ * @param bytes_to_read how many bytes to read
+ * @param callback completion callback, can be NULL
+ * @param context callback context
+ * @return true if queued, false if STORAGE_ASYNC_DEPTH requests are already queued
+ */
+bool storage_file_read_async(
+    File* file,
+    void* buff,
+    uint16_t bytes_to_read,
+    StorageAsyncCallback callback,
+    void* context);
+
+/** Queues writing to a file and returns without waiting for it
+ * Requests are done in order, together with the synchronous ones: any synchronous call
+ * on the file returns after its queued requests are completed.
+ * @param file pointer to file object
+ * @param buff pointer to data, must stay valid until the callback
+ * @param bytes_to_write how many bytes to write
+ * @param callback completion callback, can be NULL
+ * @param context callback context
+ * @return true if queued, false if STORAGE_ASYNC_DEPTH requests are already queued
+ */
+bool storage_file_write_async(
+    File* file,
+    const void* buff,
+    uint16_t bytes_to_write,
+    StorageAsyncCallback callback,
+    void* context);
+
+/** Cancels asynchronous requests of the file that are not started yet
+ * Callbacks of cancelled requests are called with FSE_CANCELLED.
+ * When this function returns, all requests queued before it are completed or cancelled.
+ * @param file pointer to file object
+ * @return uint16_t how many requests were cancelled
+ */
+uint16_t storage_file_async_cancel(File* file);
+
 /**
  * @brief Check that file exists
  * 
@@ -184,6 +317,28 @@ bool storage_dir_close(File* file);
  */
 bool storage_dir_read(File* file, FileInfo* fileinfo, char* name, uint16_t name_length);
 
+/** Directory entry placed by storage_dir_read_batch */
+typedef struct {
+    FileInfo fileinfo;
+    uint16_t size; /**< record size, the next record starts right after it */
+    char name[]; /**< zero terminated name */
+} StorageDirEntry;
+
+/** Name buffer size of a batch entry, longer names are truncated like in storage_dir_read */
+#define STORAGE_DIR_ENTRY_NAME_SIZE 256
+
+/** Buffer space that one batch entry may take */
+#define STORAGE_DIR_ENTRY_SIZE_MAX (sizeof(StorageDirEntry) + STORAGE_DIR_ENTRY_NAME_SIZE)
+
+/** Reads as many next objects of the directory as fit into the buffer, in one request
+ * @param file pointer to file object.
+ * @param buffer buffer for StorageDirEntry records, aligned like StorageDirEntry
+ * @param size buffer size, at least STORAGE_DIR_ENTRY_SIZE_MAX
+ * @return uint16_t bytes of the buffer used by records, 0 on error or if there are no more
+ *         objects (the file error id is FSE_NOT_EXIST then)
+ */
+uint16_t storage_dir_read_batch(File* file, void* buffer, uint16_t size);
+
 /** Rewinds the read pointer to first item in the directory
  * @param file pointer to file object.
  * @return bool success flag
@@ -242,6 +397,41 @@ FS_Error storage_common_rename(Storage* storage, const char* old_path, const cha
  */
 FS_Error storage_common_copy(Storage* storage, const char* old_path, const char* new_path);
 
+/** Copy progress */
+typedef struct {
+    const char* path; /**< source file being copied */
+    uint64_t file_size;
+    uint64_t file_copied;
+    uint64_t total_copied; /**< bytes copied by this call, all files */
+    uint32_t files; /**< files copied by this call, the current one is not counted */
+} StorageCopyProgress;
+
+/** Copy progress callback
+ * Called from the storage thread after each chunk, must not call storage functions.
+ * @param progress copy progress
+ * @param context callback context
+ * @return false to cancel the copy
+ */
+typedef bool (*StorageCopyCallback)(const StorageCopyProgress* progress, void* context);
+
+/** Copy file or directory with progress reports, file must not be open
+ * Each file is copied by the storage thread at once, with a large buffer,
+ * destination space is allocated upfront, modification time is preserved
+ * when the filesystem supports it. Unfinished or cancelled destination file is removed.
+ * @param storage pointer to the api
+ * @param old_path old path
+ * @param new_path new path
+ * @param callback progress callback, can be NULL
+ * @param context callback context
+ * @return FS_Error operation result, FSE_CANCELLED if cancelled by the callback
+ */
+FS_Error storage_common_copy_ex(
+    Storage* storage,
+    const char* old_path,
+    const char* new_path,
+    StorageCopyCallback callback,
+    void* context);
+
 /** Copy one folder contents into another with rename of all conflicting files
  * @param app pointer to the api
  * @param old_path old path
@@ -8,8 +8,13 @@
 #include <storage/storage.h>
 #include <storage/storage_sd_api.h>
 #include <power/power_service/power.h>
+#include <sector_cache.h>
+
+#include "storage_i.h"
+#include "storage_message.h"
 
 #define MAX_NAME_LENGTH 255
+#define WATCH_QUEUE_SIZE 16
 
 static void storage_cli_print_usage() {
     printf("Usage:\r\n");
@@ -33,6 +38,10 @@ static void storage_cli_print_usage() {
     printf("\tmd5\t - md5 hash of the file\r\n");
     printf("\tstat\t - info about file or dir\r\n");
     printf("\ttimestamp\t - last modification timestamp\r\n");
+    printf("\tstats\t - storage thread statistics per command, no <path>\r\n");
+    printf(
+        "\ttrace\t - I/O trace, <path> is start, stop, clear, apps (per app counters) or dump (binary)\r\n");
+    printf("\twatch\t - print changes in the directory, stops by ctrl+c\r\n");
 };
 
 static void storage_cli_print_error(FS_Error error) {
@@ -80,6 +89,20 @@ static void storage_cli_info(Cli* cli, FuriString* path) {
                 sd_info.product_serial_number,
                 sd_info.manufacturing_month,
                 sd_info.manufacturing_year);
+
+            SectorCacheStats stats;
+            sector_cache_get_stats(&stats);
+            uint32_t lookups = stats.hits + stats.misses;
+            printf(
+                "Cache: %lu sectors, %lu hits, %lu misses (%lu%% hit rate)\r\n"
+                "Cache writes: %lu coalesced, %lu written back, %lu dirty\r\n",
+                stats.sectors,
+                stats.hits,
+                stats.misses,
+                lookups ? (uint32_t)((uint64_t)stats.hits * 100 / lookups) : 0,
+                stats.coalesced,
+                stats.written_back,
+                stats.dirty);
         }
     } else {
         storage_cli_print_usage();
@@ -88,6 +111,135 @@ static void storage_cli_info(Cli* cli, FuriString* path) {
     furi_record_close(RECORD_STORAGE);
 };
 
+static const char* const storage_cli_command_names[] = {
+    [StorageCommandFileOpen] = "file open",
+    [StorageCommandFileClose] = "file close",
+    [StorageCommandFileRead] = "file read",
+    [StorageCommandFileBorrow] = "file borrow",
+    [StorageCommandFileWrite] = "file write",
+    [StorageCommandFileSeek] = "file seek",
+    [StorageCommandFileTell] = "file tell",
+    [StorageCommandFileTruncate] = "file truncate",
+    [StorageCommandFilePreallocate] = "file preallocate",
+    [StorageCommandFileSize] = "file size",
+    [StorageCommandFileSync] = "file sync",
+    [StorageCommandFileEof] = "file eof",
+    [StorageCommandFileAsyncCancel] = "file async cancel",
+    [StorageCommandDirOpen] = "dir open",
+    [StorageCommandDirClose] = "dir close",
+    [StorageCommandDirRead] = "dir read",
+    [StorageCommandDirReadBatch] = "dir read batch",
+    [StorageCommandDirRewind] = "dir rewind",
+    [StorageCommandCommonTimestamp] = "timestamp",
+    [StorageCommandCommonStat] = "stat",
+    [StorageCommandCommonRemove] = "remove",
+    [StorageCommandCommonMkDir] = "mkdir",
+    [StorageCommandCommonCopy] = "copy",
+    [StorageCommandCommonFSInfo] = "fs info",
+    [StorageCommandSDFormat] = "sd format",
+    [StorageCommandSDUnmount] = "sd unmount",
+    [StorageCommandSDInfo] = "sd info",
+    [StorageCommandSDStatus] = "sd status",
+    [StorageCommandCommonResolvePath] = "resolve path",
+    [StorageCommandCommonRenameNotify] = "rename notify",
+};
+
+_Static_assert(
+    COUNT_OF(storage_cli_command_names) == STORAGE_COMMAND_COUNT,
+    "Storage command names mismatch");
+
+static void storage_cli_stats(Cli* cli) {
+    UNUSED(cli);
+    Storage* api = furi_record_open(RECORD_STORAGE);
+
+    // Counters are updated by storage thread, small tearing is fine here
+    printf(
+        "%-18s %10s %12s %10s %10s %12s\r\n",
+        "Command",
+        "Count",
+        "Total us",
+        "Avg us",
+        "Max us",
+        "Bytes");
+    for(size_t i = 0; i < STORAGE_COMMAND_COUNT; i++) {
+        StorageCommandStats stats = api->stats[i];
+        if(stats.count == 0) continue;
+
+        printf(
+            "%-18s %10lu %12lu %10lu %10lu %12lu",
+            storage_cli_command_names[i],
+            stats.count,
+            (uint32_t)stats.time_total,
+            (uint32_t)(stats.time_total / stats.count),
+            stats.time_max,
+            (uint32_t)stats.bytes);
+        if(stats.bytes && stats.time_total) {
+            printf(" %lu KiB/s", (uint32_t)(stats.bytes * 1000000 / 1024 / stats.time_total));
+        }
+        printf("\r\n");
+    }
+
+    furi_record_close(RECORD_STORAGE);
+}
+
+static void storage_cli_trace_apps(StorageTrace* trace) {
+    StorageTraceApp* apps = malloc(sizeof(StorageTraceApp) * STORAGE_TRACE_APPS);
+    uint8_t count = storage_trace_get_apps(trace, apps);
+
+    printf(
+        "%-23s %8s %12s %12s %8s %8s\r\n", "App", "Ops", "Bytes", "Total us", "p50 us", "p99 us");
+    for(uint8_t i = 0; i < count; i++) {
+        printf(
+            "%-23s %8lu %12lu %12lu %8lu %8lu\r\n",
+            apps[i].name,
+            apps[i].ops,
+            (uint32_t)apps[i].bytes,
+            (uint32_t)apps[i].time_total,
+            storage_trace_app_percentile(&apps[i], 50),
+            storage_trace_app_percentile(&apps[i], 99));
+    }
+
+    free(apps);
+}
+
+static void storage_cli_trace_dump(Cli* cli, StorageTrace* trace) {
+    size_t size;
+    uint8_t* dump = storage_trace_dump(trace, &size);
+
+    if(dump == NULL) {
+        printf("No trace, start it first\r\n");
+    } else {
+        printf("Size: %lu\r\n", (uint32_t)size);
+        cli_write(cli, dump, size);
+        printf("\r\n");
+        free(dump);
+    }
+}
+
+static void storage_cli_trace(Cli* cli, FuriString* args) {
+    Storage* api = furi_record_open(RECORD_STORAGE);
+    FuriString* action = furi_string_alloc();
+
+    if(!args_read_string_and_trim(args, action)) {
+        storage_cli_print_usage();
+    } else if(furi_string_cmp_str(action, "start") == 0) {
+        storage_trace_start(api->trace);
+    } else if(furi_string_cmp_str(action, "stop") == 0) {
+        storage_trace_stop(api->trace);
+    } else if(furi_string_cmp_str(action, "clear") == 0) {
+        storage_trace_clear(api->trace);
+    } else if(furi_string_cmp_str(action, "apps") == 0) {
+        storage_cli_trace_apps(api->trace);
+    } else if(furi_string_cmp_str(action, "dump") == 0) {
+        storage_cli_trace_dump(cli, api->trace);
+    } else {
+        storage_cli_print_usage();
+    }
+
+    furi_string_free(action);
+    furi_record_close(RECORD_STORAGE);
+}
+
 static void storage_cli_format(Cli* cli, FuriString* path) {
     if(furi_string_cmp_str(path, STORAGE_INT_PATH_PREFIX) == 0) {
         storage_cli_print_error(FSE_NOT_IMPLEMENTED);
@@ -478,6 +630,63 @@ static void storage_cli_mkdir(Cli* cli, FuriString* path) {
     furi_record_close(RECORD_STORAGE);
 }
 
+static const char* storage_cli_watch_event_name(StorageWatchEvent event) {
+    switch(event) {
+    case StorageWatchEventCreate:
+        return "create";
+    case StorageWatchEventModify:
+        return "modify";
+    case StorageWatchEventDelete:
+        return "delete";
+    case StorageWatchEventRename:
+        return "rename";
+    }
+
+    return "unknown";
+}
+
+static void storage_cli_watch_callback(const StorageWatchMessage* message, void* context) {
+    FuriMessageQueue* queue = context;
+
+    // Storage thread can't print to cli, line is printed by cli thread
+    FuriString* line = furi_string_alloc_printf(
+        "%s %s", storage_cli_watch_event_name(message->event), message->path);
+    if(message->old_path) {
+        furi_string_cat_printf(line, " <- %s", message->old_path);
+    }
+
+    if(furi_message_queue_put(queue, &line, 0) != FuriStatusOk) {
+        furi_string_free(line);
+    }
+}
+
+static void storage_cli_watch(Cli* cli, FuriString* path) {
+    Storage* api = furi_record_open(RECORD_STORAGE);
+    FuriMessageQueue* queue = furi_message_queue_alloc(WATCH_QUEUE_SIZE, sizeof(FuriString*));
+    StorageWatch* watch = storage_watch_dir(
+        api,
+        furi_string_get_cstr(path),
+        STORAGE_WATCH_EVENT_ALL,
+        storage_cli_watch_callback,
+        queue);
+
+    printf("Press Ctrl+C to stop\r\n");
+    FuriString* line;
+    while(!cli_cmd_interrupt_received(cli)) {
+        if(furi_message_queue_get(queue, &line, 100) == FuriStatusOk) {
+            printf("%s\r\n", furi_string_get_cstr(line));
+            furi_string_free(line);
+        }
+    }
+
+    storage_unwatch_dir(watch);
+    while(furi_message_queue_get(queue, &line, 0) == FuriStatusOk) {
+        furi_string_free(line);
+    }
+    furi_message_queue_free(queue);
+    furi_record_close(RECORD_STORAGE);
+}
+
 static void storage_cli_md5(Cli* cli, FuriString* path) {
     UNUSED(cli);
     Storage* api = furi_record_open(RECORD_STORAGE);
@@ -529,6 +738,16 @@ void storage_cli(Cli* cli, FuriString* args, void* context) {
             break;
         }
 
+        if(furi_string_cmp_str(cmd, "stats") == 0) {
+            storage_cli_stats(cli);
+            break;
+        }
+
+        if(furi_string_cmp_str(cmd, "trace") == 0) {
+            storage_cli_trace(cli, args);
+            break;
+        }
+
         if(!args_read_probably_quoted_string_and_trim(args, path)) {
             storage_cli_print_usage();
             break;
@@ -609,6 +828,11 @@ void storage_cli(Cli* cli, FuriString* args, void* context) {
             break;
         }
 
+        if(furi_string_cmp_str(cmd, "watch") == 0) {
+            storage_cli_watch(cli, path);
+            break;
+        }
+
         storage_cli_print_usage();
     } while(false);
 
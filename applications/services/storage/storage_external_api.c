@@ -3,16 +3,18 @@
 #include "storage.h"
 #include "storage_i.h"
 #include "storage_message.h"
-#include <toolbox/stream/file_stream.h>
 #include <toolbox/dir_walk.h>
 #include "toolbox/path.h"
+#include <m-array.h>
 
-#define MAX_NAME_LENGTH 256
 #define MAX_EXT_LEN 16
 #define FILE_BUFFER_SIZE 512
+#define WALK_ARENA_SIZE 1024
 
 #define TAG "StorageAPI"
 
+ARRAY_DEF(StoragePathArray, FuriString*, FURI_STRING_OPLIST)
+
 #define S_API_PROLOGUE FuriApiLock lock = api_lock_alloc_locked();
 
 #define S_FILE_API_PROLOGUE           \
@@ -25,13 +27,14 @@
         FuriStatusOk);                                                               \
     api_lock_wait_unlock_and_free(lock)
 
-#define S_API_MESSAGE(_command)      \
-    SAReturn return_data;            \
-    StorageMessage message = {       \
-        .lock = lock,                \
-        .command = _command,         \
-        .data = &data,               \
-        .return_data = &return_data, \
+#define S_API_MESSAGE(_command)                     \
+    SAReturn return_data;                           \
+    StorageMessage message = {                      \
+        .lock = lock,                               \
+        .command = _command,                        \
+        .data = &data,                              \
+        .return_data = &return_data,                \
+        .thread_id = furi_thread_get_current_id(), \
     };
 
 #define S_API_DATA_FILE   \
@@ -45,6 +48,7 @@
 #define S_RETURN_UINT64 (return_data.uint64_value);
 #define S_RETURN_ERROR (return_data.error_value);
 #define S_RETURN_CSTRING (return_data.cstring_value);
+#define S_RETURN_POINTER (return_data.pointer_value);
 
 typedef enum {
     StorageEventFlagFileClose = (1 << 0),
@@ -159,6 +163,26 @@ uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read) {
     return S_RETURN_UINT16;
 }
 
+const void* storage_file_borrow(File* file, size_t* size) {
+    furi_assert(size);
+    if(*size == 0) {
+        return NULL;
+    }
+
+    S_FILE_API_PROLOGUE;
+    S_API_PROLOGUE;
+
+    SAData data = {
+        .fborrow = {
+            .file = file,
+            .size = size,
+        }};
+
+    S_API_MESSAGE(StorageCommandFileBorrow);
+    S_API_EPILOGUE;
+    return S_RETURN_POINTER;
+}
+
 uint16_t storage_file_write(File* file, const void* buff, uint16_t bytes_to_write) {
     if(bytes_to_write == 0) {
         return 0;
@@ -213,6 +237,21 @@ bool storage_file_truncate(File* file) {
     return S_RETURN_BOOL;
 }
 
+bool storage_file_preallocate(File* file, uint64_t size) {
+    S_FILE_API_PROLOGUE;
+    S_API_PROLOGUE;
+
+    SAData data = {
+        .fpreallocate = {
+            .file = file,
+            .size = size,
+        }};
+
+    S_API_MESSAGE(StorageCommandFilePreallocate);
+    S_API_EPILOGUE;
+    return S_RETURN_BOOL;
+}
+
 uint64_t storage_file_size(File* file) {
     S_FILE_API_PROLOGUE;
     S_API_PROLOGUE;
@@ -240,6 +279,94 @@ bool storage_file_eof(File* file) {
     return S_RETURN_BOOL;
 }
 
+/****************** FILE ASYNC ******************/
+
+static bool storage_async_acquire(Storage* storage) {
+    bool acquired = false;
+
+    FURI_CRITICAL_ENTER();
+    if(storage->async_count < STORAGE_ASYNC_DEPTH) {
+        storage->async_count++;
+        acquired = true;
+    }
+    FURI_CRITICAL_EXIT();
+
+    return acquired;
+}
+
+static void storage_async_send(
+    Storage* storage,
+    StorageCommand command,
+    StorageAsyncRequest* request) {
+    StorageMessage message = {
+        .command = command,
+        .data = &request->data,
+        .return_data = &request->return_data,
+        .async = request,
+        .thread_id = furi_thread_get_current_id(),
+    };
+
+    furi_check(
+        furi_message_queue_put(storage->message_queue, &message, FuriWaitForever) ==
+        FuriStatusOk);
+}
+
+bool storage_file_read_async(
+    File* file,
+    void* buff,
+    uint16_t bytes_to_read,
+    StorageAsyncCallback callback,
+    void* context) {
+    S_FILE_API_PROLOGUE;
+    if(!storage_async_acquire(storage)) {
+        return false;
+    }
+
+    StorageAsyncRequest* request = malloc(sizeof(StorageAsyncRequest));
+    request->data.fread.file = file;
+    request->data.fread.buff = buff;
+    request->data.fread.bytes_to_read = bytes_to_read;
+    request->callback = callback;
+    request->context = context;
+
+    storage_async_send(storage, StorageCommandFileRead, request);
+    return true;
+}
+
+bool storage_file_write_async(
+    File* file,
+    const void* buff,
+    uint16_t bytes_to_write,
+    StorageAsyncCallback callback,
+    void* context) {
+    S_FILE_API_PROLOGUE;
+    if(!storage_async_acquire(storage)) {
+        return false;
+    }
+
+    StorageAsyncRequest* request = malloc(sizeof(StorageAsyncRequest));
+    request->data.fwrite.file = file;
+    request->data.fwrite.buff = buff;
+    request->data.fwrite.bytes_to_write = bytes_to_write;
+    request->callback = callback;
+    request->context = context;
+
+    storage_async_send(storage, StorageCommandFileWrite, request);
+    return true;
+}
+
+uint16_t storage_file_async_cancel(File* file) {
+    S_FILE_API_PROLOGUE;
+    // Storage thread drops requests of the file until it gets the message below
+    file->async_cancel = true;
+
+    S_API_PROLOGUE;
+    S_API_DATA_FILE;
+    S_API_MESSAGE(StorageCommandFileAsyncCancel);
+    S_API_EPILOGUE;
+    return S_RETURN_UINT16;
+}
+
 bool storage_file_exists(Storage* storage, const char* path) {
     bool exist = false;
     FileInfo fileinfo;
@@ -357,6 +484,24 @@ bool storage_dir_read(File* file, FileInfo* fileinfo, char* name, uint16_t name_
     return S_RETURN_BOOL;
 }
 
+uint16_t storage_dir_read_batch(File* file, void* buffer, uint16_t size) {
+    furi_check(size >= STORAGE_DIR_ENTRY_SIZE_MAX);
+    furi_assert(((uintptr_t)buffer % _Alignof(StorageDirEntry)) == 0);
+    S_FILE_API_PROLOGUE;
+    S_API_PROLOGUE;
+
+    SAData data = {
+        .dreadbatch = {
+            .file = file,
+            .buffer = buffer,
+            .size = size,
+        }};
+
+    S_API_MESSAGE(StorageCommandDirReadBatch);
+    S_API_EPILOGUE;
+    return S_RETURN_UINT16;
+}
+
 bool storage_dir_rewind(File* file) {
     S_FILE_API_PROLOGUE;
     S_API_PROLOGUE;
@@ -429,20 +574,88 @@ FS_Error storage_common_rename(Storage* storage, const char* old_path, const cha
         }
     }
 
+    // Rename is copy and remove, storage thread publishes the watch event after its parts
+    if(error == FSE_OK && storage->watch_count > 0) {
+        S_API_PROLOGUE;
+        SAData data = {
+            .crename = {
+                .old_path = old_path,
+                .new_path = new_path,
+                .thread_id = furi_thread_get_current_id(),
+            }};
+
+        S_API_MESSAGE(StorageCommandCommonRenameNotify);
+        S_API_EPILOGUE;
+    }
+
     return error;
 }
 
-static FS_Error
-    storage_copy_recursive(Storage* storage, const char* old_path, const char* new_path) {
+static FS_Error storage_copy_file_internal(
+    Storage* storage,
+    const char* old_path,
+    const char* new_path,
+    StorageCopyProgress* progress,
+    StorageCopyCallback callback,
+    void* context) {
+    S_API_PROLOGUE;
+    SAData data = {
+        .ccopy = {
+            .old_path = old_path,
+            .new_path = new_path,
+            .progress = progress,
+            .callback = callback,
+            .context = context,
+            .thread_id = furi_thread_get_current_id(),
+        }};
+
+    S_API_MESSAGE(StorageCommandCommonCopy);
+    S_API_EPILOGUE;
+    return S_RETURN_ERROR;
+}
+
+static FS_Error storage_copy_file(
+    Storage* storage,
+    const char* old_path,
+    const char* new_path,
+    StorageCopyProgress* progress,
+    StorageCopyCallback callback,
+    void* context) {
+    FS_Error error;
+    FuriEventFlag* event = furi_event_flag_alloc();
+    FuriPubSubSubscription* subscription = furi_pubsub_subscribe(
+        storage_get_pubsub(storage), storage_file_close_callback, event);
+
+    // Same as storage_file_open, wait until the other side closes the file
+    do {
+        error =
+            storage_copy_file_internal(storage, old_path, new_path, progress, callback, context);
+
+        if(error == FSE_ALREADY_OPEN) {
+            furi_event_flag_wait(
+                event, StorageEventFlagFileClose, FuriFlagWaitAny, FuriWaitForever);
+        } else {
+            break;
+        }
+    } while(true);
+
+    furi_pubsub_unsubscribe(storage_get_pubsub(storage), subscription);
+    furi_event_flag_free(event);
+    return error;
+}
+
+static FS_Error storage_copy_recursive(
+    Storage* storage,
+    const char* old_path,
+    const char* new_path,
+    StorageCopyProgress* progress,
+    StorageCopyCallback callback,
+    void* context) {
     FS_Error error = storage_common_mkdir(storage, new_path);
     DirWalk* dir_walk = dir_walk_alloc(storage);
-    FuriString* path;
-    FuriString* tmp_new_path;
-    FuriString* tmp_old_path;
-    FileInfo fileinfo;
-    path = furi_string_alloc();
-    tmp_new_path = furi_string_alloc();
-    tmp_old_path = furi_string_alloc();
+    uint8_t* arena = malloc(WALK_ARENA_SIZE);
+    FuriString* tmp_new_path = furi_string_alloc();
+    size_t old_path_length = strlen(old_path);
 
     do {
         if(error != FSE_OK) break;
@@ -452,73 +665,72 @@ static FS_Error
             break;
         }
 
-        while(1) {
-            DirWalkResult res = dir_walk_read(dir_walk, path, &fileinfo);
-
-            if(res == DirWalkError) {
-                error = dir_walk_get_error(dir_walk);
-                break;
-            } else if(res == DirWalkLast) {
-                break;
-            } else {
-                furi_string_set(tmp_old_path, path);
-                furi_string_right(path, strlen(old_path));
-                furi_string_printf(tmp_new_path, "%s%s", new_path, furi_string_get_cstr(path));
-
-                if(file_info_is_dir(&fileinfo)) {
+        // Directory always comes before its content, so it is created first
+        size_t used;
+        DirWalkResult res;
+        while((res = dir_walk_read_batch(dir_walk, arena, WALK_ARENA_SIZE, &used)) ==
+              DirWalkOK) {
+            size_t offset = 0;
+            while(offset < used && error == FSE_OK) {
+                const DirWalkEntry* entry = (const DirWalkEntry*)&arena[offset];
+                offset += entry->size;
+
+                furi_string_printf(tmp_new_path, "%s%s", new_path, &entry->path[old_path_length]);
+                if(file_info_is_dir(&entry->fileinfo)) {
                     error = storage_common_mkdir(storage, furi_string_get_cstr(tmp_new_path));
                 } else {
-                    error = storage_common_copy(
+                    error = storage_copy_file(
                         storage,
-                        furi_string_get_cstr(tmp_old_path),
-                        furi_string_get_cstr(tmp_new_path));
+                        entry->path,
+                        furi_string_get_cstr(tmp_new_path),
+                        progress,
+                        callback,
+                        context);
                 }
-
-                if(error != FSE_OK) break;
             }
+
+            if(error != FSE_OK) break;
         }
 
+        if(res == DirWalkError) {
+            error = dir_walk_get_error(dir_walk);
+        }
     } while(false);
 
     furi_string_free(tmp_new_path);
-    furi_string_free(tmp_old_path);
-    furi_string_free(path);
+    free(arena);
     dir_walk_free(dir_walk);
     return error;
 }
 
-FS_Error storage_common_copy(Storage* storage, const char* old_path, const char* new_path) {
+FS_Error storage_common_copy_ex(
+    Storage* storage,
+    const char* old_path,
+    const char* new_path,
+    StorageCopyCallback callback,
+    void* context) {
     FS_Error error;
+    StorageCopyProgress progress = {0};
 
     FileInfo fileinfo;
     error = storage_common_stat(storage, old_path, &fileinfo);
 
     if(error == FSE_OK) {
         if(file_info_is_dir(&fileinfo)) {
-            error = storage_copy_recursive(storage, old_path, new_path);
+            error =
+                storage_copy_recursive(storage, old_path, new_path, &progress, callback, context);
         } else {
-            Stream* stream_from = file_stream_alloc(storage);
-            Stream* stream_to = file_stream_alloc(storage);
-
-            do {
-                if(!file_stream_open(stream_from, old_path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
-                if(!file_stream_open(stream_to, new_path, FSAM_WRITE, FSOM_CREATE_NEW)) break;
-                stream_copy_full(stream_from, stream_to);
-            } while(false);
-
-            error = file_stream_get_error(stream_from);
-            if(error == FSE_OK) {
-                error = file_stream_get_error(stream_to);
-            }
-
-            stream_free(stream_from);
-            stream_free(stream_to);
+            error = storage_copy_file(storage, old_path, new_path, &progress, callback, context);
         }
     }
 
     return error;
 }
 
+FS_Error storage_common_copy(Storage* storage, const char* old_path, const char* new_path) {
+    return storage_common_copy_ex(storage, old_path, new_path, NULL, NULL);
+}
+
 static FS_Error
     storage_merge_recursive(Storage* storage, const char* old_path, const char* new_path) {
     FS_Error error = FSE_OK;
@@ -624,22 +836,8 @@ FS_Error storage_common_merge(Storage* storage, const char* old_path, const char
             } else {
                 new_path_tmp = new_path;
             }
-            Stream* stream_from = file_stream_alloc(storage);
-            Stream* stream_to = file_stream_alloc(storage);
-
-            do {
-                if(!file_stream_open(stream_from, old_path, FSAM_READ, FSOM_OPEN_EXISTING)) break;
-                if(!file_stream_open(stream_to, new_path_tmp, FSAM_WRITE, FSOM_CREATE_NEW)) break;
-                stream_copy_full(stream_from, stream_to);
-            } while(false);
-
-            error = file_stream_get_error(stream_from);
-            if(error == FSE_OK) {
-                error = file_stream_get_error(stream_to);
-            }
-
-            stream_free(stream_from);
-            stream_free(stream_to);
+            StorageCopyProgress progress = {0};
+            error = storage_copy_file(storage, old_path, new_path_tmp, &progress, NULL, NULL);
         }
     }
 
@@ -806,66 +1004,148 @@ FuriPubSub* storage_get_pubsub(Storage* storage) {
     return storage->pubsub;
 }
 
+/****************** WATCH ******************/
+
+struct StorageWatch {
+    Storage* storage;
+    FuriString* path;
+    uint32_t mask;
+    StorageWatchCallback callback;
+    void* context;
+    FuriPubSubSubscription* subscription;
+};
+
+static bool storage_watch_is_child(FuriString* dir, const char* path) {
+    const char* name = strrchr(path, '/');
+    return name && ((size_t)(name - path) == furi_string_size(dir)) &&
+           (strncmp(path, furi_string_get_cstr(dir), furi_string_size(dir)) == 0);
+}
+
+static void storage_watch_callback(const void* message, void* context) {
+    const StorageWatchMessage* watch_message = message;
+    StorageWatch* watch = context;
+
+    if(watch_message->event & watch->mask) {
+        bool match = storage_watch_is_child(watch->path, watch_message->path);
+        if(!match && watch_message->old_path) {
+            match = storage_watch_is_child(watch->path, watch_message->old_path);
+        }
+
+        if(match) {
+            watch->callback(watch_message, watch->context);
+        }
+    }
+}
+
+StorageWatch* storage_watch_dir(
+    Storage* storage,
+    const char* path,
+    uint32_t mask,
+    StorageWatchCallback callback,
+    void* context) {
+    furi_assert(storage);
+    furi_assert(path);
+    furi_assert(callback);
+
+    StorageWatch* watch = malloc(sizeof(StorageWatch));
+    watch->storage = storage;
+    watch->path = furi_string_alloc_set(path);
+    watch->mask = mask;
+    watch->callback = callback;
+    watch->context = context;
+
+    storage_common_resolve_path_and_ensure_app_directory(storage, watch->path);
+    if(furi_string_end_with(watch->path, "/")) {
+        furi_string_left(watch->path, furi_string_size(watch->path) - 1);
+    }
+
+    watch->subscription =
+        furi_pubsub_subscribe(storage->watch_pubsub, storage_watch_callback, watch);
+
+    FURI_CRITICAL_ENTER();
+    storage->watch_count++;
+    FURI_CRITICAL_EXIT();
+
+    return watch;
+}
+
+void storage_unwatch_dir(StorageWatch* watch) {
+    furi_assert(watch);
+    Storage* storage = watch->storage;
+
+    FURI_CRITICAL_ENTER();
+    storage->watch_count--;
+    FURI_CRITICAL_EXIT();
+
+    furi_pubsub_unsubscribe(storage->watch_pubsub, watch->subscription);
+    furi_string_free(watch->path);
+    free(watch);
+}
+
+FuriPubSub* storage_get_watch_pubsub(Storage* storage) {
+    return storage->watch_pubsub;
+}
+
 bool storage_simply_remove_recursive(Storage* storage, const char* path) {
     furi_assert(storage);
     furi_assert(path);
-    FileInfo fileinfo;
     bool result = false;
-    FuriString* fullname;
-    FuriString* cur_dir;
 
     if(storage_simply_remove(storage, path)) {
         return true;
     }
 
-    char* name = malloc(MAX_NAME_LENGTH + 1); //-V799
-    File* dir = storage_file_alloc(storage);
-    cur_dir = furi_string_alloc_set(path);
-    bool go_deeper = false;
+    DirWalk* dir_walk = dir_walk_alloc(storage);
+    uint8_t* arena = malloc(WALK_ARENA_SIZE);
+    StoragePathArray_t dirs;
+    StoragePathArray_init(dirs);
 
-    while(1) {
-        if(!storage_dir_open(dir, furi_string_get_cstr(cur_dir))) {
-            storage_dir_close(dir);
+    do {
+        if(!dir_walk_open(dir_walk, path)) {
             break;
         }
 
-        while(storage_dir_read(dir, &fileinfo, name, MAX_NAME_LENGTH)) {
-            if(file_info_is_dir(&fileinfo)) {
-                furi_string_cat_printf(cur_dir, "/%s", name);
-                go_deeper = true;
-                break;
+        // Files go right away, directories when they are empty
+        size_t used;
+        DirWalkResult res;
+        while((res = dir_walk_read_batch(dir_walk, arena, WALK_ARENA_SIZE, &used)) ==
+              DirWalkOK) {
+            for(size_t offset = 0; offset < used;) {
+                const DirWalkEntry* entry = (const DirWalkEntry*)&arena[offset];
+                offset += entry->size;
+
+                if(file_info_is_dir(&entry->fileinfo)) {
+                    furi_string_set(*StoragePathArray_push_new(dirs), entry->path);
+                } else {
+                    FS_Error error = storage_common_remove(storage, entry->path);
+                    furi_check(error == FSE_OK);
+                }
             }
+        }
 
-            fullname = furi_string_alloc_printf("%s/%s", furi_string_get_cstr(cur_dir), name);
-            FS_Error error = storage_common_remove(storage, furi_string_get_cstr(fullname));
-            furi_check(error == FSE_OK);
-            furi_string_free(fullname);
+        if(res != DirWalkLast) {
+            break;
         }
-        storage_dir_close(dir);
 
-        if(go_deeper) {
-            go_deeper = false;
-            continue;
+        // Directory is found after its parent, so the deepest ones are the last
+        FuriString* dir = furi_string_alloc();
+        while(StoragePathArray_size(dirs) > 0) {
+            StoragePathArray_pop_back(&dir, dirs);
+            FS_Error error = storage_common_remove(storage, furi_string_get_cstr(dir));
+            furi_check(error == FSE_OK);
         }
+        furi_string_free(dir);
 
-        FS_Error error = storage_common_remove(storage, furi_string_get_cstr(cur_dir));
+        FS_Error error = storage_common_remove(storage, path);
         furi_check(error == FSE_OK);
+        result = true;
+    } while(false);
 
-        if(furi_string_cmp(cur_dir, path)) {
-            size_t last_char = furi_string_search_rchar(cur_dir, '/');
-            furi_assert(last_char != FURI_STRING_FAILURE);
-            furi_string_left(cur_dir, last_char);
-        } else {
-            result = true;
-            break;
-        }
-    }
-
-    storage_file_free(dir);
-    furi_string_free(cur_dir);
-    free(name);
+    StoragePathArray_clear(dirs);
+    free(arena);
+    dir_walk_free(dir_walk);
     return result;
-} //-V773
+}
 
 bool storage_simply_remove(Storage* storage, const char* path) {
     FS_Error result;
@@ -1,36 +1,13 @@
 #include "storage_glue.h"
 #include <furi_hal.h>
 
-/****************** storage file ******************/
-
-void storage_file_init(StorageFile* obj) {
-    obj->file = NULL;
-    obj->file_data = NULL;
-    obj->path = furi_string_alloc();
-}
-
-void storage_file_init_set(StorageFile* obj, const StorageFile* src) {
-    obj->file = src->file;
-    obj->file_data = src->file_data;
-    obj->path = furi_string_alloc_set(src->path);
-}
-
-void storage_file_set(StorageFile* obj, const StorageFile* src) { //-V524
-    obj->file = src->file;
-    obj->file_data = src->file_data;
-    furi_string_set(obj->path, src->path);
-}
-
-void storage_file_clear(StorageFile* obj) {
-    furi_string_free(obj->path);
-}
-
 /****************** storage data ******************/
 
 void storage_data_init(StorageData* storage) {
     storage->data = NULL;
     storage->status = StorageStatusNotReady;
-    StorageFileList_init(storage->files);
+    StorageFileDict_init(storage->files);
+    StoragePathDict_init(storage->paths);
 }
 
 StorageStatus storage_data_status(StorageData* storage) {
@@ -73,79 +50,51 @@ uint32_t storage_data_get_timestamp(StorageData* storage) {
 
 /****************** storage glue ******************/
 
-static StorageFile* storage_get_file(const File* file, StorageData* storage) {
-    StorageFile* storage_file_ref = NULL;
-
-    StorageFileList_it_t it;
-    for(StorageFileList_it(it, storage->files); !StorageFileList_end_p(it);
-        StorageFileList_next(it)) {
-        StorageFile* storage_file = StorageFileList_ref(it);
-
-        if(storage_file->file->file_id == file->file_id) {
-            storage_file_ref = storage_file;
-            break;
-        }
-    }
-
-    return storage_file_ref;
+StorageFile* storage_get_storage_file(const File* file, StorageData* storage) {
+    StorageFile** storage_file_ref = StorageFileDict_get(storage->files, file->file_id);
+    return storage_file_ref ? *storage_file_ref : NULL;
 }
 
 bool storage_has_file(const File* file, StorageData* storage) {
-    return storage_get_file(file, storage) != NULL;
+    return storage_get_storage_file(file, storage) != NULL;
 }
 
 bool storage_path_already_open(FuriString* path, StorageData* storage) {
-    bool open = false;
-
-    StorageFileList_it_t it;
-
-    for(StorageFileList_it(it, storage->files); !StorageFileList_end_p(it);
-        StorageFileList_next(it)) {
-        const StorageFile* storage_file = StorageFileList_cref(it);
-
-        if(furi_string_cmp(storage_file->path, path) == 0) {
-            open = true;
-            break;
-        }
-    }
-
-    return open;
+    return StoragePathDict_get(storage->paths, furi_string_get_cstr(path)) != NULL;
 }
 
 void storage_set_storage_file_data(const File* file, void* file_data, StorageData* storage) {
-    StorageFile* storage_file_ref = storage_get_file(file, storage);
+    StorageFile* storage_file_ref = storage_get_storage_file(file, storage);
     furi_check(storage_file_ref != NULL);
     storage_file_ref->file_data = file_data;
 }
 
 void* storage_get_storage_file_data(const File* file, StorageData* storage) {
-    StorageFile* storage_file_ref = storage_get_file(file, storage);
+    StorageFile* storage_file_ref = storage_get_storage_file(file, storage);
     furi_check(storage_file_ref != NULL);
     return storage_file_ref->file_data;
 }
 
 void storage_push_storage_file(File* file, FuriString* path, StorageData* storage) {
-    StorageFile* storage_file = StorageFileList_push_new(storage->files);
+    StorageFile* storage_file = malloc(sizeof(StorageFile));
     file->file_id = (uint32_t)storage_file;
     storage_file->file = file;
-    furi_string_set(storage_file->path, path);
+    storage_file->path = furi_string_alloc_set(path);
+
+    StorageFileDict_set_at(storage->files, file->file_id, storage_file);
+    StoragePathDict_set_at(storage->paths, furi_string_get_cstr(storage_file->path), storage_file);
 }
 
 bool storage_pop_storage_file(File* file, StorageData* storage) {
-    StorageFileList_it_t it;
-    bool result = false;
-
-    for(StorageFileList_it(it, storage->files); !StorageFileList_end_p(it);
-        StorageFileList_next(it)) {
-        if(StorageFileList_cref(it)->file->file_id == file->file_id) {
-            result = true;
-            break;
-        }
+    StorageFile* storage_file = storage_get_storage_file(file, storage);
+    if(storage_file == NULL) {
+        return false;
     }
 
-    if(result) {
-        StorageFileList_remove(storage->files, it);
-    }
+    StorageFileDict_erase(storage->files, file->file_id);
+    StoragePathDict_erase(storage->paths, furi_string_get_cstr(storage_file->path));
+    furi_string_free(storage_file->path);
+    free(storage_file);
 
-    return result;
+    return true;
 }
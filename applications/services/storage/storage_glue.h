@@ -2,7 +2,7 @@
 
 #include <furi.h>
 #include "filesystem_api_internal.h"
-#include <m-list.h>
+#include <m-dict.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,12 +14,14 @@ typedef struct StorageData StorageData;
 
 typedef struct {
     void (*tick)(StorageData* storage);
+    void (*process)(StorageData* storage); /**< after each message, storage is not idle */
 } StorageApi;
 
 typedef struct {
     File* file;
     void* file_data;
     FuriString* path;
+    bool modified; /**< written since open, reported to watches on close */
 } StorageFile;
 
 typedef enum {
@@ -31,35 +33,29 @@ typedef enum {
     StorageStatusErrorInternal, /**< any other internal error */
 } StorageStatus;
 
-void storage_file_init(StorageFile* obj);
-void storage_file_init_set(StorageFile* obj, const StorageFile* src);
-void storage_file_set(StorageFile* obj, const StorageFile* src);
-void storage_file_clear(StorageFile* obj);
-
 void storage_data_init(StorageData* storage);
 StorageStatus storage_data_status(StorageData* storage);
 const char* storage_data_status_text(StorageData* storage);
 void storage_data_timestamp(StorageData* storage);
 uint32_t storage_data_get_timestamp(StorageData* storage);
 
-LIST_DEF(
-    StorageFileList,
-    StorageFile,
-    (INIT(API_2(storage_file_init)),
-     SET(API_6(storage_file_init_set)),
-     INIT_SET(API_6(storage_file_set)),
-     CLEAR(API_2(storage_file_clear))))
+/* Open files by file id */
+DICT_DEF2(StorageFileDict, uint32_t, M_DEFAULT_OPLIST, StorageFile*, M_PTR_OPLIST)
+/* Open files by path, key is the path string of the StorageFile */
+DICT_DEF2(StoragePathDict, const char*, M_CSTR_OPLIST, StorageFile*, M_PTR_OPLIST)
 
 struct StorageData {
     const FS_Api* fs_api;
     StorageApi api;
     void* data;
     StorageStatus status;
-    StorageFileList_t files;
+    StorageFileDict_t files;
+    StoragePathDict_t paths;
     uint32_t timestamp;
 };
 
 bool storage_has_file(const File* file, StorageData* storage_data);
+StorageFile* storage_get_storage_file(const File* file, StorageData* storage_data);
 bool storage_path_already_open(FuriString* path, StorageData* storage_data);
 
 void storage_set_storage_file_data(const File* file, void* file_data, StorageData* storage);
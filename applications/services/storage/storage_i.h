@@ -3,6 +3,7 @@
 #include <furi_hal.h>
 #include <gui/gui.h>
 #include "storage_glue.h"
+#include "storage_trace.h"
 #include "storage_sd_api.h"
 #include "filesystem_api_internal.h"
 
@@ -15,16 +16,33 @@ extern "C" {
 #define APPS_DATA_PATH EXT_PATH("apps_data")
 #define APPS_ASSETS_PATH EXT_PATH("apps_assets")
 
+/** Copy engine buffer, 16 sectors */
+#define STORAGE_COPY_BUFFER_SIZE (8 * 1024)
+
 typedef struct {
     ViewPort* view_port;
     bool enabled;
 } StorageSDGui;
 
+/** Storage thread statistics of one command */
+typedef struct {
+    uint32_t count;
+    uint32_t time_max; /**< microseconds */
+    uint64_t time_total; /**< microseconds */
+    uint64_t bytes; /**< bytes read or written */
+} StorageCommandStats;
+
 struct Storage {
     FuriMessageQueue* message_queue;
     StorageData storage[STORAGE_COUNT];
     StorageSDGui sd_gui;
     FuriPubSub* pubsub;
+    FuriPubSub* watch_pubsub; /**< StorageWatchMessage */
+    volatile uint32_t watch_count; /**< events are not tracked without watches */
+    StorageCommandStats* stats; /**< per command, indexed by StorageCommand */
+    volatile uint32_t async_count; /**< asynchronous requests in flight */
+    StorageTrace* trace;
+    uint8_t* copy_buffer; /**< from the memory pool, NULL if the pool is short */
 };
 
 #ifdef __cplusplus
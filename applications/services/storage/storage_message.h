@@ -20,6 +20,11 @@ typedef struct {
     uint16_t bytes_to_read;
 } SADataFRead;
 
+typedef struct {
+    File* file;
+    size_t* size;
+} SADataFBorrow;
+
 typedef struct {
     File* file;
     const void* buff;
@@ -32,6 +37,11 @@ typedef struct {
     bool from_start;
 } SADataFSeek;
 
+typedef struct {
+    File* file;
+    uint64_t size;
+} SADataFPreallocate;
+
 typedef struct {
     File* file;
     const char* path;
@@ -45,6 +55,12 @@ typedef struct {
     uint16_t name_length;
 } SADataDRead;
 
+typedef struct {
+    File* file;
+    void* buffer;
+    uint16_t size;
+} SADataDReadBatch;
+
 typedef struct {
     const char* path;
     uint32_t* timestamp;
@@ -69,6 +85,21 @@ typedef struct {
     FuriThreadId thread_id;
 } SADataCResolvePath;
 
+typedef struct {
+    const char* old_path;
+    const char* new_path;
+    StorageCopyProgress* progress;
+    StorageCopyCallback callback;
+    void* context;
+    FuriThreadId thread_id;
+} SADataCCopy;
+
+typedef struct {
+    const char* old_path;
+    const char* new_path;
+    FuriThreadId thread_id;
+} SADataCRename;
+
 typedef struct {
     uint32_t id;
 } SADataError;
@@ -89,16 +120,21 @@ typedef struct {
 typedef union {
     SADataFOpen fopen;
     SADataFRead fread;
+    SADataFBorrow fborrow;
     SADataFWrite fwrite;
     SADataFSeek fseek;
+    SADataFPreallocate fpreallocate;
 
     SADataDOpen dopen;
     SADataDRead dread;
+    SADataDReadBatch dreadbatch;
 
     SADataCTimestamp ctimestamp;
     SADataCStat cstat;
     SADataCFSInfo cfsinfo;
     SADataCResolvePath cresolvepath;
+    SADataCCopy ccopy;
+    SADataCRename crename;
 
     SADataError error;
 
@@ -114,40 +150,60 @@ typedef union {
     uint64_t uint64_value;
     FS_Error error_value;
     const char* cstring_value;
+    const void* pointer_value;
 } SAReturn;
 
 typedef enum {
     StorageCommandFileOpen,
     StorageCommandFileClose,
     StorageCommandFileRead,
+    StorageCommandFileBorrow,
     StorageCommandFileWrite,
     StorageCommandFileSeek,
     StorageCommandFileTell,
     StorageCommandFileTruncate,
+    StorageCommandFilePreallocate,
     StorageCommandFileSize,
     StorageCommandFileSync,
     StorageCommandFileEof,
+    StorageCommandFileAsyncCancel,
     StorageCommandDirOpen,
     StorageCommandDirClose,
     StorageCommandDirRead,
+    StorageCommandDirReadBatch,
     StorageCommandDirRewind,
     StorageCommandCommonTimestamp,
     StorageCommandCommonStat,
     StorageCommandCommonRemove,
     StorageCommandCommonMkDir,
+    StorageCommandCommonCopy,
     StorageCommandCommonFSInfo,
     StorageCommandSDFormat,
     StorageCommandSDUnmount,
     StorageCommandSDInfo,
     StorageCommandSDStatus,
     StorageCommandCommonResolvePath,
+    StorageCommandCommonRenameNotify,
 } StorageCommand;
 
+/** Number of commands, must follow the last command */
+#define STORAGE_COMMAND_COUNT (StorageCommandCommonRenameNotify + 1)
+
+/** Asynchronous request, freed by storage thread after the callback */
+typedef struct {
+    SAData data;
+    SAReturn return_data;
+    StorageAsyncCallback callback;
+    void* context;
+} StorageAsyncRequest;
+
 typedef struct {
     FuriApiLock lock;
     StorageCommand command;
     SAData* data;
     SAReturn* return_data;
+    StorageAsyncRequest* async; /**< NULL for synchronous requests */
+    FuriThreadId thread_id; /**< calling thread */
 } StorageMessage;
 
 #ifdef __cplusplus
@@ -98,6 +98,34 @@ static FS_Error storage_get_data(Storage* app, FuriString* path, StorageData** s
     }
 }
 
+/******************* Watch Functions *******************/
+
+static void
+    storage_process_watch_publish(Storage* app, StorageWatchEvent event, FuriString* path) {
+    if(app->watch_count > 0) {
+        StorageWatchMessage message = {.event = event, .path = furi_string_get_cstr(path)};
+        furi_pubsub_publish(app->watch_pubsub, &message);
+    }
+}
+
+static void storage_process_watch_rename(Storage* app, FuriString* path, FuriString* old_path) {
+    if(app->watch_count > 0) {
+        StorageWatchMessage message = {
+            .event = StorageWatchEventRename,
+            .path = furi_string_get_cstr(path),
+            .old_path = furi_string_get_cstr(old_path),
+        };
+        furi_pubsub_publish(app->watch_pubsub, &message);
+    }
+}
+
+static void storage_process_watch_modified(File* file, StorageData* storage) {
+    StorageFile* storage_file = storage_get_storage_file(file, storage);
+    if(storage_file) {
+        storage_file->modified = true;
+    }
+}
+
 /******************* File Functions *******************/
 
 bool storage_process_file_open(
@@ -120,7 +148,20 @@ bool storage_process_file_open(
             storage_push_storage_file(file, path, storage);
 
             const char* path_cstr_no_vfs = cstr_path_without_vfs_prefix(path);
+            bool create = (app->watch_count > 0) && (access_mode & FSAM_WRITE) &&
+                          (open_mode != FSOM_OPEN_EXISTING);
+            if(create) {
+                create = storage->fs_api->common.stat(storage, path_cstr_no_vfs, NULL) ==
+                         FSE_NOT_EXIST;
+            }
+
             FS_CALL(storage, file.open(storage, file, path_cstr_no_vfs, access_mode, open_mode));
+
+            if(ret && create) {
+                storage_process_watch_publish(app, StorageWatchEventCreate, path);
+            } else if(ret && open_mode == FSOM_CREATE_ALWAYS) {
+                storage_process_watch_modified(file, storage);
+            }
         }
     }
 
@@ -135,6 +176,11 @@ bool storage_process_file_close(Storage* app, File* file) {
         file->error_id = FSE_INVALID_PARAMETER;
     } else {
         FS_CALL(storage, file.close(storage, file));
+
+        StorageFile* storage_file = storage_get_storage_file(file, storage);
+        if(storage_file->modified) {
+            storage_process_watch_publish(app, StorageWatchEventModify, storage_file->path);
+        }
         storage_pop_storage_file(file, storage);
 
         StorageEvent event = {.type = StorageEventTypeFileClose};
@@ -158,6 +204,19 @@ static uint16_t
     return ret;
 }
 
+static const void* storage_process_file_borrow(Storage* app, File* file, size_t* size) {
+    const void* ret = NULL;
+    StorageData* storage = get_storage_by_file(file, app->storage);
+
+    if(storage == NULL) {
+        file->error_id = FSE_INVALID_PARAMETER;
+    } else {
+        FS_CALL(storage, file.borrow(storage, file, size));
+    }
+
+    return ret;
+}
+
 static uint16_t storage_process_file_write(
     Storage* app,
     File* file,
@@ -171,6 +230,9 @@ static uint16_t storage_process_file_write(
     } else {
         storage_data_timestamp(storage);
         FS_CALL(storage, file.write(storage, file, buff, bytes_to_write));
+        if(ret > 0) {
+            storage_process_watch_modified(file, storage);
+        }
     }
 
     return ret;
@@ -215,11 +277,38 @@ static bool storage_process_file_truncate(Storage* app, File* file) {
     } else {
         storage_data_timestamp(storage);
         FS_CALL(storage, file.truncate(storage, file));
+        if(ret) {
+            storage_process_watch_modified(file, storage);
+        }
+    }
+
+    return ret;
+}
+
+static bool storage_process_file_preallocate(Storage* app, File* file, uint64_t size) {
+    bool ret = false;
+    StorageData* storage = get_storage_by_file(file, app->storage);
+
+    if(storage == NULL) {
+        file->error_id = FSE_INVALID_PARAMETER;
+    } else {
+        FS_CALL(storage, file.preallocate(storage, file, size));
+        if(ret) {
+            storage_process_watch_modified(file, storage);
+        }
     }
 
     return ret;
 }
 
+static uint16_t storage_process_file_async_cancel(File* file) {
+    // Requests of the file queued before this command are already dropped
+    uint16_t cancelled = file->async_cancelled;
+    file->async_cancelled = 0;
+    file->async_cancel = false;
+    return cancelled;
+}
+
 static bool storage_process_file_sync(Storage* app, File* file) {
     bool ret = false;
     StorageData* storage = get_storage_by_file(file, app->storage);
@@ -314,6 +403,39 @@ bool storage_process_dir_read(
     return ret;
 }
 
+static uint16_t
+    storage_process_dir_read_batch(Storage* app, File* file, void* buffer, uint16_t size) {
+    uint16_t used = 0;
+    StorageData* storage = get_storage_by_file(file, app->storage);
+
+    if(storage == NULL) {
+        file->error_id = FSE_INVALID_PARAMETER;
+    } else {
+        // Space for the longest name is checked first, an object read can't be undone
+        while((size_t)(size - used) >= STORAGE_DIR_ENTRY_SIZE_MAX) {
+            StorageDirEntry* entry = (StorageDirEntry*)((uint8_t*)buffer + used);
+            bool ret = false;
+            FS_CALL(
+                storage,
+                dir.read(
+                    storage, file, &entry->fileinfo, entry->name, STORAGE_DIR_ENTRY_NAME_SIZE));
+            if(!ret) break;
+
+            const size_t align = _Alignof(StorageDirEntry);
+            size_t entry_size = offsetof(StorageDirEntry, name) + strlen(entry->name) + 1;
+            entry->size = (entry_size + align - 1) / align * align;
+            used += entry->size;
+        }
+
+        // End of the directory is reported by the next call
+        if(used > 0) {
+            file->error_id = FSE_OK;
+        }
+    }
+
+    return used;
+}
+
 bool storage_process_dir_rewind(Storage* app, File* file) {
     bool ret = false;
     StorageData* storage = get_storage_by_file(file, app->storage);
@@ -364,6 +486,9 @@ static FS_Error storage_process_common_remove(Storage* app, FuriString* path) {
 
         storage_data_timestamp(storage);
         FS_CALL(storage, common.remove(storage, cstr_path_without_vfs_prefix(path)));
+        if(ret == FSE_OK) {
+            storage_process_watch_publish(app, StorageWatchEventDelete, path);
+        }
     } while(false);
 
     return ret;
@@ -376,6 +501,9 @@ static FS_Error storage_process_common_mkdir(Storage* app, FuriString* path) {
     if(ret == FSE_OK) {
         storage_data_timestamp(storage);
         FS_CALL(storage, common.mkdir(storage, cstr_path_without_vfs_prefix(path)));
+        if(ret == FSE_OK) {
+            storage_process_watch_publish(app, StorageWatchEventCreate, path);
+        }
     }
 
     return ret;
@@ -398,6 +526,125 @@ static FS_Error storage_process_common_fs_info(
     return ret;
 }
 
+/******************* Copy Engine *******************/
+
+static uint8_t* storage_process_copy_buffer_acquire(Storage* app) {
+    // Pool memory is never freed, so it is taken only if there is plenty of it
+    if(app->copy_buffer == NULL &&
+       memmgr_pool_get_max_block() / 2 >= STORAGE_COPY_BUFFER_SIZE) {
+        app->copy_buffer = memmgr_alloc_from_pool(STORAGE_COPY_BUFFER_SIZE);
+    }
+
+    return app->copy_buffer ? app->copy_buffer : malloc(STORAGE_COPY_BUFFER_SIZE);
+}
+
+static void storage_process_copy_buffer_release(Storage* app, uint8_t* buffer) {
+    if(buffer != app->copy_buffer) {
+        free(buffer);
+    }
+}
+
+static void storage_process_copy_mtime(Storage* app, FuriString* old_path, FuriString* new_path) {
+    StorageData* source;
+    StorageData* destination;
+    if(storage_get_data(app, old_path, &source) != FSE_OK) return;
+    if(storage_get_data(app, new_path, &destination) != FSE_OK) return;
+
+    // Time format is filesystem specific
+    const FS_Common_Api* api = &source->fs_api->common;
+    if(source->fs_api != destination->fs_api || !api->get_mtime || !api->set_mtime) return;
+
+    uint32_t mtime;
+    if(api->get_mtime(source, cstr_path_without_vfs_prefix(old_path), &mtime) == FSE_OK) {
+        api->set_mtime(destination, cstr_path_without_vfs_prefix(new_path), mtime);
+    }
+}
+
+static FS_Error storage_process_copy_data(
+    Storage* app,
+    File* source,
+    File* destination,
+    StorageCopyProgress* progress,
+    StorageCopyCallback callback,
+    void* context) {
+    FS_Error error = FSE_OK;
+    uint8_t* buffer = storage_process_copy_buffer_acquire(app);
+
+    // Contiguous clusters, if there are any, otherwise plain writes do the allocation
+    if(progress->file_size > STORAGE_COPY_BUFFER_SIZE) {
+        storage_process_file_preallocate(app, destination, progress->file_size);
+    }
+
+    while(error == FSE_OK && progress->file_copied < progress->file_size) {
+        uint16_t size = MIN(progress->file_size - progress->file_copied, STORAGE_COPY_BUFFER_SIZE);
+        if(storage_process_file_read(app, source, buffer, size) != size) {
+            error = source->error_id != FSE_OK ? source->error_id : FSE_INTERNAL;
+            break;
+        }
+        if(storage_process_file_write(app, destination, buffer, size) != size) {
+            error = destination->error_id != FSE_OK ? destination->error_id : FSE_INTERNAL;
+            break;
+        }
+
+        progress->file_copied += size;
+        progress->total_copied += size;
+        if(callback && !callback(progress, context)) {
+            error = FSE_CANCELLED;
+        }
+    }
+
+    storage_process_copy_buffer_release(app, buffer);
+    return error;
+}
+
+static FS_Error storage_process_common_copy(
+    Storage* app,
+    FuriString* old_path,
+    FuriString* new_path,
+    StorageCopyProgress* progress,
+    StorageCopyCallback callback,
+    void* context) {
+    File source = {.type = FileTypeOpenFile, .storage = app};
+    File destination = {.type = FileTypeOpenFile, .storage = app};
+    FS_Error error = FSE_OK;
+    bool created = false;
+
+    progress->path = furi_string_get_cstr(old_path);
+    progress->file_size = 0;
+    progress->file_copied = 0;
+
+    do {
+        if(!storage_process_file_open(app, &source, old_path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            error = source.error_id;
+            break;
+        }
+        if(!storage_process_file_open(
+               app, &destination, new_path, FSAM_WRITE, FSOM_CREATE_NEW)) {
+            error = destination.error_id;
+            break;
+        }
+        created = true;
+
+        progress->file_size = storage_process_file_size(app, &source);
+        error =
+            storage_process_copy_data(app, &source, &destination, progress, callback, context);
+    } while(false);
+
+    // Same as with the file api, a file is closed even if open has failed,
+    // close of a file that was never registered is a no-op
+    storage_process_file_close(app, &source);
+    storage_process_file_close(app, &destination);
+
+    if(created && error == FSE_OK) {
+        progress->files++;
+        storage_process_copy_mtime(app, old_path, new_path);
+    } else if(created) {
+        storage_process_common_remove(app, new_path);
+    }
+
+    return error;
+}
+
 /****************** Raw SD API ******************/
 // TODO think about implementing a custom storage API to split that kind of api linkage
 #include "storages/storage_ext.h"
@@ -531,6 +778,10 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
             message->data->fread.buff,
             message->data->fread.bytes_to_read);
         break;
+    case StorageCommandFileBorrow:
+        message->return_data->pointer_value = storage_process_file_borrow(
+            app, message->data->fborrow.file, message->data->fborrow.size);
+        break;
     case StorageCommandFileWrite:
         message->return_data->uint16_value = storage_process_file_write(
             app,
@@ -553,6 +804,14 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
         message->return_data->bool_value =
             storage_process_file_truncate(app, message->data->file.file);
         break;
+    case StorageCommandFilePreallocate:
+        message->return_data->bool_value = storage_process_file_preallocate(
+            app, message->data->fpreallocate.file, message->data->fpreallocate.size);
+        break;
+    case StorageCommandFileAsyncCancel:
+        message->return_data->uint16_value =
+            storage_process_file_async_cancel(message->data->file.file);
+        break;
     case StorageCommandFileSync:
         message->return_data->bool_value =
             storage_process_file_sync(app, message->data->file.file);
@@ -584,6 +843,13 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
             message->data->dread.name,
             message->data->dread.name_length);
         break;
+    case StorageCommandDirReadBatch:
+        message->return_data->uint16_value = storage_process_dir_read_batch(
+            app,
+            message->data->dreadbatch.file,
+            message->data->dreadbatch.buffer,
+            message->data->dreadbatch.size);
+        break;
     case StorageCommandDirRewind:
         message->return_data->bool_value =
             storage_process_dir_rewind(app, message->data->file.file);
@@ -612,6 +878,21 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
         storage_process_alias(app, path, message->data->path.thread_id, true);
         message->return_data->error_value = storage_process_common_mkdir(app, path);
         break;
+    case StorageCommandCommonCopy: {
+        path = furi_string_alloc_set(message->data->ccopy.old_path);
+        storage_process_alias(app, path, message->data->ccopy.thread_id, false);
+        FuriString* new_path = furi_string_alloc_set(message->data->ccopy.new_path);
+        storage_process_alias(app, new_path, message->data->ccopy.thread_id, true);
+        message->return_data->error_value = storage_process_common_copy(
+            app,
+            path,
+            new_path,
+            message->data->ccopy.progress,
+            message->data->ccopy.callback,
+            message->data->ccopy.context);
+        furi_string_free(new_path);
+        break;
+    }
     case StorageCommandCommonFSInfo:
         path = furi_string_alloc_set(message->data->cfsinfo.fs_path);
         storage_process_alias(app, path, message->data->cfsinfo.thread_id, false);
@@ -622,6 +903,15 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
         storage_process_alias(
             app, message->data->cresolvepath.path, message->data->cresolvepath.thread_id, true);
         break;
+    case StorageCommandCommonRenameNotify: {
+        path = furi_string_alloc_set(message->data->crename.new_path);
+        storage_process_alias(app, path, message->data->crename.thread_id, false);
+        FuriString* old_path = furi_string_alloc_set(message->data->crename.old_path);
+        storage_process_alias(app, old_path, message->data->crename.thread_id, false);
+        storage_process_watch_rename(app, path, old_path);
+        furi_string_free(old_path);
+        break;
+    }
 
     // SD operations
     case StorageCommandSDFormat:
@@ -642,10 +932,81 @@ void storage_process_message_internal(Storage* app, StorageMessage* message) {
     if(path != NULL) { //-V547
         furi_string_free(path);
     }
+}
 
-    api_lock_unlock(message->lock);
+static uint32_t storage_process_message_bytes(StorageMessage* message) {
+    if(message->command == StorageCommandFileRead ||
+       message->command == StorageCommandFileWrite) {
+        return message->return_data->uint16_value;
+    } else if(message->command == StorageCommandFileBorrow) {
+        return *message->data->fborrow.size;
+    } else if(message->command == StorageCommandCommonCopy) {
+        return message->data->ccopy.progress->file_copied;
+    }
+    return 0;
+}
+
+static void storage_process_stats_update(
+    Storage* app,
+    StorageMessage* message,
+    uint32_t time,
+    uint32_t bytes) {
+    furi_assert(message->command < STORAGE_COMMAND_COUNT);
+    StorageCommandStats* stats = &app->stats[message->command];
+
+    stats->count++;
+    stats->time_total += time;
+    stats->time_max = MAX(stats->time_max, time);
+    stats->bytes += bytes;
+}
+
+static void storage_process_async_complete(Storage* app, StorageMessage* message, bool cancel) {
+    StorageAsyncRequest* request = message->async;
+    File* file = request->data.file.file;
+
+    uint16_t bytes = 0;
+    FS_Error error = FSE_CANCELLED;
+    if(cancel) {
+        file->async_cancelled++;
+    } else {
+        bytes = request->return_data.uint16_value;
+        error = file->error_id;
+    }
+
+    if(request->callback) {
+        request->callback(file, bytes, error, request->context);
+    }
+    free(request);
+
+    FURI_CRITICAL_ENTER();
+    app->async_count--;
+    FURI_CRITICAL_EXIT();
 }
 
 void storage_process_message(Storage* app, StorageMessage* message) {
+    if(message->async && message->data->file.file->async_cancel) {
+        storage_process_async_complete(app, message, true);
+        return;
+    }
+
+    uint32_t start = DWT->CYCCNT;
     storage_process_message_internal(app, message);
+    uint32_t time = (DWT->CYCCNT - start) / furi_hal_cortex_instructions_per_microsecond();
+
+    // Message data and return data live on the caller stack until the unlock
+    uint32_t bytes = storage_process_message_bytes(message);
+    storage_process_stats_update(app, message, time, bytes);
+    storage_trace_record(app->trace, message, start, time, bytes);
+    if(message->async) {
+        storage_process_async_complete(app, message, false);
+    } else {
+        api_lock_unlock(message->lock);
+    }
+
+    // Caller is already released, write back is not on its time
+    for(uint8_t i = 0; i < STORAGE_COUNT; i++) {
+        if(app->storage[i].api.process != NULL) {
+            app->storage[i].api.process(&app->storage[i]);
+        }
+    }
 }
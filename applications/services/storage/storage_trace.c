@@ -0,0 +1,291 @@
+#include "storage_trace.h"
+#include "filesystem_api_internal.h"
+#include <furi_hal.h>
+
+// DWT cycle counter wraps in about a minute at 64MHz
+#define STORAGE_TRACE_CYCLES_WRAP_MS 30000
+#define STORAGE_TRACE_THREADS 8
+
+typedef struct {
+    FuriThreadId thread_id;
+    uint8_t app;
+} StorageTraceThread;
+
+struct StorageTrace {
+    FuriMutex* mutex;
+    volatile bool running;
+
+    StorageTraceRecord* records;
+    uint32_t head; /**< records written since start */
+
+    StorageTraceApp* apps;
+    uint8_t apps_count;
+    StorageTraceThread threads[STORAGE_TRACE_THREADS]; /**< thread to application cache */
+    uint8_t threads_next;
+
+    uint32_t time; /**< microseconds since start */
+    uint32_t last_cycles;
+    uint32_t last_tick;
+};
+
+_Static_assert(sizeof(StorageTraceRecord) == 20, "Storage trace record size mismatch");
+_Static_assert(sizeof(StorageTraceHeader) == 20, "Storage trace header size mismatch");
+_Static_assert(STORAGE_COMMAND_COUNT <= UINT8_MAX, "Storage command doesn't fit trace record");
+
+StorageTrace* storage_trace_alloc() {
+    StorageTrace* trace = malloc(sizeof(StorageTrace));
+    trace->mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return trace;
+}
+
+void storage_trace_free(StorageTrace* trace) {
+    furi_assert(trace);
+    storage_trace_clear(trace);
+    furi_mutex_free(trace->mutex);
+    free(trace);
+}
+
+void storage_trace_start(StorageTrace* trace) {
+    furi_assert(trace);
+    furi_check(furi_mutex_acquire(trace->mutex, FuriWaitForever) == FuriStatusOk);
+
+    if(trace->records == NULL) {
+        trace->records = malloc(sizeof(StorageTraceRecord) * STORAGE_TRACE_RECORDS);
+        trace->apps = malloc(sizeof(StorageTraceApp) * STORAGE_TRACE_APPS);
+    } else {
+        memset(trace->apps, 0, sizeof(StorageTraceApp) * STORAGE_TRACE_APPS);
+    }
+
+    trace->head = 0;
+    trace->apps_count = 0;
+    memset(trace->threads, 0, sizeof(trace->threads));
+    trace->threads_next = 0;
+
+    trace->time = 0;
+    trace->last_cycles = DWT->CYCCNT;
+    trace->last_tick = furi_get_tick();
+    trace->running = true;
+
+    furi_mutex_release(trace->mutex);
+}
+
+void storage_trace_stop(StorageTrace* trace) {
+    furi_assert(trace);
+    trace->running = false;
+}
+
+void storage_trace_clear(StorageTrace* trace) {
+    furi_assert(trace);
+    furi_check(furi_mutex_acquire(trace->mutex, FuriWaitForever) == FuriStatusOk);
+
+    trace->running = false;
+    free(trace->records);
+    trace->records = NULL;
+    free(trace->apps);
+    trace->apps = NULL;
+    trace->head = 0;
+    trace->apps_count = 0;
+
+    furi_mutex_release(trace->mutex);
+}
+
+bool storage_trace_is_running(StorageTrace* trace) {
+    furi_assert(trace);
+    return trace->running;
+}
+
+static uint32_t storage_trace_time(StorageTrace* trace, uint32_t cycles) {
+    uint32_t tick = furi_get_tick();
+    uint32_t cycles_per_us = furi_hal_cortex_instructions_per_microsecond();
+
+    if(tick - trace->last_tick < STORAGE_TRACE_CYCLES_WRAP_MS) {
+        uint32_t us = (cycles - trace->last_cycles) / cycles_per_us;
+        trace->time += us;
+        trace->last_cycles += us * cycles_per_us;
+    } else {
+        // Cycle counter may have wrapped, tick is good enough after a long pause
+        trace->time += (tick - trace->last_tick) * 1000;
+        trace->last_cycles = cycles;
+    }
+
+    trace->last_tick = tick;
+    return trace->time;
+}
+
+static const char* storage_trace_thread_name(FuriThreadId thread_id) {
+    const char* appid = furi_thread_get_appid(thread_id);
+
+    // Services have no application id, thread name tells more
+    if(strcmp(appid, "driver") == 0 || strcmp(appid, "system") == 0 ||
+       strcmp(appid, "unknown") == 0) {
+        const char* name = furi_thread_get_name(thread_id);
+        if(name != NULL) appid = name;
+    }
+
+    return appid;
+}
+
+static uint8_t storage_trace_app_find(StorageTrace* trace, const char* name) {
+    for(uint8_t i = 0; i < trace->apps_count; i++) {
+        if(strncmp(trace->apps[i].name, name, STORAGE_TRACE_APP_NAME_SIZE - 1) == 0) {
+            return i;
+        }
+    }
+
+    // Table is full, the rest is counted in the last entry
+    uint8_t app = STORAGE_TRACE_APPS - 1;
+    if(trace->apps_count < STORAGE_TRACE_APPS - 1) {
+        app = trace->apps_count++;
+        strncpy(trace->apps[app].name, name, STORAGE_TRACE_APP_NAME_SIZE - 1);
+    } else if(trace->apps_count < STORAGE_TRACE_APPS) {
+        trace->apps_count++;
+        strncpy(trace->apps[app].name, "other", STORAGE_TRACE_APP_NAME_SIZE - 1);
+    }
+
+    return app;
+}
+
+static uint8_t storage_trace_app(StorageTrace* trace, const StorageMessage* message) {
+    FuriThreadId thread_id = message->thread_id;
+    for(uint8_t i = 0; i < STORAGE_TRACE_THREADS; i++) {
+        if(trace->threads[i].thread_id == thread_id && thread_id != NULL) {
+            return trace->threads[i].app;
+        }
+    }
+
+    // Asynchronous caller is not waiting for us and may be gone already
+    const char* name = "unknown";
+    if(thread_id != NULL && message->async == NULL) {
+        name = storage_trace_thread_name(thread_id);
+    }
+
+    uint8_t app = storage_trace_app_find(trace, name);
+    if(thread_id != NULL && message->async == NULL) {
+        trace->threads[trace->threads_next].thread_id = thread_id;
+        trace->threads[trace->threads_next].app = app;
+        trace->threads_next = (trace->threads_next + 1) % STORAGE_TRACE_THREADS;
+    }
+
+    return app;
+}
+
+static uint32_t storage_trace_file(const StorageMessage* message) {
+    if(message->command <= StorageCommandDirRewind) {
+        return (uint32_t)message->data->file.file;
+    }
+    return 0;
+}
+
+static uint8_t storage_trace_error(const StorageMessage* message) {
+    if(message->command <= StorageCommandDirRewind) {
+        return message->data->file.file->error_id;
+    } else if(message->command <= StorageCommandSDStatus) {
+        return message->return_data->error_value;
+    }
+    return FSE_OK;
+}
+
+void storage_trace_record(
+    StorageTrace* trace,
+    const StorageMessage* message,
+    uint32_t start,
+    uint32_t latency,
+    uint32_t bytes) {
+    furi_assert(trace);
+    furi_assert(message->command < STORAGE_COMMAND_COUNT);
+    if(!trace->running) return;
+
+    furi_check(furi_mutex_acquire(trace->mutex, FuriWaitForever) == FuriStatusOk);
+    if(trace->running) {
+        uint8_t app = storage_trace_app(trace, message);
+
+        StorageTraceRecord* record = &trace->records[trace->head % STORAGE_TRACE_RECORDS];
+        record->time = storage_trace_time(trace, start);
+        record->latency = latency;
+        record->file = storage_trace_file(message);
+        record->bytes = bytes;
+        record->command = message->command;
+        record->app = app;
+        record->error = storage_trace_error(message);
+        record->flags = message->async ? STORAGE_TRACE_FLAG_ASYNC : 0;
+        trace->head++;
+
+        StorageTraceApp* counters = &trace->apps[app];
+        uint8_t bucket = latency ? 32 - __builtin_clz(latency) : 0;
+        counters->ops++;
+        counters->bytes += bytes;
+        counters->time_total += latency;
+        counters->latency[MIN(bucket, STORAGE_TRACE_LATENCY_BUCKETS - 1)]++;
+    }
+    furi_mutex_release(trace->mutex);
+}
+
+uint8_t storage_trace_get_apps(StorageTrace* trace, StorageTraceApp* apps) {
+    furi_assert(trace);
+    furi_assert(apps);
+    furi_check(furi_mutex_acquire(trace->mutex, FuriWaitForever) == FuriStatusOk);
+
+    uint8_t count = trace->apps_count;
+    if(count > 0) {
+        memcpy(apps, trace->apps, sizeof(StorageTraceApp) * count);
+    }
+
+    furi_mutex_release(trace->mutex);
+    return count;
+}
+
+uint32_t storage_trace_app_percentile(const StorageTraceApp* app, uint8_t percent) {
+    furi_assert(app);
+    furi_assert(percent > 0 && percent <= 100);
+
+    // Rank of the percentile, rounded up
+    uint32_t rank = ((uint64_t)app->ops * percent + 99) / 100;
+    uint32_t count = 0;
+    for(uint8_t i = 0; i < STORAGE_TRACE_LATENCY_BUCKETS; i++) {
+        count += app->latency[i];
+        if(count >= rank) return 1UL << i;
+    }
+
+    return 1UL << (STORAGE_TRACE_LATENCY_BUCKETS - 1);
+}
+
+void* storage_trace_dump(StorageTrace* trace, size_t* size) {
+    furi_assert(trace);
+    furi_assert(size);
+    furi_check(furi_mutex_acquire(trace->mutex, FuriWaitForever) == FuriStatusOk);
+
+    uint8_t* dump = NULL;
+    *size = 0;
+
+    if(trace->records != NULL) {
+        uint32_t records = MIN(trace->head, (uint32_t)STORAGE_TRACE_RECORDS);
+        size_t names_size = trace->apps_count * STORAGE_TRACE_APP_NAME_SIZE;
+        *size = sizeof(StorageTraceHeader) + names_size + records * sizeof(StorageTraceRecord);
+        dump = malloc(*size);
+
+        StorageTraceHeader* header = (StorageTraceHeader*)dump;
+        header->magic = STORAGE_TRACE_MAGIC;
+        header->version = STORAGE_TRACE_VERSION;
+        header->record_size = sizeof(StorageTraceRecord);
+        header->records = records;
+        header->dropped = trace->head - records;
+        header->apps = trace->apps_count;
+        header->app_name_size = STORAGE_TRACE_APP_NAME_SIZE;
+
+        uint8_t* names = dump + sizeof(StorageTraceHeader);
+        for(uint8_t i = 0; i < trace->apps_count; i++) {
+            memcpy(
+                &names[i * STORAGE_TRACE_APP_NAME_SIZE],
+                trace->apps[i].name,
+                STORAGE_TRACE_APP_NAME_SIZE);
+        }
+
+        StorageTraceRecord* output = (StorageTraceRecord*)(names + names_size);
+        for(uint32_t i = 0; i < records; i++) {
+            output[i] = trace->records[(trace->head - records + i) % STORAGE_TRACE_RECORDS];
+        }
+    }
+
+    furi_mutex_release(trace->mutex);
+    return dump;
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <furi.h>
+#include "storage.h"
+#include "storage_message.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Storage I/O trace
+ *
+ * Every request processed by the storage thread is put into a ring of records,
+ * and counted per calling application. Tracing is off by default, buffers are
+ * allocated on the first start and kept until clear.
+ */
+
+#define STORAGE_TRACE_RECORDS 256
+#define STORAGE_TRACE_APPS 16
+#define STORAGE_TRACE_APP_NAME_SIZE 24
+#define STORAGE_TRACE_LATENCY_BUCKETS 24
+
+#define STORAGE_TRACE_MAGIC 0x43525453 // "STRC"
+#define STORAGE_TRACE_VERSION 2
+
+#define STORAGE_TRACE_FLAG_ASYNC (1 << 0)
+
+/** Trace record, dumped as is, little endian */
+typedef struct {
+    uint32_t time; /**< request start, microseconds since trace start, wraps */
+    uint32_t latency; /**< microseconds */
+    uint32_t file; /**< File handle, 0 for path requests */
+    uint32_t bytes; /**< bytes read or written */
+    uint8_t command; /**< StorageCommand */
+    uint8_t app; /**< index in the application table */
+    uint8_t error; /**< FS_Error */
+    uint8_t flags; /**< STORAGE_TRACE_FLAG_* */
+} StorageTraceRecord;
+
+/** Binary dump header, followed by application names
+ * (app_name_size bytes each) and records, oldest first
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t records; /**< records in the dump */
+    uint32_t dropped; /**< records overwritten before the dump */
+    uint16_t apps;
+    uint16_t app_name_size;
+} StorageTraceHeader;
+
+/** Counters of one calling application */
+typedef struct {
+    char name[STORAGE_TRACE_APP_NAME_SIZE];
+    uint32_t ops;
+    uint64_t bytes;
+    uint64_t time_total; /**< microseconds */
+    uint32_t latency[STORAGE_TRACE_LATENCY_BUCKETS]; /**< bucket n counts under 2^n us */
+} StorageTraceApp;
+
+typedef struct StorageTrace StorageTrace;
+
+StorageTrace* storage_trace_alloc();
+
+void storage_trace_free(StorageTrace* trace);
+
+/** Start tracing, previous records and counters are dropped
+ * @param trace StorageTrace instance
+ */
+void storage_trace_start(StorageTrace* trace);
+
+/** Stop tracing, records and counters are kept for the dump
+ * @param trace StorageTrace instance
+ */
+void storage_trace_stop(StorageTrace* trace);
+
+/** Stop tracing and free the buffers
+ * @param trace StorageTrace instance
+ */
+void storage_trace_clear(StorageTrace* trace);
+
+bool storage_trace_is_running(StorageTrace* trace);
+
+/** Record processed request, storage thread only
+ * @param trace StorageTrace instance
+ * @param message processed message, return data must be valid
+ * @param start DWT cycle counter at request start
+ * @param latency request time, microseconds
+ * @param bytes bytes read or written
+ */
+void storage_trace_record(
+    StorageTrace* trace,
+    const StorageMessage* message,
+    uint32_t start,
+    uint32_t latency,
+    uint32_t bytes);
+
+/** Copy application counters
+ * @param trace StorageTrace instance
+ * @param apps output, STORAGE_TRACE_APPS entries
+ * @return number of applications
+ */
+uint8_t storage_trace_get_apps(StorageTrace* trace, StorageTraceApp* apps);
+
+/** Latency percentile from the application histogram
+ * @param app application counters
+ * @param percent percentile, 1-100
+ * @return upper bound of the histogram bucket, microseconds
+ */
+uint32_t storage_trace_app_percentile(const StorageTraceApp* app, uint8_t percent);
+
+/** Make binary dump: StorageTraceHeader, application names, records
+ * @param trace StorageTrace instance
+ * @param size dump size output
+ * @return dump, must be freed by the caller, NULL if there is no trace
+ */
+void* storage_trace_dump(StorageTrace* trace, size_t* size);
+
+#ifdef __cplusplus
+}
+#endif
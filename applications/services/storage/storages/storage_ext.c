@@ -1,17 +1,27 @@
 #include "fatfs.h"
+#include "sector_cache.h"
 #include "../filesystem_api_internal.h"
 #include "storage_ext.h"
 #include <furi_hal.h>
 #include "sd_notify.h"
 #include <furi_hal_sd.h>
 
-typedef FIL SDFile;
+typedef struct {
+    FIL fil;
+    bool linkmap_failed;
+} SDFile;
 typedef DIR SDDir;
 typedef FILINFO SDFileInfo;
 typedef FRESULT SDError;
 
 #define TAG "StorageExt"
 
+// Link map is built for files of this size in clusters and bigger
+#define SD_LINKMAP_MIN_CLUSTERS 8
+// Link map table sizes, 2 items for each fragment plus 2
+#define SD_LINKMAP_SIZE_INITIAL 16
+#define SD_LINKMAP_SIZE_MAX 256
+
 /********************* Definitions ********************/
 
 typedef struct {
@@ -93,10 +103,28 @@ static bool sd_mount_card(StorageData* storage, bool notify) {
     return result;
 }
 
+static void sd_cache_sync(StorageData* storage) {
+    SDData* sd_data = storage->data;
+    SectorCacheStats stats;
+
+    sector_cache_get_stats(&stats);
+    if(stats.dirty > 0 && hal_sd_detect()) {
+        if(disk_ioctl(sd_data->fs->drv, CTRL_SYNC, NULL) != RES_OK) {
+            FURI_LOG_E(TAG, "sector cache write back error");
+        }
+    }
+}
+
 FS_Error sd_unmount_card(StorageData* storage) {
     SDData* sd_data = storage->data;
     SDError error;
 
+    // Cached metadata goes to the card if it is still there, otherwise it is lost
+    if(storage->status == StorageStatusOK) {
+        sd_cache_sync(storage);
+    }
+    sector_cache_discard();
+
     storage->status = StorageStatusNotReady;
     error = FR_DISK_ERR;
 
@@ -115,6 +143,9 @@ FS_Error sd_format_card(StorageData* storage) {
     SDData* sd_data = storage->data;
     SDError error;
 
+    // Dirty sectors belong to the file system that is about to be destroyed
+    sector_cache_discard();
+
     work_area = malloc(_MAX_SS);
     error = f_mkfs(sd_data->path, FM_ANY, 0, work_area, _MAX_SS);
     free(work_area);
@@ -265,6 +296,18 @@ static void storage_ext_tick_internal(StorageData* storage, bool notify) {
 
 static void storage_ext_tick(StorageData* storage) {
     storage_ext_tick_internal(storage, true);
+
+    // Storage is idle, don't keep dirty metadata around in case of power loss
+    if(storage->status == StorageStatusOK) {
+        sd_cache_sync(storage);
+    }
+}
+
+static void storage_ext_process(StorageData* storage) {
+    // Steady traffic never lets the tick run, so dirty metadata is bounded here too
+    if(storage->status == StorageStatusOK && sector_cache_flush_due()) {
+        sd_cache_sync(storage);
+    }
 }
 
 /****************** Common Functions ******************/
@@ -306,6 +349,46 @@ static FS_Error storage_ext_parse_error(SDError error) {
 
 /******************* File Functions *******************/
 
+static void storage_ext_file_linkmap_drop(SDFile* file_data) {
+    free(file_data->fil.cltbl);
+    file_data->fil.cltbl = NULL;
+}
+
+static void storage_ext_file_linkmap_build(SDFile* file_data) {
+    FIL* fil = &file_data->fil;
+    uint32_t cluster_size = fil->obj.fs->csize * _MAX_SS;
+    if(f_size(fil) / cluster_size < SD_LINKMAP_MIN_CLUSTERS) return;
+
+    // First item is the table size, FatFs puts the required size there if it is not enough
+    DWORD table_size = SD_LINKMAP_SIZE_INITIAL;
+    while(table_size <= SD_LINKMAP_SIZE_MAX) {
+        fil->cltbl = malloc(table_size * sizeof(DWORD));
+        fil->cltbl[0] = table_size;
+
+        FRESULT result = f_lseek(fil, CREATE_LINKMAP);
+        if(result == FR_OK) return;
+
+        table_size = fil->cltbl[0];
+        storage_ext_file_linkmap_drop(file_data);
+        if(result != FR_NOT_ENOUGH_CORE) break;
+    }
+
+    FURI_LOG_D(TAG, "no link map, %lu items required", table_size);
+    file_data->linkmap_failed = true;
+}
+
+/* Link map lets f_lseek find the cluster without walking the FAT chain from the start.
+ * It is built on the first seek in a big file and covers only the current chain,
+ * so it is dropped before the chain is changed. */
+static void storage_ext_file_linkmap_update(SDFile* file_data, uint64_t position) {
+    FIL* fil = &file_data->fil;
+    if(position > f_size(fil)) {
+        storage_ext_file_linkmap_drop(file_data);
+    } else if(fil->cltbl == NULL && !file_data->linkmap_failed) {
+        storage_ext_file_linkmap_build(file_data);
+    }
+}
+
 static bool storage_ext_file_open(
     void* ctx,
     File* file,
@@ -326,7 +409,7 @@ static bool storage_ext_file_open(
     SDFile* file_data = malloc(sizeof(SDFile));
     storage_set_storage_file_data(file, file_data, storage);
 
-    file->internal_error_id = f_open(file_data, path, _mode);
+    file->internal_error_id = f_open(&file_data->fil, path, _mode);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
     return (file->error_id == FSE_OK);
 }
@@ -334,8 +417,9 @@ static bool storage_ext_file_open(
 static bool storage_ext_file_close(void* ctx, File* file) {
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
-    file->internal_error_id = f_close(file_data);
+    file->internal_error_id = f_close(&file_data->fil);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
+    storage_ext_file_linkmap_drop(file_data);
     free(file_data);
     return (file->error_id == FSE_OK);
 }
@@ -345,11 +429,20 @@ static uint16_t
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
     uint16_t bytes_read = 0;
-    file->internal_error_id = f_read(file_data, buff, bytes_to_read, &bytes_read);
+    file->internal_error_id = f_read(&file_data->fil, buff, bytes_to_read, &bytes_read);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
     return bytes_read;
 }
 
+static const void* storage_ext_file_borrow(void* ctx, File* file, size_t* size) {
+    UNUSED(ctx);
+    // SD card is not memory mapped
+    *size = 0;
+    file->internal_error_id = 0;
+    file->error_id = FSE_NOT_IMPLEMENTED;
+    return NULL;
+}
+
 static uint16_t
     storage_ext_file_write(void* ctx, File* file, const void* buff, uint16_t const bytes_to_write) {
 #ifdef FURI_RAM_EXEC
@@ -362,7 +455,10 @@ static uint16_t
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
     uint16_t bytes_written = 0;
-    file->internal_error_id = f_write(file_data, buff, bytes_to_write, &bytes_written);
+    if(f_tell(&file_data->fil) + bytes_to_write > f_size(&file_data->fil)) {
+        storage_ext_file_linkmap_drop(file_data);
+    }
+    file->internal_error_id = f_write(&file_data->fil, buff, bytes_to_write, &bytes_written);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
     return bytes_written;
 #endif
@@ -373,14 +469,14 @@ static bool
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
 
-    if(from_start) {
-        file->internal_error_id = f_lseek(file_data, offset);
-    } else {
-        uint64_t position = f_tell(file_data);
-        position += offset;
-        file->internal_error_id = f_lseek(file_data, position);
+    uint64_t position = offset;
+    if(!from_start) {
+        position += f_tell(&file_data->fil);
     }
 
+    storage_ext_file_linkmap_update(file_data, position);
+    file->internal_error_id = f_lseek(&file_data->fil, position);
+
     file->error_id = storage_ext_parse_error(file->internal_error_id);
     return (file->error_id == FSE_OK);
 }
@@ -390,7 +486,7 @@ static uint64_t storage_ext_file_tell(void* ctx, File* file) {
     SDFile* file_data = storage_get_storage_file_data(file, storage);
 
     uint64_t position = 0;
-    position = f_tell(file_data);
+    position = f_tell(&file_data->fil);
     file->error_id = FSE_OK;
     return position;
 }
@@ -404,7 +500,25 @@ static bool storage_ext_file_truncate(void* ctx, File* file) {
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
 
-    file->internal_error_id = f_truncate(file_data);
+    storage_ext_file_linkmap_drop(file_data);
+    file->internal_error_id = f_truncate(&file_data->fil);
+    file->error_id = storage_ext_parse_error(file->internal_error_id);
+    return (file->error_id == FSE_OK);
+#endif
+}
+
+static bool storage_ext_file_preallocate(void* ctx, File* file, uint64_t size) {
+#ifdef FURI_RAM_EXEC
+    UNUSED(ctx);
+    UNUSED(size);
+    file->error_id = FSE_NOT_READY;
+    return false;
+#else
+    StorageData* storage = ctx;
+    SDFile* file_data = storage_get_storage_file_data(file, storage);
+
+    // Find contiguous free clusters and make them the next to allocate
+    file->internal_error_id = f_expand(&file_data->fil, size, 0);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
     return (file->error_id == FSE_OK);
 #endif
@@ -419,7 +533,7 @@ static bool storage_ext_file_sync(void* ctx, File* file) {
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
 
-    file->internal_error_id = f_sync(file_data);
+    file->internal_error_id = f_sync(&file_data->fil);
     file->error_id = storage_ext_parse_error(file->internal_error_id);
     return (file->error_id == FSE_OK);
 #endif
@@ -430,7 +544,7 @@ static uint64_t storage_ext_file_size(void* ctx, File* file) {
     SDFile* file_data = storage_get_storage_file_data(file, storage);
 
     uint64_t size = 0;
-    size = f_size(file_data);
+    size = f_size(&file_data->fil);
     file->error_id = FSE_OK;
     return size;
 }
@@ -439,7 +553,7 @@ static bool storage_ext_file_eof(void* ctx, File* file) {
     StorageData* storage = ctx;
     SDFile* file_data = storage_get_storage_file_data(file, storage);
 
-    bool eof = f_eof(file_data);
+    bool eof = f_eof(&file_data->fil);
     file->internal_error_id = 0;
     file->error_id = FSE_OK;
     return eof;
@@ -523,6 +637,34 @@ static FS_Error storage_ext_common_stat(void* ctx, const char* path, FileInfo* f
     return storage_ext_parse_error(result);
 }
 
+static FS_Error storage_ext_common_get_mtime(void* ctx, const char* path, uint32_t* mtime) {
+    UNUSED(ctx);
+    SDFileInfo _fileinfo;
+    SDError result = f_stat(path, &_fileinfo);
+
+    if(result == FR_OK) {
+        *mtime = (uint32_t)_fileinfo.fdate << 16 | _fileinfo.ftime;
+    }
+
+    return storage_ext_parse_error(result);
+}
+
+static FS_Error storage_ext_common_set_mtime(void* ctx, const char* path, uint32_t mtime) {
+    UNUSED(ctx);
+#ifdef FURI_RAM_EXEC
+    UNUSED(path);
+    UNUSED(mtime);
+    return FSE_NOT_READY;
+#else
+    SDFileInfo _fileinfo = {
+        .fdate = mtime >> 16,
+        .ftime = mtime & 0xFFFF,
+    };
+    SDError result = f_utime(path, &_fileinfo);
+    return storage_ext_parse_error(result);
+#endif
+}
+
 static FS_Error storage_ext_common_remove(void* ctx, const char* path) {
     UNUSED(ctx);
 #ifdef FURI_RAM_EXEC
@@ -593,10 +735,12 @@ static const FS_Api fs_api = {
             .open = storage_ext_file_open,
             .close = storage_ext_file_close,
             .read = storage_ext_file_read,
+            .borrow = storage_ext_file_borrow,
             .write = storage_ext_file_write,
             .seek = storage_ext_file_seek,
             .tell = storage_ext_file_tell,
             .truncate = storage_ext_file_truncate,
+            .preallocate = storage_ext_file_preallocate,
             .size = storage_ext_file_size,
             .sync = storage_ext_file_sync,
             .eof = storage_ext_file_eof,
@@ -614,6 +758,8 @@ static const FS_Api fs_api = {
             .mkdir = storage_ext_common_mkdir,
             .remove = storage_ext_common_remove,
             .fs_info = storage_ext_common_fs_info,
+            .get_mtime = storage_ext_common_get_mtime,
+            .set_mtime = storage_ext_common_set_mtime,
         },
 };
 
@@ -627,6 +773,7 @@ void storage_ext_init(StorageData* storage) {
 
     storage->data = sd_data;
     storage->api.tick = storage_ext_tick;
+    storage->api.process = storage_ext_process;
     storage->fs_api = &fs_api;
 
     hal_sd_detect_init();
@@ -11,6 +11,15 @@
  * modification of non-dot files is restricted */
 #define LFS_RESERVED_PAGES_COUNT 3
 
+/* Read, prog and every open file cache are cache_size each. Larger caches mean fewer
+ * flash operations and bigger files kept inline in directory pages instead of own page. */
+#define LFS_CACHE_SIZE_MIN 16
+#define LFS_CACHE_SIZE_MAX 256
+/* Read and prog caches plus a couple of open files take no more than 1/64 of free heap */
+#define LFS_CACHE_COUNT 4
+#define LFS_CACHE_HEAP_SHARE 64
+#define LFS_LOOKAHEAD_SIZE_MIN 16
+
 typedef struct {
     const size_t start_address;
     const size_t start_page;
@@ -134,6 +143,26 @@ static int storage_int_device_sync(const struct lfs_config* c) {
     return 0;
 }
 
+static lfs_size_t storage_int_cache_size(const struct lfs_config* config) {
+    size_t budget = memmgr_get_free_heap() / LFS_CACHE_HEAP_SHARE;
+
+    lfs_size_t cache_size = LFS_CACHE_SIZE_MAX;
+    while(cache_size > LFS_CACHE_SIZE_MIN && cache_size * LFS_CACHE_COUNT > budget) {
+        cache_size /= 2;
+    }
+
+    furi_check(config->block_size % cache_size == 0);
+    furi_check(cache_size % config->prog_size == 0);
+    furi_check(cache_size % config->read_size == 0);
+    return cache_size;
+}
+
+static lfs_size_t storage_int_lookahead_size(const struct lfs_config* config) {
+    // One bit per block, so allocator scans whole storage at once. Multiple of 8 bytes.
+    lfs_size_t lookahead_size = ((config->block_count + 63) / 64) * 8;
+    return MAX(lookahead_size, (lfs_size_t)LFS_LOOKAHEAD_SIZE_MIN);
+}
+
 static LFSData* storage_int_lfs_data_alloc() {
     LFSData* lfs_data = malloc(sizeof(LFSData));
 
@@ -156,8 +185,14 @@ static LFSData* storage_int_lfs_data_alloc() {
     lfs_data->config.block_size = furi_hal_flash_get_page_size();
     lfs_data->config.block_count = furi_hal_flash_get_free_page_count();
     lfs_data->config.block_cycles = furi_hal_flash_get_cycles_count();
-    lfs_data->config.cache_size = 16;
-    lfs_data->config.lookahead_size = 16;
+    lfs_data->config.cache_size = storage_int_cache_size(&lfs_data->config);
+    lfs_data->config.lookahead_size = storage_int_lookahead_size(&lfs_data->config);
+
+    FURI_LOG_I(
+        TAG,
+        "Cache %lu, lookahead %lu",
+        lfs_data->config.cache_size,
+        lfs_data->config.lookahead_size);
 
     return lfs_data;
 };
@@ -387,6 +422,73 @@ static uint16_t
     return bytes_read;
 }
 
+/* Pages of files that are not inline are memory mapped flash. Reading one byte makes
+ * LittleFS find the page of r/w pointer, the rest of the page is contiguous file data. */
+static const void* storage_int_file_borrow(void* ctx, File* file, size_t* size) {
+    StorageData* storage = ctx;
+    lfs_t* lfs = lfs_get_from_storage(storage);
+    LFSData* lfs_data = lfs_data_get_from_storage(storage);
+    LFSHandle* handle = storage_get_storage_file_data(file, storage);
+
+    const uint8_t* data = NULL;
+    bool supported = true;
+    size_t requested = *size;
+    *size = 0;
+    file->internal_error_id = 0;
+
+    do {
+        if(!lfs_handle_is_open(handle)) {
+            file->internal_error_id = LFS_ERR_BADF;
+            break;
+        }
+
+        lfs_file_t* lfs_file = lfs_handle_get_file(handle);
+        // Inline data is in directory pages, unsynced data is in the file cache
+        if(lfs_file->flags & (LFS_F_INLINE | LFS_F_DIRTY | LFS_F_WRITING)) {
+            supported = false;
+            break;
+        }
+
+        lfs_soff_t position = lfs_file_tell(lfs, lfs_file);
+        lfs_soff_t file_size = lfs_file_size(lfs, lfs_file);
+        if(position < 0 || position >= file_size) break;
+
+        uint8_t first_byte;
+        file->internal_error_id = lfs_file_read(lfs, lfs_file, &first_byte, 1);
+        if(file->internal_error_id != 1) break;
+        file->internal_error_id = 0;
+
+        const lfs_size_t block_size = lfs_data->config.block_size;
+        const lfs_off_t offset = lfs_file->off - 1;
+        const uint8_t* address =
+            (const uint8_t*)(lfs_data->start_address + lfs_file->block * block_size + offset);
+        if(lfs_file->block >= lfs_data->config.block_count || *address != first_byte) {
+            // Not where we expect it to be, caller will read it the usual way
+            lfs_file_seek(lfs, lfs_file, position, LFS_SEEK_SET);
+            supported = false;
+            break;
+        }
+
+        size_t available = MIN(block_size - offset, (size_t)(file_size - position));
+        available = MIN(available, requested);
+
+        file->internal_error_id =
+            lfs_file_seek(lfs, lfs_file, position + available, LFS_SEEK_SET);
+        if(file->internal_error_id < 0) break;
+        file->internal_error_id = 0;
+
+        data = address;
+        *size = available;
+    } while(false);
+
+    file->error_id = storage_int_parse_error(file->internal_error_id);
+    if(!supported) {
+        file->error_id = FSE_NOT_IMPLEMENTED;
+    }
+
+    return data;
+}
+
 static uint16_t
     storage_int_file_write(void* ctx, File* file, const void* buff, uint16_t const bytes_to_write) {
     StorageData* storage = ctx;
@@ -687,16 +789,27 @@ static FS_Error storage_int_common_fs_info(
 }
 
 /******************* Init Storage *******************/
+static bool storage_int_file_preallocate(void* ctx, File* file, uint64_t size) {
+    UNUSED(ctx);
+    UNUSED(size);
+    // LittleFS has no cluster chains, nothing to prepare
+    file->internal_error_id = 0;
+    file->error_id = FSE_NOT_IMPLEMENTED;
+    return false;
+}
+
 static const FS_Api fs_api = {
     .file =
         {
             .open = storage_int_file_open,
             .close = storage_int_file_close,
             .read = storage_int_file_read,
+            .borrow = storage_int_file_borrow,
             .write = storage_int_file_write,
             .seek = storage_int_file_seek,
             .tell = storage_int_file_tell,
             .truncate = storage_int_file_truncate,
+            .preallocate = storage_int_file_preallocate,
             .size = storage_int_file_size,
             .sync = storage_int_file_sync,
             .eof = storage_int_file_eof,
@@ -734,5 +847,6 @@ void storage_int_init(StorageData* storage) {
 
     storage->data = lfs_data;
     storage->api.tick = NULL;
+    storage->api.process = NULL;
     storage->fs_api = &fs_api;
 }
@@ -67,6 +67,7 @@ typedef enum {
     SD_CMD17_READ_SINGLE_BLOCK = 17,
     SD_CMD18_READ_MULT_BLOCK = 18,
     SD_CMD23_SET_BLOCK_COUNT = 23,
+    SD_CMD23_SET_WR_BLK_ERASE_COUNT = 23,
     SD_CMD24_WRITE_SINGLE_BLOCK = 24,
     SD_CMD25_WRITE_MULT_BLOCK = 25,
     SD_CMD27_PROG_CSD = 27,
@@ -253,9 +254,21 @@ static inline void sd_spi_purge_crc() {
     sd_spi_read_byte();
 }
 
+static void sd_spi_write_cmd_frame(SdSpiCmd cmd, uint32_t arg, uint8_t crc) {
+    uint8_t frame[SD_CMD_LENGTH];
+
+    frame[0] = ((uint8_t)cmd | 0x40);
+    frame[1] = (uint8_t)(arg >> 24);
+    frame[2] = (uint8_t)(arg >> 16);
+    frame[3] = (uint8_t)(arg >> 8);
+    frame[4] = (uint8_t)(arg);
+    frame[5] = (crc | 0x01);
+
+    sd_spi_write_bytes(frame, sizeof(frame));
+}
+
 static SdSpiCmdAnswer
     sd_spi_send_cmd(SdSpiCmd cmd, uint32_t arg, uint8_t crc, SdSpiCmdAnswerType answer_type) {
-    uint8_t frame[SD_CMD_LENGTH];
     SdSpiCmdAnswer cmd_answer = {
         .r1 = SD_DUMMY_BYTE,
         .r2 = SD_DUMMY_BYTE,
@@ -268,15 +281,8 @@ static SdSpiCmdAnswer
     // R1b identical to R1 + Busy information
     // R2 Length = NCS(0)+ 6 Bytes command + NCR(min1 max8) + 2 Bytes answer + NEC(0) = 16bytes
 
-    frame[0] = ((uint8_t)cmd | 0x40);
-    frame[1] = (uint8_t)(arg >> 24);
-    frame[2] = (uint8_t)(arg >> 16);
-    frame[3] = (uint8_t)(arg >> 8);
-    frame[4] = (uint8_t)(arg);
-    frame[5] = (crc | 0x01);
-
     sd_spi_select_card();
-    sd_spi_write_bytes(frame, sizeof(frame));
+    sd_spi_write_cmd_frame(cmd, arg, crc);
 
     switch(answer_type) {
     case SdSpiCmdAnswerTypeR1:
@@ -599,10 +605,46 @@ static SdSpiStatus sd_spi_get_cid(SD_CID* Cid) {
     return ret;
 }
 
+static SdSpiStatus sd_spi_cmd_stop_transmission(uint32_t timeout_ms) {
+    // CMD12 (STOP_TRANSMISSION): R1b response, card is selected by the read command
+    sd_spi_write_cmd_frame(SD_CMD12_STOP_TRANSMISSION, 0, 0xFF);
+
+    // Skip stuff byte, then wait for R1, data bytes of the stopped block can still go before it
+    sd_spi_read_byte();
+    uint8_t retry_count = SD_ANSWER_RETRY_COUNT;
+    uint8_t r1;
+    do {
+        r1 = sd_spi_read_byte();
+        retry_count--;
+    } while((r1 & 0x80) && retry_count);
+
+    // Wait for the end of busy
+    if(sd_spi_wait_for_data(SD_DUMMY_BYTE, timeout_ms) != SdSpiStatusOK) {
+        return SdSpiStatusTimeout;
+    }
+
+    return (r1 == SdSpi_R1_NO_ERROR) ? SdSpiStatusOK : SdSpiStatusError;
+}
+
+static SdSpiStatus sd_spi_read_data_block(uint8_t* data, uint32_t timeout_ms) {
+    // Wait for the data start token
+    if(sd_spi_wait_for_data(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ, timeout_ms) !=
+       SdSpiStatusOK) {
+        return SdSpiStatusError;
+    }
+
+    // Read the data block
+    sd_spi_read_bytes_dma(data, SD_BLOCK_SIZE);
+    sd_spi_purge_crc();
+
+    return SdSpiStatusOK;
+}
+
 static SdSpiStatus
     sd_spi_cmd_read_blocks(uint32_t* data, uint32_t address, uint32_t blocks, uint32_t timeout_ms) {
     uint32_t block_address = address;
-    uint32_t offset = 0;
+    uint8_t* buffer = (uint8_t*)data;
+    SdSpiStatus status;
 
     // CMD16 (SET_BLOCKLEN): R1 response (0x00: no errors)
     SdSpiCmdAnswer response =
@@ -617,40 +659,44 @@ static SdSpiStatus
         block_address = address * SD_BLOCK_SIZE;
     }
 
-    while(blocks--) {
+    if(blocks == 1) {
         // CMD17 (READ_SINGLE_BLOCK): R1 response (0x00: no errors)
         response =
             sd_spi_send_cmd(SD_CMD17_READ_SINGLE_BLOCK, block_address, 0xFF, SdSpiCmdAnswerTypeR1);
-        if(response.r1 != SdSpi_R1_NO_ERROR) {
-            sd_spi_deselect_card_and_purge();
-            return SdSpiStatusError;
+        status = SdSpiStatusError;
+        if(response.r1 == SdSpi_R1_NO_ERROR) {
+            status = sd_spi_read_data_block(buffer, timeout_ms);
         }
 
-        // Wait for the data start token
-        if(sd_spi_wait_for_data(SD_TOKEN_START_DATA_SINGLE_BLOCK_READ, timeout_ms) ==
-           SdSpiStatusOK) {
-            // Read the data block
-            sd_spi_read_bytes_dma((uint8_t*)data + offset, SD_BLOCK_SIZE);
-            sd_spi_purge_crc();
+        sd_spi_deselect_card_and_purge();
+        return status;
+    }
 
-            // increase offset
-            offset += SD_BLOCK_SIZE;
+    // CMD18 (READ_MULT_BLOCK): R1 response (0x00: no errors)
+    response =
+        sd_spi_send_cmd(SD_CMD18_READ_MULT_BLOCK, block_address, 0xFF, SdSpiCmdAnswerTypeR1);
+    if(response.r1 != SdSpi_R1_NO_ERROR) {
+        sd_spi_deselect_card_and_purge();
+        return SdSpiStatusError;
+    }
 
-            // increase block address
-            if(sd_high_capacity) {
-                block_address += 1;
-            } else {
-                block_address += SD_BLOCK_SIZE;
-            }
-        } else {
-            sd_spi_deselect_card_and_purge();
-            return SdSpiStatusError;
+    // Card sends blocks one after another until the transmission is stopped
+    status = SdSpiStatusOK;
+    while(blocks--) {
+        status = sd_spi_read_data_block(buffer, timeout_ms);
+        if(status != SdSpiStatusOK) {
+            break;
         }
+        buffer += SD_BLOCK_SIZE;
+    }
 
-        sd_spi_deselect_card_and_purge();
+    // Stop is required after an error too, to bring the card back to the transfer state
+    if(sd_spi_cmd_stop_transmission(timeout_ms) != SdSpiStatusOK) {
+        status = SdSpiStatusError;
     }
 
-    return SdSpiStatusOK;
+    sd_spi_deselect_card_and_purge();
+    return status;
 }
 
 static SdSpiStatus sd_spi_cmd_write_blocks(
@@ -659,7 +705,8 @@ static SdSpiStatus sd_spi_cmd_write_blocks(
     uint32_t blocks,
     uint32_t timeout_ms) {
     uint32_t block_address = address;
-    uint32_t offset = 0;
+    uint8_t* buffer = (uint8_t*)data;
+    SdSpiStatus status;
 
     // CMD16 (SET_BLOCKLEN): R1 response (0x00: no errors)
     SdSpiCmdAnswer response =
@@ -674,7 +721,7 @@ static SdSpiStatus sd_spi_cmd_write_blocks(
         block_address = address * SD_BLOCK_SIZE;
     }
 
-    while(blocks--) {
+    if(blocks == 1) {
         // CMD24 (WRITE_SINGLE_BLOCK): R1 response (0x00: no errors)
         response = sd_spi_send_cmd(
             SD_CMD24_WRITE_SINGLE_BLOCK, block_address, 0xFF, SdSpiCmdAnswerTypeR1);
@@ -690,29 +737,64 @@ static SdSpiStatus sd_spi_cmd_write_blocks(
 
         // Send the data start token
         sd_spi_write_byte(SD_TOKEN_START_DATA_SINGLE_BLOCK_WRITE);
-        sd_spi_write_bytes_dma((uint8_t*)data + offset, SD_BLOCK_SIZE);
+        sd_spi_write_bytes_dma(buffer, SD_BLOCK_SIZE);
         sd_spi_purge_crc();
 
         // Read data response
         SdSpiDataResponce data_responce = sd_spi_get_data_response(timeout_ms);
         sd_spi_deselect_card_and_purge();
 
-        if(data_responce != SdSpiDataResponceOK) {
-            return SdSpiStatusError;
-        }
+        return (data_responce == SdSpiDataResponceOK) ? SdSpiStatusOK : SdSpiStatusError;
+    }
 
-        // increase offset
-        offset += SD_BLOCK_SIZE;
+    // ACMD23 (SET_WR_BLK_ERASE_COUNT): pre-erase hint, write works without it, result is ignored
+    response = sd_spi_send_cmd(SD_CMD55_APP_CMD, 0, 0xFF, SdSpiCmdAnswerTypeR1);
+    sd_spi_deselect_card_and_purge();
+    if(response.r1 == SdSpi_R1_NO_ERROR) {
+        sd_spi_send_cmd(SD_CMD23_SET_WR_BLK_ERASE_COUNT, blocks, 0xFF, SdSpiCmdAnswerTypeR1);
+        sd_spi_deselect_card_and_purge();
+    }
 
-        // increase block address
-        if(sd_high_capacity) {
-            block_address += 1;
-        } else {
-            block_address += SD_BLOCK_SIZE;
+    // CMD25 (WRITE_MULT_BLOCK): R1 response (0x00: no errors)
+    response =
+        sd_spi_send_cmd(SD_CMD25_WRITE_MULT_BLOCK, block_address, 0xFF, SdSpiCmdAnswerTypeR1);
+    if(response.r1 != SdSpi_R1_NO_ERROR) {
+        sd_spi_deselect_card_and_purge();
+        return SdSpiStatusError;
+    }
+
+    // Send dummy byte for NWR timing : one byte between CMD_WRITE and TOKEN
+    sd_spi_write_byte(SD_DUMMY_BYTE);
+
+    status = SdSpiStatusOK;
+    while(blocks--) {
+        // Send the data start token
+        sd_spi_write_byte(SD_TOKEN_START_DATA_MULTIPLE_BLOCK_WRITE);
+        sd_spi_write_bytes_dma(buffer, SD_BLOCK_SIZE);
+        sd_spi_purge_crc();
+
+        // Read data response, busy of the block is over on return
+        if(sd_spi_get_data_response(timeout_ms) != SdSpiDataResponceOK) {
+            status = SdSpiStatusError;
+            break;
         }
+        buffer += SD_BLOCK_SIZE;
     }
 
-    return SdSpiStatusOK;
+    // Stop token ends the transfer after an error too, it is accepted only when card is not busy
+    if(sd_spi_wait_for_data(SD_DUMMY_BYTE, timeout_ms) != SdSpiStatusOK) {
+        status = SdSpiStatusError;
+    }
+    sd_spi_write_byte(SD_TOKEN_STOP_DATA_MULTIPLE_BLOCK_WRITE);
+
+    // Skip one byte before busy, then wait while card is programming
+    sd_spi_read_byte();
+    if(sd_spi_wait_for_data(SD_DUMMY_BYTE, timeout_ms) != SdSpiStatusOK) {
+        status = SdSpiStatusError;
+    }
+
+    sd_spi_deselect_card_and_purge();
+    return status;
 }
 
 uint8_t sd_max_mount_retry_count() {
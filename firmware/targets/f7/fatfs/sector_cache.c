@@ -7,50 +7,295 @@
 #include <furi_hal_memory.h>
 
 #define SECTOR_SIZE 512
-#define N_SECTORS 8
+#define SECTOR_CACHE_WAYS 4
+// 8 sectors minimum, 32 sectors (16KiB) maximum
+#define SECTOR_CACHE_SETS_MIN 2
+#define SECTOR_CACHE_SETS_MAX 8
+
+// Dirty metadata is written back at this age or count even if storage is never idle
+#define SECTOR_CACHE_DIRTY_TIMEOUT_MS 2000
+#define SECTOR_CACHE_DIRTY_MAX 8
+
+#define SECTOR_CACHE_FLAG_VALID (1 << 0)
+#define SECTOR_CACHE_FLAG_META (1 << 1)
+#define SECTOR_CACHE_FLAG_DIRTY (1 << 2)
 
 typedef struct {
-    uint32_t itr;
-    uint32_t sectors[N_SECTORS];
-    uint8_t sector_data[N_SECTORS][SECTOR_SIZE];
+    uint32_t sector;
+    uint32_t stamp;
+    uint8_t flags;
+} SectorCacheEntry;
+
+typedef struct {
+    uint32_t sets;
+    uint32_t set_shift;
+    uint32_t stamp;
+    uint32_t dirty_tick; /**< when the cache went from clean to dirty */
+    SectorCacheStats stats;
+    SectorCacheEntry* entries;
+    uint8_t* data;
 } SectorCache;
 
 static SectorCache* cache = NULL;
 
+static size_t sector_cache_size(uint32_t sets) {
+    return sizeof(SectorCache) +
+           sets * SECTOR_CACHE_WAYS * (sizeof(SectorCacheEntry) + SECTOR_SIZE);
+}
+
+static void sector_cache_alloc() {
+    // Take no more than a half of the largest pool block, the rest is for thread stacks
+    size_t headroom = memmgr_pool_get_max_block() / 2;
+    uint32_t sets = SECTOR_CACHE_SETS_MAX;
+    while(sets > SECTOR_CACHE_SETS_MIN && sector_cache_size(sets) > headroom) {
+        sets /= 2;
+    }
+
+    uint8_t* memory = memmgr_alloc_from_pool(sector_cache_size(sets));
+    if(memory == NULL) return;
+    memset(memory, 0, sector_cache_size(sets));
+
+    cache = (SectorCache*)memory;
+    cache->sets = sets;
+    cache->set_shift = 32 - __builtin_ctz(sets);
+    cache->entries = (SectorCacheEntry*)(memory + sizeof(SectorCache));
+    cache->data = (uint8_t*)&cache->entries[sets * SECTOR_CACHE_WAYS];
+}
+
+static inline uint32_t sector_cache_set(uint32_t n_sector) {
+    // Fibonacci hashing, neighbour sectors end up in different sets
+    return ((uint32_t)(n_sector * 2654435769U) >> cache->set_shift) * SECTOR_CACHE_WAYS;
+}
+
+static inline uint8_t* sector_cache_data(uint32_t index) {
+    return &cache->data[index * SECTOR_SIZE];
+}
+
+static int32_t sector_cache_find(uint32_t n_sector) {
+    uint32_t set = sector_cache_set(n_sector);
+    for(uint32_t way = 0; way < SECTOR_CACHE_WAYS; way++) {
+        SectorCacheEntry* entry = &cache->entries[set + way];
+        if((entry->flags & SECTOR_CACHE_FLAG_VALID) && entry->sector == n_sector) {
+            return set + way;
+        }
+    }
+    return -1;
+}
+
+/** Pick entry to replace: free, then least recently used data, then clean metadata,
+ * then dirty metadata. Data sectors are allowed to replace only data sectors.
+ */
+static int32_t sector_cache_victim(uint32_t n_sector, bool meta) {
+    uint32_t set = sector_cache_set(n_sector);
+    int32_t victim = -1;
+    uint8_t victim_rank = UINT8_MAX;
+
+    for(uint32_t way = 0; way < SECTOR_CACHE_WAYS; way++) {
+        SectorCacheEntry* entry = &cache->entries[set + way];
+        if(!(entry->flags & SECTOR_CACHE_FLAG_VALID)) return set + way;
+
+        uint8_t rank = 0;
+        if(entry->flags & SECTOR_CACHE_FLAG_META) rank++;
+        if(entry->flags & SECTOR_CACHE_FLAG_DIRTY) rank++;
+        if(rank > 0 && !meta) continue;
+
+        if(rank < victim_rank ||
+           (rank == victim_rank && entry->stamp < cache->entries[victim].stamp)) {
+            victim = set + way;
+            victim_rank = rank;
+        }
+    }
+
+    return victim;
+}
+
+static bool sector_cache_write_back(
+    uint32_t index,
+    SectorCacheWriteCallback callback,
+    void* context) {
+    SectorCacheEntry* entry = &cache->entries[index];
+    if(!(entry->flags & SECTOR_CACHE_FLAG_DIRTY)) return true;
+    if(callback == NULL || !callback(entry->sector, sector_cache_data(index), context)) {
+        return false;
+    }
+
+    entry->flags &= ~SECTOR_CACHE_FLAG_DIRTY;
+    cache->stats.dirty--;
+    cache->stats.written_back++;
+    return true;
+}
+
+static void sector_cache_drop(uint32_t index) {
+    SectorCacheEntry* entry = &cache->entries[index];
+    if(entry->flags & SECTOR_CACHE_FLAG_DIRTY) cache->stats.dirty--;
+    entry->flags = 0;
+}
+
+static int32_t sector_cache_place(
+    uint32_t n_sector,
+    bool meta,
+    SectorCacheWriteCallback callback,
+    void* context) {
+    int32_t index = sector_cache_find(n_sector);
+    if(index < 0) {
+        index = sector_cache_victim(n_sector, meta);
+        if(index < 0) return -1;
+        if(!sector_cache_write_back(index, callback, context)) return -1;
+        cache->entries[index].flags = SECTOR_CACHE_FLAG_VALID;
+        cache->entries[index].sector = n_sector;
+    }
+
+    if(meta) cache->entries[index].flags |= SECTOR_CACHE_FLAG_META;
+    cache->entries[index].stamp = ++cache->stamp;
+    return index;
+}
+
 void sector_cache_init() {
     if(cache == NULL) {
-        cache = memmgr_alloc_from_pool(sizeof(SectorCache));
+        sector_cache_alloc();
     }
 
     if(cache != NULL) {
-        memset(cache, 0, sizeof(SectorCache));
+        // Card may be changed, but dirty sectors are the only copy of the data
+        for(uint32_t i = 0; i < cache->sets * SECTOR_CACHE_WAYS; i++) {
+            if(!(cache->entries[i].flags & SECTOR_CACHE_FLAG_DIRTY)) {
+                cache->entries[i].flags = 0;
+            }
+        }
     }
 }
 
 uint8_t* sector_cache_get(uint32_t n_sector) {
-    if(cache != NULL && n_sector != 0) {
-        for(int sector_i = 0; sector_i < N_SECTORS; ++sector_i) {
-            if(cache->sectors[sector_i] == n_sector) {
-                return cache->sector_data[sector_i];
+    if(cache == NULL) return NULL;
+
+    int32_t index = sector_cache_find(n_sector);
+    if(index < 0) {
+        cache->stats.misses++;
+        return NULL;
+    }
+
+    cache->stats.hits++;
+    cache->entries[index].stamp = ++cache->stamp;
+    return sector_cache_data(index);
+}
+
+void sector_cache_put(
+    uint32_t n_sector,
+    uint8_t* data,
+    bool meta,
+    SectorCacheWriteCallback callback,
+    void* context) {
+    if(cache == NULL) return;
+
+    int32_t index = sector_cache_place(n_sector, meta, callback, context);
+    if(index < 0) return;
+
+    // Data is the same as on the card now
+    if(cache->entries[index].flags & SECTOR_CACHE_FLAG_DIRTY) {
+        cache->entries[index].flags &= ~SECTOR_CACHE_FLAG_DIRTY;
+        cache->stats.dirty--;
+    }
+    memcpy(sector_cache_data(index), data, SECTOR_SIZE);
+}
+
+bool sector_cache_write(
+    uint32_t n_sector,
+    const uint8_t* data,
+    SectorCacheWriteCallback callback,
+    void* context) {
+#if SECTOR_CACHE_WRITE_BACK
+    if(cache == NULL) return false;
+
+    int32_t index = sector_cache_place(n_sector, true, callback, context);
+    if(index < 0) return false;
+
+    if(cache->entries[index].flags & SECTOR_CACHE_FLAG_DIRTY) {
+        cache->stats.coalesced++;
+    } else {
+        if(cache->stats.dirty == 0) cache->dirty_tick = furi_get_tick();
+        cache->entries[index].flags |= SECTOR_CACHE_FLAG_DIRTY;
+        cache->stats.dirty++;
+    }
+    memcpy(sector_cache_data(index), data, SECTOR_SIZE);
+    return true;
+#else
+    UNUSED(n_sector);
+    UNUSED(data);
+    UNUSED(callback);
+    UNUSED(context);
+    return false;
+#endif
+}
+
+void sector_cache_read_dirty(uint32_t start_sector, uint32_t count, uint8_t* data) {
+    if(cache == NULL || cache->stats.dirty == 0) return;
+
+    for(uint32_t i = 0; i < cache->sets * SECTOR_CACHE_WAYS; i++) {
+        SectorCacheEntry* entry = &cache->entries[i];
+        if((entry->flags & SECTOR_CACHE_FLAG_DIRTY) && (entry->sector >= start_sector) &&
+           (entry->sector - start_sector < count)) {
+            memcpy(
+                &data[(entry->sector - start_sector) * SECTOR_SIZE],
+                sector_cache_data(i),
+                SECTOR_SIZE);
+        }
+    }
+}
+
+bool sector_cache_flush(SectorCacheWriteCallback callback, void* context) {
+    if(cache == NULL) return true;
+
+    while(cache->stats.dirty > 0) {
+        // Lowest sector first, so FAT copies and directory entries go in disk order
+        int32_t index = -1;
+        for(uint32_t i = 0; i < cache->sets * SECTOR_CACHE_WAYS; i++) {
+            SectorCacheEntry* entry = &cache->entries[i];
+            if((entry->flags & SECTOR_CACHE_FLAG_DIRTY) &&
+               (index < 0 || entry->sector < cache->entries[index].sector)) {
+                index = i;
             }
         }
+
+        furi_check(index >= 0);
+        if(!sector_cache_write_back(index, callback, context)) return false;
     }
-    return NULL;
+
+    return true;
 }
 
-void sector_cache_put(uint32_t n_sector, uint8_t* data) {
-    if(cache == NULL) return;
-    cache->sectors[cache->itr % N_SECTORS] = n_sector;
-    memcpy(cache->sector_data[cache->itr % N_SECTORS], data, SECTOR_SIZE);
-    cache->itr++;
+bool sector_cache_flush_due() {
+    if(cache == NULL || cache->stats.dirty == 0) return false;
+    if(cache->stats.dirty >= SECTOR_CACHE_DIRTY_MAX) return true;
+    // Tick is kept until the cache is clean, eviction of the oldest sector makes it early
+    uint32_t age = furi_get_tick() - cache->dirty_tick;
+    return age >= furi_ms_to_ticks(SECTOR_CACHE_DIRTY_TIMEOUT_MS);
 }
 
 void sector_cache_invalidate_range(uint32_t start_sector, uint32_t end_sector) {
     if(cache == NULL) return;
-    for(int sector_i = 0; sector_i < N_SECTORS; ++sector_i) {
-        if((cache->sectors[sector_i] >= start_sector) &&
-           (cache->sectors[sector_i] <= end_sector)) {
-            cache->sectors[sector_i] = 0;
+    for(uint32_t i = 0; i < cache->sets * SECTOR_CACHE_WAYS; i++) {
+        if((cache->entries[i].flags & SECTOR_CACHE_FLAG_VALID) &&
+           (cache->entries[i].sector >= start_sector) &&
+           (cache->entries[i].sector <= end_sector)) {
+            sector_cache_drop(i);
         }
     }
-}
\ No newline at end of file
+}
+
+void sector_cache_discard() {
+    if(cache == NULL) return;
+    for(uint32_t i = 0; i < cache->sets * SECTOR_CACHE_WAYS; i++) {
+        sector_cache_drop(i);
+    }
+}
+
+void sector_cache_get_stats(SectorCacheStats* stats) {
+    furi_assert(stats);
+    if(cache == NULL) {
+        memset(stats, 0, sizeof(SectorCacheStats));
+        return;
+    }
+
+    *stats = cache->stats;
+    stats->sectors = cache->sets * SECTOR_CACHE_WAYS;
+}
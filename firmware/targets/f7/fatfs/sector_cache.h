@@ -1,12 +1,44 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Sector cache
+ *
+ * Set associative, sector number is hashed into the set, LRU inside of the set.
+ * Metadata sectors (FAT, directories) have priority: data sectors never evict them.
+ * With SECTOR_CACHE_WRITE_BACK metadata writes are kept dirty in the cache
+ * until flush or eviction, so repeated updates of the same sector are coalesced.
+ * sector_cache_flush_due tells when dirty sectors are too many or too old to keep.
+ */
+
+#ifndef SECTOR_CACHE_WRITE_BACK
+#define SECTOR_CACHE_WRITE_BACK 1
+#endif
+
+/** Sector cache statistics */
+typedef struct {
+    uint32_t sectors; /**< cache capacity in sectors, 0 if cache is not allocated */
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t coalesced; /**< writes absorbed by already dirty sectors */
+    uint32_t written_back; /**< dirty sectors written to the card */
+    uint32_t dirty; /**< dirty sectors in the cache right now */
+} SectorCacheStats;
+
+/** Sector write callback, used to write back dirty sectors
+ * @param n_sector Sector number
+ * @param data Sector data
+ * @param context Callback context
+ * @return true if sector is written
+ */
+typedef bool (*SectorCacheWriteCallback)(uint32_t n_sector, const uint8_t* data, void* context);
+
 /**
- * @brief Init sector cache system
+ * @brief Init sector cache system, clean sectors are dropped, dirty sectors are kept
  */
 void sector_cache_init();
 
@@ -18,19 +50,74 @@ void sector_cache_init();
 uint8_t* sector_cache_get(uint32_t n_sector);
 
 /**
- * @brief Put sector data to cache
+ * @brief Put clean sector data to cache
  * @param n_sector Sector number
  * @param data Pointer to sector data
+ * @param meta Sector is FAT or directory sector
+ * @param callback Write callback for evicted dirty sector
+ * @param context Callback context
  */
-void sector_cache_put(uint32_t n_sector, uint8_t* data);
+void sector_cache_put(
+    uint32_t n_sector,
+    uint8_t* data,
+    bool meta,
+    SectorCacheWriteCallback callback,
+    void* context);
 
 /**
- * @brief Invalidate sector cache for given range
+ * @brief Put dirty metadata sector to cache instead of writing it to the card
+ * @param n_sector Sector number
+ * @param data Pointer to sector data
+ * @param callback Write callback for evicted dirty sector
+ * @param context Callback context
+ * @return true if sector is in the cache, false if it must be written by the caller
+ */
+bool sector_cache_write(
+    uint32_t n_sector,
+    const uint8_t* data,
+    SectorCacheWriteCallback callback,
+    void* context);
+
+/**
+ * @brief Copy dirty sectors over data that was just read from the card
+ * @param start_sector Start sector number
+ * @param count Number of sectors
+ * @param data Sectors data
+ */
+void sector_cache_read_dirty(uint32_t start_sector, uint32_t count, uint8_t* data);
+
+/**
+ * @brief Write all dirty sectors, in sector order
+ * @param callback Write callback
+ * @param context Callback context
+ * @return true if all dirty sectors are written
+ */
+bool sector_cache_flush(SectorCacheWriteCallback callback, void* context);
+
+/**
+ * @brief Check if dirty sectors must be flushed now, without waiting for idle time
+ * @return true if too many sectors are dirty or they are dirty for too long
+ */
+bool sector_cache_flush_due();
+
+/**
+ * @brief Invalidate sector cache for given range, dirty sectors are dropped too
  * @param start_sector Start sector number
  * @param end_sector End sector number
  */
 void sector_cache_invalidate_range(uint32_t start_sector, uint32_t end_sector);
 
+/**
+ * @brief Drop everything, including dirty sectors. Used when card is gone.
+ */
+void sector_cache_discard();
+
+/**
+ * @brief Get sector cache statistics
+ * @param stats Statistics output
+ */
+void sector_cache_get_stats(SectorCacheStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
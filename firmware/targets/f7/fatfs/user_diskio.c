@@ -1,6 +1,7 @@
 #include "user_diskio.h"
 #include <furi_hal.h>
 #include "sector_cache.h"
+#include "fatfs.h"
 
 static volatile DSTATUS Stat = STA_NOINIT;
 
@@ -28,6 +29,8 @@ Diskio_drvTypeDef sd_fatfs_driver = {
     driver_ioctl,
 };
 
+static bool sd_cache_write_back(uint32_t sector, const uint8_t* data, void* context);
+
 static inline bool sd_cache_get(uint32_t address, uint32_t* data) {
     uint8_t* cached_data = sector_cache_get(address);
     if(cached_data) {
@@ -37,8 +40,20 @@ static inline bool sd_cache_get(uint32_t address, uint32_t* data) {
     return false;
 }
 
-static inline void sd_cache_put(uint32_t address, uint32_t* data) {
-    sector_cache_put(address, (uint8_t*)data);
+static inline void sd_cache_put(uint32_t address, uint32_t* data, bool meta) {
+    sector_cache_put(address, (uint8_t*)data, meta, sd_cache_write_back, NULL);
+}
+
+static inline bool sd_cache_write(uint32_t address, const uint32_t* data) {
+    return sector_cache_write(address, (const uint8_t*)data, sd_cache_write_back, NULL);
+}
+
+static inline void sd_cache_read_dirty(uint32_t address, uint32_t count, uint32_t* data) {
+    sector_cache_read_dirty(address, count, (uint8_t*)data);
+}
+
+static inline bool sd_cache_flush() {
+    return sector_cache_flush(sd_cache_write_back, NULL);
 }
 
 static inline void sd_cache_invalidate_range(uint32_t start_sector, uint32_t end_sector) {
@@ -49,24 +64,19 @@ static inline void sd_cache_invalidate_all() {
     sector_cache_init();
 }
 
+/* FatFs reads and writes FAT and directory sectors through its window buffer */
+static inline bool sd_cache_is_meta(const BYTE* buff) {
+    return buff == fatfs_object.win;
+}
+
 static bool sd_device_read(uint32_t* buff, uint32_t sector, uint32_t count) {
-    bool result = false;
+    bool result;
 
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
-    if(sd_read_blocks(buff, sector, count, SD_TIMEOUT_MS) == SdSpiStatusOK) {
-        FuriHalCortexTimer timer = furi_hal_cortex_timer_get(SD_TIMEOUT_MS * 1000);
-
-        /* wait until the read operation is finished */
-        result = true;
-        while(sd_get_card_state() != SdSpiStatusOK) {
-            if(furi_hal_cortex_timer_is_expired(timer)) {
-                result = false;
-                break;
-            }
-        }
-    }
+    /* card is back in the transfer state on return, multiple block read is stopped */
+    result = (sd_read_blocks(buff, sector, count, SD_TIMEOUT_MS) == SdSpiStatusOK);
 
     furi_hal_sd_spi_handle = NULL;
     furi_hal_spi_release(&furi_hal_spi_bus_handle_sd_fast);
@@ -101,6 +111,39 @@ static bool sd_device_write(uint32_t* buff, uint32_t sector, uint32_t count) {
     return result;
 }
 
+typedef bool (*SdDeviceIo)(uint32_t* buff, uint32_t sector, uint32_t count);
+
+static bool sd_device_retry(SdDeviceIo io, uint32_t* buff, uint32_t sector, uint32_t count) {
+    bool result = io(buff, sector, count);
+
+    if(!result) {
+        uint8_t counter = sd_max_mount_retry_count();
+
+        while(result == false && counter > 0 && hal_sd_detect()) {
+            SdSpiStatus status;
+
+            if((counter % 2) == 0) {
+                // power reset sd card
+                status = sd_init(true);
+            } else {
+                status = sd_init(false);
+            }
+
+            if(status == SdSpiStatusOK) {
+                result = io(buff, sector, count);
+            }
+            counter--;
+        }
+    }
+
+    return result;
+}
+
+static bool sd_cache_write_back(uint32_t sector, const uint8_t* data, void* context) {
+    UNUSED(context);
+    return sd_device_retry(sd_device_write, (uint32_t*)data, sector, 1);
+}
+
 /**
   * @brief  Initializes a Drive
   * @param  pdrv: Physical drive number (0..)
@@ -141,6 +184,7 @@ static DRESULT driver_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
 
     bool result;
     bool single_sector = count == 1;
+    bool meta = sd_cache_is_meta(buff);
 
     if(single_sector) {
         if(sd_cache_get(sector, (uint32_t*)buff)) {
@@ -148,32 +192,16 @@ static DRESULT driver_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
         }
     }
 
-    result = sd_device_read((uint32_t*)buff, (uint32_t)(sector), count);
-
-    if(!result) {
-        uint8_t counter = sd_max_mount_retry_count();
-
-        while(result == false && counter > 0 && hal_sd_detect()) {
-            SdSpiStatus status;
+    result = sd_device_retry(sd_device_read, (uint32_t*)buff, (uint32_t)(sector), count);
 
-            if((counter % 2) == 0) {
-                // power reset sd card
-                status = sd_init(true);
-            } else {
-                status = sd_init(false);
-            }
-
-            if(status == SdSpiStatusOK) {
-                result = sd_device_read((uint32_t*)buff, (uint32_t)(sector), count);
-            }
-            counter--;
+    if(result == true) {
+        if(single_sector) {
+            sd_cache_put(sector, (uint32_t*)buff, meta);
+        } else {
+            sd_cache_read_dirty(sector, count, (uint32_t*)buff);
         }
     }
 
-    if(single_sector && result == true) {
-        sd_cache_put(sector, (uint32_t*)buff);
-    }
-
     return result ? RES_OK : RES_ERROR;
 }
 
@@ -188,29 +216,19 @@ static DRESULT driver_read(BYTE pdrv, BYTE* buff, DWORD sector, UINT count) {
 static DRESULT driver_write(BYTE pdrv, const BYTE* buff, DWORD sector, UINT count) {
     UNUSED(pdrv);
     bool result;
+    bool meta = sd_cache_is_meta(buff);
 
-    sd_cache_invalidate_range(sector, sector + count);
-
-    result = sd_device_write((uint32_t*)buff, (uint32_t)(sector), count);
-
-    if(!result) {
-        uint8_t counter = sd_max_mount_retry_count();
+    /* metadata is written back on CTRL_SYNC, FatFs rewrites the same sectors a lot */
+    if(meta && count == 1 && sd_cache_write(sector, (const uint32_t*)buff)) {
+        return RES_OK;
+    }
 
-        while(result == false && counter > 0 && hal_sd_detect()) {
-            SdSpiStatus status;
+    sd_cache_invalidate_range(sector, sector + count - 1);
 
-            if((counter % 2) == 0) {
-                // power reset sd card
-                status = sd_init(true);
-            } else {
-                status = sd_init(false);
-            }
+    result = sd_device_retry(sd_device_write, (uint32_t*)buff, (uint32_t)(sector), count);
 
-            if(status == SdSpiStatusOK) {
-                result = sd_device_write((uint32_t*)buff, (uint32_t)(sector), count);
-            }
-            counter--;
-        }
+    if(meta && count == 1 && result) {
+        sd_cache_put(sector, (uint32_t*)buff, true);
     }
 
     return result ? RES_OK : RES_ERROR;
@@ -230,11 +248,14 @@ static DRESULT driver_ioctl(BYTE pdrv, BYTE cmd, void* buff) {
 
     if(Stat & STA_NOINIT) return RES_NOTRDY;
 
+    /* write path takes the bus on its own */
+    if(cmd == CTRL_SYNC && !sd_cache_flush()) return RES_ERROR;
+
     furi_hal_spi_acquire(&furi_hal_spi_bus_handle_sd_fast);
     furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
 
     switch(cmd) {
-    /* Make sure that no pending write process */
+    /* Make sure that no pending write process, dirty sectors are already written */
     case CTRL_SYNC:
         res = RES_OK;
         break;
@@ -24,6 +24,10 @@ uint32_t furi_hal_cortex_instructions_per_microsecond() {
     return FURI_HAL_CORTEX_INSTRUCTIONS_PER_MICROSECOND;
 }
 
+uint32_t furi_hal_cortex_get_cycle_count() {
+    return DWT->CYCCNT;
+}
+
 FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
     FuriHalCortexTimer cortex_timer = {0};
     cortex_timer.start = DWT->CYCCNT;
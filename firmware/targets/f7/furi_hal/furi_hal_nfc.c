@@ -109,7 +109,7 @@ bool furi_hal_nfc_detect(FuriHalNfcDevData* nfc_data, uint32_t timeout) {
         rfalNfcWorker();
         state = rfalNfcGetState();
         if(state != state_old) {
-            FURI_LOG_T(TAG, "State change %d -> %d", state_old, state);
+            FURI_LOG_DEFERRED_T(TAG, "State change %d -> %d", state_old, state);
         }
         state_old = state;
         if(state == RFAL_NFC_STATE_ACTIVATED) {
@@ -125,7 +125,7 @@ bool furi_hal_nfc_detect(FuriHalNfcDevData* nfc_data, uint32_t timeout) {
         }
         if(DWT->CYCCNT - start > timeout * clocks_in_ms) {
             rfalNfcDeactivate(true);
-            FURI_LOG_T(TAG, "Timeout");
+            FURI_LOG_DEFERRED_T(TAG, "Timeout");
             break;
         }
         furi_delay_tick(1);
@@ -192,7 +192,7 @@ bool furi_hal_nfc_activate_nfca(uint32_t timeout, uint32_t* cuid) {
     while(state != RFAL_NFC_STATE_ACTIVATED) {
         rfalNfcWorker();
         state = rfalNfcGetState();
-        FURI_LOG_T(TAG, "Current state %d", state);
+        FURI_LOG_DEFERRED_T(TAG, "Current state %d", state);
         if(state == RFAL_NFC_STATE_POLL_ACTIVATION) {
             start = DWT->CYCCNT;
             continue;
@@ -202,7 +202,7 @@ bool furi_hal_nfc_activate_nfca(uint32_t timeout, uint32_t* cuid) {
         }
         if(DWT->CYCCNT - start > timeout * clocks_in_ms) {
             rfalNfcDeactivate(true);
-            FURI_LOG_T(TAG, "Timeout");
+            FURI_LOG_DEFERRED_T(TAG, "Timeout");
             return false;
         }
         furi_thread_yield();
@@ -216,7 +216,7 @@ bool furi_hal_nfc_activate_nfca(uint32_t timeout, uint32_t* cuid) {
         }
         *cuid = (cuid_start[0] << 24) | (cuid_start[1] << 16) | (cuid_start[2] << 8) |
                 (cuid_start[3]);
-        FURI_LOG_T(TAG, "Activated tag with cuid: %lX", *cuid);
+        FURI_LOG_DEFERRED_T(TAG, "Activated tag with cuid: %lX", *cuid);
     }
     return true;
 }
@@ -321,7 +321,7 @@ bool furi_hal_nfc_listen_rx(FuriHalNfcTxRxContext* tx_rx, uint32_t timeout_ms) {
             continue;
         }
         if(furi_get_tick() - start > timeout_ms) {
-            FURI_LOG_T(TAG, "Interrupt waiting timeout");
+            FURI_LOG_DEFERRED_T(TAG, "Interrupt waiting timeout");
             furi_delay_tick(1);
             break;
         }
@@ -472,7 +472,7 @@ bool furi_hal_nfc_emulate_nfca(
                     data_type,
                     RFAL_FWT_NONE);
                 if(ret) {
-                    FURI_LOG_E(TAG, "Tranceive failed with status %d", ret);
+                    FURI_LOG_DEFERRED_E(TAG, "Tranceive failed with status %d", ret);
                     break;
                 }
                 continue;
@@ -496,7 +496,7 @@ bool furi_hal_nfc_emulate_nfca(
                         data_type,
                         RFAL_FWT_NONE);
                     if(ret) {
-                        FURI_LOG_E(TAG, "Tranceive failed with status %d", ret);
+                        FURI_LOG_DEFERRED_E(TAG, "Tranceive failed with status %d", ret);
                         continue;
                     }
                 } else {
@@ -554,7 +554,7 @@ static bool furi_hal_nfc_transparent_tx_rx(FuriHalNfcTxRxContext* tx_rx, uint16_
         }
         uint32_t timeout = DWT->CYCCNT - start;
         if(timeout / furi_hal_cortex_instructions_per_microsecond() > timeout_ms * 1000) {
-            FURI_LOG_D(TAG, "Interrupt waiting timeout");
+            FURI_LOG_DEFERRED_D(TAG, "Interrupt waiting timeout");
             break;
         }
     }
@@ -703,7 +703,7 @@ bool furi_hal_nfc_tx_rx(FuriHalNfcTxRxContext* tx_rx, uint16_t timeout_ms) {
         ret = rfalNfcDataExchangeGetStatus();
         if(ret == ERR_BUSY) {
             if(DWT->CYCCNT - start > timeout_ms * clocks_in_ms) {
-                FURI_LOG_D(TAG, "Timeout during data exchange");
+                FURI_LOG_DEFERRED_D(TAG, "Timeout during data exchange");
                 return false;
             }
             continue;
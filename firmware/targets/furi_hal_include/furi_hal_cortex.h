@@ -34,6 +34,14 @@ void furi_hal_cortex_delay_us(uint32_t microseconds);
  */
 uint32_t furi_hal_cortex_instructions_per_microsecond();
 
+/** Get cycle counter value
+ *
+ * Free running, wraps around every 2^32 / SystemCoreClock seconds.
+ *
+ * @return     current CPU cycle count
+ */
+uint32_t furi_hal_cortex_get_cycle_count();
+
 /** Get Timer
  *
  * @param[in]  timeout_us  The expire timeout in us
@@ -1,15 +1,34 @@
 #include "log.h"
 #include "check.h"
+#include "kernel.h"
 #include "mutex.h"
+#include "spsc_ring.h"
+#include "thread.h"
+#include "common_defines.h"
 #include <furi_hal.h>
+#include <string.h>
+
+#define TAG "FuriLog"
 
 #define FURI_LOG_LEVEL_DEFAULT FuriLogLevelInfo
 
+#define FURI_LOG_DEFERRED_CAPACITY (128)
+#define FURI_LOG_DEFERRED_WATERMARK (32)
+#define FURI_LOG_DEFERRED_TIMEOUT (100)
+#define FURI_LOG_DEFERRED_STACK_SIZE (1024)
+
 typedef struct {
     FuriLogLevel log_level;
     FuriLogPuts puts;
     FuriLogTimestamp timestamp;
     FuriMutex* mutex;
+
+    volatile bool deferred_enabled;
+    volatile uint32_t deferred_dropped; /**< ISR records with deferred logging off */
+    FuriSpscRing* deferred_ring;
+    FuriThread* deferred_thread;
+    FuriLogDeferredSink deferred_sink;
+    void* deferred_sink_context;
 } FuriLogParams;
 
 static FuriLogParams furi_log;
@@ -117,3 +136,119 @@ void furi_log_set_timestamp(FuriLogTimestamp timestamp) {
     furi_assert(timestamp);
     furi_log.timestamp = timestamp;
 }
+
+static void furi_log_deferred_print(const FuriLogDeferredRecord* record, FuriString* string) {
+    furi_string_printf(string, "#L %08lX %lX", (uint32_t)record->site, record->timestamp);
+    for(size_t i = 0; i < record->site->argc; i++) {
+        furi_string_cat_printf(string, " %lX", record->args[i]);
+    }
+    furi_string_cat(string, "\r\n");
+
+    if(furi_mutex_acquire(furi_log.mutex, FuriWaitForever) == FuriStatusOk) {
+        furi_log.puts(furi_string_get_cstr(string));
+        furi_mutex_release(furi_log.mutex);
+    }
+}
+
+static int32_t furi_log_deferred_thread(void* context) {
+    UNUSED(context);
+
+    FuriString* string = furi_string_alloc();
+    FuriLogDeferredRecord record;
+    FuriSpscRingStats stats;
+    uint32_t overruns = 0;
+
+    while(true) {
+        furi_spsc_ring_wait(furi_log.deferred_ring, FURI_LOG_DEFERRED_TIMEOUT);
+
+        while(furi_spsc_ring_pop(furi_log.deferred_ring, &record, 1)) {
+            FuriLogDeferredSink sink = furi_log.deferred_sink;
+            if(sink) {
+                sink(&record, furi_log.deferred_sink_context);
+            } else {
+                furi_log_deferred_print(&record, string);
+            }
+        }
+
+        furi_spsc_ring_get_stats(furi_log.deferred_ring, &stats);
+        if(stats.overruns != overruns) {
+            FURI_LOG_W(TAG, "%lu deferred records lost", stats.overruns - overruns);
+            overruns = stats.overruns;
+        }
+    }
+
+    return 0;
+}
+
+void furi_log_deferred(const FuriLogDeferredSite* site, const uint32_t* args) {
+    furi_assert(site);
+    furi_assert(site->argc <= FURI_LOG_DEFERRED_ARGS_MAX);
+
+    if(site->level > furi_log.log_level) return;
+
+    if(!furi_log.deferred_enabled) {
+        // Printing takes log mutex, not an option for ISR
+        if(furi_kernel_is_irq_or_masked()) {
+            furi_log.deferred_dropped++;
+            return;
+        }
+
+        FURI_CRITICAL_ENTER();
+        uint32_t dropped = furi_log.deferred_dropped;
+        furi_log.deferred_dropped = 0;
+        FURI_CRITICAL_EXIT();
+        if(dropped) {
+            furi_log_print_format(
+                FuriLogLevelWarn, TAG, "%lu deferred records from ISR dropped", dropped);
+        }
+
+        uint32_t a[FURI_LOG_DEFERRED_ARGS_MAX] = {0};
+        memcpy(a, args, site->argc * sizeof(uint32_t));
+        // Extra arguments are ignored by formatter
+        furi_log_print_format(
+            site->level, site->tag, site->format, a[0], a[1], a[2], a[3], a[4], a[5]);
+        return;
+    }
+
+    FuriLogDeferredRecord record;
+    record.site = site;
+    record.timestamp = furi_log.timestamp();
+    memcpy(record.args, args, site->argc * sizeof(uint32_t));
+
+    // Producers are serialized, ring itself allows only one
+    FURI_CRITICAL_ENTER();
+    furi_spsc_ring_push(furi_log.deferred_ring, &record);
+    FURI_CRITICAL_EXIT();
+}
+
+void furi_log_deferred_enable(bool enable) {
+    furi_assert(!furi_kernel_is_irq_or_masked());
+    furi_check(furi_mutex_acquire(furi_log.mutex, FuriWaitForever) == FuriStatusOk);
+
+    if(enable && !furi_log.deferred_thread) {
+        furi_log.deferred_ring = furi_spsc_ring_alloc(
+            sizeof(FuriLogDeferredRecord),
+            FURI_LOG_DEFERRED_CAPACITY,
+            FURI_LOG_DEFERRED_WATERMARK);
+        furi_log.deferred_thread = furi_thread_alloc_ex(
+            "LogDeferred", FURI_LOG_DEFERRED_STACK_SIZE, furi_log_deferred_thread, NULL);
+        furi_thread_mark_as_service(furi_log.deferred_thread);
+        furi_thread_set_priority(furi_log.deferred_thread, FuriThreadPriorityLowest);
+        furi_thread_start(furi_log.deferred_thread);
+    }
+    // Thread stays alive on disable and drains what is left
+    furi_log.deferred_enabled = enable;
+
+    furi_mutex_release(furi_log.mutex);
+}
+
+bool furi_log_deferred_is_enabled() {
+    return furi_log.deferred_enabled;
+}
+
+void furi_log_deferred_set_sink(FuriLogDeferredSink sink, void* context) {
+    FURI_CRITICAL_ENTER();
+    furi_log.deferred_sink = sink;
+    furi_log.deferred_sink_context = context;
+    FURI_CRITICAL_EXIT();
+}
@@ -1,11 +1,19 @@
 /**
  * @file log.h
  * Furi Logging system
+ *
+ * Deferred records (FURI_LOG_DEFERRED_*) are meant for timing sensitive
+ * code: call site only stores pointer to its static descriptor, timestamp
+ * and raw argument words into a ring, formatting and output happen in a
+ * low priority thread. Descriptors are collected by linker into
+ * `.furi_log_fmt` section, so thread prints them as `#L` lines with hex
+ * words and `scripts/log_decode.py` restores text using firmware ELF.
  */
 #pragma once
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdarg.h>
 
 #ifdef __cplusplus
@@ -41,6 +49,27 @@ typedef enum {
 typedef void (*FuriLogPuts)(const char* data);
 typedef uint32_t (*FuriLogTimestamp)(void);
 
+/** Maximum amount of deferred record arguments */
+#define FURI_LOG_DEFERRED_ARGS_MAX (6)
+
+/** Deferred record call site descriptor, lives in `.furi_log_fmt` section */
+typedef struct {
+    uint8_t level;
+    uint8_t argc;
+    const char* tag;
+    const char* format;
+} FuriLogDeferredSite;
+
+/** Deferred record as stored in ring */
+typedef struct {
+    const FuriLogDeferredSite* site;
+    uint32_t timestamp;
+    uint32_t args[FURI_LOG_DEFERRED_ARGS_MAX];
+} FuriLogDeferredRecord;
+
+/** Deferred record sink, called from log thread */
+typedef void (*FuriLogDeferredSink)(const FuriLogDeferredRecord* record, void* context);
+
 /** Initialize logging */
 void furi_log_init();
 
@@ -63,6 +92,36 @@ void furi_log_print_format(FuriLogLevel level, const char* tag, const char* form
 void furi_log_print_raw_format(FuriLogLevel level, const char* format, ...)
     _ATTRIBUTE((__format__(__printf__, 2, 3)));
 
+/** Store deferred log record, ISR safe
+ *
+ * Use FURI_LOG_DEFERRED_* macros instead of calling it directly. Record is
+ * printed immediately if deferred logging is disabled, records from ISR are
+ * dropped in that case and reported by the next record from a thread.
+ *
+ * @param      site  call site descriptor
+ * @param      args  argument words
+ */
+void furi_log_deferred(const FuriLogDeferredSite* site, const uint32_t* args);
+
+/** Enable or disable deferred logging, log thread is started on first enable
+ *
+ * @param      enable  true to defer records, false to print them immediately
+ */
+void furi_log_deferred_enable(bool enable);
+
+/** Check if deferred logging is enabled
+ *
+ * @return     true if enabled
+ */
+bool furi_log_deferred_is_enabled();
+
+/** Set deferred record sink
+ *
+ * @param      sink     sink callback, NULL to print `#L` lines with log puts
+ * @param      context  sink context
+ */
+void furi_log_deferred_set_sink(FuriLogDeferredSink sink, void* context);
+
 /** Set log level
  *
  * @param[in]  level  The level
@@ -104,6 +163,39 @@ void furi_log_set_timestamp(FuriLogTimestamp timestamp);
 #define FURI_LOG_T(tag, format, ...) \
     furi_log_print_format(FuriLogLevelTrace, tag, format, ##__VA_ARGS__)
 
+/** Deferred log methods
+ *
+ * Arguments are stored as uint32_t words: integers and chars are converted
+ * implicitly, pointers must be cast. `%s` is resolved by decoder only for
+ * strings stored in firmware flash, C only.
+ *
+ * @param      tag     The application tag, string literal
+ * @param      format  The format, string literal
+ * @param      ...     Up to FURI_LOG_DEFERRED_ARGS_MAX integer args
+ */
+#define FURI_LOG_DEFERRED(level, tag, format, ...)                                      \
+    do {                                                                               \
+        const uint32_t _furi_log_args[] = {0, ##__VA_ARGS__};                          \
+        _Static_assert(                                                                \
+            sizeof(_furi_log_args) <= sizeof(uint32_t) * (FURI_LOG_DEFERRED_ARGS_MAX + 1), \
+            "Too many deferred log arguments");                                        \
+        static const FuriLogDeferredSite _furi_log_site                                \
+            __attribute__((section(".furi_log_fmt"), used)) = {                        \
+                level, sizeof(_furi_log_args) / sizeof(uint32_t) - 1, tag, format};    \
+        furi_log_deferred(&_furi_log_site, &_furi_log_args[1]);                        \
+    } while(0)
+
+#define FURI_LOG_DEFERRED_E(tag, format, ...) \
+    FURI_LOG_DEFERRED(FuriLogLevelError, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_DEFERRED_W(tag, format, ...) \
+    FURI_LOG_DEFERRED(FuriLogLevelWarn, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_DEFERRED_I(tag, format, ...) \
+    FURI_LOG_DEFERRED(FuriLogLevelInfo, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_DEFERRED_D(tag, format, ...) \
+    FURI_LOG_DEFERRED(FuriLogLevelDebug, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_DEFERRED_T(tag, format, ...) \
+    FURI_LOG_DEFERRED(FuriLogLevelTrace, tag, format, ##__VA_ARGS__)
+
 /** Log methods
  *
  * @param      format  The raw format 
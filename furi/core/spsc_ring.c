@@ -0,0 +1,154 @@
+#include "spsc_ring.h"
+#include "check.h"
+#include "core_defines.h"
+#include "thread.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct FuriSpscRing {
+    size_t item_size;
+    size_t mask;
+    size_t watermark;
+
+    /* Free running indexes, head is owned by producer, tail by consumer */
+    size_t head;
+    size_t tail;
+
+    /* Set by consumer while it sleeps, taken by producer to wake it */
+    FuriThreadId consumer;
+
+    uint32_t overruns;
+    size_t high_water;
+
+    uint8_t buffer[];
+};
+
+FuriSpscRing* furi_spsc_ring_alloc(size_t item_size, size_t capacity, size_t watermark) {
+    furi_assert(item_size);
+    furi_check(capacity && !(capacity & (capacity - 1)));
+    furi_assert(watermark && watermark <= capacity);
+
+    FuriSpscRing* ring = malloc(sizeof(FuriSpscRing) + item_size * capacity);
+    ring->item_size = item_size;
+    ring->mask = capacity - 1;
+    ring->watermark = watermark;
+
+    return ring;
+}
+
+void furi_spsc_ring_free(FuriSpscRing* ring) {
+    furi_assert(ring);
+    furi_assert(!ring->consumer);
+    free(ring);
+}
+
+bool furi_spsc_ring_push(FuriSpscRing* ring, const void* item) {
+    furi_assert(ring);
+
+    size_t head = ring->head;
+    size_t count = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if(count > ring->mask) {
+        ring->overruns++;
+        return false;
+    }
+
+    memcpy(&ring->buffer[(head & ring->mask) * ring->item_size], item, ring->item_size);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+    count++;
+    if(count > ring->high_water) ring->high_water = count;
+
+    if(count >= ring->watermark && __atomic_load_n(&ring->consumer, __ATOMIC_RELAXED)) {
+        FuriThreadId consumer = __atomic_exchange_n(&ring->consumer, NULL, __ATOMIC_ACQ_REL);
+        if(consumer) furi_thread_flags_set(consumer, FURI_SPSC_RING_FLAG);
+    }
+
+    return true;
+}
+
+size_t furi_spsc_ring_wait(FuriSpscRing* ring, uint32_t timeout) {
+    furi_assert(ring);
+
+    size_t count = furi_spsc_ring_count(ring);
+    if(count >= ring->watermark || !timeout) return count;
+
+    // Publish consumer first, then recheck: producer either sees it or we see the items
+    __atomic_store_n(&ring->consumer, furi_thread_get_current_id(), __ATOMIC_SEQ_CST);
+    count = furi_spsc_ring_count(ring);
+    if(count < ring->watermark) {
+        furi_thread_flags_wait(FURI_SPSC_RING_FLAG, FuriFlagWaitAny, timeout);
+        count = furi_spsc_ring_count(ring);
+    }
+    __atomic_store_n(&ring->consumer, NULL, __ATOMIC_SEQ_CST);
+
+    return count;
+}
+
+size_t furi_spsc_ring_count(const FuriSpscRing* ring) {
+    furi_assert(ring);
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    return head - ring->tail;
+}
+
+size_t furi_spsc_ring_peek(FuriSpscRing* ring, const void** items) {
+    furi_assert(ring);
+    furi_assert(items);
+
+    size_t offset = ring->tail & ring->mask;
+    size_t count = furi_spsc_ring_count(ring);
+    count = MIN(count, ring->mask + 1 - offset);
+    *items = &ring->buffer[offset * ring->item_size];
+
+    return count;
+}
+
+void furi_spsc_ring_release(FuriSpscRing* ring, size_t count) {
+    furi_assert(ring);
+    furi_assert(count <= furi_spsc_ring_count(ring));
+    __atomic_store_n(&ring->tail, ring->tail + count, __ATOMIC_RELEASE);
+}
+
+size_t furi_spsc_ring_pop(FuriSpscRing* ring, void* items, size_t count) {
+    furi_assert(ring);
+    furi_assert(items);
+
+    uint8_t* destination = items;
+    size_t copied = 0;
+
+    // At most two runs: up to the end of buffer and from its start
+    while(copied < count) {
+        const void* run;
+        size_t run_count = furi_spsc_ring_peek(ring, &run);
+        run_count = MIN(run_count, count - copied);
+        if(!run_count) break;
+
+        memcpy(destination, run, run_count * ring->item_size);
+        furi_spsc_ring_release(ring, run_count);
+
+        destination += run_count * ring->item_size;
+        copied += run_count;
+    }
+
+    return copied;
+}
+
+void furi_spsc_ring_flush(FuriSpscRing* ring) {
+    furi_assert(ring);
+    __atomic_store_n(
+        &ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+void furi_spsc_ring_get_stats(const FuriSpscRing* ring, FuriSpscRingStats* stats) {
+    furi_assert(ring);
+    furi_assert(stats);
+    stats->overruns = ring->overruns;
+    stats->high_water = ring->high_water;
+}
+
+void furi_spsc_ring_reset_stats(FuriSpscRing* ring) {
+    furi_assert(ring);
+    ring->overruns = 0;
+    ring->high_water = furi_spsc_ring_count(ring);
+}
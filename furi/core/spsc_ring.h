@@ -0,0 +1,125 @@
+/**
+ * @file spsc_ring.h
+ * Furi lock-free single producer single consumer ring.
+ *
+ * Ring of fixed size items for interrupt to task streaming: push never
+ * blocks and is safe to call from ISR, consumer drains items in batches
+ * and sleeps until fill level reaches watermark or timeout expires.
+ * Unlike stream buffer there are no kernel calls on the hot path,
+ * consumer is notified only when watermark is crossed.
+ *
+ * ***NOTE***: exactly one producer and one consumer are allowed.
+ * Consumer waits with FURI_SPSC_RING_FLAG thread flag, do not use it
+ * for other purposes in consumer thread.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Thread flag used to wake consumer */
+#define FURI_SPSC_RING_FLAG (1UL << 30)
+
+typedef struct FuriSpscRing FuriSpscRing;
+
+typedef struct {
+    uint32_t overruns; /**< items dropped because ring was full */
+    size_t high_water; /**< maximum fill level seen by producer */
+} FuriSpscRingStats;
+
+/** Allocate ring
+ *
+ * @param      item_size  size of one item in bytes
+ * @param      capacity   ring capacity in items, must be power of two
+ * @param      watermark  fill level that wakes waiting consumer, 1..capacity
+ *
+ * @return     FuriSpscRing instance
+ */
+FuriSpscRing* furi_spsc_ring_alloc(size_t item_size, size_t capacity, size_t watermark);
+
+/** Free ring
+ *
+ * @param      ring  FuriSpscRing instance
+ */
+void furi_spsc_ring_free(FuriSpscRing* ring);
+
+/** Push item, producer side, ISR safe
+ *
+ * @param      ring  FuriSpscRing instance
+ * @param      item  pointer to item_size bytes
+ *
+ * @return     true on success, false if ring is full and item was dropped
+ */
+bool furi_spsc_ring_push(FuriSpscRing* ring, const void* item);
+
+/** Wait until watermark is reached or timeout expires, consumer side
+ *
+ * @param      ring     FuriSpscRing instance
+ * @param      timeout  timeout in ticks
+ *
+ * @return     amount of items available
+ */
+size_t furi_spsc_ring_wait(FuriSpscRing* ring, uint32_t timeout);
+
+/** Get amount of items in ring
+ *
+ * @param      ring  FuriSpscRing instance
+ *
+ * @return     amount of items
+ */
+size_t furi_spsc_ring_count(const FuriSpscRing* ring);
+
+/** Get contiguous run of items without copying, consumer side
+ * Items stay in ring until furi_spsc_ring_release is called.
+ *
+ * @param      ring   FuriSpscRing instance
+ * @param      items  pointer to first item, undefined if nothing available
+ *
+ * @return     amount of contiguous items, may be less than furi_spsc_ring_count
+ */
+size_t furi_spsc_ring_peek(FuriSpscRing* ring, const void** items);
+
+/** Release items obtained with furi_spsc_ring_peek, consumer side
+ *
+ * @param      ring   FuriSpscRing instance
+ * @param      count  amount of items to release, not more than peeked
+ */
+void furi_spsc_ring_release(FuriSpscRing* ring, size_t count);
+
+/** Copy items out of ring, consumer side
+ *
+ * @param      ring   FuriSpscRing instance
+ * @param      items  destination for up to count items
+ * @param      count  maximum amount of items
+ *
+ * @return     amount of copied items
+ */
+size_t furi_spsc_ring_pop(FuriSpscRing* ring, void* items, size_t count);
+
+/** Drop all items, consumer side
+ *
+ * @param      ring  FuriSpscRing instance
+ */
+void furi_spsc_ring_flush(FuriSpscRing* ring);
+
+/** Get ring counters
+ *
+ * @param      ring   FuriSpscRing instance
+ * @param      stats  counters destination
+ */
+void furi_spsc_ring_get_stats(const FuriSpscRing* ring, FuriSpscRingStats* stats);
+
+/** Reset ring counters, high water restarts from current fill level
+ *
+ * @param      ring  FuriSpscRing instance
+ */
+void furi_spsc_ring_reset_stats(FuriSpscRing* ring);
+
+#ifdef __cplusplus
+}
+#endif
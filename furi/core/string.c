@@ -1,10 +1,44 @@
 #include "string.h"
-#include <m-string.h>
+#include "check.h"
+#include "core_defines.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+/* Strings up to FURI_STRING_INLINE_SIZE - 1 characters live inside the
+ * header, so typical keys, names and numbers never touch the heap.
+ * Longer strings move to heap or, for arena strings, to arena memory. */
+#define FURI_STRING_INLINE_SIZE (24)
+#define FURI_STRING_ARENA_ALIGN (sizeof(void*))
+#define FURI_STRING_FORMAT_STACK_SIZE (64)
 
 struct FuriString {
-    string_t string;
+    char* ptr;
+    size_t size;
+    size_t alloc;
+    FuriStringArena* arena;
+    char buffer[FURI_STRING_INLINE_SIZE];
+};
+
+typedef struct FuriStringArenaBlock FuriStringArenaBlock;
+
+struct FuriStringArenaBlock {
+    FuriStringArenaBlock* next;
+    size_t size;
+    size_t used;
+    uint8_t data[];
+};
+
+struct FuriStringArena {
+    /* Newest block first, the one allocated with the arena is the last */
+    FuriStringArenaBlock* head;
+    size_t block_size;
 };
 
+static FuriStringStats furi_string_stats = {0};
+
 #undef furi_string_alloc_set
 #undef furi_string_set
 #undef furi_string_cmp
@@ -22,23 +56,204 @@ struct FuriString {
 #undef furi_string_trim
 #undef furi_string_cat
 
+//---------------------------------------------------------------------------
+//                               Memory
+//---------------------------------------------------------------------------
+
+static void* furi_string_heap_alloc(size_t size) {
+    __atomic_fetch_add(&furi_string_stats.heap_allocs, 1, __ATOMIC_RELAXED);
+    return malloc(size);
+}
+
+static void* furi_string_heap_realloc(void* ptr, size_t size) {
+    __atomic_fetch_add(&furi_string_stats.heap_allocs, 1, __ATOMIC_RELAXED);
+    return realloc(ptr, size);
+}
+
+static size_t furi_string_arena_align(size_t size) {
+    return (size + FURI_STRING_ARENA_ALIGN - 1) & ~(FURI_STRING_ARENA_ALIGN - 1);
+}
+
+static FuriStringArenaBlock* furi_string_arena_block_alloc(size_t size) {
+    FuriStringArenaBlock* block = furi_string_heap_alloc(sizeof(FuriStringArenaBlock) + size);
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+static void* furi_string_arena_take(FuriStringArena* arena, size_t size) {
+    size = furi_string_arena_align(size);
+    FuriStringArenaBlock* block = arena->head;
+
+    if(block->size - block->used < size) {
+        block = furi_string_arena_block_alloc(MAX(size, arena->block_size));
+        block->next = arena->head;
+        arena->head = block;
+    }
+
+    void* ptr = &block->data[block->used];
+    block->used += size;
+    __atomic_fetch_add(&furi_string_stats.arena_allocs, 1, __ATOMIC_RELAXED);
+    return ptr;
+}
+
+/* Grow last allocation of the arena in place */
+static bool furi_string_arena_extend(FuriStringArena* arena, void* ptr, size_t old, size_t size) {
+    FuriStringArenaBlock* block = arena->head;
+    old = furi_string_arena_align(old);
+    size = furi_string_arena_align(size);
+
+    if((uint8_t*)ptr + old != &block->data[block->used]) return false;
+    if(block->size - block->used < size - old) return false;
+
+    block->used += size - old;
+    return true;
+}
+
+static bool furi_string_is_inline(const FuriString* s) {
+    return s->ptr == s->buffer;
+}
+
+static void furi_string_init(FuriString* s, FuriStringArena* arena) {
+    s->ptr = s->buffer;
+    s->size = 0;
+    s->alloc = FURI_STRING_INLINE_SIZE;
+    s->arena = arena;
+    s->buffer[0] = '\0';
+}
+
+/* Release buffer, header stays untouched */
+static void furi_string_clear(FuriString* s) {
+    if(!furi_string_is_inline(s) && !s->arena) {
+        free(s->ptr);
+    }
+}
+
+/* Ensure buffer can hold alloc bytes, terminator included */
+static void furi_string_fit(FuriString* s, size_t alloc) {
+    if(alloc <= s->alloc) return;
+    alloc = MAX(alloc, s->alloc + s->alloc / 2);
+
+    char* ptr;
+    if(s->arena) {
+        alloc = furi_string_arena_align(alloc);
+        if(!furi_string_is_inline(s) &&
+           furi_string_arena_extend(s->arena, s->ptr, s->alloc, alloc)) {
+            ptr = s->ptr;
+        } else {
+            ptr = furi_string_arena_take(s->arena, alloc);
+            memcpy(ptr, s->ptr, s->size + 1);
+        }
+    } else if(furi_string_is_inline(s)) {
+        ptr = furi_string_heap_alloc(alloc);
+        memcpy(ptr, s->ptr, s->size + 1);
+    } else {
+        ptr = furi_string_heap_realloc(s->ptr, alloc);
+    }
+
+    s->ptr = ptr;
+    s->alloc = alloc;
+}
+
+/* Replace len characters at pos with data, data may point into the string itself */
+static void furi_string_splice(
+    FuriString* s,
+    size_t pos,
+    size_t len,
+    const char* data,
+    size_t data_size) {
+    furi_assert(pos <= s->size);
+    len = MIN(len, s->size - pos);
+
+    char* copy = NULL;
+    if(data_size && data >= s->ptr && data < s->ptr + s->alloc) {
+        if(pos == 0 && len == s->size) {
+            memmove(s->ptr, data, data_size);
+            s->ptr[data_size] = '\0';
+            s->size = data_size;
+            return;
+        }
+        copy = malloc(data_size);
+        memcpy(copy, data, data_size);
+        data = copy;
+    }
+
+    size_t size = s->size - len + data_size;
+    furi_string_fit(s, size + 1);
+    memmove(&s->ptr[pos + data_size], &s->ptr[pos + len], s->size - pos - len + 1);
+    memcpy(&s->ptr[pos], data, data_size);
+    s->size = size;
+
+    free(copy);
+}
+
+//---------------------------------------------------------------------------
+//                               Arena
+//---------------------------------------------------------------------------
+
+FuriStringArena* furi_string_arena_alloc(size_t size) {
+    furi_assert(size);
+    FuriStringArena* arena = malloc(sizeof(FuriStringArena));
+    arena->block_size = furi_string_arena_align(size);
+    arena->head = furi_string_arena_block_alloc(arena->block_size);
+    return arena;
+}
+
+void furi_string_arena_free(FuriStringArena* arena) {
+    furi_assert(arena);
+    while(arena->head) {
+        FuriStringArenaBlock* next = arena->head->next;
+        free(arena->head);
+        arena->head = next;
+    }
+    free(arena);
+}
+
+void furi_string_arena_reset(FuriStringArena* arena) {
+    furi_assert(arena);
+    while(arena->head->next) {
+        FuriStringArenaBlock* next = arena->head->next;
+        free(arena->head);
+        arena->head = next;
+    }
+    arena->head->used = 0;
+}
+
+FuriString* furi_string_arena_alloc_string(FuriStringArena* arena) {
+    furi_assert(arena);
+    FuriString* string = furi_string_arena_take(arena, sizeof(FuriString));
+    furi_string_init(string, arena);
+    return string;
+}
+
+void furi_string_get_stats(FuriStringStats* stats) {
+    furi_assert(stats);
+    stats->heap_allocs = __atomic_load_n(&furi_string_stats.heap_allocs, __ATOMIC_RELAXED);
+    stats->arena_allocs = __atomic_load_n(&furi_string_stats.arena_allocs, __ATOMIC_RELAXED);
+}
+
+//---------------------------------------------------------------------------
+//                               String
+//---------------------------------------------------------------------------
+
 FuriString* furi_string_alloc() {
-    FuriString* string = malloc(sizeof(FuriString));
-    string_init(string->string);
+    FuriString* string = furi_string_heap_alloc(sizeof(FuriString));
+    furi_string_init(string, NULL);
     return string;
 }
 
 FuriString* furi_string_alloc_set(const FuriString* s) {
-    FuriString* string = malloc(sizeof(FuriString)); //-V799
-    string_init_set(string->string, s->string);
+    FuriString* string = furi_string_alloc();
+    furi_string_splice(string, 0, 0, s->ptr, s->size);
     return string;
-} //-V773
+}
 
 FuriString* furi_string_alloc_set_str(const char cstr[]) {
-    FuriString* string = malloc(sizeof(FuriString)); //-V799
-    string_init_set(string->string, cstr);
+    FuriString* string = furi_string_alloc();
+    furi_string_splice(string, 0, 0, cstr, strlen(cstr));
     return string;
-} //-V773
+}
 
 FuriString* furi_string_alloc_printf(const char format[], ...) {
     va_list args;
@@ -49,107 +264,171 @@ FuriString* furi_string_alloc_printf(const char format[], ...) {
 }
 
 FuriString* furi_string_alloc_vprintf(const char format[], va_list args) {
-    FuriString* string = malloc(sizeof(FuriString));
-    string_init_vprintf(string->string, format, args);
+    FuriString* string = furi_string_alloc();
+    furi_string_vprintf(string, format, args);
     return string;
 }
 
 FuriString* furi_string_alloc_move(FuriString* s) {
-    FuriString* string = malloc(sizeof(FuriString));
-    string_init_move(string->string, s->string);
-    free(s);
+    FuriString* string = furi_string_alloc();
+    furi_string_move(string, s);
     return string;
 }
 
 void furi_string_free(FuriString* s) {
-    string_clear(s->string);
+    if(s->arena) return;
+    furi_string_clear(s);
     free(s);
 }
 
 void furi_string_reserve(FuriString* s, size_t alloc) {
-    string_reserve(s->string, alloc);
+    furi_string_fit(s, alloc);
 }
 
 void furi_string_reset(FuriString* s) {
-    string_reset(s->string);
+    s->size = 0;
+    s->ptr[0] = '\0';
 }
 
 void furi_string_swap(FuriString* v1, FuriString* v2) {
-    string_swap(v1->string, v2->string);
+    if(v1->arena != v2->arena) {
+        // Buffers can not change their owner, exchange content instead
+        FuriString* tmp = furi_string_alloc_set(v1);
+        furi_string_set(v1, v2);
+        furi_string_set(v2, tmp);
+        furi_string_free(tmp);
+        return;
+    }
+
+    bool inline_1 = furi_string_is_inline(v1);
+    bool inline_2 = furi_string_is_inline(v2);
+    FuriString tmp = *v1;
+    *v1 = *v2;
+    *v2 = tmp;
+    if(inline_2) v1->ptr = v1->buffer;
+    if(inline_1) v2->ptr = v2->buffer;
 }
 
 void furi_string_move(FuriString* v1, FuriString* v2) {
-    string_clear(v1->string);
-    string_init_move(v1->string, v2->string);
-    free(v2);
+    if(v1->arena != v2->arena || furi_string_is_inline(v2)) {
+        furi_string_splice(v1, 0, v1->size, v2->ptr, v2->size);
+    } else {
+        furi_string_clear(v1);
+        v1->ptr = v2->ptr;
+        v1->size = v2->size;
+        v1->alloc = v2->alloc;
+        furi_string_init(v2, v2->arena);
+    }
+    furi_string_free(v2);
 }
 
 size_t furi_string_hash(const FuriString* v) {
-    return string_hash(v->string);
+    return m_core_hash(v->ptr, v->size);
 }
 
 char furi_string_get_char(const FuriString* v, size_t index) {
-    return string_get_char(v->string, index);
+    furi_assert(index < v->size);
+    return v->ptr[index];
 }
 
 const char* furi_string_get_cstr(const FuriString* s) {
-    return string_get_cstr(s->string);
+    return s->ptr;
 }
 
 void furi_string_set(FuriString* s, FuriString* source) {
-    string_set(s->string, source->string);
+    furi_string_splice(s, 0, s->size, source->ptr, source->size);
 }
 
 void furi_string_set_str(FuriString* s, const char cstr[]) {
-    string_set(s->string, cstr);
+    furi_string_splice(s, 0, s->size, cstr, strlen(cstr));
 }
 
 void furi_string_set_strn(FuriString* s, const char str[], size_t n) {
-    string_set_strn(s->string, str, n);
+    size_t size = 0;
+    while(size < n && str[size]) size++;
+    furi_string_splice(s, 0, s->size, str, size);
 }
 
 void furi_string_set_char(FuriString* s, size_t index, const char c) {
-    string_set_char(s->string, index, c);
+    furi_assert(index < s->size);
+    s->ptr[index] = c;
 }
 
 int furi_string_cmp(const FuriString* s1, const FuriString* s2) {
-    return string_cmp(s1->string, s2->string);
+    return strcmp(s1->ptr, s2->ptr);
 }
 
 int furi_string_cmp_str(const FuriString* s1, const char str[]) {
-    return string_cmp(s1->string, str);
+    return strcmp(s1->ptr, str);
 }
 
 int furi_string_cmpi(const FuriString* v1, const FuriString* v2) {
-    return string_cmpi(v1->string, v2->string);
+    return furi_string_cmpi_str(v1, v2->ptr);
 }
 
 int furi_string_cmpi_str(const FuriString* v1, const char p2[]) {
-    return string_cmpi_str(v1->string, p2);
+    const char* p1 = v1->ptr;
+    int c1, c2;
+    do {
+        // Go through upper case to handle locales without 1 to 1 mapping
+        c1 = tolower(toupper((unsigned char)*p1++));
+        c2 = tolower(toupper((unsigned char)*p2++));
+    } while(c1 == c2 && c1 != 0);
+    return c1 - c2;
 }
 
 size_t furi_string_search(const FuriString* v, const FuriString* needle, size_t start) {
-    return string_search(v->string, needle->string, start);
+    return furi_string_search_str(v, needle->ptr, start);
 }
 
 size_t furi_string_search_str(const FuriString* v, const char needle[], size_t start) {
-    return string_search(v->string, needle, start);
+    if(start > v->size) return FURI_STRING_FAILURE;
+    const char* p = strstr(&v->ptr[start], needle);
+    return p ? (size_t)(p - v->ptr) : FURI_STRING_FAILURE;
 }
 
 bool furi_string_equal(const FuriString* v1, const FuriString* v2) {
-    return string_equal_p(v1->string, v2->string);
+    return v1->size == v2->size && memcmp(v1->ptr, v2->ptr, v1->size) == 0;
 }
 
 bool furi_string_equal_str(const FuriString* v1, const char v2[]) {
-    return string_equal_p(v1->string, v2);
+    return strcmp(v1->ptr, v2) == 0;
 }
 
 void furi_string_push_back(FuriString* v, char c) {
-    string_push_back(v->string, c);
+    furi_string_fit(v, v->size + 2);
+    v->ptr[v->size++] = c;
+    v->ptr[v->size] = '\0';
 }
 
 size_t furi_string_size(const FuriString* s) {
-    return string_size(s->string);
+    return s->size;
+}
+
+/* Replace the tail from pos with formatted output.
+ * Format and arguments may point into the string itself, so output goes to a
+ * temporary first: on the stack when it is short, on the heap otherwise.
+ */
+static int furi_string_format_at(FuriString* v, size_t pos, const char format[], va_list args) {
+    char stack_buffer[FURI_STRING_FORMAT_STACK_SIZE];
+    char* buffer = stack_buffer;
+    va_list args_copy;
+    va_copy(args_copy, args);
+
+    int ret = vsnprintf(buffer, sizeof(stack_buffer), format, args);
+    if(ret >= (int)sizeof(stack_buffer)) {
+        buffer = malloc(ret + 1);
+        vsnprintf(buffer, ret + 1, format, args_copy);
+    }
+    va_end(args_copy);
+
+    furi_string_splice(v, pos, v->size - pos, buffer, ret > 0 ? ret : 0);
+
+    if(buffer != stack_buffer) {
+        free(buffer);
+    }
+
+    return ret;
 }
 
 int furi_string_printf(FuriString* v, const char format[], ...) {
@@ -161,7 +440,7 @@ int furi_string_printf(FuriString* v, const char format[], ...) {
 }
 
 int furi_string_vprintf(FuriString* v, const char format[], va_list args) {
-    return string_vprintf(v->string, format, args);
+    return furi_string_format_at(v, 0, format, args);
 }
 
 int furi_string_cat_printf(FuriString* v, const char format[], ...) {
@@ -173,130 +452,196 @@ int furi_string_cat_printf(FuriString* v, const char format[], ...) {
 }
 
 int furi_string_cat_vprintf(FuriString* v, const char format[], va_list args) {
-    FuriString* string = furi_string_alloc();
-    int ret = furi_string_vprintf(string, format, args);
-    furi_string_cat(v, string);
-    furi_string_free(string);
-    return ret;
+    return furi_string_format_at(v, v->size, format, args);
 }
 
 bool furi_string_empty(const FuriString* v) {
-    return string_empty_p(v->string);
+    return v->size == 0;
 }
 
 void furi_string_replace_at(FuriString* v, size_t pos, size_t len, const char str2[]) {
-    string_replace_at(v->string, pos, len, str2);
+    furi_string_splice(v, pos, len, str2, strlen(str2));
 }
 
 size_t
     furi_string_replace(FuriString* string, FuriString* needle, FuriString* replace, size_t start) {
-    return string_replace(string->string, needle->string, replace->string, start);
+    return furi_string_replace_str(string, needle->ptr, replace->ptr, start);
 }
 
 size_t furi_string_replace_str(FuriString* v, const char str1[], const char str2[], size_t start) {
-    return string_replace_str(v->string, str1, str2, start);
+    size_t i = furi_string_search_str(v, str1, start);
+    if(i != FURI_STRING_FAILURE) {
+        furi_string_splice(v, i, strlen(str1), str2, strlen(str2));
+    }
+    return i;
 }
 
 void furi_string_replace_all_str(FuriString* v, const char str1[], const char str2[]) {
-    string_replace_all_str(v->string, str1, str2);
+    size_t size_1 = strlen(str1);
+    size_t size_2 = strlen(str2);
+    if(!size_1) return;
+
+    size_t i = 0;
+    while((i = furi_string_search_str(v, str1, i)) != FURI_STRING_FAILURE) {
+        furi_string_splice(v, i, size_1, str2, size_2);
+        i += size_2;
+    }
 }
 
 void furi_string_replace_all(FuriString* v, const FuriString* str1, const FuriString* str2) {
-    string_replace_all(v->string, str1->string, str2->string);
+    furi_string_replace_all_str(v, str1->ptr, str2->ptr);
 }
 
 bool furi_string_start_with(const FuriString* v, const FuriString* v2) {
-    return string_start_with_string_p(v->string, v2->string);
+    return v->size >= v2->size && memcmp(v->ptr, v2->ptr, v2->size) == 0;
 }
 
 bool furi_string_start_with_str(const FuriString* v, const char str[]) {
-    return string_start_with_str_p(v->string, str);
+    return strncmp(v->ptr, str, strlen(str)) == 0;
 }
 
 bool furi_string_end_with(const FuriString* v, const FuriString* v2) {
-    return string_end_with_string_p(v->string, v2->string);
+    return v->size >= v2->size &&
+           memcmp(&v->ptr[v->size - v2->size], v2->ptr, v2->size) == 0;
 }
 
 bool furi_string_end_with_str(const FuriString* v, const char str[]) {
-    return string_end_with_str_p(v->string, str);
+    size_t size = strlen(str);
+    return v->size >= size && memcmp(&v->ptr[v->size - size], str, size) == 0;
 }
 
 size_t furi_string_search_char(const FuriString* v, char c, size_t start) {
-    return string_search_char(v->string, c, start);
+    if(start > v->size) return FURI_STRING_FAILURE;
+    const char* p = strchr(&v->ptr[start], c);
+    return p ? (size_t)(p - v->ptr) : FURI_STRING_FAILURE;
 }
 
 size_t furi_string_search_rchar(const FuriString* v, char c, size_t start) {
-    return string_search_rchar(v->string, c, start);
+    if(start > v->size) return FURI_STRING_FAILURE;
+    const char* p = strrchr(&v->ptr[start], c);
+    return p ? (size_t)(p - v->ptr) : FURI_STRING_FAILURE;
 }
 
 void furi_string_left(FuriString* v, size_t index) {
-    string_left(v->string, index);
+    if(index < v->size) {
+        v->size = index;
+        v->ptr[index] = '\0';
+    }
 }
 
 void furi_string_right(FuriString* v, size_t index) {
-    string_right(v->string, index);
+    if(index >= v->size) {
+        furi_string_reset(v);
+    } else {
+        v->size -= index;
+        memmove(v->ptr, &v->ptr[index], v->size + 1);
+    }
 }
 
 void furi_string_mid(FuriString* v, size_t index, size_t size) {
-    string_mid(v->string, index, size);
+    furi_string_right(v, index);
+    furi_string_left(v, size);
 }
 
 void furi_string_trim(FuriString* v, const char charac[]) {
-    string_strim(v->string, charac);
+    size_t end = v->size;
+    while(end > 0 && strchr(charac, v->ptr[end - 1])) end--;
+
+    size_t begin = 0;
+    while(begin < end && strchr(charac, v->ptr[begin])) begin++;
+
+    v->size = end - begin;
+    memmove(v->ptr, &v->ptr[begin], v->size);
+    v->ptr[v->size] = '\0';
 }
 
 void furi_string_cat(FuriString* v, const FuriString* v2) {
-    string_cat(v->string, v2->string);
+    furi_string_splice(v, v->size, 0, v2->ptr, v2->size);
 }
 
 void furi_string_cat_str(FuriString* v, const char str[]) {
-    string_cat(v->string, str);
+    furi_string_splice(v, v->size, 0, str, strlen(str));
 }
 
 void furi_string_set_n(FuriString* v, const FuriString* ref, size_t offset, size_t length) {
-    string_set_n(v->string, ref->string, offset, length);
+    furi_assert(offset <= ref->size);
+    length = MIN(length, ref->size - offset);
+    furi_string_splice(v, 0, v->size, &ref->ptr[offset], length);
 }
 
 size_t furi_string_utf8_length(FuriString* str) {
-    return string_length_u(str->string);
+    size_t size = 0;
+    FuriStringUTF8State state = FuriStringUTF8StateStarting;
+    FuriStringUnicodeValue unicode = 0;
+
+    for(size_t i = 0; i < str->size; i++) {
+        furi_string_utf8_decode(str->ptr[i], &state, &unicode);
+        if(state == FuriStringUTF8StateError) return SIZE_MAX;
+        if(state == FuriStringUTF8StateStarting) size++;
+    }
+
+    return size;
 }
 
 void furi_string_utf8_push(FuriString* str, FuriStringUnicodeValue u) {
-    string_push_u(str->string, u);
+    char buffer[4];
+    size_t size;
+
+    if(u < 0x80) {
+        buffer[0] = (char)u;
+        size = 1;
+    } else if(u < 0x800) {
+        buffer[0] = (char)(0xC0 | (u >> 6));
+        buffer[1] = (char)(0x80 | (u & 0x3F));
+        size = 2;
+    } else if(u < 0x10000) {
+        buffer[0] = (char)(0xE0 | (u >> 12));
+        buffer[1] = (char)(0x80 | ((u >> 6) & 0x3F));
+        buffer[2] = (char)(0x80 | (u & 0x3F));
+        size = 3;
+    } else {
+        buffer[0] = (char)(0xF0 | (u >> 18));
+        buffer[1] = (char)(0x80 | ((u >> 12) & 0x3F));
+        buffer[2] = (char)(0x80 | ((u >> 6) & 0x3F));
+        buffer[3] = (char)(0x80 | (u & 0x3F));
+        size = 4;
+    }
+
+    furi_string_splice(str, str->size, 0, buffer, size);
 }
 
-static m_str1ng_utf8_state_e furi_state_to_state(FuriStringUTF8State state) {
-    switch(state) {
+void furi_string_utf8_decode(char c, FuriStringUTF8State* state, FuriStringUnicodeValue* unicode) {
+    uint8_t byte = (uint8_t)c;
+
+    switch(*state) {
     case FuriStringUTF8StateStarting:
-        return M_STRING_UTF8_STARTING;
+        if(byte < 0x80) {
+            *unicode = byte;
+        } else if((byte & 0xE0) == 0xC0) {
+            *unicode = byte & 0x1F;
+            *state = FuriStringUTF8StateDecoding1;
+        } else if((byte & 0xF0) == 0xE0) {
+            *unicode = byte & 0x0F;
+            *state = FuriStringUTF8StateDecoding2;
+        } else if((byte & 0xF8) == 0xF0) {
+            *unicode = byte & 0x07;
+            *state = FuriStringUTF8StateDecoding3;
+        } else {
+            *state = FuriStringUTF8StateError;
+        }
+        break;
     case FuriStringUTF8StateDecoding1:
-        return M_STRING_UTF8_DECODING_1;
     case FuriStringUTF8StateDecoding2:
-        return M_STRING_UTF8_DECODING_2;
     case FuriStringUTF8StateDecoding3:
-        return M_STRING_UTF8_DOCODING_3;
+        if((byte & 0xC0) == 0x80) {
+            *unicode = (*unicode << 6) | (byte & 0x3F);
+            *state = *state - 1;
+        } else {
+            *state = FuriStringUTF8StateError;
+        }
+        break;
     default:
-        return M_STRING_UTF8_ERROR;
+        *state = FuriStringUTF8StateError;
+        break;
     }
 }
-
-static FuriStringUTF8State state_to_furi_state(m_str1ng_utf8_state_e state) {
-    switch(state) {
-    case M_STRING_UTF8_STARTING:
-        return FuriStringUTF8StateStarting;
-    case M_STRING_UTF8_DECODING_1:
-        return FuriStringUTF8StateDecoding1;
-    case M_STRING_UTF8_DECODING_2:
-        return FuriStringUTF8StateDecoding2;
-    case M_STRING_UTF8_DOCODING_3:
-        return FuriStringUTF8StateDecoding3;
-    default:
-        return FuriStringUTF8StateError;
-    }
-}
-
-void furi_string_utf8_decode(char c, FuriStringUTF8State* state, FuriStringUnicodeValue* unicode) {
-    m_str1ng_utf8_state_e m_state = furi_state_to_state(*state);
-    m_str1ng_utf8_decode(c, &m_state, unicode);
-    *state = state_to_furi_state(m_state);
-}
@@ -87,6 +87,47 @@ FuriString* furi_string_alloc_move(FuriString* source);
  */
 void furi_string_free(FuriString* string);
 
+//---------------------------------------------------------------------------
+//                                  Arena
+//---------------------------------------------------------------------------
+
+/**
+ * @brief Furi string arena.
+ * Bump allocator for short lived strings, e.g. temporaries of a parsing loop.
+ * Strings and their buffers are carved from arena blocks and released all at once
+ * by furi_string_arena_reset or furi_string_arena_free.
+ */
+typedef struct FuriStringArena FuriStringArena;
+
+/**
+ * @brief Allocate new FuriStringArena.
+ * @param size block size in bytes, bigger requests get a dedicated block
+ * @return FuriStringArena* 
+ */
+FuriStringArena* furi_string_arena_alloc(size_t size);
+
+/**
+ * @brief Free FuriStringArena and all strings allocated from it.
+ * @param arena 
+ */
+void furi_string_arena_free(FuriStringArena* arena);
+
+/**
+ * @brief Release all strings allocated from arena at once.
+ * Strings allocated from arena must not be used after this call.
+ * @param arena 
+ */
+void furi_string_arena_reset(FuriStringArena* arena);
+
+/**
+ * @brief Allocate new FuriString in arena.
+ * String is fully functional, its buffer grows inside the arena.
+ * furi_string_free on it is allowed and does nothing.
+ * @param arena 
+ * @return FuriString* 
+ */
+FuriString* furi_string_arena_alloc_string(FuriStringArena* arena);
+
 //---------------------------------------------------------------------------
 //                         String memory management
 //---------------------------------------------------------------------------
@@ -554,6 +595,24 @@ typedef enum {
  */
 void furi_string_utf8_decode(char c, FuriStringUTF8State* state, FuriStringUnicodeValue* unicode);
 
+//---------------------------------------------------------------------------
+//                               Statistics
+//---------------------------------------------------------------------------
+
+/**
+ * @brief Furi string allocation counters, cumulative since boot.
+ */
+typedef struct {
+    uint32_t heap_allocs; /**< heap allocations and reallocations, headers included */
+    uint32_t arena_allocs; /**< allocations served by arenas */
+} FuriStringStats;
+
+/**
+ * @brief Get allocation counters.
+ * @param stats 
+ */
+void furi_string_get_stats(FuriStringStats* stats);
+
 //---------------------------------------------------------------------------
 //                Lasciate ogne speranza, voi ch’entrate
 //---------------------------------------------------------------------------
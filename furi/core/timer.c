@@ -2,125 +2,476 @@
 #include "check.h"
 #include "memmgr.h"
 #include "kernel.h"
+#include "mutex.h"
+#include "thread.h"
+#include "common_defines.h"
 
 #include <FreeRTOS.h>
-#include <timers.h>
+#include <task.h>
+#include <string.h>
 
-typedef struct {
+/* Hierarchical timer wheel.
+ * Slot of level N spans 32^N ticks, timer is kept on the lowest level which
+ * covers its expiration and cascades down while wheel time advances.
+ * Single service task sleeps till the earliest expiration and serves every
+ * expired timer at once, so with tickless idle CPU wakes once per batch. */
+
+#define TIMER_WHEEL_LEVELS (4)
+#define TIMER_WHEEL_SLOT_BITS (5)
+#define TIMER_WHEEL_SLOTS (1U << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+#define TIMER_WHEEL_TASK_NAME "TimerWheel"
+#define TIMER_WHEEL_FLAG_UPDATE (1UL << 0)
+#define TIMER_WHEEL_NEVER (UINT64_MAX)
+
+#define TIMER_STATS_OTHER "other"
+
+typedef enum {
+    TimerPlaceNone,
+    TimerPlaceWheel,
+    TimerPlacePending,
+} TimerPlace;
+
+typedef struct TimerInstance TimerInstance;
+
+struct TimerInstance {
+    TimerInstance* prev;
+    TimerInstance* next;
     FuriTimerCallback func;
     void* context;
-} TimerCallback_t;
+    FuriTimerType type;
+    TimerPlace place;
+    uint8_t level;
+    uint8_t slot;
+    uint8_t subsystem;
+    uint32_t period;
+    uint32_t slack;
+    uint64_t deadline;
+    uint64_t expire;
+};
 
-static void TimerCallback(TimerHandle_t hTimer) {
-    TimerCallback_t* callb;
+typedef struct {
+    FuriTimerSubsystemStats stats;
+    uint32_t batch;
+} TimerSubsystem;
 
-    /* Retrieve pointer to callback function and context */
-    callb = (TimerCallback_t*)pvTimerGetTimerID(hTimer);
+typedef struct {
+    FuriMutex* mutex;
+    TaskHandle_t task;
+
+    TimerInstance* slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint32_t occupied[TIMER_WHEEL_LEVELS];
+    TimerInstance* pending;
+    TimerInstance* current;
+
+    uint64_t time;
+    uint64_t clock;
+    uint32_t last_tick;
+    uint64_t sleep_until;
+
+    uint32_t batch;
+    uint32_t stats_tick;
+    uint32_t stats_wakeups;
+    size_t subsystems_count;
+    TimerSubsystem subsystems[FURI_TIMER_STATS_SUBSYSTEMS_MAX];
+} TimerWheel;
+
+static TimerWheel timer_wheel;
+
+/* Monotonic 64 bit tick, immune to kernel tick wrap */
+static uint64_t timer_wheel_now() {
+    uint32_t tick = xTaskGetTickCount();
+    timer_wheel.clock += (uint32_t)(tick - timer_wheel.last_tick);
+    timer_wheel.last_tick = tick;
+    return timer_wheel.clock;
+}
 
-    /* Remove dynamic allocation flag */
-    callb = (TimerCallback_t*)((uint32_t)callb & ~1U);
+/* Latest tick within [deadline, deadline + slack] with most trailing zeros,
+ * timers with overlapping windows end up on the same tick */
+static uint64_t timer_wheel_align(uint64_t deadline, uint32_t slack) {
+    if(!slack) return deadline;
+    uint64_t latest = deadline + slack;
+    uint64_t mask = UINT64_MAX >> __builtin_clzll(deadline ^ latest);
+    return latest & ~(mask >> 1);
+}
 
-    if(callb != NULL) {
-        callb->func(callb->context);
+static TimerInstance** timer_wheel_get_list(TimerInstance* timer) {
+    if(timer->place == TimerPlaceWheel) {
+        return &timer_wheel.slots[timer->level][timer->slot];
+    } else {
+        return &timer_wheel.pending;
     }
 }
 
-FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
-    furi_assert((furi_kernel_is_irq_or_masked() == 0U) && (func != NULL));
+static void timer_wheel_push(TimerInstance** list, TimerInstance* timer) {
+    timer->prev = NULL;
+    timer->next = *list;
+    if(*list) (*list)->prev = timer;
+    *list = timer;
+}
 
-    TimerHandle_t hTimer;
-    TimerCallback_t* callb;
-    UBaseType_t reload;
+static void timer_wheel_unlink(TimerInstance* timer) {
+    if(timer->place == TimerPlaceNone) return;
 
-    hTimer = NULL;
+    TimerInstance** list = timer_wheel_get_list(timer);
+    if(timer->prev) {
+        timer->prev->next = timer->next;
+    } else {
+        *list = timer->next;
+    }
+    if(timer->next) timer->next->prev = timer->prev;
 
-    /* Dynamic memory allocation is available: if memory for callback and */
-    /* its context is not provided, allocate it from dynamic memory pool */
-    callb = (TimerCallback_t*)malloc(sizeof(TimerCallback_t));
+    if((timer->place == TimerPlaceWheel) && !*list) {
+        timer_wheel.occupied[timer->level] &= ~(1UL << timer->slot);
+    }
+    timer->place = TimerPlaceNone;
+}
 
-    callb->func = func;
-    callb->context = context;
+static void timer_wheel_insert(TimerInstance* timer) {
+    uint64_t expire = MAX(timer->expire, timer_wheel.time);
+    uint64_t slot_time = 0;
+    uint8_t level;
 
-    if(type == FuriTimerTypeOnce) {
-        reload = pdFALSE;
-    } else {
-        reload = pdTRUE;
+    for(level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        uint8_t shift = level * TIMER_WHEEL_SLOT_BITS;
+        slot_time = expire >> shift;
+        if(slot_time - (timer_wheel.time >> shift) < TIMER_WHEEL_SLOTS) break;
     }
 
-    /* Store callback memory dynamic allocation flag */
-    callb = (TimerCallback_t*)((uint32_t)callb | 1U);
-    // TimerCallback function is always provided as a callback and is used to call application
-    // specified function with its context both stored in structure callb.
-    hTimer = xTimerCreate(NULL, 1, reload, callb, TimerCallback);
-    furi_check(hTimer);
+    if(level == TIMER_WHEEL_LEVELS) {
+        // Beyond wheel range: park in the farthest top slot and cascade again from there
+        level = TIMER_WHEEL_LEVELS - 1;
+        slot_time = (timer_wheel.time >> (level * TIMER_WHEEL_SLOT_BITS)) + TIMER_WHEEL_SLOTS - 1;
+    }
 
-    /* Return timer ID */
-    return ((FuriTimer*)hTimer);
+    timer->level = level;
+    timer->slot = slot_time & TIMER_WHEEL_SLOT_MASK;
+    timer->place = TimerPlaceWheel;
+    timer_wheel_push(&timer_wheel.slots[level][timer->slot], timer);
+    timer_wheel.occupied[level] |= 1UL << timer->slot;
 }
 
-void furi_timer_free(FuriTimer* instance) {
-    furi_assert(!furi_kernel_is_irq_or_masked());
-    furi_assert(instance);
+static uint8_t timer_wheel_first_slot(uint8_t level, uint8_t* distance) {
+    uint32_t occupied = timer_wheel.occupied[level];
+    uint8_t index = (timer_wheel.time >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+    uint32_t rotated = (occupied >> index) | (occupied << ((TIMER_WHEEL_SLOTS - index) & 31));
+    *distance = __builtin_ctz(rotated);
+    return (index + *distance) & TIMER_WHEEL_SLOT_MASK;
+}
+
+/* Earliest wheel time when some slot must be cascaded or fired */
+static uint64_t timer_wheel_next_slot_time() {
+    uint64_t next = TIMER_WHEEL_NEVER;
+    for(uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if(!timer_wheel.occupied[level]) continue;
+        uint8_t shift = level * TIMER_WHEEL_SLOT_BITS;
+        uint8_t distance;
+        timer_wheel_first_slot(level, &distance);
+        next = MIN(next, ((timer_wheel.time >> shift) + distance) << shift);
+    }
+    return next;
+}
+
+/* Earliest actual expiration, cascade points are not worth a wakeup.
+ * Every occupied slot is scanned: timers parked beyond the wheel range share
+ * the top level with nearer ones, so there slot order is not expiration order. */
+static uint64_t timer_wheel_next_expire() {
+    uint64_t next = TIMER_WHEEL_NEVER;
+    for(uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        uint32_t occupied = timer_wheel.occupied[level];
+        while(occupied) {
+            uint8_t slot = __builtin_ctz(occupied);
+            occupied &= occupied - 1;
+            for(TimerInstance* timer = timer_wheel.slots[level][slot]; timer;
+                timer = timer->next) {
+                next = MIN(next, timer->expire);
+            }
+        }
+    }
+    return next;
+}
+
+static void timer_wheel_process(uint64_t time) {
+    timer_wheel.time = time;
+
+    for(uint8_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+        uint8_t slot = (time >> (level * TIMER_WHEEL_SLOT_BITS)) & TIMER_WHEEL_SLOT_MASK;
+        TimerInstance* timer = timer_wheel.slots[level][slot];
+        timer_wheel.slots[level][slot] = NULL;
+        timer_wheel.occupied[level] &= ~(1UL << slot);
+
+        while(timer) {
+            TimerInstance* next = timer->next;
+            timer_wheel_insert(timer);
+            timer = next;
+        }
+    }
+
+    uint8_t slot = time & TIMER_WHEEL_SLOT_MASK;
+    TimerInstance* timer = timer_wheel.slots[0][slot];
+    timer_wheel.slots[0][slot] = NULL;
+    timer_wheel.occupied[0] &= ~(1UL << slot);
+
+    while(timer) {
+        TimerInstance* next = timer->next;
+        timer->place = TimerPlacePending;
+        timer_wheel_push(&timer_wheel.pending, timer);
+        timer = next;
+    }
+}
+
+static void timer_wheel_account(TimerInstance* timer) {
+    TimerSubsystem* subsystem = &timer_wheel.subsystems[timer->subsystem];
+    subsystem->stats.expirations++;
+    if(subsystem->batch != timer_wheel.batch) {
+        subsystem->batch = timer_wheel.batch;
+        subsystem->stats.wakeups++;
+    }
+}
+
+static void timer_wheel_task(void* context) {
+    UNUSED(context);
+
+    for(;;) {
+        furi_check(furi_mutex_acquire(timer_wheel.mutex, FuriWaitForever) == FuriStatusOk);
+        // Awake: wheel is rescanned before sleep, no need to notify
+        timer_wheel.sleep_until = 0;
+
+        uint64_t now = timer_wheel_now();
+        uint64_t next;
+        while((next = timer_wheel_next_slot_time()) <= now) {
+            timer_wheel_process(next);
+        }
+        timer_wheel.time = now;
+
+        if(timer_wheel.pending) {
+            timer_wheel.batch++;
+            timer_wheel.stats_wakeups++;
+        }
+
+        while(timer_wheel.pending) {
+            TimerInstance* timer = timer_wheel.pending;
+            timer_wheel_unlink(timer);
+
+            // Rearm before callback, so callback is free to stop or restart timer
+            if(timer->type == FuriTimerTypePeriodic) {
+                timer->deadline += timer->period;
+                if(timer->deadline <= now) timer->deadline = now + timer->period;
+                timer->expire = timer_wheel_align(timer->deadline, timer->slack);
+                timer_wheel_insert(timer);
+            }
+
+            timer_wheel_account(timer);
+            timer_wheel.current = timer;
+            FuriTimerCallback func = timer->func;
+            void* func_context = timer->context;
+            furi_mutex_release(timer_wheel.mutex);
+
+            func(func_context);
+
+            furi_check(furi_mutex_acquire(timer_wheel.mutex, FuriWaitForever) == FuriStatusOk);
+            timer_wheel.current = NULL;
+        }
+
+        uint32_t timeout = FuriWaitForever;
+        next = timer_wheel_next_expire();
+        if(next != TIMER_WHEEL_NEVER) {
+            now = timer_wheel_now();
+            timeout = (next > now) ? MIN(next - now, (uint64_t)FuriWaitForever - 1) : 0;
+        }
+        timer_wheel.sleep_until = next;
+        furi_mutex_release(timer_wheel.mutex);
+
+        furi_thread_flags_wait(TIMER_WHEEL_FLAG_UPDATE, FuriFlagWaitAny, timeout);
+    }
+}
 
-    TimerHandle_t hTimer = (TimerHandle_t)instance;
-    TimerCallback_t* callb;
+static void timer_wheel_lock() {
+    furi_check(furi_mutex_acquire(timer_wheel.mutex, FuriWaitForever) == FuriStatusOk);
+}
+
+static void timer_wheel_unlock() {
+    furi_check(furi_mutex_release(timer_wheel.mutex) == FuriStatusOk);
+}
+
+static bool timer_wheel_is_service_task() {
+    return (xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) &&
+           (xTaskGetCurrentTaskHandle() == timer_wheel.task);
+}
+
+static uint8_t timer_wheel_get_subsystem() {
+    const char* name = NULL;
+    if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED) {
+        name = furi_thread_get_name(furi_thread_get_current_id());
+    }
+    if(!name) return 0;
 
-    callb = (TimerCallback_t*)pvTimerGetTimerID(hTimer);
+    for(size_t i = 1; i < timer_wheel.subsystems_count; i++) {
+        if(!strncmp(
+               timer_wheel.subsystems[i].stats.name, name, FURI_TIMER_STATS_NAME_SIZE - 1)) {
+            return i;
+        }
+    }
 
-    furi_check(xTimerDelete(hTimer, portMAX_DELAY) == pdPASS);
+    if(timer_wheel.subsystems_count == FURI_TIMER_STATS_SUBSYSTEMS_MAX) return 0;
 
-    while(furi_timer_is_running(instance)) furi_delay_tick(2);
+    FuriTimerSubsystemStats* stats = &timer_wheel.subsystems[timer_wheel.subsystems_count].stats;
+    strncpy(stats->name, name, FURI_TIMER_STATS_NAME_SIZE - 1);
+    return timer_wheel.subsystems_count++;
+}
 
-    if((uint32_t)callb & 1U) {
-        /* Callback memory was allocated from dynamic pool, clear flag */
-        callb = (TimerCallback_t*)((uint32_t)callb & ~1U);
+void furi_timer_init() {
+    furi_assert(!timer_wheel.mutex);
+
+    timer_wheel.mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    timer_wheel.sleep_until = TIMER_WHEEL_NEVER;
+    strcpy(timer_wheel.subsystems[0].stats.name, TIMER_STATS_OTHER);
+    timer_wheel.subsystems_count = 1;
+
+    // Same stack and priority as kernel timer task had for FuriTimer callbacks
+    BaseType_t ret = xTaskCreate(
+        timer_wheel_task,
+        TIMER_WHEEL_TASK_NAME,
+        configTIMER_TASK_STACK_DEPTH,
+        NULL,
+        configTIMER_TASK_PRIORITY,
+        &timer_wheel.task);
+    furi_check(ret == pdPASS);
+}
 
-        /* Return allocated memory to dynamic pool */
-        free(callb);
+FuriTimer* furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void* context) {
+    furi_assert((furi_kernel_is_irq_or_masked() == 0U) && (func != NULL));
+    furi_assert(timer_wheel.mutex);
+
+    TimerInstance* timer = malloc(sizeof(TimerInstance));
+    timer->func = func;
+    timer->context = context;
+    timer->type = type;
+    timer->place = TimerPlaceNone;
+
+    timer_wheel_lock();
+    timer->subsystem = timer_wheel_get_subsystem();
+    timer_wheel_unlock();
+
+    return (FuriTimer*)timer;
+}
+
+void furi_timer_free(FuriTimer* instance) {
+    furi_assert(!furi_kernel_is_irq_or_masked());
+    furi_assert(instance);
+
+    TimerInstance* timer = instance;
+
+    timer_wheel_lock();
+    timer_wheel_unlink(timer);
+    // Wait for callback in progress, unless timer is freed from its own callback
+    while((timer_wheel.current == timer) && !timer_wheel_is_service_task()) {
+        timer_wheel_unlock();
+        furi_delay_tick(1);
+        timer_wheel_lock();
     }
+    timer_wheel_unlock();
+
+    free(timer);
 }
 
 FuriStatus furi_timer_start(FuriTimer* instance, uint32_t ticks) {
     furi_assert(!furi_kernel_is_irq_or_masked());
     furi_assert(instance);
+    furi_assert(ticks);
 
-    TimerHandle_t hTimer = (TimerHandle_t)instance;
-    FuriStatus stat;
+    TimerInstance* timer = instance;
 
-    if(xTimerChangePeriod(hTimer, ticks, portMAX_DELAY) == pdPASS) {
-        stat = FuriStatusOk;
-    } else {
-        stat = FuriStatusErrorResource;
+    timer_wheel_lock();
+    timer_wheel_unlink(timer);
+
+    timer->period = MAX(ticks, 1UL);
+    timer->deadline = timer_wheel_now() + timer->period;
+    timer->expire = timer_wheel_align(timer->deadline, timer->slack);
+    timer_wheel_insert(timer);
+
+    if(timer->expire < timer_wheel.sleep_until) {
+        timer_wheel.sleep_until = timer->expire;
+        furi_thread_flags_set(timer_wheel.task, TIMER_WHEEL_FLAG_UPDATE);
     }
+    timer_wheel_unlock();
 
-    /* Return execution status */
-    return (stat);
+    return FuriStatusOk;
 }
 
 FuriStatus furi_timer_stop(FuriTimer* instance) {
     furi_assert(!furi_kernel_is_irq_or_masked());
     furi_assert(instance);
 
-    TimerHandle_t hTimer = (TimerHandle_t)instance;
-    FuriStatus stat;
+    TimerInstance* timer = instance;
+    FuriStatus stat = FuriStatusOk;
 
-    if(xTimerIsTimerActive(hTimer) == pdFALSE) {
+    timer_wheel_lock();
+    if(timer->place == TimerPlaceNone) {
         stat = FuriStatusErrorResource;
     } else {
-        furi_check(xTimerStop(hTimer, portMAX_DELAY) == pdPASS);
-        stat = FuriStatusOk;
+        // Service task may wake up for nothing once, not worth a notification
+        timer_wheel_unlink(timer);
     }
+    timer_wheel_unlock();
 
-    /* Return execution status */
-    return (stat);
+    return stat;
 }
 
 uint32_t furi_timer_is_running(FuriTimer* instance) {
     furi_assert(!furi_kernel_is_irq_or_masked());
     furi_assert(instance);
 
-    TimerHandle_t hTimer = (TimerHandle_t)instance;
+    TimerInstance* timer = instance;
 
     /* Return 0: not running, 1: running */
-    return (uint32_t)xTimerIsTimerActive(hTimer);
+    return (timer->place != TimerPlaceNone);
+}
+
+void furi_timer_set_slack(FuriTimer* instance, uint32_t slack) {
+    furi_assert(instance);
+
+    TimerInstance* timer = instance;
+
+    timer_wheel_lock();
+    timer->slack = slack;
+    timer_wheel_unlock();
+}
+
+uint32_t furi_timer_get_expire_time(FuriTimer* instance) {
+    furi_assert(instance);
+
+    TimerInstance* timer = instance;
+
+    timer_wheel_lock();
+    uint64_t now = timer_wheel_now();
+    uint32_t expire_time = timer_wheel.last_tick + (uint32_t)(timer->expire - now);
+    timer_wheel_unlock();
+
+    return expire_time;
+}
+
+void furi_timer_get_stats(FuriTimerStats* stats) {
+    furi_assert(stats);
+
+    timer_wheel_lock();
+    stats->ticks = xTaskGetTickCount() - timer_wheel.stats_tick;
+    stats->wakeups = timer_wheel.stats_wakeups;
+    stats->subsystems_count = timer_wheel.subsystems_count;
+    for(size_t i = 0; i < timer_wheel.subsystems_count; i++) {
+        stats->subsystems[i] = timer_wheel.subsystems[i].stats;
+    }
+    timer_wheel_unlock();
+}
+
+void furi_timer_reset_stats() {
+    timer_wheel_lock();
+    timer_wheel.stats_tick = xTaskGetTickCount();
+    timer_wheel.stats_wakeups = 0;
+    for(size_t i = 0; i < timer_wheel.subsystems_count; i++) {
+        timer_wheel.subsystems[i].stats.wakeups = 0;
+        timer_wheel.subsystems[i].stats.expirations = 0;
+    }
+    timer_wheel_unlock();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core/base.h"
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -56,6 +57,56 @@ FuriStatus furi_timer_stop(FuriTimer* instance);
  */
 uint32_t furi_timer_is_running(FuriTimer* instance);
 
+/** Set expiration tolerance
+ *
+ * Timer is allowed to fire up to slack ticks late. Timers with overlapping
+ * tolerance windows are aligned to the same tick and served in one wakeup.
+ * Takes effect on next start or period.
+ *
+ * @param      instance  The pointer to FuriTimer instance
+ * @param[in]  slack     The tolerance in ticks, 0 for exact expiration
+ */
+void furi_timer_set_slack(FuriTimer* instance, uint32_t slack);
+
+/** Get timer expiration tick
+ *
+ * @param      instance  The pointer to FuriTimer instance
+ *
+ * @return     expiration tick, meaningful only if timer is running
+ */
+uint32_t furi_timer_get_expire_time(FuriTimer* instance);
+
+#define FURI_TIMER_STATS_SUBSYSTEMS_MAX (16)
+#define FURI_TIMER_STATS_NAME_SIZE (16)
+
+typedef struct {
+    char name[FURI_TIMER_STATS_NAME_SIZE]; ///< Name of thread that allocated timers
+    uint32_t wakeups; ///< Wakeups with at least one timer of subsystem expired
+    uint32_t expirations; ///< Expired timers of subsystem
+} FuriTimerSubsystemStats;
+
+typedef struct {
+    uint32_t ticks; ///< Ticks since statistics reset
+    uint32_t wakeups; ///< Timer service wakeups with expired timers
+    size_t subsystems_count;
+    FuriTimerSubsystemStats subsystems[FURI_TIMER_STATS_SUBSYSTEMS_MAX];
+} FuriTimerStats;
+
+/** Get timer service statistics since last reset
+ *
+ * Timers are attributed to subsystem by the name of allocating thread,
+ * first entry collects timers of unnamed and excess subsystems.
+ *
+ * @param      stats  The pointer to FuriTimerStats to fill
+ */
+void furi_timer_get_stats(FuriTimerStats* stats);
+
+/** Reset timer service statistics */
+void furi_timer_reset_stats();
+
+/** Init timer service, called once by furi_init */
+void furi_timer_init();
+
 #ifdef __cplusplus
 }
 #endif
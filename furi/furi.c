@@ -8,6 +8,7 @@ void furi_init() {
 
     furi_log_init();
     furi_record_init();
+    furi_timer_init();
 }
 
 void furi_run() {
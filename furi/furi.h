@@ -14,6 +14,7 @@
 #include "core/pubsub.h"
 #include "core/record.h"
 #include "core/semaphore.h"
+#include "core/spsc_ring.h"
 #include "core/thread.h"
 #include "core/timer.h"
 #include "core/string.h"
@@ -377,6 +377,18 @@ bool flipper_format_read_hex(
         flipper_format->strict_mode);
 }
 
+bool flipper_format_read_hex_array_masked(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint8_t* data,
+    uint8_t* mask,
+    const uint16_t data_size) {
+    furi_assert(flipper_format);
+    furi_assert(mask);
+    return flipper_format_stream_read_hex_masked(
+        flipper_format->stream, key, data, mask, data_size, flipper_format->strict_mode);
+}
+
 bool flipper_format_write_hex(
     FlipperFormat* flipper_format,
     const char* key,
@@ -458,6 +458,22 @@ bool flipper_format_read_hex(
     uint8_t* data,
     const uint16_t data_size);
 
+/**
+ * Read array of hex-formatted bytes by key, "??" values are accepted as unknown
+ * @param flipper_format Pointer to a FlipperFormat instance
+ * @param key Key
+ * @param data Value, unknown bytes are set to 0
+ * @param mask Bit per value, set if value is known, (data_size + 7) / 8 bytes
+ * @param data_size Values count
+ * @return True on success
+ */
+bool flipper_format_read_hex_array_masked(
+    FlipperFormat* flipper_format,
+    const char* key,
+    uint8_t* data,
+    uint8_t* mask,
+    const uint16_t data_size);
+
 /**
  * Write key and array of hex-formatted bytes
  * @param flipper_format Pointer to a FlipperFormat instance
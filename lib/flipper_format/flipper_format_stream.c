@@ -342,6 +342,11 @@ bool flipper_format_stream_read_value_line(
     void* _data,
     size_t data_size,
     bool strict_mode) {
+    if(type == FlipperStreamValueHex) {
+        return flipper_format_stream_read_hex_masked(
+            stream, key, _data, NULL, data_size, strict_mode);
+    }
+
     bool result = false;
 
     do {
@@ -365,18 +370,6 @@ bool flipper_format_stream_read_value_line(
                     int scan_values = 0;
 
                     switch(type) {
-                    case FlipperStreamValueHex: {
-                        uint8_t* data = _data;
-                        if(furi_string_size(value) >= 2) {
-                            // sscanf "%02X" does not work here
-                            if(hex_char_to_uint8(
-                                   furi_string_get_char(value, 0),
-                                   furi_string_get_char(value, 1),
-                                   &data[i])) {
-                                scan_values = 1;
-                            }
-                        }
-                    }; break;
 #ifndef FLIPPER_STREAM_LITE
                     case FlipperStreamValueFloat: {
                         float* data = _data;
@@ -436,6 +429,90 @@ bool flipper_format_stream_read_value_line(
     return result;
 }
 
+bool flipper_format_stream_read_hex_masked(
+    Stream* stream,
+    const char* key,
+    uint8_t* data,
+    uint8_t* mask,
+    size_t data_size,
+    bool strict_mode) {
+    if(!flipper_format_stream_seek_to_key(stream, key, strict_mode)) return false;
+    if(!data_size) return true;
+
+    // Values are decoded in place while scanning the line, no intermediate strings
+    const size_t buffer_size = 64;
+    uint8_t buffer[buffer_size];
+    size_t index = 0;
+    size_t token_size = 0;
+    char hi = 0;
+    bool result = false;
+    bool error = false;
+
+    while(true) {
+        size_t was_read = stream_read(stream, buffer, buffer_size);
+
+        if(was_read == 0) {
+            if(token_size >= 2) index++;
+            result = (index == data_size) && stream_eof(stream);
+            break;
+        }
+
+        size_t i = 0;
+        for(; i < was_read; i++) {
+            const char c = buffer[i];
+
+            if(flipper_format_stream_is_space(c) || c == flipper_format_eoln) {
+                if(token_size == 1) {
+                    error = true;
+                } else if(token_size >= 2) {
+                    index++;
+                }
+                token_size = 0;
+
+                if(!error && index == data_size) {
+                    result = true;
+                } else if(c == flipper_format_eoln) {
+                    error = true;
+                }
+
+                if(result || error) break;
+            } else if(token_size == 0) {
+                hi = c;
+                token_size++;
+            } else if(token_size == 1) {
+                uint8_t byte = 0;
+                bool known = true;
+                if(hi == '?' && c == '?' && mask) {
+                    known = false;
+                } else if(!hex_char_to_uint8(hi, c, &byte)) {
+                    error = true;
+                    break;
+                }
+                data[index] = byte;
+                if(mask) {
+                    if(known) {
+                        mask[index / 8] |= 1 << (index % 8);
+                    } else {
+                        mask[index / 8] &= ~(1 << (index % 8));
+                    }
+                }
+                token_size++;
+            }
+            // Characters past the first two are ignored, as in generic value reader
+        }
+
+        if(result || error) {
+            // Leave stream at the terminating character, next key search starts from it
+            if(!stream_seek(stream, i - was_read, StreamOffsetFromCurrent)) {
+                result = false;
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
 bool flipper_format_stream_get_value_count(
     Stream* stream,
     const char* key,
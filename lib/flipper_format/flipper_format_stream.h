@@ -53,6 +53,26 @@ bool flipper_format_stream_read_value_line(
     size_t data_size,
     bool strict_mode);
 
+/**
+ * Read array of hex-formatted bytes by key from a stream.
+ * Values are decoded while scanning the line, "??" marks unknown byte.
+ * @param stream 
+ * @param key 
+ * @param data decoded bytes, unknown bytes are set to 0
+ * @param mask bit per byte, set for known bytes. NULL if "??" is not allowed
+ * @param data_size 
+ * @param strict_mode 
+ * @return true 
+ * @return false 
+ */
+bool flipper_format_stream_read_hex_masked(
+    Stream* stream,
+    const char* key,
+    uint8_t* data,
+    uint8_t* mask,
+    size_t data_size,
+    bool strict_mode);
+
 /**
  * Get the count of values by key from a stream.
  * @param stream 
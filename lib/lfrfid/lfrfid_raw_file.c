@@ -23,6 +23,11 @@ struct LFRFIDRawFile {
     uint8_t* buffer;
     uint32_t buffer_size;
     size_t buffer_counter;
+
+    // Size prefixes must live until the asynchronous write is done
+    size_t record_sizes[STORAGE_ASYNC_DEPTH];
+    size_t record_index;
+    volatile bool record_error;
 };
 
 LFRFIDRawFile* lfrfid_raw_file_alloc(Storage* storage) {
@@ -73,6 +78,52 @@ bool lfrfid_raw_file_write_buffer(LFRFIDRawFile* file, uint8_t* buffer_data, siz
     return true;
 }
 
+static void lfrfid_raw_file_write_size_callback(
+    File* storage_file,
+    uint16_t bytes,
+    FS_Error error,
+    void* context) {
+    UNUSED(storage_file);
+    LFRFIDRawFile* file = context;
+    if(error != FSE_OK || bytes != sizeof(size_t)) {
+        file->record_error = true;
+    }
+}
+
+bool lfrfid_raw_file_write_buffer_async(
+    LFRFIDRawFile* file,
+    uint8_t* buffer_data,
+    size_t buffer_size,
+    StorageAsyncCallback callback,
+    void* context) {
+    furi_assert(callback);
+    if(file->record_error) return false;
+
+    File* storage_file = file_stream_get_file(file->stream);
+    size_t* record_size = &file->record_sizes[file->record_index];
+    file->record_index = (file->record_index + 1) % STORAGE_ASYNC_DEPTH;
+    *record_size = buffer_size;
+
+    // Requests are processed in order, so synchronous writes are used when the queue is full
+    if(!storage_file_write_async(
+           storage_file,
+           record_size,
+           sizeof(size_t),
+           lfrfid_raw_file_write_size_callback,
+           file)) {
+        if(storage_file_write(storage_file, record_size, sizeof(size_t)) != sizeof(size_t)) {
+            return false;
+        }
+    }
+
+    if(!storage_file_write_async(storage_file, buffer_data, buffer_size, callback, context)) {
+        uint16_t size = storage_file_write(storage_file, buffer_data, buffer_size);
+        callback(storage_file, size, storage_file_get_error(storage_file), context);
+    }
+
+    return true;
+}
+
 bool lfrfid_raw_file_read_header(LFRFIDRawFile* file, float* frequency, float* duty_cycle) {
     LFRFIDRawFileHeader header;
     size_t size = stream_read(file->stream, (uint8_t*)&header, sizeof(LFRFIDRawFileHeader));
@@ -65,6 +65,27 @@ bool lfrfid_raw_file_write_header(
  */
 bool lfrfid_raw_file_write_buffer(LFRFIDRawFile* file, uint8_t* buffer_data, size_t buffer_size);
 
+/**
+ * @brief Write data to RAW file without waiting for the storage
+ * 
+ * Data must stay valid until the callback is called. The callback is called from
+ * the storage thread, or from the caller if the storage queue is full.
+ * Closing or freeing the file waits for all queued writes.
+ * 
+ * @param file 
+ * @param buffer_data 
+ * @param buffer_size 
+ * @param callback completion callback, called once if true is returned
+ * @param context callback context
+ * @return bool false if data is not written because of the previous error
+ */
+bool lfrfid_raw_file_write_buffer_async(
+    LFRFIDRawFile* file,
+    uint8_t* buffer_data,
+    size_t buffer_size,
+    StorageAsyncCallback callback,
+    void* context);
+
 /**
  * @brief Read RAW file header
  * 
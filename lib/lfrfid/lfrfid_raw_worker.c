@@ -35,6 +35,12 @@ typedef enum {
 typedef struct {
     BufferStream* stream;
     VarintPair* pair;
+
+    // Buffers being written, asynchronous writes complete in order
+    Buffer* pending[READ_DATA_BUFFER_COUNT];
+    size_t pending_next;
+    size_t pending_done;
+    volatile bool write_error;
 } LFRFIDRawWorkerReadData;
 
 // main worker
@@ -130,6 +136,22 @@ static void lfrfid_raw_worker_capture(bool level, uint32_t duration, void* conte
     }
 }
 
+static void lfrfid_raw_worker_write_callback(
+    File* file,
+    uint16_t bytes,
+    FS_Error error,
+    void* context) {
+    UNUSED(file);
+    LFRFIDRawWorkerReadData* data = context;
+    // Buffer is returned to the pool only after the storage is done with it
+    Buffer* buffer = data->pending[data->pending_done];
+    data->pending_done = (data->pending_done + 1) % READ_DATA_BUFFER_COUNT;
+    if(error != FSE_OK || bytes != buffer_get_size(buffer)) {
+        data->write_error = true;
+    }
+    buffer_reset(buffer);
+}
+
 static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
     LFRFIDRawWorker* worker = (LFRFIDRawWorker*)thread_context;
 
@@ -165,12 +187,18 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
             Buffer* buffer = buffer_stream_receive(data->stream, 100);
 
             if(buffer != NULL) {
-                file_valid = lfrfid_raw_file_write_buffer(
-                    file, buffer_get_data(buffer), buffer_get_size(buffer));
-                buffer_reset(buffer);
+                data->pending[data->pending_next] = buffer;
+                data->pending_next = (data->pending_next + 1) % READ_DATA_BUFFER_COUNT;
+                file_valid = lfrfid_raw_file_write_buffer_async(
+                    file,
+                    buffer_get_data(buffer),
+                    buffer_get_size(buffer),
+                    lfrfid_raw_worker_write_callback,
+                    data);
             }
 
-            if(!file_valid) {
+            if(!file_valid || data->write_error) {
+                file_valid = false;
                 if(worker->read_callback != NULL) {
                     // message file_error to worker
                     worker->read_callback(LFRFIDWorkerReadRawFileError, worker->context);
@@ -211,9 +239,10 @@ static int32_t lfrfid_raw_read_worker_thread(void* thread_context) {
         }
     }
 
+    // Closing the file waits for the queued writes, so it goes before the buffers
+    lfrfid_raw_file_free(file);
     varint_pair_free(data->pair);
     buffer_stream_free(data->stream);
-    lfrfid_raw_file_free(file);
     furi_record_close(RECORD_STORAGE);
     free(data);
 
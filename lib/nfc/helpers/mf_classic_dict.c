@@ -10,10 +10,13 @@
 #define TAG "MfClassicDict"
 
 #define NFC_MF_CLASSIC_KEY_LEN (13)
+#define NFC_MF_CLASSIC_DICT_ARENA_SIZE (128)
 
 struct MfClassicDict {
     Stream* stream;
     uint32_t total_keys;
+    // Temporaries of per key lookups, reset after each call
+    FuriStringArena* arena;
 };
 
 bool mf_classic_dict_check_presence(MfClassicDictType dict_type) {
@@ -39,6 +42,7 @@ MfClassicDict* mf_classic_dict_alloc(MfClassicDictType dict_type) {
     Storage* storage = furi_record_open(RECORD_STORAGE);
     dict->stream = buffered_file_stream_alloc(storage);
     furi_record_close(RECORD_STORAGE);
+    dict->arena = furi_string_arena_alloc(NFC_MF_CLASSIC_DICT_ARENA_SIZE);
 
     bool dict_loaded = false;
     do {
@@ -106,6 +110,7 @@ MfClassicDict* mf_classic_dict_alloc(MfClassicDictType dict_type) {
 
     if(!dict_loaded) {
         buffered_file_stream_close(dict->stream);
+        furi_string_arena_free(dict->arena);
         free(dict);
         dict = NULL;
     }
@@ -119,6 +124,7 @@ void mf_classic_dict_free(MfClassicDict* dict) {
 
     buffered_file_stream_close(dict->stream);
     stream_free(dict->stream);
+    furi_string_arena_free(dict->arena);
     free(dict);
 }
 
@@ -175,12 +181,12 @@ bool mf_classic_dict_get_next_key(MfClassicDict* dict, uint64_t* key) {
     furi_assert(dict->stream);
 
     FuriString* temp_key;
-    temp_key = furi_string_alloc();
+    temp_key = furi_string_arena_alloc_string(dict->arena);
     bool key_read = mf_classic_dict_get_next_key_str(dict, temp_key);
     if(key_read) {
         mf_classic_dict_str_to_int(temp_key, key);
     }
-    furi_string_free(temp_key);
+    furi_string_arena_reset(dict->arena);
     return key_read;
 }
 
@@ -189,7 +195,7 @@ bool mf_classic_dict_is_key_present_str(MfClassicDict* dict, FuriString* key) {
     furi_assert(dict->stream);
 
     FuriString* next_line;
-    next_line = furi_string_alloc();
+    next_line = furi_string_arena_alloc_string(dict->arena);
 
     bool key_found = false;
     stream_rewind(dict->stream);
@@ -202,7 +208,7 @@ bool mf_classic_dict_is_key_present_str(MfClassicDict* dict, FuriString* key) {
         key_found = true;
     }
 
-    furi_string_free(next_line);
+    furi_string_arena_reset(dict->arena);
     return key_found;
 }
 
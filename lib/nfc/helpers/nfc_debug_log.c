@@ -53,14 +53,15 @@ void nfc_debug_log_process_data(
     uint8_t* data,
     uint16_t len,
     bool reader_to_tag,
-    bool crc_dropped) {
+    bool crc_dropped,
+    uint32_t tick) {
     furi_assert(instance);
     furi_assert(instance->file_stream);
     furi_assert(instance->data_str);
     furi_assert(data);
     UNUSED(crc_dropped);
 
-    furi_string_printf(instance->data_str, "%lu %c:", furi_get_tick(), reader_to_tag ? 'R' : 'T');
+    furi_string_printf(instance->data_str, "%lu %c:", tick, reader_to_tag ? 'R' : 'T');
     uint16_t data_len = len;
     for(size_t i = 0; i < data_len; i++) {
         furi_string_cat_printf(instance->data_str, " %02x", data[i]);
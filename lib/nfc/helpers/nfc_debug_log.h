@@ -14,4 +14,5 @@ void nfc_debug_log_process_data(
     uint8_t* data,
     uint16_t len,
     bool reader_to_tag,
-    bool crc_dropped);
+    bool crc_dropped,
+    uint32_t tick);
@@ -1,9 +1,8 @@
 #include "nfc_debug_pcap.h"
 
 #include <storage/storage.h>
-#include <stream/buffered_file_stream.h>
+#include <stream/file_stream.h>
 #include <furi_hal_nfc.h>
-#include <furi_hal_rtc.h>
 
 #define TAG "NfcDebugPcap"
 
@@ -18,16 +17,32 @@
 #define DATA_PCD_TO_PICC_CRC_DROPPED 0xFA
 
 #define NFC_DEBUG_PCAP_FILENAME EXT_PATH("nfc/debug.pcap")
+/* Records are collected in RAM and written to file in chunks of this size */
+#define NFC_DEBUG_PCAP_BUFFER_SIZE (2048)
+
+typedef struct {
+    // https://wiki.wireshark.org/Development/LibpcapFileFormat#record-packet-header
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+    // https://www.kaiser.cx/posts/pcap-iso14443/#_packet_data
+    uint8_t version;
+    uint8_t event;
+    uint16_t len;
+} __attribute__((__packed__)) NfcDebugPcapRecordHeader;
 
 struct NfcDebugPcap {
     Stream* file_stream;
+    uint8_t* buffer;
+    size_t buffer_used;
 };
 
 static Stream* nfc_debug_pcap_open(Storage* storage) {
     Stream* stream = NULL;
-    stream = buffered_file_stream_alloc(storage);
-    if(!buffered_file_stream_open(stream, NFC_DEBUG_PCAP_FILENAME, FSAM_WRITE, FSOM_OPEN_APPEND)) {
-        buffered_file_stream_close(stream);
+    stream = file_stream_alloc(storage);
+    if(!file_stream_open(stream, NFC_DEBUG_PCAP_FILENAME, FSAM_WRITE, FSOM_OPEN_APPEND)) {
+        file_stream_close(stream);
         stream_free(stream);
         stream = NULL;
     } else {
@@ -47,7 +62,7 @@ static Stream* nfc_debug_pcap_open(Storage* storage) {
             };
             if(stream_write(stream, (uint8_t*)&pcap_hdr, sizeof(pcap_hdr)) != sizeof(pcap_hdr)) {
                 FURI_LOG_E(TAG, "Failed to write pcap header");
-                buffered_file_stream_close(stream);
+                file_stream_close(stream);
                 stream_free(stream);
                 stream = NULL;
             }
@@ -64,6 +79,8 @@ NfcDebugPcap* nfc_debug_pcap_alloc() {
     if(!instance->file_stream) {
         free(instance);
         instance = NULL;
+    } else {
+        instance->buffer = malloc(NFC_DEBUG_PCAP_BUFFER_SIZE);
     }
     furi_record_close(RECORD_STORAGE);
 
@@ -74,22 +91,49 @@ void nfc_debug_pcap_free(NfcDebugPcap* instance) {
     furi_assert(instance);
     furi_assert(instance->file_stream);
 
-    buffered_file_stream_close(instance->file_stream);
+    nfc_debug_pcap_flush(instance);
+    file_stream_close(instance->file_stream);
     stream_free(instance->file_stream);
 
+    free(instance->buffer);
     free(instance);
 }
 
+void nfc_debug_pcap_flush(NfcDebugPcap* instance) {
+    furi_assert(instance);
+
+    if(instance->buffer_used) {
+        size_t written =
+            stream_write(instance->file_stream, instance->buffer, instance->buffer_used);
+        if(written != instance->buffer_used) {
+            FURI_LOG_E(TAG, "Failed to write %zu bytes", instance->buffer_used - written);
+        }
+        instance->buffer_used = 0;
+    }
+}
+
+static void nfc_debug_pcap_append(NfcDebugPcap* instance, const void* data, size_t size) {
+    if(instance->buffer_used + size > NFC_DEBUG_PCAP_BUFFER_SIZE) {
+        nfc_debug_pcap_flush(instance);
+    }
+    if(size > NFC_DEBUG_PCAP_BUFFER_SIZE) {
+        stream_write(instance->file_stream, data, size);
+    } else {
+        memcpy(&instance->buffer[instance->buffer_used], data, size);
+        instance->buffer_used += size;
+    }
+}
+
 void nfc_debug_pcap_process_data(
     NfcDebugPcap* instance,
     uint8_t* data,
     uint16_t len,
     bool reader_to_tag,
-    bool crc_dropped) {
+    bool crc_dropped,
+    uint32_t ts_sec,
+    uint32_t ts_usec) {
     furi_assert(instance);
     furi_assert(data);
-    FuriHalRtcDateTime datetime;
-    furi_hal_rtc_get_datetime(&datetime);
 
     uint8_t event = 0;
     if(reader_to_tag) {
@@ -106,25 +150,15 @@ void nfc_debug_pcap_process_data(
         }
     }
 
-    struct {
-        // https://wiki.wireshark.org/Development/LibpcapFileFormat#record-packet-header
-        uint32_t ts_sec;
-        uint32_t ts_usec;
-        uint32_t incl_len;
-        uint32_t orig_len;
-        // https://www.kaiser.cx/posts/pcap-iso14443/#_packet_data
-        uint8_t version;
-        uint8_t event;
-        uint16_t len;
-    } __attribute__((__packed__)) pkt_hdr = {
-        .ts_sec = furi_hal_rtc_datetime_to_timestamp(&datetime),
-        .ts_usec = 0,
+    NfcDebugPcapRecordHeader pkt_hdr = {
+        .ts_sec = ts_sec,
+        .ts_usec = ts_usec,
         .incl_len = len + 4,
         .orig_len = len + 4,
         .version = 0,
         .event = event,
         .len = len << 8 | len >> 8,
     };
-    stream_write(instance->file_stream, (uint8_t*)&pkt_hdr, sizeof(pkt_hdr));
-    stream_write(instance->file_stream, data, len);
+    nfc_debug_pcap_append(instance, &pkt_hdr, sizeof(pkt_hdr));
+    nfc_debug_pcap_append(instance, data, len);
 }
@@ -9,9 +9,15 @@ NfcDebugPcap* nfc_debug_pcap_alloc();
 
 void nfc_debug_pcap_free(NfcDebugPcap* instance);
 
+/** Append frame record, records are written to file in large chunks */
 void nfc_debug_pcap_process_data(
     NfcDebugPcap* instance,
     uint8_t* data,
     uint16_t len,
     bool reader_to_tag,
-    bool crc_dropped);
+    bool crc_dropped,
+    uint32_t ts_sec,
+    uint32_t ts_usec);
+
+/** Write collected records to file */
+void nfc_debug_pcap_flush(NfcDebugPcap* instance);
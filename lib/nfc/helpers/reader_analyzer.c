@@ -1,6 +1,8 @@
 #include "reader_analyzer.h"
 #include <lib/nfc/protocols/nfc_util.h>
 #include <lib/nfc/protocols/mifare_classic.h>
+#include <furi_hal_cortex.h>
+#include <furi_hal_rtc.h>
 #include <m-array.h>
 
 #include "mfkey32.h"
@@ -9,12 +11,18 @@
 
 #define TAG "ReaderAnalyzer"
 
-#define READER_ANALYZER_MAX_BUFF_SIZE (1024)
+/* Frame ring size in bytes, must be power of two */
+#define READER_ANALYZER_RING_SIZE (4096)
+#define READER_ANALYZER_RING_MASK (READER_ANALYZER_RING_SIZE - 1)
+#define READER_ANALYZER_FLAG_DATA (1UL << 0)
+#define READER_ANALYZER_POLL_TIMEOUT (50)
 
 typedef struct {
+    uint32_t cycles;
+    uint32_t tick;
+    uint16_t len;
     bool reader_to_tag;
     bool crc_dropped;
-    uint16_t len;
 } ReaderAnalyzerHeader;
 
 typedef enum {
@@ -24,10 +32,22 @@ typedef enum {
 struct ReaderAnalyzer {
     FuriHalNfcDevData nfc_data;
 
-    bool alive;
-    FuriStreamBuffer* stream;
+    volatile bool alive;
     FuriThread* thread;
 
+    /* Frame ring: header and payload, free running indexes */
+    uint8_t* ring;
+    size_t head;
+    size_t tail;
+    ReaderAnalyzerStats stats;
+
+    /* Capture time base */
+    uint32_t start_timestamp;
+    uint64_t start_cycles;
+    uint64_t cycles;
+    uint32_t cycles_tick;
+    uint8_t frame[FURI_HAL_NFC_DATA_BUFF_SIZE];
+
     ReaderAnalyzerParseDataCallback callback;
     void* context;
 
@@ -48,48 +68,97 @@ const FuriHalNfcDevData reader_analyzer_nfc_data[] = {
          .cuid = 0x2A234F80},
 };
 
-void reader_analyzer_parse(ReaderAnalyzer* instance, uint8_t* buffer, size_t size) {
-    if(size < sizeof(ReaderAnalyzerHeader)) return;
+static void reader_analyzer_ring_write(
+    ReaderAnalyzer* instance,
+    size_t index,
+    const void* data,
+    size_t size) {
+    size_t offset = index & READER_ANALYZER_RING_MASK;
+    size_t run = MIN(size, READER_ANALYZER_RING_SIZE - offset);
+    memcpy(&instance->ring[offset], data, run);
+    memcpy(instance->ring, (const uint8_t*)data + run, size - run);
+}
 
-    size_t bytes_i = 0;
-    while(bytes_i < size) {
-        ReaderAnalyzerHeader* header = (ReaderAnalyzerHeader*)&buffer[bytes_i];
-        uint16_t len = header->len;
-        if(bytes_i + len > size) break;
-        bytes_i += sizeof(ReaderAnalyzerHeader);
-        if(instance->mfkey32) {
-            mfkey32_process_data(
-                instance->mfkey32,
-                &buffer[bytes_i],
-                len,
-                header->reader_to_tag,
-                header->crc_dropped);
-        }
-        if(instance->pcap) {
-            nfc_debug_pcap_process_data(
-                instance->pcap, &buffer[bytes_i], len, header->reader_to_tag, header->crc_dropped);
-        }
-        if(instance->debug_log) {
-            nfc_debug_log_process_data(
-                instance->debug_log,
-                &buffer[bytes_i],
-                len,
-                header->reader_to_tag,
-                header->crc_dropped);
-        }
-        bytes_i += len;
+static void
+    reader_analyzer_ring_read(ReaderAnalyzer* instance, size_t index, void* data, size_t size) {
+    size_t offset = index & READER_ANALYZER_RING_MASK;
+    size_t run = MIN(size, READER_ANALYZER_RING_SIZE - offset);
+    memcpy(data, &instance->ring[offset], run);
+    memcpy((uint8_t*)data + run, instance->ring, size - run);
+}
+
+static uint64_t
+    reader_analyzer_get_cycles(ReaderAnalyzer* instance, const ReaderAnalyzerHeader* header) {
+    // Cycle counter wraps in about a minute, tick delta tells how many times it did
+    uint32_t cycles_per_tick = furi_hal_cortex_instructions_per_microsecond() * 1000000 /
+                               furi_kernel_get_tick_frequency();
+    uint32_t delta = header->cycles - (uint32_t)instance->cycles;
+    int64_t expected = (int64_t)(header->tick - instance->cycles_tick) * cycles_per_tick;
+    int64_t wraps = (expected - delta + (1LL << 31)) >> 32;
+    if(wraps < 0) wraps = 0;
+
+    instance->cycles += delta + ((uint64_t)wraps << 32);
+    instance->cycles_tick = header->tick;
+    return instance->cycles;
+}
+
+static void reader_analyzer_process(
+    ReaderAnalyzer* instance,
+    const ReaderAnalyzerHeader* header,
+    uint8_t* data) {
+    if(instance->mfkey32) {
+        mfkey32_process_data(
+            instance->mfkey32, data, header->len, header->reader_to_tag, header->crc_dropped);
+    }
+    if(instance->pcap) {
+        uint64_t cycles = reader_analyzer_get_cycles(instance, header) - instance->start_cycles;
+        uint64_t elapsed_us = cycles / furi_hal_cortex_instructions_per_microsecond();
+        nfc_debug_pcap_process_data(
+            instance->pcap,
+            data,
+            header->len,
+            header->reader_to_tag,
+            header->crc_dropped,
+            instance->start_timestamp + elapsed_us / 1000000,
+            elapsed_us % 1000000);
+    }
+    if(instance->debug_log) {
+        nfc_debug_log_process_data(
+            instance->debug_log,
+            data,
+            header->len,
+            header->reader_to_tag,
+            header->crc_dropped,
+            header->tick);
     }
 }
 
 int32_t reader_analyzer_thread(void* context) {
-    ReaderAnalyzer* reader_analyzer = context;
-    uint8_t buffer[READER_ANALYZER_MAX_BUFF_SIZE] = {};
+    ReaderAnalyzer* instance = context;
+    ReaderAnalyzerHeader header;
+
+    while(true) {
+        // Check alive first: producer is stopped by then and ring is drained completely
+        bool alive = instance->alive;
+        size_t tail = instance->tail;
+        size_t available = __atomic_load_n(&instance->head, __ATOMIC_ACQUIRE) - tail;
+
+        if(!available) {
+            if(!alive) break;
+            furi_thread_flags_wait(
+                READER_ANALYZER_FLAG_DATA, FuriFlagWaitAny, READER_ANALYZER_POLL_TIMEOUT);
+            continue;
+        }
+
+        while(available) {
+            reader_analyzer_ring_read(instance, tail, &header, sizeof(header));
+            reader_analyzer_ring_read(
+                instance, tail + sizeof(header), instance->frame, header.len);
+            tail += sizeof(header) + header.len;
+            available -= sizeof(header) + header.len;
+            __atomic_store_n(&instance->tail, tail, __ATOMIC_RELEASE);
 
-    while(reader_analyzer->alive || !furi_stream_buffer_is_empty(reader_analyzer->stream)) {
-        size_t ret = furi_stream_buffer_receive(
-            reader_analyzer->stream, buffer, READER_ANALYZER_MAX_BUFF_SIZE, 50);
-        if(ret) {
-            reader_analyzer_parse(reader_analyzer, buffer, ret);
+            reader_analyzer_process(instance, &header, instance->frame);
         }
     }
 
@@ -101,8 +170,7 @@ ReaderAnalyzer* reader_analyzer_alloc() {
 
     instance->nfc_data = reader_analyzer_nfc_data[ReaderAnalyzerNfcDataMfClassic];
     instance->alive = false;
-    instance->stream =
-        furi_stream_buffer_alloc(READER_ANALYZER_MAX_BUFF_SIZE, sizeof(ReaderAnalyzerHeader));
+    instance->ring = malloc(READER_ANALYZER_RING_SIZE);
 
     instance->thread =
         furi_thread_alloc_ex("ReaderAnalyzerWorker", 2048, reader_analyzer_thread, instance);
@@ -125,7 +193,15 @@ static void reader_analyzer_mfkey_callback(Mfkey32Event event, void* context) {
 void reader_analyzer_start(ReaderAnalyzer* instance, ReaderAnalyzerMode mode) {
     furi_assert(instance);
 
-    furi_stream_buffer_reset(instance->stream);
+    instance->head = 0;
+    instance->tail = 0;
+    memset(&instance->stats, 0, sizeof(ReaderAnalyzerStats));
+
+    instance->start_timestamp = furi_hal_rtc_get_timestamp();
+    instance->cycles_tick = furi_get_tick();
+    instance->cycles = furi_hal_cortex_get_cycle_count();
+    instance->start_cycles = instance->cycles;
+
     if(mode & ReaderAnalyzerModeDebugLog) {
         instance->debug_log = nfc_debug_log_alloc();
     }
@@ -146,9 +222,18 @@ void reader_analyzer_start(ReaderAnalyzer* instance, ReaderAnalyzerMode mode) {
 void reader_analyzer_stop(ReaderAnalyzer* instance) {
     furi_assert(instance);
 
+    if(!instance->alive) return;
+
     instance->alive = false;
     furi_thread_join(instance->thread);
 
+    FURI_LOG_I(
+        TAG,
+        "Frames: %lu, dropped: %lu, ring high water: %zu",
+        instance->stats.frames,
+        instance->stats.dropped,
+        instance->stats.high_water);
+
     if(instance->debug_log) {
         nfc_debug_log_free(instance->debug_log);
         instance->debug_log = NULL;
@@ -168,7 +253,7 @@ void reader_analyzer_free(ReaderAnalyzer* instance) {
 
     reader_analyzer_stop(instance);
     furi_thread_free(instance->thread);
-    furi_stream_buffer_free(instance->stream);
+    free(instance->ring);
     free(instance);
 }
 
@@ -203,6 +288,13 @@ FuriHalNfcDevData* reader_analyzer_get_nfc_data(ReaderAnalyzer* instance) {
     return &instance->nfc_data;
 }
 
+void reader_analyzer_get_stats(ReaderAnalyzer* instance, ReaderAnalyzerStats* stats) {
+    furi_assert(instance);
+    furi_assert(stats);
+
+    *stats = instance->stats;
+}
+
 void reader_analyzer_set_nfc_data(ReaderAnalyzer* instance, FuriHalNfcDevData* nfc_data) {
     furi_assert(instance);
     furi_assert(nfc_data);
@@ -217,16 +309,33 @@ static void reader_analyzer_write(
     bool reader_to_tag,
     bool crc_dropped) {
     ReaderAnalyzerHeader header = {
-        .reader_to_tag = reader_to_tag, .crc_dropped = crc_dropped, .len = len};
-    size_t data_sent = 0;
-    data_sent = furi_stream_buffer_send(
-        instance->stream, &header, sizeof(ReaderAnalyzerHeader), FuriWaitForever);
-    if(data_sent != sizeof(ReaderAnalyzerHeader)) {
-        FURI_LOG_W(TAG, "Sent %zu out of %zu bytes", data_sent, sizeof(ReaderAnalyzerHeader));
+        .cycles = furi_hal_cortex_get_cycle_count(),
+        .tick = furi_get_tick(),
+        .len = len,
+        .reader_to_tag = reader_to_tag,
+        .crc_dropped = crc_dropped,
+    };
+    size_t size = sizeof(ReaderAnalyzerHeader) + len;
+
+    // Never block NFC exchange: drop frame if ring is full
+    size_t head = instance->head;
+    size_t used = head - __atomic_load_n(&instance->tail, __ATOMIC_ACQUIRE);
+    if(len > FURI_HAL_NFC_DATA_BUFF_SIZE || size > READER_ANALYZER_RING_SIZE - used) {
+        instance->stats.dropped++;
+        return;
     }
-    data_sent = furi_stream_buffer_send(instance->stream, data, len, FuriWaitForever);
-    if(data_sent != len) {
-        FURI_LOG_W(TAG, "Sent %zu out of %u bytes", data_sent, len);
+
+    reader_analyzer_ring_write(instance, head, &header, sizeof(ReaderAnalyzerHeader));
+    reader_analyzer_ring_write(instance, head + sizeof(ReaderAnalyzerHeader), data, len);
+    __atomic_store_n(&instance->head, head + size, __ATOMIC_RELEASE);
+
+    instance->stats.frames++;
+    used += size;
+    if(used > instance->stats.high_water) instance->stats.high_water = used;
+
+    // Worker polls anyway, wake it early only when ring gets half full
+    if(used >= READER_ANALYZER_RING_SIZE / 2 && used - size < READER_ANALYZER_RING_SIZE / 2) {
+        furi_thread_flags_set(furi_thread_get_id(instance->thread), READER_ANALYZER_FLAG_DATA);
     }
 }
 
@@ -15,6 +15,12 @@ typedef enum {
 
 typedef struct ReaderAnalyzer ReaderAnalyzer;
 
+typedef struct {
+    uint32_t frames; /**< frames captured */
+    uint32_t dropped; /**< frames dropped because capture ring was full */
+    size_t high_water; /**< maximum capture ring fill level in bytes */
+} ReaderAnalyzerStats;
+
 typedef void (*ReaderAnalyzerParseDataCallback)(ReaderAnalyzerEvent event, void* context);
 
 ReaderAnalyzer* reader_analyzer_alloc();
@@ -33,6 +39,8 @@ void reader_analyzer_stop(ReaderAnalyzer* instance);
 NfcProtocol
     reader_analyzer_guess_protocol(ReaderAnalyzer* instance, uint8_t* buff_rx, uint16_t len);
 
+void reader_analyzer_get_stats(ReaderAnalyzer* instance, ReaderAnalyzerStats* stats);
+
 FuriHalNfcDevData* reader_analyzer_get_nfc_data(ReaderAnalyzer* instance);
 
 void reader_analyzer_set_nfc_data(ReaderAnalyzer* instance, FuriHalNfcDevData* nfc_data);
@@ -3,13 +3,14 @@
 #include "nfc_types.h"
 
 #include <lib/toolbox/path.h>
-#include <lib/toolbox/hex.h>
+#include <lib/toolbox/crc32_calc.h>
 #include <lib/nfc/protocols/nfc_util.h>
 #include <flipper_format/flipper_format.h>
 
 #define TAG "NfcDevice"
 #define NFC_DEVICE_KEYS_FOLDER EXT_PATH("nfc/.cache")
 #define NFC_DEVICE_KEYS_EXTENSION ".keys"
+#define NFC_DEVICE_DUMP_CACHE_EXTENSION ".nfcc"
 
 static const char* nfc_file_header = "Flipper NFC device";
 static const uint32_t nfc_file_version = 3;
@@ -17,6 +18,10 @@ static const uint32_t nfc_file_version = 3;
 static const char* nfc_keys_file_header = "Flipper NFC keys";
 static const uint32_t nfc_keys_file_version = 1;
 
+// "NFDC", bump version on any NfcDeviceData layout change
+static const uint32_t nfc_dump_cache_magic = 0x4344464E;
+static const uint16_t nfc_dump_cache_version = 1;
+
 // Protocols format versions
 static const uint32_t nfc_mifare_classic_data_format_version = 2;
 static const uint32_t nfc_mifare_ultralight_data_format_version = 1;
@@ -781,31 +786,26 @@ static bool nfc_device_save_mifare_classic_data(FlipperFormat* file, NfcDevice*
     return saved;
 }
 
-static void nfc_device_load_mifare_classic_block(
-    FuriString* block_str,
+static bool nfc_device_load_mifare_classic_block(
+    FlipperFormat* file,
+    const char* block_key,
     MfClassicData* data,
     uint8_t block_num) {
-    furi_string_trim(block_str);
     MfClassicBlock block_tmp = {};
     bool is_sector_trailer = mf_classic_is_sector_trailer(block_num);
     uint8_t sector_num = mf_classic_get_sector_by_block(block_num);
-    uint16_t block_unknown_bytes_mask = 0;
+    uint8_t block_known_bytes[MF_CLASSIC_BLOCK_SIZE / 8] = {};
 
-    furi_string_trim(block_str);
-    for(size_t i = 0; i < MF_CLASSIC_BLOCK_SIZE; i++) {
-        char hi = furi_string_get_char(block_str, 3 * i);
-        char low = furi_string_get_char(block_str, 3 * i + 1);
-        uint8_t byte = 0;
-        if(hex_char_to_uint8(hi, low, &byte)) {
-            block_tmp.value[i] = byte;
-        } else {
-            FURI_BIT_SET(block_unknown_bytes_mask, i);
-        }
+    if(!flipper_format_read_hex_array_masked(
+           file, block_key, block_tmp.value, block_known_bytes, MF_CLASSIC_BLOCK_SIZE)) {
+        return false;
     }
+    uint16_t block_unknown_bytes_mask =
+        ~(block_known_bytes[0] | (block_known_bytes[1] << 8)) & 0xffff;
 
     if(block_unknown_bytes_mask == 0xffff) {
         // All data is unknown, exit
-        return;
+        return true;
     }
 
     if(is_sector_trailer) {
@@ -832,6 +832,8 @@ static void nfc_device_load_mifare_classic_block(
             mf_classic_set_block_read(data, block_num, &block_tmp);
         }
     }
+
+    return true;
 }
 
 static bool nfc_device_load_mifare_classic_data(FlipperFormat* file, NfcDevice* dev) {
@@ -873,17 +875,14 @@ static bool nfc_device_load_mifare_classic_data(FlipperFormat* file, NfcDevice*
 
         // Read Mifare Classic blocks
         bool block_read = true;
-        FuriString* block_str;
-        block_str = furi_string_alloc();
         for(size_t i = 0; i < data_blocks; i++) {
             furi_string_printf(temp_str, "Block %d", i);
-            if(!flipper_format_read_string(file, furi_string_get_cstr(temp_str), block_str)) {
+            if(!nfc_device_load_mifare_classic_block(
+                   file, furi_string_get_cstr(temp_str), data, i)) {
                 block_read = false;
                 break;
             }
-            nfc_device_load_mifare_classic_block(block_str, data, i);
         }
-        furi_string_free(block_str);
         if(!block_read) break;
 
         // Set keys and blocks as unknown for backward compatibility
@@ -1040,6 +1039,149 @@ static void nfc_device_get_folder_from_path(FuriString* path, FuriString* folder
     }
 }
 
+#pragma pack(push, 1)
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t format;
+    uint8_t protocol;
+    uint32_t source_timestamp;
+    uint32_t source_size;
+    uint32_t data_size;
+    uint32_t data_crc;
+} NfcDeviceDumpCacheHeader;
+#pragma pack(pop)
+
+static size_t nfc_device_get_dump_cache_data_size(NfcDevice* dev) {
+    // Only flat dumps are cached, DESFire keeps applications in lists
+    if(dev->format == NfcDeviceSaveFormatMifareClassic) {
+        return sizeof(MfClassicData);
+    } else if(dev->format == NfcDeviceSaveFormatMifareUl) {
+        return sizeof(MfUltralightData);
+    }
+    return 0;
+}
+
+static void nfc_device_get_dump_cache_path(const char* source_path, FuriString* cache_path) {
+    uint32_t path_crc = crc32_calc_buffer(0, source_path, strlen(source_path));
+    furi_string_printf(
+        cache_path,
+        "%s/%08lX%s",
+        NFC_DEVICE_KEYS_FOLDER,
+        path_crc,
+        NFC_DEVICE_DUMP_CACHE_EXTENSION);
+}
+
+static bool nfc_device_get_dump_cache_source_stamp(
+    NfcDevice* dev,
+    FuriString* source_path,
+    NfcDeviceDumpCacheHeader* header) {
+    FileInfo file_info = {};
+    const char* path = furi_string_get_cstr(source_path);
+    if(storage_common_stat(dev->storage, path, &file_info) != FSE_OK) return false;
+    if(storage_common_timestamp(dev->storage, path, &header->source_timestamp) != FSE_OK)
+        return false;
+    header->source_size = file_info.size;
+    return true;
+}
+
+static bool nfc_device_load_dump_cache(NfcDevice* dev, FuriString* source_path) {
+    NfcDeviceDumpCacheHeader source = {};
+    if(!nfc_device_get_dump_cache_source_stamp(dev, source_path, &source)) return false;
+
+    FuriString* cache_path = furi_string_alloc();
+    nfc_device_get_dump_cache_path(furi_string_get_cstr(source_path), cache_path);
+    File* file = storage_file_alloc(dev->storage);
+    // Keep current data intact until whole cache is verified
+    NfcDeviceData* data = malloc(sizeof(NfcDeviceData));
+    bool loaded = false;
+
+    do {
+        if(!storage_file_open(
+               file, furi_string_get_cstr(cache_path), FSAM_READ, FSOM_OPEN_EXISTING))
+            break;
+        NfcDeviceDumpCacheHeader header = {};
+        if(storage_file_read(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(header.magic != nfc_dump_cache_magic || header.version != nfc_dump_cache_version)
+            break;
+        // Text file is the source of truth, any change to it invalidates cache
+        if(header.source_timestamp != source.source_timestamp ||
+           header.source_size != source.source_size)
+            break;
+
+        dev->format = header.format;
+        size_t data_size = nfc_device_get_dump_cache_data_size(dev);
+        if(!data_size || header.data_size != data_size) break;
+        if(storage_file_read(file, &data->nfc_data, sizeof(data->nfc_data)) !=
+           sizeof(data->nfc_data))
+            break;
+        if(storage_file_read(file, &data->mf_classic_data, data_size) != data_size) break;
+        uint32_t data_crc = crc32_calc_buffer(0, &data->nfc_data, sizeof(data->nfc_data));
+        data_crc = crc32_calc_buffer(data_crc, &data->mf_classic_data, data_size);
+        if(data_crc != header.data_crc) break;
+
+        dev->dev_data.nfc_data = data->nfc_data;
+        dev->dev_data.protocol = header.protocol;
+        memcpy(&dev->dev_data.mf_classic_data, &data->mf_classic_data, data_size);
+        loaded = true;
+    } while(false);
+
+    free(data);
+    storage_file_free(file);
+    furi_string_free(cache_path);
+    return loaded;
+}
+
+static void nfc_device_save_dump_cache(NfcDevice* dev, FuriString* source_path) {
+    size_t data_size = nfc_device_get_dump_cache_data_size(dev);
+    if(!data_size) return;
+
+    NfcDeviceDumpCacheHeader header = {
+        .magic = nfc_dump_cache_magic,
+        .version = nfc_dump_cache_version,
+        .format = dev->format,
+        .protocol = dev->dev_data.protocol,
+        .data_size = data_size,
+    };
+    if(!nfc_device_get_dump_cache_source_stamp(dev, source_path, &header)) return;
+    NfcDeviceData* data = &dev->dev_data;
+    header.data_crc = crc32_calc_buffer(0, &data->nfc_data, sizeof(data->nfc_data));
+    header.data_crc = crc32_calc_buffer(header.data_crc, &data->mf_classic_data, data_size);
+
+    FuriString* cache_path = furi_string_alloc();
+    nfc_device_get_dump_cache_path(furi_string_get_cstr(source_path), cache_path);
+    File* file = storage_file_alloc(dev->storage);
+    bool saved = false;
+
+    do {
+        if(!storage_simply_mkdir(dev->storage, NFC_DEVICE_KEYS_FOLDER)) break;
+        if(!storage_file_open(
+               file, furi_string_get_cstr(cache_path), FSAM_WRITE, FSOM_CREATE_ALWAYS))
+            break;
+        if(storage_file_write(file, &header, sizeof(header)) != sizeof(header)) break;
+        if(storage_file_write(file, &data->nfc_data, sizeof(data->nfc_data)) !=
+           sizeof(data->nfc_data))
+            break;
+        if(storage_file_write(file, &data->mf_classic_data, data_size) != data_size) break;
+        saved = true;
+    } while(false);
+
+    storage_file_close(file);
+    if(!saved) {
+        FURI_LOG_W(TAG, "Failed to save dump cache");
+        storage_simply_remove(dev->storage, furi_string_get_cstr(cache_path));
+    }
+    storage_file_free(file);
+    furi_string_free(cache_path);
+}
+
+static void nfc_device_remove_dump_cache(NfcDevice* dev, const char* source_path) {
+    FuriString* cache_path = furi_string_alloc();
+    nfc_device_get_dump_cache_path(source_path, cache_path);
+    storage_common_remove(dev->storage, furi_string_get_cstr(cache_path));
+    furi_string_free(cache_path);
+}
+
 bool nfc_device_save(NfcDevice* dev, const char* dev_name) {
     furi_assert(dev);
 
@@ -1092,6 +1234,8 @@ bool nfc_device_save(NfcDevice* dev, const char* dev_name) {
             // Save keys cache
             if(!nfc_device_save_mifare_classic_keys(dev)) break;
         }
+        // Timestamp resolution is too coarse to catch quick overwrite, drop cache explicitly
+        nfc_device_remove_dump_cache(dev, dev_name);
         saved = true;
     } while(0);
 
@@ -1120,11 +1264,12 @@ bool nfc_device_save_shadow(NfcDevice* dev, const char* path) {
 
 static bool nfc_device_load_data(NfcDevice* dev, FuriString* path, bool show_dialog) {
     bool parsed = false;
-    FlipperFormat* file = flipper_format_file_alloc(dev->storage);
+    FlipperFormat* file = flipper_format_buffered_file_alloc(dev->storage);
     FuriHalNfcDevData* data = &dev->dev_data.nfc_data;
     uint32_t data_cnt = 0;
     FuriString* temp_str;
     temp_str = furi_string_alloc();
+    FuriString* source_path = furi_string_alloc();
     bool deprecated_version = false;
 
     // Version 2 of file format had ATQA bytes swapped
@@ -1140,11 +1285,14 @@ static bool nfc_device_load_data(NfcDevice* dev, FuriString* path, bool show_dia
         dev->shadow_file_exist =
             storage_common_stat(dev->storage, furi_string_get_cstr(temp_str), NULL) == FSE_OK;
         // Open shadow file if it exists. If not - open original
-        if(dev->shadow_file_exist) {
-            if(!flipper_format_file_open_existing(file, furi_string_get_cstr(temp_str))) break;
-        } else {
-            if(!flipper_format_file_open_existing(file, furi_string_get_cstr(path))) break;
+        furi_string_set(source_path, dev->shadow_file_exist ? temp_str : path);
+        // Compiled dump is valid only for unchanged source file
+        if(nfc_device_load_dump_cache(dev, source_path)) {
+            parsed = true;
+            break;
         }
+        if(!flipper_format_buffered_file_open_existing(file, furi_string_get_cstr(source_path)))
+            break;
         // Read and verify file header
         uint32_t version = 0;
         if(!flipper_format_read_header(file, temp_str, &version)) break;
@@ -1190,6 +1338,7 @@ static bool nfc_device_load_data(NfcDevice* dev, FuriString* path, bool show_dia
             if(!nfc_device_load_bank_card_data(file, dev)) break;
         }
         parsed = true;
+        nfc_device_save_dump_cache(dev, source_path);
     } while(false);
 
     if(dev->loading_cb) {
@@ -1204,6 +1353,7 @@ static bool nfc_device_load_data(NfcDevice* dev, FuriString* path, bool show_dia
         }
     }
 
+    furi_string_free(source_path);
     furi_string_free(temp_str);
     flipper_format_free(file);
     return parsed;
@@ -1307,6 +1457,7 @@ bool nfc_device_delete(NfcDevice* dev, bool use_load_path) {
                 NFC_APP_EXTENSION);
         }
         if(!storage_simply_remove(dev->storage, furi_string_get_cstr(file_path))) break;
+        nfc_device_remove_dump_cache(dev, furi_string_get_cstr(file_path));
         // Delete shadow file if it exists
         if(dev->shadow_file_exist) {
             if(use_load_path && !furi_string_empty(dev->load_path)) {
@@ -1320,6 +1471,7 @@ bool nfc_device_delete(NfcDevice* dev, bool use_load_path) {
                     NFC_APP_SHADOW_EXTENSION);
             }
             if(!storage_simply_remove(dev->storage, furi_string_get_cstr(file_path))) break;
+            nfc_device_remove_dump_cache(dev, furi_string_get_cstr(file_path));
         }
         deleted = true;
     } while(0);
@@ -27,7 +27,58 @@ void crypto1_init(Crypto1* crypto1, uint64_t key) {
     }
 }
 
+// Filter function index bits for odd state bits 0..7, 8..15 and 16..19
+static const uint8_t crypto1_filter_lo[256] = {
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x00, 0x00, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x10, 0x10, 0x10, 0x10,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+    0x08, 0x08, 0x18, 0x18, 0x08, 0x18, 0x08, 0x08, 0x08, 0x18, 0x08, 0x08, 0x18, 0x18, 0x18, 0x18,
+};
+
+static const uint8_t crypto1_filter_mid[256] = {
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x00, 0x00, 0x04, 0x04, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x04, 0x04, 0x04, 0x04,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+    0x02, 0x02, 0x06, 0x06, 0x02, 0x06, 0x02, 0x02, 0x02, 0x06, 0x02, 0x02, 0x06, 0x06, 0x06, 0x06,
+};
+
+static const uint8_t crypto1_filter_hi[16] = {
+    0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x01, 0x01,
+};
+
 uint32_t crypto1_filter(uint32_t in) {
+    uint32_t out = crypto1_filter_lo[in & 0xff];
+    out |= crypto1_filter_mid[in >> 8 & 0xff];
+    out |= crypto1_filter_hi[in >> 16 & 0xf];
+    return FURI_BIT(0xEC57E80A, out);
+}
+
+// Bitwise reference filter, kept for crypto1_bit
+static uint32_t crypto1_filter_bitwise(uint32_t in) {
     uint32_t out = 0;
     out = 0xf22c0 >> (in & 0xf) & 16;
     out |= 0x6c9c0 >> (in >> 4 & 0xf) & 8;
@@ -37,9 +88,26 @@ uint32_t crypto1_filter(uint32_t in) {
     return FURI_BIT(0xEC57E80A, out);
 }
 
+static inline uint32_t crypto1_parity32(uint32_t x) {
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    return 0x6996 >> (x & 0xf) & 1;
+}
+
+// Single LFSR step without odd/even swap: filter is taken from `odd`, feedback
+// is shifted into `even`. Callers alternate the halves on each step instead.
+static inline uint32_t
+    crypto1_step(uint32_t odd, uint32_t* even, uint32_t in, uint32_t encrypted) {
+    uint32_t out = crypto1_filter(odd);
+    uint32_t feed = (out & encrypted) ^ in ^ (LF_POLY_ODD & odd) ^ (LF_POLY_EVEN & *even);
+    *even = *even << 1 | crypto1_parity32(feed);
+    return out;
+}
+
 uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     furi_assert(crypto1);
-    uint8_t out = crypto1_filter(crypto1->odd);
+    uint8_t out = crypto1_filter_bitwise(crypto1->odd);
     uint32_t feed = out & (!!is_encrypted);
     feed ^= !!in;
     feed ^= LF_POLY_ODD & crypto1->odd;
@@ -50,21 +118,38 @@ uint8_t crypto1_bit(Crypto1* crypto1, uint8_t in, int is_encrypted) {
     return out;
 }
 
-uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
-    furi_assert(crypto1);
-    uint8_t out = 0;
-    for(uint8_t i = 0; i < 8; i++) {
-        out |= crypto1_bit(crypto1, FURI_BIT(in, i), is_encrypted) << i;
+// Byte and word are stepped two bits per iteration, so state halves
+// end up in place without swapping and stay in registers
+static inline uint8_t crypto1_byte_fast(Crypto1* crypto1, uint8_t in, uint32_t encrypted) {
+    uint32_t odd = crypto1->odd;
+    uint32_t even = crypto1->even;
+    uint32_t out = 0;
+    for(uint8_t i = 0; i < 8; i += 2) {
+        out |= crypto1_step(odd, &even, FURI_BIT(in, i), encrypted) << i;
+        out |= crypto1_step(even, &odd, FURI_BIT(in, i + 1), encrypted) << (i + 1);
     }
+    crypto1->odd = odd;
+    crypto1->even = even;
     return out;
 }
 
+uint8_t crypto1_byte(Crypto1* crypto1, uint8_t in, int is_encrypted) {
+    furi_assert(crypto1);
+    return crypto1_byte_fast(crypto1, in, !!is_encrypted);
+}
+
 uint32_t crypto1_word(Crypto1* crypto1, uint32_t in, int is_encrypted) {
     furi_assert(crypto1);
+    uint32_t encrypted = !!is_encrypted;
+    uint32_t odd = crypto1->odd;
+    uint32_t even = crypto1->even;
     uint32_t out = 0;
-    for(uint8_t i = 0; i < 32; i++) {
-        out |= crypto1_bit(crypto1, BEBIT(in, i), is_encrypted) << (24 ^ i);
+    for(uint8_t i = 0; i < 32; i += 2) {
+        out |= crypto1_step(odd, &even, BEBIT(in, i), encrypted) << (24 ^ i);
+        out |= crypto1_step(even, &odd, BEBIT(in, i + 1), encrypted) << (24 ^ (i + 1));
     }
+    crypto1->odd = odd;
+    crypto1->even = even;
     return out;
 }
 
@@ -93,7 +178,7 @@ void crypto1_decrypt(
         decrypted_data[0] = decrypted_byte;
     } else {
         for(size_t i = 0; i < encrypted_data_bits / 8; i++) {
-            decrypted_data[i] = crypto1_byte(crypto, 0, 0) ^ encrypted_data[i];
+            decrypted_data[i] = crypto1_byte_fast(crypto, 0, 0) ^ encrypted_data[i];
         }
     }
 }
@@ -118,7 +203,7 @@ void crypto1_encrypt(
     } else {
         memset(encrypted_parity, 0, plain_data_bits / 8 + 1);
         for(uint8_t i = 0; i < plain_data_bits / 8; i++) {
-            encrypted_data[i] = crypto1_byte(crypto, keystream ? keystream[i] : 0, 0) ^
+            encrypted_data[i] = crypto1_byte_fast(crypto, keystream ? keystream[i] : 0, 0) ^
                                 plain_data[i];
             encrypted_parity[i / 8] |=
                 (((crypto1_filter(crypto->odd) ^ nfc_util_odd_parity8(plain_data[i])) & 0x01)
@@ -863,7 +863,7 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             memcpy(plain_data, tx_rx->rx_data, tx_rx->rx_bits / 8);
         } else {
             if(!furi_hal_nfc_tx_rx(tx_rx, 300)) {
-                FURI_LOG_D(
+                FURI_LOG_DEFERRED_D(
                     TAG,
                     "Error in tx rx. Tx :%d bits, Rx: %d bits",
                     tx_rx->tx_bits,
@@ -880,7 +880,7 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
         }
 
         if(cmd == 0x50 && plain_data[1] == 0x00) {
-            FURI_LOG_T(TAG, "Halt received");
+            FURI_LOG_DEFERRED_T(TAG, "Halt received");
             furi_hal_nfc_listen_sleep();
             command_processed = true;
             break;
@@ -924,13 +924,13 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
                 tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
             }
             if(!furi_hal_nfc_tx_rx(tx_rx, 500)) {
-                FURI_LOG_E(TAG, "Error in NT exchange");
+                FURI_LOG_DEFERRED_E(TAG, "Error in NT exchange");
                 command_processed = true;
                 break;
             }
 
             if(tx_rx->rx_bits != 64) {
-                FURI_LOG_W(TAG, "Incorrect nr + ar length: %d", tx_rx->rx_bits);
+                FURI_LOG_DEFERRED_W(TAG, "Incorrect nr + ar length: %d", tx_rx->rx_bits);
                 command_processed = true;
                 break;
             }
@@ -941,7 +941,8 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             crypto1_word(&emulator->crypto, nr, 1);
             uint32_t cardRr = ar ^ crypto1_word(&emulator->crypto, 0, 0);
             if(cardRr != prng_successor(nonce, 64)) {
-                FURI_LOG_T(TAG, "Wrong AUTH! %08lX != %08lX", cardRr, prng_successor(nonce, 64));
+                FURI_LOG_DEFERRED_T(
+                    TAG, "Wrong AUTH! %08lX != %08lX", cardRr, prng_successor(nonce, 64));
                 // Don't send NACK, as the tag doesn't send it
                 command_processed = true;
                 break;
@@ -965,7 +966,7 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
         }
 
         if(!is_encrypted) {
-            FURI_LOG_T(TAG, "Invalid command before auth session established: %02X", cmd);
+            FURI_LOG_DEFERRED_T(TAG, "Invalid command before auth session established: %02X", cmd);
             break;
         }
 
@@ -1119,7 +1120,7 @@ bool mf_classic_emulator(MfClassicEmulator* emulator, FuriHalNfcTxRxContext* tx_
             tx_rx->tx_rx_type = FuriHalNfcTxRxTransparent;
             tx_rx->tx_bits = 4;
         } else {
-            FURI_LOG_T(TAG, "Unknown command: %02X", cmd);
+            FURI_LOG_DEFERRED_T(TAG, "Unknown command: %02X", cmd);
             break;
         }
     }
@@ -1,6 +1,7 @@
 #include "raw.h"
 #include <lib/flipper_format/flipper_format.h>
 #include "../subghz_file_encoder_worker.h"
+#include "../subghz_raw_binary.h"
 
 #include "../blocks/const.h"
 #include "../blocks/decoder.h"
@@ -28,6 +29,7 @@ struct SubGhzProtocolDecoderRAW {
     uint16_t ind_write;
     Storage* storage;
     FlipperFormat* flipper_file;
+    SubGhzRawBinaryWriter* binary_writer;
     uint32_t file_is_open;
     FuriString* file_name;
     size_t sample_write;
@@ -156,6 +158,16 @@ bool subghz_protocol_raw_save_to_file_init(
             break;
         }
 
+        uint32_t binary_version = SUBGHZ_RAW_BINARY_VERSION;
+        if(!flipper_format_write_uint32(
+               instance->flipper_file, SUBGHZ_RAW_BINARY_KEY, &binary_version, 1)) {
+            FURI_LOG_E(TAG, "Unable to add " SUBGHZ_RAW_BINARY_KEY);
+            break;
+        }
+        // Blocks are stored uncompressed: recording must keep up with receiver
+        instance->binary_writer = subghz_raw_binary_writer_alloc(
+            flipper_format_get_raw_stream(instance->flipper_file), false);
+
         instance->upload_raw = malloc(SUBGHZ_DOWNLOAD_MAX_SIZE * sizeof(int32_t));
         instance->file_is_open = RAWFileIsOpenWrite;
         instance->sample_write = 0;
@@ -174,9 +186,9 @@ static bool subghz_protocol_raw_save_to_file_write(SubGhzProtocolDecoderRAW* ins
 
     bool is_write = false;
     if(instance->file_is_open == RAWFileIsOpenWrite) {
-        if(!flipper_format_write_int32(
-               instance->flipper_file, "RAW_Data", instance->upload_raw, instance->ind_write)) {
-            FURI_LOG_E(TAG, "Unable to add RAW_Data");
+        if(!subghz_raw_binary_writer_write(
+               instance->binary_writer, instance->upload_raw, instance->ind_write)) {
+            FURI_LOG_E(TAG, "Unable to add RAW data");
         } else {
             instance->sample_write += instance->ind_write;
             instance->ind_write = 0;
@@ -192,6 +204,11 @@ void subghz_protocol_raw_save_to_file_stop(SubGhzProtocolDecoderRAW* instance) {
     if(instance->file_is_open == RAWFileIsOpenWrite && instance->ind_write)
         subghz_protocol_raw_save_to_file_write(instance);
     if(instance->file_is_open != RAWFileIsOpenClose) {
+        if(!subghz_raw_binary_writer_finish(instance->binary_writer)) {
+            FURI_LOG_E(TAG, "Unable to add RAW index");
+        }
+        subghz_raw_binary_writer_free(instance->binary_writer);
+        instance->binary_writer = NULL;
         free(instance->upload_raw);
         instance->upload_raw = NULL;
         flipper_format_file_close(instance->flipper_file);
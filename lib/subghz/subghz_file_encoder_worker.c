@@ -1,4 +1,5 @@
 #include "subghz_file_encoder_worker.h"
+#include "subghz_raw_binary.h"
 
 #include <toolbox/stream/stream.h>
 #include <flipper_format/flipper_format.h>
@@ -22,6 +23,9 @@ struct SubGhzFileEncoderWorker {
     FuriString* str_data;
     FuriString* file_path;
 
+    SubGhzRawBinaryReader* binary_reader;
+    int32_t* binary_data;
+
     SubGhzFileEncoderWorkerCallbackEnd callback_end;
     void* context_end;
 };
@@ -50,7 +54,7 @@ void subghz_file_encoder_worker_add_level_duration(
         instance->level = !instance->level;
         furi_stream_buffer_send(instance->stream, &duration, sizeof(int32_t), 100);
     } else {
-        FURI_LOG_E(TAG, "Invalid level in the stream");
+        FURI_LOG_DEFERRED_E(TAG, "Invalid level in the stream");
     }
 }
 
@@ -79,6 +83,40 @@ bool subghz_file_encoder_worker_data_parse(SubGhzFileEncoderWorker* instance, co
     return res;
 }
 
+static void subghz_file_encoder_worker_add_block(
+    SubGhzFileEncoderWorker* instance,
+    int32_t* durations,
+    size_t count) {
+    // Validate levels in place and send whole block at once
+    size_t valid = 0;
+    for(size_t i = 0; i < count; i++) {
+        int32_t duration = durations[i];
+        if((duration < 0 && !instance->level) || (duration > 0 && instance->level)) {
+            FURI_LOG_DEFERRED_E(TAG, "Invalid level in the stream");
+            continue;
+        }
+        instance->level = !instance->level;
+        durations[valid++] = duration;
+    }
+
+    furi_stream_buffer_send(instance->stream, durations, valid * sizeof(int32_t), 100);
+}
+
+static bool subghz_file_encoder_worker_load(SubGhzFileEncoderWorker* instance, Stream* stream) {
+    if(instance->binary_reader) {
+        size_t count =
+            subghz_raw_binary_reader_read(instance->binary_reader, instance->binary_data);
+        if(!count) return false;
+        subghz_file_encoder_worker_add_block(instance, instance->binary_data, count);
+        return true;
+    }
+
+    if(!stream_read_line(stream, instance->str_data)) return false;
+    furi_string_trim(instance->str_data);
+    return subghz_file_encoder_worker_data_parse(
+        instance, furi_string_get_cstr(instance->str_data));
+}
+
 LevelDuration subghz_file_encoder_worker_get_level_duration(void* context) {
     furi_assert(context);
     SubGhzFileEncoderWorker* instance = context;
@@ -129,6 +167,16 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
 
         //skip the end of the previous line "\n"
         stream_seek(stream, 1, StreamOffsetFromCurrent);
+
+        // Binary data section is marked by its own line, text lines are parsed one by one
+        size_t data_start = stream_tell(stream);
+        if(stream_read_line(stream, instance->str_data) &&
+           furi_string_start_with_str(instance->str_data, SUBGHZ_RAW_BINARY_KEY ":")) {
+            instance->binary_reader = subghz_raw_binary_reader_alloc(stream);
+            instance->binary_data = malloc(SUBGHZ_RAW_BINARY_BLOCK_SIZE * sizeof(int32_t));
+        } else {
+            stream_seek(stream, data_start, StreamOffsetFromStart);
+        }
         res = true;
         instance->worker_stoping = false;
         FURI_LOG_I(TAG, "Start transmission");
@@ -137,14 +185,7 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
     while(res && instance->worker_running) {
         size_t stream_free_byte = furi_stream_buffer_spaces_available(instance->stream);
         if((stream_free_byte / sizeof(int32_t)) >= SUBGHZ_FILE_ENCODER_LOAD) {
-            if(stream_read_line(stream, instance->str_data)) {
-                furi_string_trim(instance->str_data);
-                if(!subghz_file_encoder_worker_data_parse(
-                       instance, furi_string_get_cstr(instance->str_data))) {
-                    subghz_file_encoder_worker_add_level_duration(instance, LEVEL_DURATION_RESET);
-                    break;
-                }
-            } else {
+            if(!subghz_file_encoder_worker_load(instance, stream)) {
                 subghz_file_encoder_worker_add_level_duration(instance, LEVEL_DURATION_RESET);
                 break;
             }
@@ -167,6 +208,12 @@ static int32_t subghz_file_encoder_worker_thread(void* context) {
         }
         furi_delay_ms(50);
     }
+    if(instance->binary_reader) {
+        subghz_raw_binary_reader_free(instance->binary_reader);
+        instance->binary_reader = NULL;
+        free(instance->binary_data);
+        instance->binary_data = NULL;
+    }
     flipper_format_file_close(instance->flipper_format);
 
     FURI_LOG_I(TAG, "Worker stop");
@@ -0,0 +1,362 @@
+#include "subghz_raw_binary.h"
+
+#include <furi.h>
+#include <inttypes.h>
+#include <toolbox/varint.h>
+#include <toolbox/compress.h>
+
+#define TAG "SubGhzRawBinary"
+
+#define SUBGHZ_RAW_BINARY_VARINT_MAX_SIZE (5)
+#define SUBGHZ_RAW_BINARY_PAYLOAD_MAX \
+    (SUBGHZ_RAW_BINARY_BLOCK_SIZE * SUBGHZ_RAW_BINARY_VARINT_MAX_SIZE)
+/* Room for compress header and uncompressed fallback */
+#define SUBGHZ_RAW_BINARY_PACKED_MAX (SUBGHZ_RAW_BINARY_PAYLOAD_MAX + 8)
+#define SUBGHZ_RAW_BINARY_INDEX_MAX (1024)
+
+#define SUBGHZ_RAW_DATA_KEY "RAW_Data:"
+
+struct SubGhzRawBinaryWriter {
+    Stream* stream;
+    size_t data_start;
+    uint32_t blocks;
+
+    Compress* compress;
+    uint8_t* packed;
+    uint8_t payload[SUBGHZ_RAW_BINARY_PAYLOAD_MAX];
+
+    uint32_t* index;
+    size_t index_count;
+    uint8_t index_stride_log;
+};
+
+struct SubGhzRawBinaryReader {
+    Stream* stream;
+    size_t data_start;
+
+    Compress* compress;
+    uint8_t* unpacked;
+    uint8_t payload[SUBGHZ_RAW_BINARY_PACKED_MAX];
+};
+
+SubGhzRawBinaryWriter* subghz_raw_binary_writer_alloc(Stream* stream, bool compress) {
+    furi_assert(stream);
+
+    SubGhzRawBinaryWriter* writer = malloc(sizeof(SubGhzRawBinaryWriter));
+    writer->stream = stream;
+    writer->data_start = stream_tell(stream);
+    writer->index = malloc(SUBGHZ_RAW_BINARY_INDEX_MAX * sizeof(uint32_t));
+
+    if(compress) {
+        writer->compress = compress_alloc(SUBGHZ_RAW_BINARY_PACKED_MAX);
+        writer->packed = malloc(SUBGHZ_RAW_BINARY_PACKED_MAX);
+    }
+
+    return writer;
+}
+
+void subghz_raw_binary_writer_free(SubGhzRawBinaryWriter* writer) {
+    furi_assert(writer);
+
+    if(writer->compress) {
+        compress_free(writer->compress);
+        free(writer->packed);
+    }
+    free(writer->index);
+    free(writer);
+}
+
+static void subghz_raw_binary_writer_index(SubGhzRawBinaryWriter* writer, uint32_t offset) {
+    uint32_t stride_mask = (1UL << writer->index_stride_log) - 1;
+    if(writer->blocks & stride_mask) return;
+
+    if(writer->index_count == SUBGHZ_RAW_BINARY_INDEX_MAX) {
+        // Index is full: keep every other entry and double the stride
+        for(size_t i = 0; i < SUBGHZ_RAW_BINARY_INDEX_MAX / 2; i++) {
+            writer->index[i] = writer->index[i * 2];
+        }
+        writer->index_count = SUBGHZ_RAW_BINARY_INDEX_MAX / 2;
+        writer->index_stride_log++;
+        if(writer->blocks & ((stride_mask << 1) | 1)) return;
+    }
+
+    writer->index[writer->index_count++] = offset;
+}
+
+bool subghz_raw_binary_writer_write(
+    SubGhzRawBinaryWriter* writer,
+    const int32_t* durations,
+    size_t count) {
+    furi_assert(writer);
+    furi_assert(durations);
+    furi_assert(count && count <= SUBGHZ_RAW_BINARY_BLOCK_SIZE);
+
+    size_t size = 0;
+    for(size_t i = 0; i < count; i++) {
+        size += varint_int32_pack(durations[i], &writer->payload[size]);
+    }
+
+    SubGhzRawBinaryBlock block = {
+        .magic = SUBGHZ_RAW_BINARY_BLOCK_MAGIC,
+        .count = count,
+        .size = size,
+    };
+    const uint8_t* payload = writer->payload;
+
+    if(writer->compress) {
+        // Plain payload is kept when compressor falls back to raw copy
+        size_t packed_size = 0;
+        if(compress_encode(
+               writer->compress,
+               writer->payload,
+               size,
+               writer->packed,
+               SUBGHZ_RAW_BINARY_PACKED_MAX,
+               &packed_size) &&
+           writer->packed[0]) {
+            block.flags |= SubGhzRawBinaryFlagCompressed;
+            block.size = packed_size;
+            payload = writer->packed;
+        }
+    }
+
+    uint32_t offset = stream_tell(writer->stream) - writer->data_start;
+    if(stream_write(writer->stream, (const uint8_t*)&block, sizeof(block)) != sizeof(block)) {
+        return false;
+    }
+    if(stream_write(writer->stream, payload, block.size) != block.size) {
+        return false;
+    }
+
+    subghz_raw_binary_writer_index(writer, offset);
+    writer->blocks++;
+
+    return true;
+}
+
+bool subghz_raw_binary_writer_finish(SubGhzRawBinaryWriter* writer) {
+    furi_assert(writer);
+
+    SubGhzRawBinaryBlock block = {
+        .magic = SUBGHZ_RAW_BINARY_BLOCK_MAGIC,
+        .flags = SubGhzRawBinaryFlagIndex,
+        .stride_log = writer->index_stride_log,
+        .count = writer->index_count,
+        .size = writer->index_count * sizeof(uint32_t),
+    };
+    SubGhzRawBinaryTrailer trailer = {
+        .index_offset = stream_tell(writer->stream) - writer->data_start,
+        .magic = SUBGHZ_RAW_BINARY_TRAILER_MAGIC,
+    };
+
+    bool success = false;
+    do {
+        if(stream_write(writer->stream, (const uint8_t*)&block, sizeof(block)) != sizeof(block))
+            break;
+        if(stream_write(writer->stream, (const uint8_t*)writer->index, block.size) != block.size)
+            break;
+        if(stream_write(writer->stream, (const uint8_t*)&trailer, sizeof(trailer)) !=
+           sizeof(trailer))
+            break;
+        success = true;
+    } while(false);
+
+    return success;
+}
+
+SubGhzRawBinaryReader* subghz_raw_binary_reader_alloc(Stream* stream) {
+    furi_assert(stream);
+
+    SubGhzRawBinaryReader* reader = malloc(sizeof(SubGhzRawBinaryReader));
+    reader->stream = stream;
+    reader->data_start = stream_tell(stream);
+
+    return reader;
+}
+
+void subghz_raw_binary_reader_free(SubGhzRawBinaryReader* reader) {
+    furi_assert(reader);
+
+    if(reader->compress) {
+        compress_free(reader->compress);
+        free(reader->unpacked);
+    }
+    free(reader);
+}
+
+size_t subghz_raw_binary_reader_read(SubGhzRawBinaryReader* reader, int32_t* durations) {
+    furi_assert(reader);
+    furi_assert(durations);
+
+    SubGhzRawBinaryBlock block;
+    if(stream_read(reader->stream, (uint8_t*)&block, sizeof(block)) != sizeof(block)) return 0;
+    if(block.magic != SUBGHZ_RAW_BINARY_BLOCK_MAGIC || (block.flags & SubGhzRawBinaryFlagIndex) ||
+       block.count > SUBGHZ_RAW_BINARY_BLOCK_SIZE || block.size > SUBGHZ_RAW_BINARY_PACKED_MAX) {
+        return 0;
+    }
+    if(stream_read(reader->stream, reader->payload, block.size) != block.size) return 0;
+
+    const uint8_t* payload = reader->payload;
+    size_t size = block.size;
+
+    if(block.flags & SubGhzRawBinaryFlagCompressed) {
+        if(!reader->compress) {
+            reader->compress = compress_alloc(SUBGHZ_RAW_BINARY_PACKED_MAX);
+            reader->unpacked = malloc(SUBGHZ_RAW_BINARY_PACKED_MAX);
+        }
+        if(!compress_decode(
+               reader->compress,
+               reader->payload,
+               block.size,
+               reader->unpacked,
+               SUBGHZ_RAW_BINARY_PAYLOAD_MAX,
+               &size)) {
+            FURI_LOG_E(TAG, "Decompression failed");
+            return 0;
+        }
+        payload = reader->unpacked;
+    }
+
+    size_t offset = 0;
+    for(size_t i = 0; i < block.count; i++) {
+        if(offset >= size) return 0;
+        offset += varint_int32_unpack(&durations[i], &payload[offset], size - offset);
+    }
+
+    return block.count;
+}
+
+bool subghz_raw_binary_reader_seek(SubGhzRawBinaryReader* reader, size_t block_number) {
+    furi_assert(reader);
+
+    bool success = false;
+    do {
+        SubGhzRawBinaryTrailer trailer;
+        if(!stream_seek(reader->stream, -(int32_t)sizeof(trailer), StreamOffsetFromEnd)) break;
+        if(stream_read(reader->stream, (uint8_t*)&trailer, sizeof(trailer)) != sizeof(trailer))
+            break;
+        if(trailer.magic != SUBGHZ_RAW_BINARY_TRAILER_MAGIC) break;
+
+        SubGhzRawBinaryBlock block;
+        if(!stream_seek(
+               reader->stream, reader->data_start + trailer.index_offset, StreamOffsetFromStart))
+            break;
+        if(stream_read(reader->stream, (uint8_t*)&block, sizeof(block)) != sizeof(block)) break;
+        if(block.magic != SUBGHZ_RAW_BINARY_BLOCK_MAGIC ||
+           !(block.flags & SubGhzRawBinaryFlagIndex))
+            break;
+
+        size_t entry = block_number >> block.stride_log;
+        if(entry >= block.count) break;
+
+        uint32_t offset;
+        if(!stream_seek(reader->stream, entry * sizeof(uint32_t), StreamOffsetFromCurrent)) break;
+        if(stream_read(reader->stream, (uint8_t*)&offset, sizeof(offset)) != sizeof(offset))
+            break;
+        if(!stream_seek(reader->stream, reader->data_start + offset, StreamOffsetFromStart)) break;
+
+        // Walk block headers from indexed block to the requested one
+        success = true;
+        for(size_t i = entry << block.stride_log; i < block_number; i++) {
+            if(stream_read(reader->stream, (uint8_t*)&block, sizeof(block)) != sizeof(block) ||
+               block.magic != SUBGHZ_RAW_BINARY_BLOCK_MAGIC ||
+               (block.flags & SubGhzRawBinaryFlagIndex) ||
+               !stream_seek(reader->stream, block.size, StreamOffsetFromCurrent)) {
+                success = false;
+                break;
+            }
+        }
+    } while(false);
+
+    return success;
+}
+
+static bool subghz_raw_binary_parse_text(const char* line, int32_t* durations, size_t* count) {
+    const char* str = line + strlen(SUBGHZ_RAW_DATA_KEY);
+    char* end;
+
+    while(*count < SUBGHZ_RAW_BINARY_BLOCK_SIZE) {
+        int32_t duration = strtol(str, &end, 10);
+        if(end == str) break;
+        durations[(*count)++] = duration;
+        str = end;
+    }
+
+    // Longer lines are not produced by firmware
+    return *count < SUBGHZ_RAW_BINARY_BLOCK_SIZE || *str == '\n' || *str == '\0';
+}
+
+static bool subghz_raw_binary_write_text(Stream* stream, const int32_t* durations, size_t count) {
+    if(!stream_write_cstring(stream, SUBGHZ_RAW_DATA_KEY)) return false;
+    for(size_t i = 0; i < count; i++) {
+        if(!stream_write_format(stream, " %" PRIi32, durations[i])) return false;
+    }
+    return stream_write_char(stream, '\n') == 1;
+}
+
+bool subghz_raw_binary_convert(Stream* source, Stream* destination, bool binary, bool compress) {
+    furi_assert(source);
+    furi_assert(destination);
+
+    FuriString* line = furi_string_alloc();
+    int32_t* durations = malloc(SUBGHZ_RAW_BINARY_BLOCK_SIZE * sizeof(int32_t));
+    SubGhzRawBinaryWriter* writer = NULL;
+    SubGhzRawBinaryReader* reader = NULL;
+    bool success = false;
+
+    do {
+        // Copy text header up to the data section
+        bool data = false;
+        bool error = false;
+        while(stream_read_line(source, line)) {
+            if(furi_string_start_with_str(line, SUBGHZ_RAW_DATA_KEY)) {
+                data = true;
+                break;
+            } else if(furi_string_start_with_str(line, SUBGHZ_RAW_BINARY_KEY ":")) {
+                reader = subghz_raw_binary_reader_alloc(source);
+                data = true;
+                break;
+            }
+            if(stream_write_string(destination, line) != furi_string_size(line)) {
+                error = true;
+                break;
+            }
+        }
+        if(error || !data) break;
+
+        if(binary) {
+            if(!stream_write_format(
+                   destination, "%s: %d\n", SUBGHZ_RAW_BINARY_KEY, SUBGHZ_RAW_BINARY_VERSION))
+                break;
+            writer = subghz_raw_binary_writer_alloc(destination, compress);
+        }
+
+        while(!error) {
+            size_t count = 0;
+            if(reader) {
+                count = subghz_raw_binary_reader_read(reader, durations);
+            } else if(furi_string_start_with_str(line, SUBGHZ_RAW_DATA_KEY)) {
+                error = !subghz_raw_binary_parse_text(
+                    furi_string_get_cstr(line), durations, &count);
+                if(!stream_read_line(source, line)) furi_string_reset(line);
+            }
+            if(!count) break;
+
+            if(writer) {
+                error = !subghz_raw_binary_writer_write(writer, durations, count);
+            } else {
+                error = !subghz_raw_binary_write_text(destination, durations, count);
+            }
+        }
+        if(error) break;
+
+        success = writer ? subghz_raw_binary_writer_finish(writer) : true;
+    } while(false);
+
+    if(writer) subghz_raw_binary_writer_free(writer);
+    if(reader) subghz_raw_binary_reader_free(reader);
+    free(durations);
+    furi_string_free(line);
+
+    return success;
+}
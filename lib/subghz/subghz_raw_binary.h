@@ -0,0 +1,146 @@
+/**
+ * @file subghz_raw_binary.h
+ * Binary data section of SubGhz RAW file.
+ *
+ * RAW file keeps its text header, but instead of `RAW_Data:` lines the
+ * data section starts after `RAW_Binary: 1` line and runs till EOF:
+ *
+ *  SubGhzRawBinaryBlock + payload, repeated
+ *  SubGhzRawBinaryBlock with SubGhzRawBinaryFlagIndex + uint32_t offsets[count]
+ *  SubGhzRawBinaryTrailer
+ *
+ * Payload is zig-zag varints of signed durations, sign is the level as in
+ * `RAW_Data`. Payload is optionally compressed with toolbox compress.
+ * Index holds offsets of every 2^stride_log block, relative to the data
+ * section start, so long captures keep it bounded.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <toolbox/stream/stream.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SUBGHZ_RAW_BINARY_KEY "RAW_Binary"
+#define SUBGHZ_RAW_BINARY_VERSION (1)
+
+#define SUBGHZ_RAW_BINARY_BLOCK_MAGIC (0x4252U) /* "RB" */
+#define SUBGHZ_RAW_BINARY_TRAILER_MAGIC (0x58444952UL) /* "RIDX" */
+/** Maximum amount of durations in one block */
+#define SUBGHZ_RAW_BINARY_BLOCK_SIZE (512)
+
+typedef enum {
+    SubGhzRawBinaryFlagCompressed = (1 << 0),
+    SubGhzRawBinaryFlagIndex = (1 << 1),
+} SubGhzRawBinaryFlag;
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint16_t magic;
+    uint8_t flags;
+    uint8_t stride_log; /* index only */
+    uint16_t count; /* durations, offsets for index */
+    uint16_t size; /* payload size */
+} SubGhzRawBinaryBlock;
+_Static_assert(sizeof(SubGhzRawBinaryBlock) == 8, "Incorrect SubGhzRawBinaryBlock size");
+
+typedef struct {
+    uint32_t index_offset;
+    uint32_t magic;
+} SubGhzRawBinaryTrailer;
+_Static_assert(sizeof(SubGhzRawBinaryTrailer) == 8, "Incorrect SubGhzRawBinaryTrailer size");
+
+#pragma pack(pop)
+
+typedef struct SubGhzRawBinaryWriter SubGhzRawBinaryWriter;
+
+typedef struct SubGhzRawBinaryReader SubGhzRawBinaryReader;
+
+/** Allocate writer, data section starts at current stream position
+ *
+ * @param      stream    Stream instance, must outlive writer
+ * @param      compress  compress blocks
+ *
+ * @return     SubGhzRawBinaryWriter instance
+ */
+SubGhzRawBinaryWriter* subghz_raw_binary_writer_alloc(Stream* stream, bool compress);
+
+/** Free writer, subghz_raw_binary_writer_finish must be called before
+ *
+ * @param      writer  SubGhzRawBinaryWriter instance
+ */
+void subghz_raw_binary_writer_free(SubGhzRawBinaryWriter* writer);
+
+/** Write block of durations
+ *
+ * @param      writer     SubGhzRawBinaryWriter instance
+ * @param      durations  signed durations, level is the sign
+ * @param      count      amount of durations, 1..SUBGHZ_RAW_BINARY_BLOCK_SIZE
+ *
+ * @return     true on success
+ */
+bool subghz_raw_binary_writer_write(
+    SubGhzRawBinaryWriter* writer,
+    const int32_t* durations,
+    size_t count);
+
+/** Write index and trailer
+ *
+ * @param      writer  SubGhzRawBinaryWriter instance
+ *
+ * @return     true on success
+ */
+bool subghz_raw_binary_writer_finish(SubGhzRawBinaryWriter* writer);
+
+/** Allocate reader, data section starts at current stream position
+ *
+ * @param      stream  Stream instance, must outlive reader
+ *
+ * @return     SubGhzRawBinaryReader instance
+ */
+SubGhzRawBinaryReader* subghz_raw_binary_reader_alloc(Stream* stream);
+
+/** Free reader
+ *
+ * @param      reader  SubGhzRawBinaryReader instance
+ */
+void subghz_raw_binary_reader_free(SubGhzRawBinaryReader* reader);
+
+/** Read next block
+ *
+ * @param      reader     SubGhzRawBinaryReader instance
+ * @param      durations  destination for SUBGHZ_RAW_BINARY_BLOCK_SIZE durations
+ *
+ * @return     amount of durations, 0 at the end of data or on error
+ */
+size_t subghz_raw_binary_reader_read(SubGhzRawBinaryReader* reader, int32_t* durations);
+
+/** Seek to block using index
+ *
+ * @param      reader  SubGhzRawBinaryReader instance
+ * @param      block   block number
+ *
+ * @return     true on success, false if file has no index or block is out of range
+ */
+bool subghz_raw_binary_reader_seek(SubGhzRawBinaryReader* reader, size_t block);
+
+/** Convert data section of RAW file between text and binary forms.
+ * Text header is copied as is.
+ *
+ * @param      source       source RAW file stream, at the beginning
+ * @param      destination  destination stream, at the beginning
+ * @param      binary       write binary form, text otherwise
+ * @param      compress     compress binary blocks
+ *
+ * @return     true on success
+ */
+bool subghz_raw_binary_convert(Stream* source, Stream* destination, bool binary, bool compress);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,9 +4,13 @@
 
 #define TAG "SubGhzWorker"
 
+#define SUBGHZ_WORKER_RING_SIZE (4096)
+#define SUBGHZ_WORKER_RING_WATERMARK (64)
+#define SUBGHZ_WORKER_RING_TIMEOUT (10)
+
 struct SubGhzWorker {
     FuriThread* thread;
-    FuriStreamBuffer* stream;
+    FuriSpscRing* ring;
 
     volatile bool running;
     volatile bool overrun;
@@ -33,9 +37,32 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
         instance->overrun = false;
         level_duration = level_duration_reset();
     }
-    size_t ret =
-        furi_stream_buffer_send(instance->stream, &level_duration, sizeof(LevelDuration), 0);
-    if(sizeof(LevelDuration) != ret) instance->overrun = true;
+    if(!furi_spsc_ring_push(instance->ring, &level_duration)) instance->overrun = true;
+}
+
+static void subghz_worker_process(SubGhzWorker* instance, LevelDuration level_duration) {
+    if(level_duration_is_reset(level_duration)) {
+        FURI_LOG_DEFERRED_E(TAG, "Overrun buffer");
+        if(instance->overrun_callback) instance->overrun_callback(instance->context);
+    } else {
+        bool level = level_duration_get_level(level_duration);
+        uint32_t duration = level_duration_get_duration(level_duration);
+
+        if((duration < instance->filter_duration) ||
+           (instance->filter_level_duration.level == level)) {
+            instance->filter_level_duration.duration += duration;
+
+        } else if(instance->filter_level_duration.level != level) {
+            if(instance->pair_callback)
+                instance->pair_callback(
+                    instance->context,
+                    instance->filter_level_duration.level,
+                    instance->filter_level_duration.duration);
+
+            instance->filter_level_duration.duration = duration;
+            instance->filter_level_duration.level = level;
+        }
+    }
 }
 
 /** Worker callback thread
@@ -46,33 +73,16 @@ void subghz_worker_rx_callback(bool level, uint32_t duration, void* context) {
 static int32_t subghz_worker_thread_callback(void* context) {
     SubGhzWorker* instance = context;
 
-    LevelDuration level_duration;
+    const LevelDuration* level_duration;
+    size_t count;
     while(instance->running) {
-        int ret = furi_stream_buffer_receive(
-            instance->stream, &level_duration, sizeof(LevelDuration), 10);
-        if(ret == sizeof(LevelDuration)) {
-            if(level_duration_is_reset(level_duration)) {
-                FURI_LOG_E(TAG, "Overrun buffer");
-                if(instance->overrun_callback) instance->overrun_callback(instance->context);
-            } else {
-                bool level = level_duration_get_level(level_duration);
-                uint32_t duration = level_duration_get_duration(level_duration);
-
-                if((duration < instance->filter_duration) ||
-                   (instance->filter_level_duration.level == level)) {
-                    instance->filter_level_duration.duration += duration;
-
-                } else if(instance->filter_level_duration.level != level) {
-                    if(instance->pair_callback)
-                        instance->pair_callback(
-                            instance->context,
-                            instance->filter_level_duration.level,
-                            instance->filter_level_duration.duration);
-
-                    instance->filter_level_duration.duration = duration;
-                    instance->filter_level_duration.level = level;
-                }
+        furi_spsc_ring_wait(instance->ring, SUBGHZ_WORKER_RING_TIMEOUT);
+        // Drain everything in place, producer keeps filling the ring meanwhile
+        while((count = furi_spsc_ring_peek(instance->ring, (const void**)&level_duration))) {
+            for(size_t i = 0; i < count; i++) {
+                subghz_worker_process(instance, level_duration[i]);
             }
+            furi_spsc_ring_release(instance->ring, count);
         }
     }
 
@@ -85,8 +95,8 @@ SubGhzWorker* subghz_worker_alloc() {
     instance->thread =
         furi_thread_alloc_ex("SubGhzWorker", 2048, subghz_worker_thread_callback, instance);
 
-    instance->stream =
-        furi_stream_buffer_alloc(sizeof(LevelDuration) * 4096, sizeof(LevelDuration));
+    instance->ring = furi_spsc_ring_alloc(
+        sizeof(LevelDuration), SUBGHZ_WORKER_RING_SIZE, SUBGHZ_WORKER_RING_WATERMARK);
 
     //setting default filter in us
     instance->filter_duration = 30;
@@ -97,7 +107,7 @@ SubGhzWorker* subghz_worker_alloc() {
 void subghz_worker_free(SubGhzWorker* instance) {
     furi_assert(instance);
 
-    furi_stream_buffer_free(instance->stream);
+    furi_spsc_ring_free(instance->ring);
     furi_thread_free(instance->thread);
 
     free(instance);
@@ -125,6 +135,7 @@ void subghz_worker_start(SubGhzWorker* instance) {
     furi_assert(!instance->running);
 
     instance->running = true;
+    furi_spsc_ring_reset_stats(instance->ring);
 
     furi_thread_start(instance->thread);
 }
@@ -136,6 +147,11 @@ void subghz_worker_stop(SubGhzWorker* instance) {
     instance->running = false;
 
     furi_thread_join(instance->thread);
+    furi_spsc_ring_flush(instance->ring);
+
+    FuriSpscRingStats stats;
+    furi_spsc_ring_get_stats(instance->ring, &stats);
+    FURI_LOG_D(TAG, "Overruns %lu, high water %zu", stats.overruns, stats.high_water);
 }
 
 bool subghz_worker_is_running(SubGhzWorker* instance) {
@@ -146,4 +162,9 @@ bool subghz_worker_is_running(SubGhzWorker* instance) {
 void subghz_worker_set_filter(SubGhzWorker* instance, uint16_t timeout) {
     furi_assert(instance);
     instance->filter_duration = timeout;
-}
\ No newline at end of file
+}
+
+void subghz_worker_get_stats(SubGhzWorker* instance, FuriSpscRingStats* stats) {
+    furi_assert(instance);
+    furi_spsc_ring_get_stats(instance->ring, stats);
+}
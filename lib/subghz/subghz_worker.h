@@ -1,5 +1,6 @@
 #pragma once
 
+#include <furi.h>
 #include <furi_hal.h>
 
 #ifdef __cplusplus
@@ -75,6 +76,13 @@ bool subghz_worker_is_running(SubGhzWorker* instance);
  */
 void subghz_worker_set_filter(SubGhzWorker* instance, uint16_t timeout);
 
+/** 
+ * Get edge ring counters: dropped edges and maximum fill level.
+ * @param instance Pointer to a SubGhzWorker instance
+ * @param stats counters destination
+ */
+void subghz_worker_get_stats(SubGhzWorker* instance, FuriSpscRingStats* stats);
+
 #ifdef __cplusplus
 }
 #endif
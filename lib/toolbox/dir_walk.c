@@ -1,6 +1,9 @@
 #include "dir_walk.h"
 #include <m-list.h>
 
+#define DIR_WALK_BATCH_SIZE 1024
+#define DIR_WALK_PENDING_SIZE_MIN 256
+
 LIST_DEF(DirIndexList, uint32_t);
 
 struct DirWalk {
@@ -11,6 +14,15 @@ struct DirWalk {
     bool recursive;
     DirWalkFilterCb filter_cb;
     void* filter_context;
+
+    // Batch mode: entries of the open directory and paths of directories to walk later
+    uint8_t* batch;
+    uint16_t batch_used;
+    uint16_t batch_offset;
+    char* pending;
+    size_t pending_used;
+    size_t pending_capacity;
+    FS_Error error;
 };
 
 DirWalk* dir_walk_alloc(Storage* storage) {
@@ -18,12 +30,23 @@ DirWalk* dir_walk_alloc(Storage* storage) {
     dir_walk->path = furi_string_alloc();
     dir_walk->file = storage_file_alloc(storage);
     DirIndexList_init(dir_walk->index_list);
+    dir_walk->current_index = 0;
     dir_walk->recursive = true;
     dir_walk->filter_cb = NULL;
+    dir_walk->filter_context = NULL;
+    dir_walk->batch = NULL;
+    dir_walk->batch_used = 0;
+    dir_walk->batch_offset = 0;
+    dir_walk->pending = NULL;
+    dir_walk->pending_used = 0;
+    dir_walk->pending_capacity = 0;
+    dir_walk->error = FSE_OK;
     return dir_walk;
 }
 
 void dir_walk_free(DirWalk* dir_walk) {
+    free(dir_walk->batch);
+    free(dir_walk->pending);
     storage_file_free(dir_walk->file);
     furi_string_free(dir_walk->path);
     DirIndexList_clear(dir_walk->index_list);
@@ -42,6 +65,10 @@ void dir_walk_set_filter_cb(DirWalk* dir_walk, DirWalkFilterCb cb, void* context
 bool dir_walk_open(DirWalk* dir_walk, const char* path) {
     furi_string_set(dir_walk->path, path);
     dir_walk->current_index = 0;
+    dir_walk->batch_used = 0;
+    dir_walk->batch_offset = 0;
+    dir_walk->pending_used = 0;
+    dir_walk->error = FSE_OK;
     return storage_dir_open(dir_walk->file, path);
 }
 
@@ -139,6 +166,9 @@ static DirWalkResult
 }
 
 FS_Error dir_walk_get_error(DirWalk* dir_walk) {
+    if(dir_walk->error != FSE_OK) {
+        return dir_walk->error;
+    }
     return storage_file_get_error(dir_walk->file);
 }
 
@@ -146,6 +176,112 @@ DirWalkResult dir_walk_read(DirWalk* dir_walk, FuriString* return_path, FileInfo
     return dir_walk_iter(dir_walk, return_path, fileinfo);
 }
 
+static void dir_walk_pending_push(DirWalk* dir_walk, const char* name) {
+    size_t path_size = furi_string_size(dir_walk->path);
+    size_t name_size = strlen(name) + 1;
+    size_t size = path_size + 1 + name_size;
+
+    if(dir_walk->pending_used + size > dir_walk->pending_capacity) {
+        dir_walk->pending_capacity = MAX(
+            MAX(dir_walk->pending_capacity * 2, dir_walk->pending_used + size),
+            (size_t)DIR_WALK_PENDING_SIZE_MIN);
+        dir_walk->pending = realloc(dir_walk->pending, dir_walk->pending_capacity); //-V701
+    }
+
+    char* pending = &dir_walk->pending[dir_walk->pending_used];
+    memcpy(pending, furi_string_get_cstr(dir_walk->path), path_size);
+    pending[path_size] = '/';
+    memcpy(&pending[path_size + 1], name, name_size);
+    dir_walk->pending_used += size;
+}
+
+static bool dir_walk_pending_pop(DirWalk* dir_walk) {
+    if(dir_walk->pending_used == 0) {
+        return false;
+    }
+
+    // Paths are zero terminated, the last one starts after the previous terminator
+    size_t start = dir_walk->pending_used - 1;
+    while(start > 0 && dir_walk->pending[start - 1] != '\0') {
+        start--;
+    }
+
+    furi_string_set(dir_walk->path, &dir_walk->pending[start]);
+    dir_walk->pending_used = start;
+    return true;
+}
+
+static bool dir_walk_batch_fill(DirWalk* dir_walk) {
+    dir_walk->batch_offset = 0;
+    dir_walk->batch_used =
+        storage_dir_read_batch(dir_walk->file, dir_walk->batch, DIR_WALK_BATCH_SIZE);
+    return dir_walk->batch_used > 0;
+}
+
+DirWalkResult
+    dir_walk_read_batch(DirWalk* dir_walk, void* arena, size_t arena_size, size_t* used) {
+    furi_assert(((uintptr_t)arena % _Alignof(DirWalkEntry)) == 0);
+    const size_t align = _Alignof(DirWalkEntry);
+    *used = 0;
+
+    // Last directory is closed when the walk is over
+    if(!storage_file_is_open(dir_walk->file)) {
+        return DirWalkLast;
+    }
+
+    if(dir_walk->batch == NULL) {
+        dir_walk->batch = malloc(DIR_WALK_BATCH_SIZE);
+    }
+
+    while(true) {
+        if(dir_walk->batch_offset == dir_walk->batch_used && !dir_walk_batch_fill(dir_walk)) {
+            if(storage_file_get_error(dir_walk->file) != FSE_NOT_EXIST) {
+                return DirWalkError;
+            }
+
+            // Directory is over, go on with the next one
+            storage_dir_close(dir_walk->file);
+            if(!dir_walk_pending_pop(dir_walk)) {
+                return (*used > 0) ? DirWalkOK : DirWalkLast;
+            }
+            if(!storage_dir_open(dir_walk->file, furi_string_get_cstr(dir_walk->path))) {
+                return DirWalkError;
+            }
+            continue;
+        }
+
+        StorageDirEntry* entry = (StorageDirEntry*)&dir_walk->batch[dir_walk->batch_offset];
+        if(dir_walk_filter(dir_walk, entry->name, &entry->fileinfo)) {
+            size_t path_size = furi_string_size(dir_walk->path);
+            size_t name_size = strlen(entry->name) + 1;
+            size_t size = offsetof(DirWalkEntry, path) + path_size + 1 + name_size;
+            size = (size + align - 1) / align * align;
+
+            if(size > arena_size - *used) {
+                if(*used == 0) {
+                    dir_walk->error = FSE_INVALID_NAME;
+                    return DirWalkError;
+                }
+                // Entry stays in the batch for the next call
+                return DirWalkOK;
+            }
+
+            DirWalkEntry* walk_entry = (DirWalkEntry*)((uint8_t*)arena + *used);
+            walk_entry->fileinfo = entry->fileinfo;
+            walk_entry->size = size;
+            memcpy(walk_entry->path, furi_string_get_cstr(dir_walk->path), path_size);
+            walk_entry->path[path_size] = '/';
+            memcpy(&walk_entry->path[path_size + 1], entry->name, name_size);
+            *used += size;
+        }
+
+        if(file_info_is_dir(&entry->fileinfo) && dir_walk->recursive) {
+            dir_walk_pending_push(dir_walk, entry->name);
+        }
+        dir_walk->batch_offset += entry->size;
+    }
+}
+
 void dir_walk_close(DirWalk* dir_walk) {
     if(storage_file_is_open(dir_walk->file)) {
         storage_dir_close(dir_walk->file);
@@ -154,4 +290,7 @@ void dir_walk_close(DirWalk* dir_walk) {
     DirIndexList_reset(dir_walk->index_list);
     furi_string_reset(dir_walk->path);
     dir_walk->current_index = 0;
+    dir_walk->batch_used = 0;
+    dir_walk->batch_offset = 0;
+    dir_walk->pending_used = 0;
 }
@@ -15,6 +15,13 @@ typedef enum {
 
 typedef bool (*DirWalkFilterCb)(const char* name, FileInfo* fileinfo, void* ctx);
 
+/** Entry placed by dir_walk_read_batch */
+typedef struct {
+    FileInfo fileinfo;
+    uint16_t size; /**< record size, the next record starts right after it */
+    char path[]; /**< zero terminated full path */
+} DirWalkEntry;
+
 /**
  * Allocate DirWalk
  * @param storage 
@@ -68,6 +75,23 @@ FS_Error dir_walk_get_error(DirWalk* dir_walk);
  */
 DirWalkResult dir_walk_read(DirWalk* dir_walk, FuriString* return_path, FileInfo* fileinfo);
 
+/**
+ * Read next elements into caller memory, as many as fit
+ * 
+ * Directory is read with a few storage requests, subdirectories are walked after
+ * the directory they are in, so only one directory is open at a time.
+ * A directory always comes before its content, otherwise the order is not defined.
+ * Filter and recursive mode apply. Don't mix with dir_walk_read on the same walk.
+ * 
+ * @param dir_walk 
+ * @param arena memory for DirWalkEntry records, aligned like DirWalkEntry
+ * @param arena_size memory size, must fit the longest path
+ * @param used bytes of the memory used by records
+ * @return DirWalkResult DirWalkOK if there are records, DirWalkLast if the walk is over
+ */
+DirWalkResult
+    dir_walk_read_batch(DirWalk* dir_walk, void* arena, size_t arena_size, size_t* used);
+
 /**
  * Close directory
  * @param dir_walk 
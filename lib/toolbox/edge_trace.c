@@ -0,0 +1,179 @@
+#include "edge_trace.h"
+#include "varint.h"
+
+#include <furi.h>
+#include <m-array.h>
+
+#define EDGE_TRACE_MAGIC (0x43525445UL) /* "ETRC" */
+#define EDGE_TRACE_VERSION (1)
+#define EDGE_TRACE_VARINT_MAX_SIZE (5)
+#define EDGE_TRACE_IO_BUFFER_SIZE (128)
+#define EDGE_TRACE_RESERVE_MAX (4096)
+
+ARRAY_DEF(EdgeTraceArray, uint32_t, M_POD_OPLIST);
+
+struct EdgeTrace {
+    EdgeTraceArray_t edges;
+};
+
+#pragma pack(push, 1)
+
+typedef struct {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t count;
+} EdgeTraceHeader;
+_Static_assert(sizeof(EdgeTraceHeader) == 12, "Incorrect EdgeTraceHeader size");
+
+#pragma pack(pop)
+
+EdgeTrace* edge_trace_alloc() {
+    EdgeTrace* trace = malloc(sizeof(EdgeTrace));
+    EdgeTraceArray_init(trace->edges);
+    return trace;
+}
+
+void edge_trace_free(EdgeTrace* trace) {
+    furi_assert(trace);
+    EdgeTraceArray_clear(trace->edges);
+    free(trace);
+}
+
+void edge_trace_reset(EdgeTrace* trace) {
+    furi_assert(trace);
+    EdgeTraceArray_reset(trace->edges);
+}
+
+void edge_trace_push(EdgeTrace* trace, bool level, uint32_t duration) {
+    furi_assert(trace);
+    duration = MIN(duration, EDGE_TRACE_MAX_DURATION);
+    EdgeTraceArray_push_back(trace->edges, (duration << 1) | (level ? 1 : 0));
+}
+
+size_t edge_trace_get_count(const EdgeTrace* trace) {
+    furi_assert(trace);
+    return EdgeTraceArray_size(trace->edges);
+}
+
+LevelDuration edge_trace_get(const EdgeTrace* trace, size_t index) {
+    furi_assert(trace);
+    uint32_t edge = *EdgeTraceArray_cget(trace->edges, index);
+    return level_duration_make(edge & 1, edge >> 1);
+}
+
+/* Unlike varint_uint32_unpack, never reads past the buffer
+ * and rejects values longer than 5 bytes */
+static size_t edge_trace_unpack(uint32_t* value, const uint8_t* data, size_t size) {
+    uint32_t parsed = 0;
+    size = MIN(size, (size_t)EDGE_TRACE_VARINT_MAX_SIZE);
+
+    for(size_t i = 0; i < size; i++) {
+        parsed |= (data[i] & 0x7FUL) << (7 * i);
+        if(!(data[i] & 0x80)) {
+            *value = parsed;
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+size_t edge_trace_parse(EdgeTrace* trace, const uint8_t* data, size_t size) {
+    furi_assert(trace);
+    size_t count = 0;
+
+    while(size) {
+        uint32_t edge;
+        size_t consumed = edge_trace_unpack(&edge, data, size);
+        if(!consumed) break;
+
+        edge_trace_push(trace, edge & 1, edge >> 1);
+        data += consumed;
+        size -= consumed;
+        count++;
+    }
+
+    return count;
+}
+
+bool edge_trace_save(const EdgeTrace* trace, Stream* stream) {
+    furi_assert(trace);
+    furi_assert(stream);
+
+    EdgeTraceHeader header = {
+        .magic = EDGE_TRACE_MAGIC,
+        .version = EDGE_TRACE_VERSION,
+        .count = EdgeTraceArray_size(trace->edges),
+    };
+
+    if(stream_write(stream, (const uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    uint8_t buffer[EDGE_TRACE_IO_BUFFER_SIZE];
+    size_t buffer_used = 0;
+    bool success = true;
+
+    for(size_t i = 0; i < header.count; i++) {
+        if(buffer_used + EDGE_TRACE_VARINT_MAX_SIZE > sizeof(buffer)) {
+            success = (stream_write(stream, buffer, buffer_used) == buffer_used);
+            if(!success) break;
+            buffer_used = 0;
+        }
+        buffer_used +=
+            varint_uint32_pack(*EdgeTraceArray_cget(trace->edges, i), &buffer[buffer_used]);
+    }
+
+    if(success && buffer_used) {
+        success = (stream_write(stream, buffer, buffer_used) == buffer_used);
+    }
+
+    return success;
+}
+
+bool edge_trace_load(EdgeTrace* trace, Stream* stream) {
+    furi_assert(trace);
+    furi_assert(stream);
+
+    edge_trace_reset(trace);
+
+    EdgeTraceHeader header;
+    if(stream_read(stream, (uint8_t*)&header, sizeof(header)) != sizeof(header)) return false;
+    if(header.magic != EDGE_TRACE_MAGIC || header.version != EDGE_TRACE_VERSION) return false;
+
+    /* count is not trusted, array grows on demand past this point */
+    EdgeTraceArray_reserve(trace->edges, MIN(header.count, (uint32_t)EDGE_TRACE_RESERVE_MAX));
+
+    uint8_t buffer[EDGE_TRACE_IO_BUFFER_SIZE];
+    size_t buffer_used = 0;
+    size_t parsed = 0;
+
+    while(parsed < header.count) {
+        buffer_used += stream_read(stream, &buffer[buffer_used], sizeof(buffer) - buffer_used);
+        if(!buffer_used) break;
+
+        size_t offset = 0;
+        while(parsed < header.count) {
+            uint32_t edge;
+            size_t consumed = edge_trace_unpack(&edge, &buffer[offset], buffer_used - offset);
+            if(!consumed) break;
+            edge_trace_push(trace, edge & 1, edge >> 1);
+            offset += consumed;
+            parsed++;
+        }
+
+        if(!offset) break;
+
+        /* keep incomplete varint for next read */
+        memmove(buffer, &buffer[offset], buffer_used - offset);
+        buffer_used -= offset;
+    }
+
+    if(parsed != header.count) {
+        edge_trace_reset(trace);
+        return false;
+    }
+
+    return true;
+}
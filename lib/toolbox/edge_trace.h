@@ -0,0 +1,104 @@
+/**
+ * @file edge_trace.h
+ * Recorded level/duration edge sequence.
+ *
+ * Shared trace container for decoders with level/duration `feed`
+ * interface: SubGhz, LFRFID, Infrared and iButton. Traces can be
+ * recorded from capture or encoder output, saved to and loaded from
+ * stream in compact binary form, and replayed into any decoder.
+ *
+ * Binary form (little endian):
+ *  uint32_t magic "ETRC", uint8_t version, uint8_t reserved[3],
+ *  uint32_t edge count, then edge count varints of (duration << 1 | level).
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "level_duration.h"
+#include "stream/stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EDGE_TRACE_MAX_DURATION (0x3FFFFFFFUL)
+
+typedef struct EdgeTrace EdgeTrace;
+
+/** Allocate empty trace
+ *
+ * @return     EdgeTrace instance
+ */
+EdgeTrace* edge_trace_alloc();
+
+/** Free trace
+ *
+ * @param      trace  EdgeTrace instance
+ */
+void edge_trace_free(EdgeTrace* trace);
+
+/** Remove all edges
+ *
+ * @param      trace  EdgeTrace instance
+ */
+void edge_trace_reset(EdgeTrace* trace);
+
+/** Append edge, duration is clamped to EDGE_TRACE_MAX_DURATION
+ *
+ * @param      trace     EdgeTrace instance
+ * @param      level     signal level
+ * @param      duration  level duration in decoder units
+ */
+void edge_trace_push(EdgeTrace* trace, bool level, uint32_t duration);
+
+/** Get edges count
+ *
+ * @param      trace  EdgeTrace instance
+ *
+ * @return     edges count
+ */
+size_t edge_trace_get_count(const EdgeTrace* trace);
+
+/** Get edge by index
+ *
+ * @param      trace  EdgeTrace instance
+ * @param      index  edge index, less than edge_trace_get_count()
+ *
+ * @return     edge as LevelDuration
+ */
+LevelDuration edge_trace_get(const EdgeTrace* trace, size_t index);
+
+/** Append edges from raw varint body, without header.
+ * Malformed tail is ignored, so any byte sequence is accepted.
+ *
+ * @param      trace  EdgeTrace instance
+ * @param      data   varint encoded edges
+ * @param      size   data size
+ *
+ * @return     amount of appended edges
+ */
+size_t edge_trace_parse(EdgeTrace* trace, const uint8_t* data, size_t size);
+
+/** Save trace to stream at current position
+ *
+ * @param      trace   EdgeTrace instance
+ * @param      stream  Stream instance
+ *
+ * @return     true on success
+ */
+bool edge_trace_save(const EdgeTrace* trace, Stream* stream);
+
+/** Load trace from stream at current position, replaces trace content
+ *
+ * @param      trace   EdgeTrace instance
+ * @param      stream  Stream instance
+ *
+ * @return     true on success
+ */
+bool edge_trace_load(EdgeTrace* trace, Stream* stream);
+
+#ifdef __cplusplus
+}
+#endif
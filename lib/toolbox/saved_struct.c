@@ -67,7 +67,8 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
 
     SavedStructHeader header;
 
-    uint8_t* data_read = malloc(size);
+    uint8_t* data_read = NULL;
+    const uint8_t* payload = NULL;
     Storage* storage = furi_record_open(RECORD_STORAGE);
     File* file = storage_file_alloc(storage);
     bool result = true;
@@ -80,7 +81,20 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
 
     if(result) {
         uint16_t bytes_count = storage_file_read(file, &header, sizeof(SavedStructHeader));
-        bytes_count += storage_file_read(file, data_read, size);
+
+        // Check payload in place if storage can give it without copying
+        size_t bytes_borrowed = size;
+        payload = storage_file_borrow(file, &bytes_borrowed);
+        if(bytes_borrowed != size) {
+            data_read = malloc(size);
+            if(bytes_borrowed) {
+                memcpy(data_read, payload, bytes_borrowed);
+            }
+            bytes_borrowed +=
+                storage_file_read(file, &data_read[bytes_borrowed], size - bytes_borrowed);
+            payload = data_read;
+        }
+        bytes_count += bytes_borrowed;
 
         if(bytes_count != (sizeof(SavedStructHeader) + size)) {
             FURI_LOG_E(TAG, "Size mismatch of file \"%s\"", path);
@@ -102,9 +116,8 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
 
     if(result) {
         uint8_t checksum = 0;
-        const uint8_t* source = (const uint8_t*)data_read;
         for(size_t i = 0; i < size; i++) {
-            checksum += source[i];
+            checksum += payload[i];
         }
 
         if(header.checksum != checksum) {
@@ -115,7 +128,7 @@ bool saved_struct_load(const char* path, void* data, size_t size, uint8_t magic,
     }
 
     if(result) {
-        memcpy(data, data_read, size);
+        memcpy(data, payload, size);
     }
 
     storage_file_close(file);
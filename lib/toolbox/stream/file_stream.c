@@ -68,6 +68,13 @@ FS_Error file_stream_get_error(Stream* _stream) {
     return storage_file_get_error(stream->file);
 }
 
+File* file_stream_get_file(Stream* _stream) {
+    furi_assert(_stream);
+    FileStream* stream = (FileStream*)_stream;
+    furi_check(stream->stream_base.vtable == &file_stream_vtable);
+    return stream->file;
+}
+
 static void file_stream_free(FileStream* stream) {
     storage_file_free(stream->file);
     free(stream);
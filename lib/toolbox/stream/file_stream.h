@@ -42,6 +42,13 @@ bool file_stream_close(Stream* stream);
  */
 FS_Error file_stream_get_error(Stream* stream);
 
+/**
+ * Get the file object behind the stream, for the calls that have no stream counterpart
+ * @param stream pointer to stream object.
+ * @return File* file object, owned by the stream
+ */
+File* file_stream_get_file(Stream* stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,10 +4,11 @@
 #include <storage/storage.h>
 #include <furi.h>
 #include <toolbox/path.h>
+#include <toolbox/dir_walk.h>
 
 #define TAG "TarArch"
-#define MAX_NAME_LEN 255
 #define FILE_BLOCK_SIZE 512
+#define WALK_ARENA_SIZE 1024
 
 #define FILE_OPEN_NTRIES 10
 #define FILE_OPEN_RETRY_DELAY 25
@@ -169,7 +170,7 @@ typedef struct {
     Storage_name_converter converter;
 } TarArchiveDirectoryOpParams;
 
-static bool archive_extract_current_file(TarArchive* archive, const char* dst_path) {
+static bool archive_extract_current_file(TarArchive* archive, const char* dst_path, size_t size) {
     mtar_t* tar = &archive->tar;
     File* out_file = storage_file_alloc(archive->storage);
     uint8_t* readbuf = malloc(FILE_BLOCK_SIZE);
@@ -191,6 +192,11 @@ static bool archive_extract_current_file(TarArchive* archive, const char* dst_pa
             break;
         }
 
+        // Size is known in advance, keep the file contiguous where it is supported
+        if(size > 0) {
+            storage_file_preallocate(out_file, size);
+        }
+
         while(!mtar_eof_data(tar)) {
             int32_t readcnt = mtar_read_data(tar, readbuf, FILE_BLOCK_SIZE);
             if(!readcnt || !storage_file_write(out_file, readbuf, readcnt)) {
@@ -247,8 +253,8 @@ static int archive_extract_foreach_cb(mtar_t* tar, const mtar_header_t* header,
     full_extracted_fname = furi_string_alloc();
     path_concat(op_params->work_dir, furi_string_get_cstr(converted_fname), full_extracted_fname);
 
-    bool success =
-        archive_extract_current_file(archive, furi_string_get_cstr(full_extracted_fname));
+    bool success = archive_extract_current_file(
+        archive, furi_string_get_cstr(full_extracted_fname), header->size);
 
     furi_string_free(converted_fname);
     furi_string_free(full_extracted_fname);
@@ -316,59 +322,59 @@ bool tar_archive_add_file(
 bool tar_archive_add_dir(TarArchive* archive, const char* fs_full_path, const char* path_prefix) {
     furi_assert(archive);
     furi_check(path_prefix);
-    File* directory = storage_file_alloc(archive->storage);
-    FileInfo file_info;
+    DirWalk* dir_walk = dir_walk_alloc(archive->storage);
 
     FURI_LOG_I(TAG, "Backing up '%s', '%s'", fs_full_path, path_prefix);
-    char* name = malloc(MAX_NAME_LEN);
+    uint8_t* arena = malloc(WALK_ARENA_SIZE);
+    FuriString* element_name = furi_string_alloc();
+    size_t fs_full_path_length = strlen(fs_full_path);
     bool success = false;
 
     do {
-        if(!storage_dir_open(directory, fs_full_path)) {
+        if(!dir_walk_open(dir_walk, fs_full_path)) {
             break;
         }
 
-        while(true) {
-            if(!storage_dir_read(directory, &file_info, name, MAX_NAME_LEN)) {
-                success = true; /* empty dir / no more files */
-                break;
-            }
-
-            FuriString* element_name = furi_string_alloc();
-            FuriString* element_fs_abs_path = furi_string_alloc();
-
-            path_concat(fs_full_path, name, element_fs_abs_path);
-            if(strlen(path_prefix)) {
-                path_concat(path_prefix, name, element_name);
-            } else {
-                furi_string_set(element_name, name);
-            }
-
-            if(file_info_is_dir(&file_info)) {
-                success =
-                    tar_archive_dir_add_element(archive, furi_string_get_cstr(element_name)) &&
-                    tar_archive_add_dir(
+        size_t used;
+        DirWalkResult result = DirWalkError;
+        success = true;
+        while(success &&
+              (result = dir_walk_read_batch(dir_walk, arena, WALK_ARENA_SIZE, &used)) ==
+                  DirWalkOK) {
+            size_t offset = 0;
+            while(success && offset < used) {
+                const DirWalkEntry* entry = (const DirWalkEntry*)&arena[offset];
+                offset += entry->size;
+
+                // Path inside of the directory, without the separator
+                const char* name = &entry->path[fs_full_path_length + 1];
+                if(strlen(path_prefix)) {
+                    path_concat(path_prefix, name, element_name);
+                } else {
+                    furi_string_set(element_name, name);
+                }
+
+                if(file_info_is_dir(&entry->fileinfo)) {
+                    success =
+                        tar_archive_dir_add_element(archive, furi_string_get_cstr(element_name));
+                } else {
+                    success = tar_archive_add_file(
                         archive,
-                        furi_string_get_cstr(element_fs_abs_path),
-                        furi_string_get_cstr(element_name));
-            } else {
-                success = tar_archive_add_file(
-                    archive,
-                    furi_string_get_cstr(element_fs_abs_path),
-                    furi_string_get_cstr(element_name),
-                    file_info.size);
+                        entry->path,
+                        furi_string_get_cstr(element_name),
+                        entry->fileinfo.size);
+                }
             }
-            furi_string_free(element_name);
-            furi_string_free(element_fs_abs_path);
+        }
 
-            if(!success) {
-                break;
-            }
+        if(success && result != DirWalkLast) {
+            success = false;
         }
     } while(false);
 
-    free(name);
-    storage_file_free(directory);
+    furi_string_free(element_name);
+    free(arena);
+    dir_walk_free(dir_walk);
     return success;
 }
 
@@ -382,5 +388,5 @@ bool tar_archive_unpack_file(
     if(mtar_find(&archive->tar, archive_fname) != MTAR_ESUCCESS) {
         return false;
     }
-    return archive_extract_current_file(archive, destination);
+    return archive_extract_current_file(archive, destination, 0);
 }
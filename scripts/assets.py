@@ -92,6 +92,12 @@ class Main(App):
             help="Symbol and file name in dolphin output directory",
             default=None,
         )
+        self.parser_dolphin.add_argument(
+            "--separate-frames",
+            action="store_true",
+            help="Also write frame_N.bm files, for firmware without bundle support",
+            default=False,
+        )
         self.parser_dolphin.add_argument(
             "input_directory", help="Dolphin source directory"
         )
@@ -276,7 +282,11 @@ class Main(App):
         self.logger.info(f"Loading data")
         dolphin.load(self.args.input_directory)
         self.logger.info(f"Packing")
-        dolphin.pack(self.args.output_directory, self.args.symbol_name)
+        dolphin.pack(
+            self.args.output_directory,
+            self.args.symbol_name,
+            self.args.separate_frames,
+        )
         self.logger.info(f"Complete")
 
         return 0
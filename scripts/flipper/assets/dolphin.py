@@ -3,6 +3,7 @@ import logging
 import os
 import sys
 import shutil
+import struct
 from collections import Counter
 
 from flipper.utils.fff import *
@@ -10,12 +11,6 @@ from flipper.utils.templite import *
 from .icon import *
 
 
-def _convert_image_to_bm(pair: set):
-    source_filename, destination_filename = pair
-    image = file2image(source_filename)
-    image.write(destination_filename)
-
-
 def _convert_image(source_filename: str):
     image = file2image(source_filename)
     return image.data
@@ -25,6 +20,20 @@ class DolphinBubbleAnimation:
     FILE_TYPE = "Flipper Animation"
     FILE_VERSION = 1
 
+    BUNDLE_FILENAME = "animation.bundle"
+    BUNDLE_MAGIC = 0x42414446
+    BUNDLE_VERSION = 1
+    BUNDLE_HEADER_FORMAT = "<IBBBBBBBBHHBBBBBBBBI"
+    BUNDLE_BUBBLE_FORMAT = "<BBBBBBBB"
+    BUNDLE_FRAME_FORMAT = "<II"
+    BUNDLE_ALIGN = {
+        "Left": b"L",
+        "Right": b"R",
+        "Top": b"T",
+        "Bottom": b"B",
+        "Center": b"C",
+    }
+
     def __init__(
         self,
         name: str,
@@ -182,7 +191,7 @@ class DolphinBubbleAnimation:
             if bubbles_in_slots[slot] != 0:
                 bubble["_NextBubbleIndex"] = bubble_index + 1
 
-    def save(self, output_directory: str):
+    def save(self, output_directory: str, separate_frames: bool = False):
         animation_directory = os.path.join(output_directory, self.name)
         os.makedirs(animation_directory, exist_ok=True)
         meta_filename = os.path.join(animation_directory, "meta.txt")
@@ -220,18 +229,82 @@ class DolphinBubbleAnimation:
 
         file.save(meta_filename)
 
-        to_pack = []
-        for index, frame in enumerate(self.frames):
-            to_pack.append(
-                (frame, os.path.join(animation_directory, f"frame_{index}.bm"))
-            )
-
         if ImageTools.is_processing_slow():
             pool = multiprocessing.Pool()
-            pool.map(_convert_image_to_bm, to_pack)
+            frames_data = pool.map(_convert_image, self.frames)
         else:
-            for image in to_pack:
-                _convert_image_to_bm(image)
+            frames_data = list(_convert_image(frame) for frame in self.frames)
+
+        # Separate frames only for firmware without bundle support
+        if separate_frames:
+            for index, frame_data in enumerate(frames_data):
+                with open(
+                    os.path.join(animation_directory, f"frame_{index}.bm"), "wb"
+                ) as frame_file:
+                    frame_file.write(frame_data)
+
+        with open(
+            os.path.join(animation_directory, self.BUNDLE_FILENAME), "wb"
+        ) as bundle_file:
+            bundle_file.write(self._pack_bundle(frames_data))
+
+    def _pack_bundle(self, frames_data: list):
+        sections = bytes(self.meta["Frames order"])
+
+        for bubble in self.bubbles:
+            text = bubble["Text"].replace("\\n", "\n").encode()
+            assert len(text) <= 100
+            sections += struct.pack(
+                self.BUNDLE_BUBBLE_FORMAT,
+                bubble["Slot"],
+                bubble["X"],
+                bubble["Y"],
+                self.BUNDLE_ALIGN[bubble["AlignH"]][0],
+                self.BUNDLE_ALIGN[bubble["AlignV"]][0],
+                bubble["StartFrame"],
+                bubble["EndFrame"],
+                len(text),
+            )
+            sections += text
+
+        header_size = struct.calcsize(self.BUNDLE_HEADER_FORMAT)
+        frame_table_offset = header_size + len(sections)
+        frame_data_offset = frame_table_offset + len(frames_data) * struct.calcsize(
+            self.BUNDLE_FRAME_FORMAT
+        )
+
+        frame_table = b""
+        for frame_data in frames_data:
+            frame_table += struct.pack(
+                self.BUNDLE_FRAME_FORMAT, frame_data_offset, len(frame_data)
+            )
+            frame_data_offset += len(frame_data)
+
+        header = struct.pack(
+            self.BUNDLE_HEADER_FORMAT,
+            self.BUNDLE_MAGIC,
+            self.BUNDLE_VERSION,
+            self.meta["Width"],
+            self.meta["Height"],
+            len(frames_data),
+            self.meta["Passive frames"],
+            self.meta["Active frames"],
+            self.meta["Active cycles"],
+            self.meta["Frame rate"],
+            self.meta["Duration"],
+            self.meta["Active cooldown"],
+            self.min_butthurt,
+            self.max_butthurt,
+            self.min_level,
+            self.max_level,
+            self.weight,
+            self.bubble_slots,
+            len(self.bubbles),
+            0,
+            frame_table_offset,
+        )
+
+        return header + sections + frame_table + b"".join(frames_data)
 
     def process(self):
         if ImageTools.is_processing_slow():
@@ -327,7 +400,7 @@ class DolphinManifest:
             symbol_name=symbol_name,
         )
 
-    def save2folder(self, output_directory: str):
+    def save2folder(self, output_directory: str, separate_frames: bool = False):
         manifest_filename = os.path.join(output_directory, "manifest.txt")
         file = FlipperFormatFile()
         file.setHeader(self.FILE_TYPE, self.FILE_VERSION)
@@ -342,16 +415,18 @@ class DolphinManifest:
             file.writeKey("Weight", animation.weight)
             file.writeEmptyLine()
 
-            animation.save(output_directory)
+            animation.save(output_directory, separate_frames)
 
         file.save(manifest_filename)
 
-    def save(self, output_directory: str, symbol_name: str):
+    def save(
+        self, output_directory: str, symbol_name: str, separate_frames: bool = False
+    ):
         os.makedirs(output_directory, exist_ok=True)
         if symbol_name:
             self.save2code(output_directory, symbol_name)
         else:
-            self.save2folder(output_directory)
+            self.save2folder(output_directory, separate_frames)
 
 
 class Dolphin:
@@ -365,5 +440,10 @@ class Dolphin:
         self.logger.info(f"Loading directory {source_directory}")
         self.manifest.load(source_directory)
 
-    def pack(self, output_directory: str, symbol_name: str = None):
-        self.manifest.save(output_directory, symbol_name)
+    def pack(
+        self,
+        output_directory: str,
+        symbol_name: str = None,
+        separate_frames: bool = False,
+    ):
+        self.manifest.save(output_directory, symbol_name, separate_frames)
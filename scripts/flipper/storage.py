@@ -86,6 +86,17 @@ class BufferedRead:
             data = self.stream.read(i)
             self.buffer.extend(data)
 
+    def exact(self, size: int):
+        while len(self.buffer) < size:
+            data = self.stream.read(size - len(self.buffer))
+            if not data:
+                raise TimeoutError(f"Expected {size} bytes, got {len(self.buffer)}")
+            self.buffer.extend(data)
+
+        read = self.buffer[:size]
+        self.buffer = self.buffer[size:]
+        return read
+
 
 class FlipperStorage:
     CLI_PROMPT = ">: "
@@ -375,6 +386,23 @@ class FlipperStorage:
         self.read.until(self.CLI_PROMPT)
         self._check_no_error(response, path)
 
+    def trace(self, action: str):
+        """Start, stop or clear storage I/O trace on Flipper"""
+        self.send_and_wait_eol(f"storage trace {action}\r")
+        return self.read.until(self.CLI_PROMPT)
+
+    def trace_dump(self):
+        """Receive binary storage I/O trace from Flipper"""
+        self.send_and_wait_eol("storage trace dump\r")
+        answer = self.read.until(self.CLI_EOL)
+        if not answer.startswith(b"Size: "):
+            self.read.until(self.CLI_PROMPT)
+            raise Exception(answer.decode("ascii", "replace"))
+        size = int(answer.split(b": ")[1])
+        data = self.read.exact(size)
+        self.read.until(self.CLI_PROMPT)
+        return data
+
     def hash_local(self, filename: str):
         """Hash of local file"""
         hash_md5 = hashlib.md5()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+
+from flipper.app import App
+import re
+import struct
+import sys
+
+# Mirrors FuriLogLevel and log colors from furi/core/log.h
+LOG_LEVELS = {
+    2: ("E", "\033[0;31m"),
+    3: ("W", "\033[0;33m"),
+    4: ("I", "\033[0;32m"),
+    5: ("D", "\033[0;34m"),
+    6: ("T", "\033[0;35m"),
+}
+LOG_COLOR_RESET = "\033[0m"
+
+# FuriLogDeferredSite: uint8_t level, uint8_t argc, const char* tag, const char* format
+SITE_STRUCT = struct.Struct("<BBxxII")
+SITE_SECTION = ".furi_log_fmt"
+
+RECORD_RE = re.compile(r"#L ([0-9A-F]{8}) ([0-9A-F]+)((?: [0-9A-F]+)*)\s*$")
+FORMAT_RE = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d+))?"
+    r"(?P<length>hh|h|ll|l|z|j|t)?(?P<conversion>[diouxXcsp%])"
+)
+
+
+class Elf32:
+    SHT_NOBITS = 8
+
+    def __init__(self, filename):
+        with open(filename, "rb") as file:
+            self.data = file.read()
+        if self.data[:4] != b"\x7fELF" or self.data[4] != 1:
+            raise ValueError(f"{filename} is not ELF32 file")
+
+        (e_shoff,) = struct.unpack_from("<I", self.data, 0x20)
+        e_shentsize, e_shnum, e_shstrndx = struct.unpack_from("<HHH", self.data, 0x2E)
+
+        headers = []
+        for index in range(e_shnum):
+            headers.append(
+                struct.unpack_from("<IIIIII", self.data, e_shoff + index * e_shentsize)
+            )
+        names_offset = headers[e_shstrndx][4]
+
+        self.sections = {}
+        for name, sh_type, _, sh_addr, sh_offset, sh_size in headers:
+            if sh_type == self.SHT_NOBITS or not sh_addr:
+                continue
+            name = self.data[names_offset + name :].split(b"\0", 1)[0].decode()
+            self.sections[name] = (sh_addr, sh_offset, sh_size)
+
+    def section(self, name):
+        return self.sections.get(name)
+
+    def read(self, address, size):
+        for sh_addr, sh_offset, sh_size in self.sections.values():
+            if sh_addr <= address and address + size <= sh_addr + sh_size:
+                offset = sh_offset + address - sh_addr
+                return self.data[offset : offset + size]
+        return None
+
+    def read_cstring(self, address):
+        for sh_addr, sh_offset, sh_size in self.sections.values():
+            if sh_addr <= address < sh_addr + sh_size:
+                offset = sh_offset + address - sh_addr
+                end = self.data.index(b"\0", offset, sh_offset + sh_size)
+                return self.data[offset:end].decode("utf-8", "replace")
+        return None
+
+
+class Main(App):
+    def init(self):
+        self.parser.add_argument("elf", help="Firmware ELF file")
+        self.parser.add_argument(
+            "input", nargs="?", help="Captured log, stdin if not specified"
+        )
+        self.parser.add_argument(
+            "--no-color", action="store_true", help="Do not print color codes"
+        )
+        self.parser.set_defaults(func=self.decode)
+
+    def _format_argument(self, match, words):
+        conversion = match.group("conversion")
+        if conversion == "%":
+            return "%"
+        if not words:
+            return match.group(0)
+        word = words.pop(0)
+
+        spec = "%" + match.group("flags")
+        if match.group("width"):
+            spec += match.group("width")
+        if match.group("precision"):
+            spec += "." + match.group("precision")
+
+        if conversion in "di":
+            value = word - (1 << 32) if word & (1 << 31) else word
+            return (spec + "d") % value
+        elif conversion == "u":
+            return (spec + "d") % word
+        elif conversion == "p":
+            return "0x%08x" % word
+        elif conversion == "c":
+            return (spec + "c") % chr(word & 0xFF)
+        elif conversion == "s":
+            string = self.elf.read_cstring(word)
+            return (spec + "s") % (string if string is not None else f"<0x{word:08X}>")
+        return (spec + conversion) % word
+
+    def _decode_record(self, match):
+        site_address = int(match.group(1), 16)
+        timestamp = int(match.group(2), 16)
+        words = [int(word, 16) for word in match.group(3).split()]
+
+        section = self.elf.section(SITE_SECTION)
+        site = self.elf.read(site_address, SITE_STRUCT.size)
+        if (
+            not section
+            or not section[0] <= site_address < section[0] + section[2]
+            or not site
+        ):
+            return f"{timestamp} [?][0x{site_address:08X}] " + " ".join(
+                f"0x{word:X}" for word in words
+            )
+
+        level, argc, tag_address, format_address = SITE_STRUCT.unpack(site)
+        if argc != len(words):
+            self.logger.warning(f"Argument count mismatch for 0x{site_address:08X}")
+        tag = self.elf.read_cstring(tag_address)
+        message = FORMAT_RE.sub(
+            lambda format_match: self._format_argument(format_match, words),
+            self.elf.read_cstring(format_address),
+        )
+
+        letter, color = LOG_LEVELS.get(level, (" ", LOG_COLOR_RESET))
+        if self.args.no_color:
+            return f"{timestamp} [{letter}][{tag}] {message}"
+        return f"{timestamp} {color}[{letter}][{tag}] {LOG_COLOR_RESET}{message}"
+
+    def decode(self):
+        self.elf = Elf32(self.args.elf)
+        if not self.elf.section(SITE_SECTION):
+            self.logger.warning(f"No {SITE_SECTION} section in {self.args.elf}")
+
+        source = sys.stdin
+        if self.args.input:
+            source = open(self.args.input, "r", errors="replace")
+        with source:
+            for line in source:
+                line = line.rstrip("\r\n")
+                match = RECORD_RE.search(line)
+                if match:
+                    line = line[: match.start()] + self._decode_record(match)
+                print(line)
+
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()
@@ -0,0 +1,233 @@
+#!/usr/bin/env python3
+
+from flipper.app import App
+from flipper.storage import FlipperStorage
+from flipper.utils.cdc import resolve_port
+
+import json
+import struct
+
+# StorageCommand, applications/services/storage/storage_message.h
+STORAGE_COMMANDS = [
+    "file open",
+    "file close",
+    "file read",
+    "file borrow",
+    "file write",
+    "file seek",
+    "file tell",
+    "file truncate",
+    "file preallocate",
+    "file size",
+    "file sync",
+    "file eof",
+    "file async cancel",
+    "dir open",
+    "dir close",
+    "dir read",
+    "dir read batch",
+    "dir rewind",
+    "timestamp",
+    "stat",
+    "remove",
+    "mkdir",
+    "copy",
+    "fs info",
+    "sd format",
+    "sd unmount",
+    "sd info",
+    "sd status",
+    "resolve path",
+    "rename notify",
+]
+
+# FS_Error, applications/services/storage/filesystem_api_defines.h
+STORAGE_ERRORS = [
+    "OK",
+    "NOT_READY",
+    "EXIST",
+    "NOT_EXIST",
+    "INVALID_PARAMETER",
+    "DENIED",
+    "INVALID_NAME",
+    "INTERNAL",
+    "NOT_IMPLEMENTED",
+    "ALREADY_OPEN",
+    "CANCELLED",
+]
+
+# StorageTraceHeader and StorageTraceRecord
+# applications/services/storage/storage_trace.h
+TRACE_MAGIC = 0x43525453
+TRACE_VERSION = 2
+TRACE_HEADER = struct.Struct("<IHHIIHH")
+TRACE_RECORD = struct.Struct("<IIIIBBBB")
+TRACE_FLAG_ASYNC = 1 << 0
+
+
+class StorageTrace:
+    def __init__(self, data: bytes):
+        (
+            magic,
+            version,
+            record_size,
+            records,
+            self.dropped,
+            apps,
+            app_name_size,
+        ) = TRACE_HEADER.unpack_from(data, 0)
+        if magic != TRACE_MAGIC or version != TRACE_VERSION:
+            raise Exception(f"Unsupported trace, magic {magic:#x}, version {version}")
+        if record_size != TRACE_RECORD.size:
+            raise Exception(f"Unsupported trace record size {record_size}")
+
+        offset = TRACE_HEADER.size
+        self.apps = []
+        for _ in range(apps):
+            name = data[offset : offset + app_name_size]
+            self.apps.append(name.split(b"\0")[0].decode("utf-8", "replace"))
+            offset += app_name_size
+
+        self.records = []
+        time_base = 0
+        time_last = None
+        for _ in range(records):
+            (
+                time,
+                latency,
+                file,
+                size,
+                command,
+                app,
+                error,
+                flags,
+            ) = TRACE_RECORD.unpack_from(data, offset)
+            offset += TRACE_RECORD.size
+
+            # Device time is 32 bit microseconds, unwrap it
+            if time_last is not None and time < time_last:
+                time_base += 1 << 32
+            time_last = time
+
+            self.records.append(
+                {
+                    "time": time_base + time,
+                    "latency": latency,
+                    "file": file,
+                    "bytes": size,
+                    "command": self._name(STORAGE_COMMANDS, command),
+                    "app": self._name(self.apps, app),
+                    "error": self._name(STORAGE_ERRORS, error),
+                    "async": bool(flags & TRACE_FLAG_ASYNC),
+                }
+            )
+
+    @staticmethod
+    def _name(names, index):
+        return names[index] if index < len(names) else str(index)
+
+    def timeline(self):
+        lines = []
+        if self.dropped:
+            lines.append(f"{self.dropped} older records dropped")
+        lines.append(
+            f"{'Time ms':>12} {'App':<23} {'Command':<18} {'File':>10} "
+            f"{'Bytes':>8} {'Latency us':>10} Error"
+        )
+        start = self.records[0]["time"] if self.records else 0
+        for record in self.records:
+            file = f"{record['file']:#010x}" if record["file"] else "-"
+            command = record["command"] + (" async" if record["async"] else "")
+            time = (record["time"] - start) / 1000
+            lines.append(
+                f"{time:>12.3f} {record['app']:<23} {command:<18} {file:>10} "
+                f"{record['bytes']:>8} {record['latency']:>10} {record['error']}"
+            )
+        return "\n".join(lines)
+
+    def chrome_trace(self):
+        """Trace Event Format, opens in chrome://tracing and Perfetto"""
+        events = []
+        for record in self.records:
+            events.append(
+                {
+                    "name": record["command"],
+                    "cat": "async" if record["async"] else "sync",
+                    "ph": "X",
+                    "ts": record["time"],
+                    "dur": max(record["latency"], 1),
+                    "pid": 0,
+                    # Storage thread does one request at a time, apps are threads here
+                    "tid": record["app"],
+                    "args": {
+                        "file": f"{record['file']:#010x}",
+                        "bytes": record["bytes"],
+                        "error": record["error"],
+                    },
+                }
+            )
+        return {"traceEvents": events, "displayTimeUnit": "ms"}
+
+
+class Main(App):
+    def init(self):
+        self.parser.add_argument("-p", "--port", help="CDC Port", default="auto")
+
+        self.subparsers = self.parser.add_subparsers(help="sub-command help")
+
+        for action, help in (
+            ("start", "Start tracing, previous trace is dropped"),
+            ("stop", "Stop tracing, trace is kept for fetch"),
+            ("clear", "Stop tracing and free trace memory"),
+            ("apps", "Print per app counters"),
+        ):
+            parser = self.subparsers.add_parser(action, help=help)
+            parser.set_defaults(func=self.action, action=action)
+
+        self.parser_fetch = self.subparsers.add_parser(
+            "fetch", help="Fetch binary trace"
+        )
+        self.parser_fetch.add_argument("trace_path", help="Local path")
+        self.parser_fetch.set_defaults(func=self.fetch)
+
+        self.parser_timeline = self.subparsers.add_parser(
+            "timeline", help="Print timeline of binary trace"
+        )
+        self.parser_timeline.add_argument("trace_path", help="Local path")
+        self.parser_timeline.add_argument(
+            "-c", "--chrome", help="Save Trace Event Format JSON too", default=None
+        )
+        self.parser_timeline.set_defaults(func=self.timeline)
+
+    def _get_port(self):
+        if not (port := resolve_port(self.logger, self.args.port)):
+            raise Exception("Failed to resolve port")
+        return port
+
+    def action(self):
+        with FlipperStorage(self._get_port()) as storage:
+            print(storage.trace(self.args.action).decode("utf-8", "replace"))
+        return 0
+
+    def fetch(self):
+        with FlipperStorage(self._get_port()) as storage:
+            data = storage.trace_dump()
+        with open(self.args.trace_path, "wb") as file:
+            file.write(data)
+        self.logger.info(f"Saved {len(data)} bytes to {self.args.trace_path}")
+        return 0
+
+    def timeline(self):
+        with open(self.args.trace_path, "rb") as file:
+            trace = StorageTrace(file.read())
+
+        print(trace.timeline())
+        if self.args.chrome:
+            with open(self.args.chrome, "w") as file:
+                json.dump(trace.chrome_trace(), file)
+            self.logger.info(f"Saved Trace Event Format to {self.args.chrome}")
+        return 0
+
+
+if __name__ == "__main__":
+    Main()()
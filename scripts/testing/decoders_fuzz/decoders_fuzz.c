@@ -0,0 +1,238 @@
+/**
+ * Fuzz target for level/duration decoders fed from edge traces
+ *
+ *   LIB=../../../lib
+ *   SRC="$LIB/toolbox/edge_trace.c $LIB/toolbox/varint.c $LIB/toolbox/hex.c \
+ *       $LIB/toolbox/manchester_decoder.c $LIB/toolbox/protocols/protocol_dict.c \
+ *       $LIB/lfrfid/protocols/lfrfid_protocols.c $LIB/lfrfid/protocols/protocol_*.c \
+ *       $LIB/lfrfid/tools/bit_lib.c $LIB/lfrfid/tools/fsk_demod.c $LIB/lfrfid/tools/fsk_ocs.c \
+ *       $(find $LIB/infrared/encoder_decoder -name '*.c') \
+ *       $LIB/ibutton/protocols/misc/protocol_cyfral.c \
+ *       $LIB/ibutton/protocols/misc/protocol_metakom.c \
+ *       $LIB/ibutton/protocols/misc/protocol_group_misc_defs.c"
+ *   INC="-Iinclude -I../../.. -I$LIB -I$LIB/infrared/encoder_decoder"
+ *
+ *   clang -g -O1 -fsanitize=fuzzer,address $INC -o decoders_fuzz decoders_fuzz.c $SRC -lm
+ *   ./decoders_fuzz corpus/
+ *
+ * Without libFuzzer the same target runs files given on the command line, or
+ * reproducible pseudo-random inputs when there are none. Alignment checks are
+ * off, some LFRFID protocols do unaligned word loads that Cortex-M4 handles:
+ *
+ *   cc -g -fsanitize=address,undefined -fno-sanitize=alignment -DDECODERS_FUZZ_STANDALONE \
+ *       $INC -o decoders_fuzz decoders_fuzz.c $SRC -lm
+ *   ./decoders_fuzz [crash file...]
+ *
+ * First input byte selects decoder family, the rest is edge trace body as
+ * parsed by edge_trace_parse. SubGhz receiver pulls in flipper format and
+ * keystore, it is covered by the on-device smoke test in the decoders suite.
+ */
+#include <furi.h>
+#include <furi_hal.h>
+#include <stdarg.h>
+#include <toolbox/edge_trace.h>
+#include <toolbox/protocols/protocol_dict.h>
+#include <lfrfid/protocols/lfrfid_protocols.h>
+#include <ibutton/protocols/misc/protocol_group_misc_defs.h>
+#include <infrared.h>
+
+#define FUZZ_STANDALONE_ITERATIONS 10000
+#define FUZZ_STANDALONE_MAX_SIZE 4096
+
+/** Decoder family: anything with level/duration feed */
+typedef struct {
+    const char* name;
+    void* (*alloc)(void);
+    void (*reset)(void* decoder);
+    void (*feed)(void* decoder, bool level, uint32_t duration);
+} DecoderFamily;
+
+static void* decoder_family_infrared_alloc(void) {
+    return infrared_alloc_decoder();
+}
+
+static void decoder_family_infrared_reset(void* decoder) {
+    infrared_reset_decoder(decoder);
+}
+
+static void decoder_family_infrared_feed(void* decoder, bool level, uint32_t duration) {
+    infrared_decode(decoder, level, duration);
+}
+
+static void* decoder_family_lfrfid_alloc(void) {
+    return protocol_dict_alloc(lfrfid_protocols, LFRFIDProtocolMax);
+}
+
+static void* decoder_family_ibutton_alloc(void) {
+    return protocol_dict_alloc(ibutton_protocols_misc, iButtonProtocolMiscMax);
+}
+
+static void decoder_family_dict_reset(void* decoder) {
+    protocol_dict_decoders_start(decoder);
+}
+
+static void decoder_family_dict_feed(void* decoder, bool level, uint32_t duration) {
+    protocol_dict_decoders_feed(decoder, level, duration);
+}
+
+static const DecoderFamily decoder_families[] = {
+    {
+        .name = "infrared",
+        .alloc = decoder_family_infrared_alloc,
+        .reset = decoder_family_infrared_reset,
+        .feed = decoder_family_infrared_feed,
+    },
+    {
+        .name = "lfrfid",
+        .alloc = decoder_family_lfrfid_alloc,
+        .reset = decoder_family_dict_reset,
+        .feed = decoder_family_dict_feed,
+    },
+    {
+        .name = "ibutton",
+        .alloc = decoder_family_ibutton_alloc,
+        .reset = decoder_family_dict_reset,
+        .feed = decoder_family_dict_feed,
+    },
+};
+
+// Decoders live for the whole run, like in the workers, and are reset per input
+static void* decoders[COUNT_OF(decoder_families)];
+static EdgeTrace* scratch = NULL;
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if(size < 1) return 0;
+
+    const DecoderFamily* family = &decoder_families[data[0] % COUNT_OF(decoder_families)];
+    void** decoder = &decoders[data[0] % COUNT_OF(decoder_families)];
+    if(!*decoder) *decoder = family->alloc();
+    if(!scratch) scratch = edge_trace_alloc();
+
+    edge_trace_reset(scratch);
+    edge_trace_parse(scratch, data + 1, size - 1);
+
+    family->reset(*decoder);
+    for(size_t i = 0; i < edge_trace_get_count(scratch); i++) {
+        LevelDuration edge = edge_trace_get(scratch, i);
+        family->feed(*decoder, level_duration_get_level(edge), level_duration_get_duration(edge));
+    }
+
+    return 0;
+}
+
+/* Host side of furi used by the decoders */
+
+struct FuriString {
+    char* data;
+    size_t size;
+};
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    string->data = malloc(1);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+static int furi_string_cat_vprintf(FuriString* string, const char format[], va_list args) {
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int size = vsnprintf(NULL, 0, format, args_copy);
+    va_end(args_copy);
+    if(size < 0) return size;
+    string->data = realloc(string->data, string->size + size + 1);
+    vsnprintf(&string->data[string->size], size + 1, format, args);
+    string->size += size;
+    return size;
+}
+
+int furi_string_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    furi_string_reset(string);
+    int result = furi_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return result;
+}
+
+int furi_string_cat_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    int result = furi_string_cat_vprintf(string, format, args);
+    va_end(args);
+    return result;
+}
+
+void furi_string_cat_str(FuriString* string, const char cstr[]) {
+    furi_string_cat_printf(string, "%s", cstr);
+}
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void) {
+    return 64;
+}
+
+// Trace save and load are not part of the target
+size_t stream_write(Stream* stream, const uint8_t* data, size_t size) {
+    UNUSED(stream);
+    UNUSED(data);
+    UNUSED(size);
+    return 0;
+}
+
+size_t stream_read(Stream* stream, uint8_t* data, size_t count) {
+    UNUSED(stream);
+    UNUSED(data);
+    UNUSED(count);
+    return 0;
+}
+
+#ifdef DECODERS_FUZZ_STANDALONE
+static bool decoders_fuzz_run_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if(!file) return false;
+    uint8_t* data = malloc(FUZZ_STANDALONE_MAX_SIZE);
+    size_t size = fread(data, 1, FUZZ_STANDALONE_MAX_SIZE, file);
+    fclose(file);
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    for(int i = 1; i < argc; i++) {
+        if(!decoders_fuzz_run_file(argv[i])) {
+            printf("Can't read %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if(argc < 2) {
+        uint8_t* data = malloc(FUZZ_STANDALONE_MAX_SIZE);
+        srand(0xF1F1);
+        for(size_t i = 0; i < FUZZ_STANDALONE_ITERATIONS; i++) {
+            size_t size = rand() % FUZZ_STANDALONE_MAX_SIZE;
+            for(size_t j = 0; j < size; j++) {
+                data[j] = rand();
+            }
+            LLVMFuzzerTestOneInput(data, size);
+        }
+        free(data);
+    }
+
+    printf("OK\n");
+    return 0;
+}
+#endif
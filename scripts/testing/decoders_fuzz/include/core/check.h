@@ -0,0 +1,3 @@
+#pragma once
+/* Host shim of core/check.h, definitions live in furi.h */
+#include <furi.h>
@@ -0,0 +1,3 @@
+#pragma once
+/* Host shim of core/common_defines.h, definitions live in furi.h */
+#include <furi.h>
@@ -0,0 +1,3 @@
+#pragma once
+/* Host shim of core/core_defines.h, definitions live in furi.h */
+#include <furi.h>
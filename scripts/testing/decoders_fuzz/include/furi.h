@@ -0,0 +1,60 @@
+#pragma once
+/* Host shim of furi.h for the decoders fuzz target, only what the decoders use */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(X) (void)(X)
+
+// Comes from newlib on the device
+#ifndef _ATTRIBUTE
+#define _ATTRIBUTE(attrs) __attribute__(attrs)
+#endif
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+
+#define furi_crash(message)                                                               \
+    do {                                                                                  \
+        fprintf(stderr, "furi_crash: %s, %s:%d\n", message, __FILE__, __LINE__);          \
+        abort();                                                                          \
+    } while(0)
+
+#define furi_check(__e)                                                                   \
+    do {                                                                                  \
+        if(!(__e)) {                                                                      \
+            fprintf(stderr, "furi_check failed: %s, %s:%d\n", #__e, __FILE__, __LINE__); \
+            abort();                                                                      \
+        }                                                                                 \
+    } while(0)
+
+#define furi_assert(__e) furi_check(__e)
+
+// Firmware heap returns zeroed memory
+#define malloc(size) calloc(1, size)
+
+#define FURI_LOG_E(tag, format, ...)
+#define FURI_LOG_W(tag, format, ...)
+#define FURI_LOG_I(tag, format, ...)
+#define FURI_LOG_D(tag, format, ...)
+#define FURI_LOG_T(tag, format, ...)
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+const char* furi_string_get_cstr(const FuriString* string);
+int furi_string_printf(FuriString* string, const char format[], ...);
+int furi_string_cat_printf(FuriString* string, const char format[], ...);
+void furi_string_cat_str(FuriString* string, const char cstr[]);
@@ -0,0 +1,5 @@
+#pragma once
+/* Host shim of furi_hal.h for the decoders fuzz target, only what the decoders use */
+#include <furi.h>
+
+uint32_t furi_hal_cortex_instructions_per_microsecond(void);
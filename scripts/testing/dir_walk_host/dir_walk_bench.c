@@ -0,0 +1,165 @@
+/**
+ * Host benchmark of the directory walker over a synthetic tree
+ *
+ *   cc -O2 -Iinclude -I../../../lib/toolbox -I../../../applications/services/storage \
+ *       -o dir_walk_bench dir_walk_bench.c storage_host.c ../../../lib/toolbox/dir_walk.c
+ *   ./dir_walk_bench [tree path]
+ *
+ * 10000 files in 110 directories are created in the tree path, /tmp/dir_walk_bench by default,
+ * then the tree is walked with dir_walk_read and with dir_walk_read_batch.
+ * Storage requests are counted by the host backend, on the device each of them is
+ * a round trip to the storage thread.
+ */
+#include <limits.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <dir_walk.h>
+
+#define BENCH_DIRS 10
+#define BENCH_SUBDIRS 10
+#define BENCH_FILES 100
+#define BENCH_ARENA_SIZE 1024
+
+typedef struct {
+    uint64_t entries;
+    uint64_t dirs;
+    uint64_t bytes;
+    uint64_t hash; /**< order independent */
+    uint64_t requests;
+    double time;
+} BenchResult;
+
+static int failures = 0;
+
+#define test_check(__e)                                               \
+    do {                                                              \
+        if(!(__e)) {                                                  \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #__e);     \
+            failures++;                                               \
+        }                                                             \
+    } while(0)
+
+static double bench_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t bench_hash(const char* path) {
+    uint64_t hash = 14695981039346656037ULL;
+    while(*path) {
+        hash = (hash ^ (uint8_t)*path++) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static void bench_tree_create(const char* base) {
+    char path[PATH_MAX];
+    mkdir(base, 0755);
+
+    for(int d = 0; d < BENCH_DIRS; d++) {
+        snprintf(path, sizeof(path), "%s/dir_%02d", base, d);
+        mkdir(path, 0755);
+        for(int s = 0; s < BENCH_SUBDIRS; s++) {
+            snprintf(path, sizeof(path), "%s/dir_%02d/subdir_%02d", base, d, s);
+            mkdir(path, 0755);
+            for(int f = 0; f < BENCH_FILES; f++) {
+                snprintf(
+                    path, sizeof(path), "%s/dir_%02d/subdir_%02d/file_%03d.bin", base, d, s, f);
+                FILE* file = fopen(path, "w");
+                furi_check(file);
+                fwrite(path, 1, f % 16, file);
+                fclose(file);
+            }
+        }
+    }
+}
+
+static void bench_account(BenchResult* result, const char* path, const FileInfo* fileinfo) {
+    result->entries++;
+    result->hash += bench_hash(path);
+    if(file_info_is_dir(fileinfo)) {
+        result->dirs++;
+    } else {
+        result->bytes += fileinfo->size;
+    }
+}
+
+static BenchResult bench_walk(const char* base) {
+    BenchResult result = {0};
+    FuriString* path = furi_string_alloc();
+    FileInfo fileinfo;
+
+    uint64_t requests = storage_host_requests;
+    double start = bench_time();
+
+    DirWalk* dir_walk = dir_walk_alloc(NULL);
+    test_check(dir_walk_open(dir_walk, base));
+    while(dir_walk_read(dir_walk, path, &fileinfo) == DirWalkOK) {
+        bench_account(&result, furi_string_get_cstr(path), &fileinfo);
+    }
+    dir_walk_free(dir_walk);
+
+    result.time = bench_time() - start;
+    result.requests = storage_host_requests - requests;
+    furi_string_free(path);
+    return result;
+}
+
+static BenchResult bench_walk_batch(const char* base) {
+    BenchResult result = {0};
+    uint64_t* arena = malloc(BENCH_ARENA_SIZE);
+
+    uint64_t requests = storage_host_requests;
+    double start = bench_time();
+
+    DirWalk* dir_walk = dir_walk_alloc(NULL);
+    test_check(dir_walk_open(dir_walk, base));
+    size_t used;
+    while(dir_walk_read_batch(dir_walk, arena, BENCH_ARENA_SIZE, &used) == DirWalkOK) {
+        for(size_t offset = 0; offset < used;) {
+            const DirWalkEntry* entry = (const DirWalkEntry*)((uint8_t*)arena + offset);
+            offset += entry->size;
+            bench_account(&result, entry->path, &entry->fileinfo);
+        }
+    }
+    test_check(dir_walk_get_error(dir_walk) == FSE_OK);
+    dir_walk_free(dir_walk);
+
+    result.time = bench_time() - start;
+    result.requests = storage_host_requests - requests;
+    free(arena);
+    return result;
+}
+
+static void bench_print(const char* name, const BenchResult* result) {
+    printf(
+        "%-12s %llu entries, %llu requests (%.2f per entry), %.1f ms\n",
+        name,
+        (unsigned long long)result->entries,
+        (unsigned long long)result->requests,
+        (double)result->requests / result->entries,
+        result->time * 1000);
+}
+
+int main(int argc, char** argv) {
+    const char* base = argc > 1 ? argv[1] : "/tmp/dir_walk_bench";
+    bench_tree_create(base);
+
+    BenchResult walk = bench_walk(base);
+    BenchResult batch = bench_walk_batch(base);
+    bench_print("dir_walk", &walk);
+    bench_print("batch", &batch);
+
+    const uint64_t dirs = BENCH_DIRS + BENCH_DIRS * BENCH_SUBDIRS;
+    test_check(walk.entries == dirs + BENCH_DIRS * BENCH_SUBDIRS * BENCH_FILES);
+    test_check(walk.dirs == dirs);
+    test_check(batch.entries == walk.entries);
+    test_check(batch.dirs == walk.dirs);
+    test_check(batch.bytes == walk.bytes);
+    test_check(batch.hash == walk.hash);
+    test_check(batch.requests < walk.requests);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
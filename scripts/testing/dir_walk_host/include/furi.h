@@ -0,0 +1,46 @@
+#pragma once
+/* Host shim of furi.h for the directory walker benchmark, only what the walker uses */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(X) (void)(X)
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+
+#define furi_check(__e)                                                                   \
+    do {                                                                                  \
+        if(!(__e)) {                                                                      \
+            fprintf(stderr, "furi_check failed: %s, %s:%d\n", #__e, __FILE__, __LINE__); \
+            abort();                                                                      \
+        }                                                                                 \
+    } while(0)
+
+#define furi_assert(__e) furi_check(__e)
+
+#define FURI_STRING_FAILURE ((size_t)-1)
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+FuriString* furi_string_alloc_set(const char cstr[]);
+void furi_string_free(FuriString* string);
+void furi_string_set(FuriString* string, const char cstr[]);
+void furi_string_reset(FuriString* string);
+void furi_string_left(FuriString* string, size_t index);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+size_t furi_string_search_rchar(const FuriString* string, char c);
+int furi_string_printf(FuriString* string, const char format[], ...);
+int furi_string_cat_printf(FuriString* string, const char format[], ...);
@@ -0,0 +1,35 @@
+#pragma once
+/* Host shim of M*LIB list, only what the walker uses */
+#include <stdlib.h>
+
+#define LIST_DEF(name, type)                                                 \
+    typedef struct {                                                         \
+        type* data;                                                          \
+        size_t size;                                                         \
+        size_t capacity;                                                     \
+    } name##_s;                                                              \
+    typedef name##_s name##_t[1];                                            \
+    static inline void name##_init(name##_t list) {                          \
+        list->data = NULL;                                                   \
+        list->size = 0;                                                      \
+        list->capacity = 0;                                                  \
+    }                                                                        \
+    static inline void name##_clear(name##_t list) {                         \
+        free(list->data);                                                    \
+    }                                                                        \
+    static inline void name##_reset(name##_t list) {                         \
+        list->size = 0;                                                      \
+    }                                                                        \
+    static inline size_t name##_size(const name##_t list) {                  \
+        return list->size;                                                   \
+    }                                                                        \
+    static inline void name##_push_back(name##_t list, type value) {         \
+        if(list->size == list->capacity) {                                   \
+            list->capacity = list->capacity ? list->capacity * 2 : 8;        \
+            list->data = realloc(list->data, list->capacity * sizeof(type)); \
+        }                                                                    \
+        list->data[list->size++] = value;                                    \
+    }                                                                        \
+    static inline void name##_pop_back(type* value, name##_t list) {         \
+        *value = list->data[--list->size];                                   \
+    }
@@ -0,0 +1,30 @@
+#pragma once
+/* Host shim of the storage API over a host directory, only what the walker uses.
+ * Every call is counted as one storage thread request. */
+#include <furi.h>
+#include <filesystem_api_defines.h>
+
+typedef struct Storage Storage;
+
+/** Storage requests done since the start */
+extern uint64_t storage_host_requests;
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_is_open(File* file);
+FS_Error storage_file_get_error(File* file);
+
+bool storage_dir_open(File* file, const char* path);
+bool storage_dir_close(File* file);
+bool storage_dir_read(File* file, FileInfo* fileinfo, char* name, uint16_t name_length);
+
+typedef struct {
+    FileInfo fileinfo;
+    uint16_t size;
+    char name[];
+} StorageDirEntry;
+
+#define STORAGE_DIR_ENTRY_NAME_SIZE 256
+#define STORAGE_DIR_ENTRY_SIZE_MAX (sizeof(StorageDirEntry) + STORAGE_DIR_ENTRY_NAME_SIZE)
+
+uint16_t storage_dir_read_batch(File* file, void* buffer, uint16_t size);
@@ -0,0 +1,229 @@
+/**
+ * Host directory backend of the storage API and host FuriString
+ *
+ * Directory reads go to the host file system, every API call counts as one
+ * storage thread request: on the device each of them is a message round trip.
+ */
+#include <limits.h>
+#include <stdarg.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <storage/storage.h>
+
+uint64_t storage_host_requests = 0;
+
+struct File {
+    DIR* dir;
+    char* path;
+    FS_Error error_id;
+};
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+/****************** FuriString ******************/
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 > string->capacity) {
+        string->capacity = MAX(size + 1, string->capacity * 2);
+        string->data = realloc(string->data, string->capacity);
+    }
+}
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = calloc(1, sizeof(FuriString));
+    furi_string_reserve(string, 16);
+    string->data[0] = '\0';
+    return string;
+}
+
+FuriString* furi_string_alloc_set(const char cstr[]) {
+    FuriString* string = furi_string_alloc();
+    furi_string_set(string, cstr);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+void furi_string_set(FuriString* string, const char cstr[]) {
+    size_t size = strlen(cstr);
+    furi_string_reserve(string, size);
+    memmove(string->data, cstr, size + 1);
+    string->size = size;
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_left(FuriString* string, size_t index) {
+    if(index < string->size) {
+        string->size = index;
+        string->data[index] = '\0';
+    }
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+size_t furi_string_search_rchar(const FuriString* string, char c) {
+    const char* found = strrchr(string->data, c);
+    return found ? (size_t)(found - string->data) : FURI_STRING_FAILURE;
+}
+
+static int furi_string_vprintf_at(
+    FuriString* string,
+    size_t at,
+    const char format[],
+    va_list args) {
+    va_list copy;
+    va_copy(copy, args);
+    int size = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+
+    furi_string_reserve(string, at + size);
+    vsnprintf(&string->data[at], size + 1, format, args);
+    string->size = at + size;
+    return size;
+}
+
+int furi_string_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    int result = furi_string_vprintf_at(string, 0, format, args);
+    va_end(args);
+    return result;
+}
+
+int furi_string_cat_printf(FuriString* string, const char format[], ...) {
+    va_list args;
+    va_start(args, format);
+    int result = furi_string_vprintf_at(string, string->size, format, args);
+    va_end(args);
+    return result;
+}
+
+/****************** Storage ******************/
+
+bool file_info_is_dir(const FileInfo* file_info) {
+    return (file_info->flags & FSF_DIRECTORY);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    if(file->dir) storage_dir_close(file);
+    free(file);
+}
+
+bool storage_file_is_open(File* file) {
+    return file->dir != NULL;
+}
+
+FS_Error storage_file_get_error(File* file) {
+    return file->error_id;
+}
+
+bool storage_dir_open(File* file, const char* path) {
+    storage_host_requests++;
+    furi_check(file->dir == NULL);
+    file->dir = opendir(path);
+    file->error_id = file->dir ? FSE_OK : FSE_NOT_EXIST;
+    if(file->dir) file->path = strdup(path);
+    return file->dir != NULL;
+}
+
+bool storage_dir_close(File* file) {
+    storage_host_requests++;
+    if(file->dir == NULL) {
+        file->error_id = FSE_INVALID_PARAMETER;
+        return false;
+    }
+
+    closedir(file->dir);
+    free(file->path);
+    file->dir = NULL;
+    file->path = NULL;
+    file->error_id = FSE_OK;
+    return true;
+}
+
+/* What a file system dir.read does in the storage thread */
+static bool storage_host_dir_read(File* file, FileInfo* fileinfo, char* name, uint16_t length) {
+    if(file->dir == NULL) {
+        file->error_id = FSE_INVALID_PARAMETER;
+        return false;
+    }
+
+    struct dirent* entry;
+    do {
+        entry = readdir(file->dir);
+    } while(entry && (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0));
+
+    if(entry == NULL) {
+        file->error_id = FSE_NOT_EXIST;
+        return false;
+    }
+
+    if(fileinfo) {
+        char path[PATH_MAX];
+        struct stat st;
+        snprintf(path, sizeof(path), "%s/%s", file->path, entry->d_name);
+        furi_check(stat(path, &st) == 0);
+        fileinfo->flags = S_ISDIR(st.st_mode) ? FSF_DIRECTORY : 0;
+        fileinfo->size = st.st_size;
+    }
+
+    if(name) {
+        snprintf(name, length, "%s", entry->d_name);
+    }
+
+    file->error_id = FSE_OK;
+    return true;
+}
+
+bool storage_dir_read(File* file, FileInfo* fileinfo, char* name, uint16_t name_length) {
+    storage_host_requests++;
+    return storage_host_dir_read(file, fileinfo, name, name_length);
+}
+
+/* Same packing as storage_process_dir_read_batch */
+uint16_t storage_dir_read_batch(File* file, void* buffer, uint16_t size) {
+    storage_host_requests++;
+    furi_check(size >= STORAGE_DIR_ENTRY_SIZE_MAX);
+    uint16_t used = 0;
+
+    while((size_t)(size - used) >= STORAGE_DIR_ENTRY_SIZE_MAX) {
+        StorageDirEntry* entry = (StorageDirEntry*)((uint8_t*)buffer + used);
+        if(!storage_host_dir_read(
+               file, &entry->fileinfo, entry->name, STORAGE_DIR_ENTRY_NAME_SIZE)) {
+            break;
+        }
+
+        const size_t align = _Alignof(StorageDirEntry);
+        size_t entry_size = offsetof(StorageDirEntry, name) + strlen(entry->name) + 1;
+        entry->size = (entry_size + align - 1) / align * align;
+        used += entry->size;
+    }
+
+    if(used > 0) {
+        file->error_id = FSE_OK;
+    }
+
+    return used;
+}
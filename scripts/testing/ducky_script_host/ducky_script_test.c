@@ -0,0 +1,902 @@
+/**
+ * Host test of the BadUSB script compiler and executor
+ *
+ *   BAD_USB=../../../applications/main/bad_usb/helpers
+ *   cc -g -fsanitize=address,undefined -Iinclude -I$BAD_USB \
+ *       -I../../../firmware/targets/furi_hal_include -I../../../applications/services/storage \
+ *       -pthread -o ducky_script_test ducky_script_test.c $BAD_USB/ducky_script*.c
+ *   ./ducky_script_test
+ *
+ * Worker thread is the firmware one on pthreads. Time is virtual: a flag wait with
+ * a timeout returns at once and moves the clock, so delays are exact and free.
+ * HID reports are recorded as a trace, WAIT_FOR_BUTTON_PRESS is answered at once.
+ *
+ * With script files as arguments the test prints their traces instead, two runs
+ * per script. Built the same way against the sources before the compiler, it gives
+ * traces of the old executor to diff with. From the repository root:
+ *
+ *   HELPERS=applications/main/bad_usb/helpers
+ *   git archive $(git log --diff-filter=A --format=%h -- $HELPERS/ducky_script_compiler.c)^ \
+ *       $HELPERS | tar -x -C /tmp/bad_usb_old
+ *
+ * and BAD_USB=/tmp/bad_usb_old/applications/main/bad_usb/helpers for the build.
+ * Old executor loops forever on REPEAT after REPEAT and sends the keys of an ALTCHAR
+ * line before it finds the line invalid, these are expected to differ.
+ */
+#include <furi.h>
+#include <furi_hal.h>
+#include <storage/storage.h>
+#include <pthread.h>
+
+#include <ducky_script.h>
+
+#define TEST_SCRIPT_PATH "/ext/badusb/test.txt"
+#define TEST_LAYOUT_PATH "/ext/badusb/assets/layouts/test.kl"
+
+static BadUsbScript* script = NULL;
+
+/* Trace of HID reports, a tap is a press followed by release of the same key */
+
+typedef struct {
+    char* text;
+    size_t size;
+    size_t capacity;
+    uint64_t time;
+    uint64_t time_reported;
+    bool press_pending;
+    uint16_t press_key;
+} TestTrace;
+
+static TestTrace trace;
+static TestTrace expected;
+
+static void test_trace_append(TestTrace* t, const char* format, ...) {
+    char token[32];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(token, sizeof(token), format, args);
+    va_end(args);
+
+    if(t->size + len + 2 > t->capacity) {
+        t->capacity = MAX(t->capacity * 2, t->size + len + 2);
+        t->text = realloc(t->text, t->capacity);
+    }
+    if(t->size > 0) t->text[t->size++] = ' ';
+    memcpy(&t->text[t->size], token, len + 1);
+    t->size += len;
+}
+
+static void test_trace_flush(TestTrace* t) {
+    if(t->press_pending) {
+        test_trace_append(t, "p%X", t->press_key);
+        t->press_pending = false;
+    }
+    if(t->time != t->time_reported) {
+        test_trace_append(t, "d%llu", (unsigned long long)(t->time - t->time_reported));
+        t->time_reported = t->time;
+    }
+}
+
+static void test_trace_reset(TestTrace* t) {
+    t->size = 0;
+    t->time = 0;
+    t->time_reported = 0;
+    t->press_pending = false;
+    if(t->text) t->text[0] = '\0';
+}
+
+static const char* test_trace_text(TestTrace* t) {
+    test_trace_flush(t);
+    return t->text ? t->text : "";
+}
+
+static void test_trace_press(TestTrace* t, uint16_t key) {
+    test_trace_flush(t);
+    t->press_pending = true;
+    t->press_key = key;
+}
+
+static void test_trace_release(TestTrace* t, uint16_t key) {
+    if(t->press_pending && t->press_key == key && t->time == t->time_reported) {
+        t->press_pending = false;
+        test_trace_append(t, "k%X", key);
+    } else {
+        test_trace_flush(t);
+        test_trace_append(t, "r%X", key);
+    }
+}
+
+static void test_trace_event(TestTrace* t, const char* event) {
+    test_trace_flush(t);
+    test_trace_append(t, "%s", event);
+}
+
+/* Expected trace */
+
+static void exp_tap(uint16_t key) {
+    test_trace_press(&expected, key);
+    test_trace_release(&expected, key);
+}
+
+static void exp_string(const char* text) {
+    for(size_t i = 0; text[i] != '\0'; i++) {
+        uint16_t key = HID_ASCII_TO_KEY(text[i]);
+        if(key != HID_KEYBOARD_NONE) exp_tap(key);
+    }
+}
+
+static void exp_repeat_string(char c, size_t count) {
+    for(size_t i = 0; i < count; i++) {
+        exp_tap(HID_ASCII_TO_KEY(c));
+    }
+}
+
+static void exp_delay(uint32_t delay) {
+    expected.time += delay;
+}
+
+/* USB HID */
+
+static uint8_t led_state = 0;
+
+struct FuriHalUsbInterface {
+    uint8_t unused;
+};
+
+FuriHalUsbInterface usb_hid;
+
+bool furi_hal_usb_set_config(FuriHalUsbInterface* new_if, void* ctx) {
+    UNUSED(new_if);
+    UNUSED(ctx);
+    return true;
+}
+
+bool furi_hal_hid_is_connected() {
+    return true;
+}
+
+uint8_t furi_hal_hid_get_led_state() {
+    return led_state;
+}
+
+void furi_hal_hid_set_state_callback(HidStateCallback cb, void* ctx) {
+    UNUSED(cb);
+    UNUSED(ctx);
+}
+
+bool furi_hal_hid_kb_press(uint16_t button) {
+    if(button == HID_KEYBOARD_LOCK_NUM_LOCK) led_state ^= HID_KB_LED_NUM;
+    test_trace_press(&trace, button);
+    return true;
+}
+
+bool furi_hal_hid_kb_release(uint16_t button) {
+    test_trace_release(&trace, button);
+    return true;
+}
+
+bool furi_hal_hid_kb_release_all() {
+    test_trace_event(&trace, "ra");
+    return true;
+}
+
+/* Threads and flags on pthreads, time moves only when the worker waits */
+
+struct FuriThread {
+    pthread_t pthread;
+    FuriThreadCallback callback;
+    void* context;
+    uint32_t flags;
+};
+
+static pthread_mutex_t test_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t test_cond = PTHREAD_COND_INITIALIZER;
+static bool worker_blocked = false;
+static _Thread_local FuriThread* furi_thread_current = NULL;
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    UNUSED(name);
+    UNUSED(stack_size);
+    FuriThread* thread = malloc(sizeof(FuriThread));
+    thread->callback = callback;
+    thread->context = context;
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    free(thread);
+}
+
+static void* furi_thread_body(void* context) {
+    FuriThread* thread = context;
+    furi_thread_current = thread;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    worker_blocked = false;
+    furi_check(pthread_create(&thread->pthread, NULL, furi_thread_body, thread) == 0);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    return pthread_join(thread->pthread, NULL) == 0;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    pthread_mutex_lock(&test_mutex);
+    thread_id->flags |= flags;
+    uint32_t result = thread_id->flags;
+    worker_blocked = false;
+    pthread_cond_broadcast(&test_cond);
+    pthread_mutex_unlock(&test_mutex);
+    return result;
+}
+
+uint32_t furi_thread_flags_clear(uint32_t flags) {
+    FuriThread* thread = furi_thread_current;
+    furi_check(thread);
+    pthread_mutex_lock(&test_mutex);
+    uint32_t result = thread->flags;
+    thread->flags &= ~flags;
+    pthread_mutex_unlock(&test_mutex);
+    return result;
+}
+
+uint32_t furi_thread_flags_get(void) {
+    FuriThread* thread = furi_thread_current;
+    furi_check(thread);
+    pthread_mutex_lock(&test_mutex);
+    uint32_t flags = thread->flags;
+    pthread_mutex_unlock(&test_mutex);
+    return flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    FuriThread* thread = furi_thread_current;
+    furi_check(thread && !(options & FuriFlagWaitAll));
+
+    // Button is pressed as soon as the script waits for it
+    if(timeout != FuriWaitForever &&
+       bad_usb_script_get_state(script)->state == BadUsbStateWaitForBtn) {
+        test_trace_event(&trace, "btn");
+        bad_usb_script_toggle(script);
+    }
+
+    pthread_mutex_lock(&test_mutex);
+    while(!(thread->flags & flags)) {
+        if(timeout != FuriWaitForever) {
+            trace.time += timeout;
+            pthread_mutex_unlock(&test_mutex);
+            return FuriFlagErrorTimeout;
+        }
+        worker_blocked = true;
+        pthread_cond_broadcast(&test_cond);
+        pthread_cond_wait(&test_cond, &test_mutex);
+    }
+    uint32_t result = thread->flags;
+    if(!(options & FuriFlagNoClear)) thread->flags &= ~flags;
+    pthread_mutex_unlock(&test_mutex);
+    return result;
+}
+
+void* furi_record_open(const char* name) {
+    UNUSED(name);
+    return NULL;
+}
+
+void furi_record_close(const char* name) {
+    UNUSED(name);
+}
+
+/* Strings */
+
+struct FuriString {
+    char* data;
+    size_t size;
+    size_t capacity;
+};
+
+FuriString* furi_string_alloc(void) {
+    FuriString* string = malloc(sizeof(FuriString));
+    string->capacity = 16;
+    string->data = malloc(string->capacity);
+    return string;
+}
+
+void furi_string_free(FuriString* string) {
+    free(string->data);
+    free(string);
+}
+
+static void furi_string_reserve(FuriString* string, size_t size) {
+    if(size + 1 > string->capacity) {
+        string->capacity = MAX(string->capacity * 2, size + 1);
+        string->data = realloc(string->data, string->capacity);
+    }
+}
+
+void furi_string_reset(FuriString* string) {
+    string->size = 0;
+    string->data[0] = '\0';
+}
+
+void furi_string_set_str(FuriString* string, const char cstr[]) {
+    furi_string_reset(string);
+    furi_string_cat(string, cstr);
+}
+
+void furi_string_set(FuriString* string, FuriString* source) {
+    furi_string_set_str(string, source->data);
+}
+
+void furi_string_cat(FuriString* string, const char cstr[]) {
+    size_t len = strlen(cstr);
+    furi_string_reserve(string, string->size + len);
+    memcpy(&string->data[string->size], cstr, len + 1);
+    string->size += len;
+}
+
+void furi_string_push_back(FuriString* string, char c) {
+    furi_string_reserve(string, string->size + 1);
+    string->data[string->size++] = c;
+    string->data[string->size] = '\0';
+}
+
+char furi_string_get_char(const FuriString* string, size_t index) {
+    furi_check(index < string->size);
+    return string->data[index];
+}
+
+const char* furi_string_get_cstr(const FuriString* string) {
+    return string->data;
+}
+
+size_t furi_string_size(const FuriString* string) {
+    return string->size;
+}
+
+bool furi_string_empty(const FuriString* string) {
+    return string->size == 0;
+}
+
+void furi_string_trim(FuriString* string) {
+    const char* chars = " \n\r\t";
+    size_t start = 0;
+    while(start < string->size && strchr(chars, string->data[start])) start++;
+    size_t end = string->size;
+    while(end > start && strchr(chars, string->data[end - 1])) end--;
+    memmove(string->data, &string->data[start], end - start);
+    string->size = end - start;
+    string->data[string->size] = '\0';
+}
+
+int test_sscanf(const char* str, const char* format, ...) {
+    char host_format[64];
+    size_t len = 0;
+    for(size_t i = 0; format[i] != '\0' && len < sizeof(host_format) - 1; i++) {
+        if(format[i] == 'l' && i > 0 && format[i - 1] == '%') continue;
+        host_format[len++] = format[i];
+    }
+    host_format[len] = '\0';
+
+    va_list args;
+    va_start(args, format);
+    int result = vsscanf(str, host_format, args);
+    va_end(args);
+    return result;
+}
+
+/* Storage, files are kept in memory */
+
+typedef struct {
+    const char* path;
+    uint8_t* data;
+    size_t size;
+} TestFile;
+
+static TestFile test_files[2] = {{.path = TEST_SCRIPT_PATH}, {.path = TEST_LAYOUT_PATH}};
+
+struct File {
+    TestFile* test_file;
+    size_t pos;
+};
+
+static void test_file_set(const char* path, const void* data, size_t size) {
+    for(size_t i = 0; i < COUNT_OF(test_files); i++) {
+        if(strcmp(test_files[i].path, path) == 0) {
+            free(test_files[i].data);
+            test_files[i].data = malloc(size + 1);
+            memcpy(test_files[i].data, data, size);
+            test_files[i].size = size;
+            return;
+        }
+    }
+    furi_check(false);
+}
+
+File* storage_file_alloc(Storage* storage) {
+    UNUSED(storage);
+    return malloc(sizeof(File));
+}
+
+void storage_file_free(File* file) {
+    free(file);
+}
+
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode) {
+    furi_check(access_mode == FSAM_READ && open_mode == FSOM_OPEN_EXISTING);
+    for(size_t i = 0; i < COUNT_OF(test_files); i++) {
+        if(strcmp(test_files[i].path, path) == 0 && test_files[i].data) {
+            file->test_file = &test_files[i];
+            file->pos = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool storage_file_close(File* file) {
+    file->test_file = NULL;
+    return true;
+}
+
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read) {
+    if(!file->test_file) return 0;
+    size_t size = MIN((size_t)bytes_to_read, file->test_file->size - file->pos);
+    memcpy(buff, &file->test_file->data[file->pos], size);
+    file->pos += size;
+    return size;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    furi_check(from_start);
+    file->pos = MIN((size_t)offset, file->test_file->size);
+    return true;
+}
+
+bool storage_file_eof(File* file) {
+    return !file->test_file || file->pos >= file->test_file->size;
+}
+
+/* Script runs */
+
+static void test_wait_worker(void) {
+    pthread_mutex_lock(&test_mutex);
+    while(!worker_blocked) {
+        pthread_cond_wait(&test_cond, &test_mutex);
+    }
+    pthread_mutex_unlock(&test_mutex);
+}
+
+static void test_open(const char* text) {
+    test_file_set(TEST_SCRIPT_PATH, text, strlen(text));
+    led_state = 0;
+    FuriString* path = furi_string_alloc();
+    furi_string_set_str(path, TEST_SCRIPT_PATH);
+    script = bad_usb_script_open(path);
+    furi_string_free(path);
+    test_wait_worker();
+}
+
+static void test_close(void) {
+    bad_usb_script_close(script);
+    script = NULL;
+}
+
+static BadUsbState* test_run(void) {
+    test_trace_reset(&trace);
+    test_trace_reset(&expected);
+    bad_usb_script_toggle(script);
+    test_wait_worker();
+    return bad_usb_script_get_state(script);
+}
+
+static BadUsbState* test_open_run(const char* text) {
+    if(script) test_close();
+    test_open(text);
+    return test_run();
+}
+
+static int failures = 0;
+
+#define test_check(__e)                                                      \
+    do {                                                                     \
+        if(!(__e)) {                                                         \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #__e);            \
+            failures++;                                                      \
+        }                                                                    \
+    } while(0)
+
+static void test_check_trace_at(int line) {
+    const char* actual = test_trace_text(&trace);
+    const char* wanted = test_trace_text(&expected);
+    if(strcmp(actual, wanted) != 0) {
+        printf("FAIL %s:%d: trace\n", __FILE__, line);
+        printf("  got:  %.300s\n  want: %.300s\n", actual, wanted);
+        failures++;
+    }
+}
+
+#define test_check_trace() test_check_trace_at(__LINE__)
+
+static char* test_script(const char* format, ...) {
+    static char* text = NULL;
+    static size_t size = 0;
+    char line[128];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if(format[0] == '\0') {
+        size = 0;
+    } else {
+        text = realloc(text, size + strlen(line) + 1);
+        memcpy(&text[size], line, strlen(line) + 1);
+        size += strlen(line);
+    }
+    return text;
+}
+
+static void test_script_long_line(const char* command, char c, size_t count) {
+    test_script("%s ", command);
+    for(size_t i = 0; i < count; i++) {
+        test_script("%c", c);
+    }
+    test_script("\n");
+}
+
+static void test_string(void) {
+    BadUsbState* st = test_open_run("STRING Hello, World!\nSTRINGLN ab\nSTRING a\xC3\xA9z\n");
+    exp_string("Hello, World!");
+    exp_string("ab");
+    exp_tap(HID_KEYBOARD_RETURN);
+    // Characters outside of the layout are dropped
+    exp_string("az");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+    test_check(st->line_nb == 3 && st->line_cur == 3);
+}
+
+static void test_keys(void) {
+    BadUsbState* st = test_open_run("GUI r\nENTER\nCTRL c\nHOLD SHIFT\nSTRING a\nRELEASE SHIFT\n"
+                                    "SYSRQ b\n");
+    exp_tap(KEY_MOD_LEFT_GUI | HID_KEYBOARD_R);
+    exp_tap(HID_KEYBOARD_RETURN);
+    exp_tap(KEY_MOD_LEFT_CTRL | HID_KEYBOARD_C);
+    test_trace_press(&expected, KEY_MOD_LEFT_SHIFT);
+    exp_string("a");
+    test_trace_release(&expected, KEY_MOD_LEFT_SHIFT);
+    test_trace_press(&expected, KEY_MOD_LEFT_ALT | HID_KEYBOARD_PRINT_SCREEN);
+    test_trace_press(&expected, HID_KEYBOARD_B);
+    test_trace_event(&expected, "ra");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+}
+
+static void test_delay(void) {
+    BadUsbState* st = test_open_run(
+        "DEFAULT_DELAY 10\nSTRING a\nDELAY 2500\nREM comment\nSTRING b\nDEFAULTDELAY 0\n"
+        "STRING c\n");
+    exp_delay(10);
+    exp_string("a");
+    exp_delay(10 + 2500 + 10 + 10);
+    exp_string("b");
+    exp_delay(10);
+    exp_string("c");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+
+    // String delay is for the next string only, default delay follows the string
+    test_open_run("DEFAULT_DELAY 5\nSTRINGDELAY 20\nSTRING abc\nSTRING de\n");
+    exp_delay(5 + 5 + 20);
+    exp_string("a");
+    exp_delay(20);
+    exp_string("b");
+    exp_delay(20);
+    exp_string("c");
+    exp_delay(20 + 5);
+    exp_string("de");
+    exp_delay(5);
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+
+    st = test_open_run("STRING a\nDELAY 0\n");
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 2);
+    test_check(strcmp(st->error, "Invalid number 0") == 0);
+}
+
+static void test_altchar(void) {
+    BadUsbState* st = test_open_run("ALTCHAR 65\nALTSTRING AB\n");
+    // Num lock is pressed only if it is off
+    exp_tap(HID_KEYBOARD_LOCK_NUM_LOCK);
+    test_trace_press(&expected, KEY_MOD_LEFT_ALT);
+    exp_tap(HID_KEYPAD_6);
+    exp_tap(HID_KEYPAD_5);
+    test_trace_release(&expected, KEY_MOD_LEFT_ALT);
+    test_trace_press(&expected, KEY_MOD_LEFT_ALT);
+    exp_tap(HID_KEYPAD_6);
+    exp_tap(HID_KEYPAD_5);
+    test_trace_release(&expected, KEY_MOD_LEFT_ALT);
+    test_trace_press(&expected, KEY_MOD_LEFT_ALT);
+    exp_tap(HID_KEYPAD_6);
+    exp_tap(HID_KEYPAD_6);
+    test_trace_release(&expected, KEY_MOD_LEFT_ALT);
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+
+    // Invalid code is found before anything is sent
+    st = test_open_run("STRING a\nALTCHAR 6x\n");
+    exp_string("a");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 2);
+    test_check(strcmp(st->error, "Invalid altchar 6x") == 0);
+}
+
+static void test_repeat(void) {
+    BadUsbState* st = test_open_run("STRING ab\nREPEAT 3\nENTER\nREPEAT 1\nREPEAT 2\n");
+    for(size_t i = 0; i < 4; i++) {
+        exp_string("ab");
+    }
+    // REPEAT after REPEAT repeats the same line again
+    for(size_t i = 0; i < 4; i++) {
+        exp_tap(HID_KEYBOARD_RETURN);
+    }
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+    test_check(st->line_cur == 5);
+
+    // Nothing to repeat
+    st = test_open_run("REPEAT 2\nSTRING a\n");
+    exp_string("a");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+
+    // Default delay is taken after the REPEAT line and after every repeated line
+    test_open_run("DEFAULT_DELAY 7\nSTRING a\nREPEAT 2\n");
+    exp_delay(7);
+    exp_string("a");
+    exp_delay(7 + 7);
+    for(size_t i = 0; i < 2; i++) {
+        exp_string("a");
+        exp_delay(7);
+    }
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+}
+
+/* Line count that fills the first chunk is not known here, so the line that ends it
+ * is moved over the range where the chunk boundary is */
+static void test_repeat_chunks(void) {
+    bool all_passed = true;
+    for(size_t lines = 240; lines < 270; lines++) {
+        int failures_before = failures;
+        test_script("");
+        for(size_t i = 0; i < lines; i++) {
+            test_script("STRING a\n");
+        }
+        BadUsbState* st = test_open_run(test_script("STRING b\nREPEAT 2\nSTRING c\n"));
+        exp_repeat_string('a', lines);
+        exp_repeat_string('b', 3);
+        exp_string("c");
+        test_trace_event(&expected, "ra");
+        test_check_trace();
+        test_check(st->state == BadUsbStateDone);
+        test_check(st->line_cur == lines + 3);
+
+        // Second run starts over, the script doesn't fit into one chunk
+        test_run();
+        exp_repeat_string('a', lines);
+        exp_repeat_string('b', 3);
+        exp_string("c");
+        test_trace_event(&expected, "ra");
+        test_check_trace();
+
+        // Error line is counted over chunk boundaries too
+        test_script("");
+        for(size_t i = 0; i < lines; i++) {
+            test_script("STRING a\n");
+        }
+        st = test_open_run(test_script("REPEAT 1\nDELAY x\nSTRING b\n"));
+        exp_repeat_string('a', lines + 1);
+        test_trace_event(&expected, "ra");
+        test_check_trace();
+        test_check(st->state == BadUsbStateScriptError && st->error_line == lines + 2);
+
+        all_passed &= (failures == failures_before);
+    }
+    test_check(all_passed);
+
+    // String pool fills up before the instructions
+    for(size_t lines = 10; lines < 30; lines++) {
+        test_script("");
+        for(size_t i = 0; i < lines; i++) {
+            test_script_long_line("STRING", 'x', 100);
+        }
+        BadUsbState* st = test_open_run(test_script("REPEAT 2\nSTRING c\n"));
+        exp_repeat_string('x', 100 * (lines + 2));
+        exp_string("c");
+        test_trace_event(&expected, "ra");
+        test_check_trace();
+        test_check(st->state == BadUsbStateDone);
+    }
+
+    // Line that is larger than a chunk, repeated from the next chunk
+    test_script("");
+    test_script("STRING a\n");
+    test_script_long_line("STRING", 'x', 3000);
+    BadUsbState* st = test_open_run(test_script("REPEAT 2\nSTRING c\n"));
+    exp_string("a");
+    exp_repeat_string('x', 3000 * 3);
+    exp_string("c");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+
+    test_script("");
+    test_script_long_line("ALTSTRING", 'A', 1000);
+    st = test_open_run(test_script("REPEAT 1\n"));
+    exp_tap(HID_KEYBOARD_LOCK_NUM_LOCK);
+    for(size_t i = 0; i < 1000 * 2; i++) {
+        test_trace_press(&expected, KEY_MOD_LEFT_ALT);
+        exp_tap(HID_KEYPAD_6);
+        exp_tap(HID_KEYPAD_5);
+        test_trace_release(&expected, KEY_MOD_LEFT_ALT);
+    }
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+}
+
+static void test_errors(void) {
+    BadUsbState* st = test_open_run("STRING a\nFOO bar\nSTRING b\n");
+    exp_string("a");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 2);
+    test_check(strcmp(st->error, "No keycode defined for FOO bar") == 0);
+
+    st = test_open_run("STRING a\nDEFAULT_DELAY x\n");
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 2);
+    test_check(strcmp(st->error, "Invalid number x") == 0);
+
+    st = test_open_run("REPEAT 0\n");
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 1);
+
+    // Errors found while running
+    st = test_open_run("STRING a\nRELEASE CTRL\n");
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 2);
+    test_check(strcmp(st->error, "No keys are hold") == 0);
+
+    st = test_open_run("HOLD a\nHOLD b\nHOLD c\nHOLD d\nHOLD e\nHOLD f\n");
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 6);
+    test_check(strcmp(st->error, "Too many keys are hold") == 0);
+
+    // Error in a repeated line is reported on that line
+    st = test_open_run("STRING a\nHOLD a\nREPEAT 9\n");
+    test_check(st->state == BadUsbStateScriptError && st->error_line == 2);
+    test_check(strcmp(st->error, "Too many keys are hold") == 0);
+}
+
+static void test_wait_for_button(void) {
+    BadUsbState* st = test_open_run("STRING a\nWAIT_FOR_BUTTON_PRESS\nSTRING b\n");
+    exp_string("a");
+    test_trace_event(&expected, "btn");
+    exp_string("b");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    test_check(st->state == BadUsbStateDone);
+}
+
+static void test_layout(void) {
+    test_open_run("STRING ab\n");
+    exp_string("ab");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+
+    // Compiled script is kept between runs, layout change drops it
+    uint16_t layout[128];
+    memcpy(layout, hid_asciimap, sizeof(layout));
+    layout['a'] = HID_KEYBOARD_Q;
+    test_file_set(TEST_LAYOUT_PATH, layout, sizeof(layout));
+    FuriString* layout_path = furi_string_alloc();
+    furi_string_set_str(layout_path, TEST_LAYOUT_PATH);
+    bad_usb_script_set_keyboard_layout(script, layout_path);
+    test_run();
+    exp_tap(HID_KEYBOARD_Q);
+    exp_string("b");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+
+    furi_string_reset(layout_path);
+    bad_usb_script_set_keyboard_layout(script, layout_path);
+    test_run();
+    exp_string("ab");
+    test_trace_event(&expected, "ra");
+    test_check_trace();
+    furi_string_free(layout_path);
+}
+
+static const char* test_state_name(BadUsbWorkerState state) {
+    switch(state) {
+    case BadUsbStateDone:
+        return "done";
+    case BadUsbStateScriptError:
+        return "script error";
+    case BadUsbStateFileError:
+        return "file error";
+    default:
+        return "other";
+    }
+}
+
+/* Trace of every given script, to compare executors */
+static int test_print_traces(int argc, char* argv[]) {
+    for(int i = 1; i < argc; i++) {
+        FILE* file = fopen(argv[i], "rb");
+        if(!file) {
+            printf("%s: can't open\n", argv[i]);
+            return 1;
+        }
+        fseek(file, 0, SEEK_END);
+        size_t size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        char* text = malloc(size + 1);
+        furi_check(fread(text, 1, size, file) == size);
+        fclose(file);
+
+        test_open(text);
+        free(text);
+        // Second run takes the compiled script if it was kept
+        for(int run = 0; run < 2; run++) {
+            BadUsbState* st = test_run();
+            printf("%s run %d: %s", argv[i], run + 1, test_state_name(st->state));
+            if(st->state == BadUsbStateScriptError) {
+                printf(" at line %u: %s", st->error_line, st->error);
+                printf("\n%s\n", test_trace_text(&trace));
+                break;
+            }
+            printf("\n%s\n", test_trace_text(&trace));
+        }
+        test_close();
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if(argc > 1) return test_print_traces(argc, argv);
+
+    test_string();
+    test_keys();
+    test_delay();
+    test_altchar();
+    test_repeat();
+    test_repeat_chunks();
+    test_errors();
+    test_wait_for_button();
+    test_layout();
+    test_close();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,4 @@
+#pragma once
+/* Host shim of dolphin.h for the BadUSB script test, deeds are not counted */
+
+#define DOLPHIN_DEED(deed)
@@ -0,0 +1,92 @@
+#pragma once
+/* Host shim of furi.h for the BadUSB script test, only what the script worker uses */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(X) (void)(X)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+#define furi_check(__e)                                                             \
+    do {                                                                            \
+        if(!(__e)) {                                                                \
+            fprintf(stderr, "furi_check failed: %s, %s:%d\n", #__e, __FILE__, __LINE__); \
+            abort();                                                                \
+        }                                                                           \
+    } while(0)
+
+#define furi_assert(__e) furi_check(__e)
+
+#define FURI_LOG_E(tag, format, ...)
+#define FURI_LOG_I(tag, format, ...)
+#define FURI_LOG_D(tag, format, ...)
+
+// Firmware heap returns zeroed memory and the worker relies on it
+#define malloc(size) calloc(1, size)
+
+// Firmware scans uint32_t with %lu, on the host it is an unsigned int
+int test_sscanf(const char* str, const char* format, ...);
+#define sscanf test_sscanf
+
+typedef enum {
+    FuriWaitForever = 0xFFFFFFFFU,
+} FuriWait;
+
+typedef enum {
+    FuriFlagWaitAny = 0x00000000U,
+    FuriFlagWaitAll = 0x00000001U,
+    FuriFlagNoClear = 0x00000002U,
+    FuriFlagError = 0x80000000U,
+    FuriFlagErrorUnknown = 0xFFFFFFFFU,
+    FuriFlagErrorTimeout = 0xFFFFFFFEU,
+    FuriFlagErrorResource = 0xFFFFFFFDU,
+} FuriFlag;
+
+typedef struct FuriThread FuriThread;
+typedef FuriThread* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_clear(uint32_t flags);
+uint32_t furi_thread_flags_get(void);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+void* furi_record_open(const char* name);
+void furi_record_close(const char* name);
+
+typedef struct FuriString FuriString;
+
+FuriString* furi_string_alloc(void);
+void furi_string_free(FuriString* string);
+void furi_string_reset(FuriString* string);
+void furi_string_set(FuriString* string, FuriString* source);
+void furi_string_set_str(FuriString* string, const char cstr[]);
+void furi_string_cat(FuriString* string, const char cstr[]);
+void furi_string_push_back(FuriString* string, char c);
+char furi_string_get_char(const FuriString* string, size_t index);
+const char* furi_string_get_cstr(const FuriString* string);
+size_t furi_string_size(const FuriString* string);
+bool furi_string_empty(const FuriString* string);
+void furi_string_trim(FuriString* string);
@@ -0,0 +1,10 @@
+#pragma once
+/* Host shim of furi_hal.h for the BadUSB script test, USB HID only */
+#include <furi.h>
+#include <furi_hal_usb_hid.h>
+
+typedef struct FuriHalUsbInterface FuriHalUsbInterface;
+
+extern FuriHalUsbInterface usb_hid;
+
+bool furi_hal_usb_set_config(FuriHalUsbInterface* new_if, void* ctx);
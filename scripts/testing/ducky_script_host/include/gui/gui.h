@@ -0,0 +1,2 @@
+#pragma once
+/* Host shim, the script worker includes it but uses nothing from it */
@@ -0,0 +1,2 @@
+#pragma once
+/* Host shim, the BadUSB script test uses only the keyboard usage page */
@@ -0,0 +1,102 @@
+#pragma once
+/* Host shim of the libusb_stm32 keyboard usage page, only the keys BadUSB knows */
+
+enum {
+    HID_KEYBOARD_A = 0x04,
+    HID_KEYBOARD_B,
+    HID_KEYBOARD_C,
+    HID_KEYBOARD_D,
+    HID_KEYBOARD_E,
+    HID_KEYBOARD_F,
+    HID_KEYBOARD_G,
+    HID_KEYBOARD_H,
+    HID_KEYBOARD_I,
+    HID_KEYBOARD_J,
+    HID_KEYBOARD_K,
+    HID_KEYBOARD_L,
+    HID_KEYBOARD_M,
+    HID_KEYBOARD_N,
+    HID_KEYBOARD_O,
+    HID_KEYBOARD_P,
+    HID_KEYBOARD_Q,
+    HID_KEYBOARD_R,
+    HID_KEYBOARD_S,
+    HID_KEYBOARD_T,
+    HID_KEYBOARD_U,
+    HID_KEYBOARD_V,
+    HID_KEYBOARD_W,
+    HID_KEYBOARD_X,
+    HID_KEYBOARD_Y,
+    HID_KEYBOARD_Z,
+    HID_KEYBOARD_1,
+    HID_KEYBOARD_2,
+    HID_KEYBOARD_3,
+    HID_KEYBOARD_4,
+    HID_KEYBOARD_5,
+    HID_KEYBOARD_6,
+    HID_KEYBOARD_7,
+    HID_KEYBOARD_8,
+    HID_KEYBOARD_9,
+    HID_KEYBOARD_0,
+    HID_KEYBOARD_RETURN,
+    HID_KEYBOARD_ESCAPE,
+    HID_KEYBOARD_DELETE,
+    HID_KEYBOARD_TAB,
+    HID_KEYBOARD_SPACEBAR,
+    HID_KEYBOARD_MINUS,
+    HID_KEYBOARD_EQUAL_SIGN,
+    HID_KEYBOARD_OPEN_BRACKET,
+    HID_KEYBOARD_CLOSE_BRACKET,
+    HID_KEYBOARD_BACKSLASH,
+    HID_KEYBOARD_NON_US_HASH,
+    HID_KEYBOARD_SEMICOLON,
+    HID_KEYBOARD_APOSTROPHE,
+    HID_KEYBOARD_GRAVE_ACCENT,
+    HID_KEYBOARD_COMMA,
+    HID_KEYBOARD_DOT,
+    HID_KEYBOARD_SLASH,
+    HID_KEYBOARD_CAPS_LOCK,
+    HID_KEYBOARD_F1,
+    HID_KEYBOARD_F2,
+    HID_KEYBOARD_F3,
+    HID_KEYBOARD_F4,
+    HID_KEYBOARD_F5,
+    HID_KEYBOARD_F6,
+    HID_KEYBOARD_F7,
+    HID_KEYBOARD_F8,
+    HID_KEYBOARD_F9,
+    HID_KEYBOARD_F10,
+    HID_KEYBOARD_F11,
+    HID_KEYBOARD_F12,
+    HID_KEYBOARD_PRINT_SCREEN,
+    HID_KEYBOARD_SCROLL_LOCK,
+    HID_KEYBOARD_PAUSE,
+    HID_KEYBOARD_INSERT,
+    HID_KEYBOARD_HOME,
+    HID_KEYBOARD_PAGE_UP,
+    HID_KEYBOARD_DELETE_FORWARD,
+    HID_KEYBOARD_END,
+    HID_KEYBOARD_PAGE_DOWN,
+    HID_KEYBOARD_RIGHT_ARROW,
+    HID_KEYBOARD_LEFT_ARROW,
+    HID_KEYBOARD_DOWN_ARROW,
+    HID_KEYBOARD_UP_ARROW,
+    HID_KEYPAD_NUMLOCK,
+    HID_KEYPAD_SLASH,
+    HID_KEYPAD_ASTERISK,
+    HID_KEYPAD_MINUS,
+    HID_KEYPAD_PLUS,
+    HID_KEYPAD_ENTER,
+    HID_KEYPAD_1,
+    HID_KEYPAD_2,
+    HID_KEYPAD_3,
+    HID_KEYPAD_4,
+    HID_KEYPAD_5,
+    HID_KEYPAD_6,
+    HID_KEYPAD_7,
+    HID_KEYPAD_8,
+    HID_KEYPAD_9,
+    HID_KEYPAD_0,
+    HID_KEYBOARD_APPLICATION = 0x65,
+    HID_KEYBOARD_LOCK_NUM_LOCK = 0x83,
+};
@@ -0,0 +1,20 @@
+#pragma once
+/* Host shim of the storage API for the BadUSB script test, files live in memory */
+#include <furi.h>
+#include <filesystem_api_defines.h>
+
+typedef struct Storage Storage;
+
+#define RECORD_STORAGE "storage"
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(
+    File* file,
+    const char* path,
+    FS_AccessMode access_mode,
+    FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+uint16_t storage_file_read(File* file, void* buff, uint16_t bytes_to_read);
+bool storage_file_seek(File* file, uint32_t offset, bool from_start);
+bool storage_file_eof(File* file);
@@ -0,0 +1,25 @@
+#pragma once
+/* Host shim of furi.h for the SD SPI driver test, only what the driver uses */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(X) (void)(X)
+
+#define furi_check(__e)                                                             \
+    do {                                                                            \
+        if(!(__e)) {                                                                \
+            fprintf(stderr, "furi_check failed: %s, %s:%d\n", #__e, __FILE__, __LINE__); \
+            abort();                                                                \
+        }                                                                           \
+    } while(0)
+
+#define furi_assert(__e) furi_check(__e)
+
+#define FURI_LOG_I(tag, format, ...) printf("[I][%s] " format "\n", tag, ##__VA_ARGS__)
+
+void furi_delay_us(uint32_t microseconds);
+void furi_delay_ms(uint32_t milliseconds);
@@ -0,0 +1,2 @@
+#pragma once
+/* Host shim, see include/furi.h */
@@ -0,0 +1,74 @@
+#pragma once
+/* Host shim of furi_hal.h for the SD SPI driver test, only what the driver uses */
+#include <furi.h>
+
+typedef struct {
+    uint8_t pin;
+} GpioPin;
+
+typedef enum {
+    GpioModeOutputPushPull,
+    GpioModeAltFunctionPushPull,
+} GpioMode;
+
+typedef enum {
+    GpioPullNo,
+    GpioPullUp,
+} GpioPull;
+
+typedef enum {
+    GpioSpeedVeryHigh,
+} GpioSpeed;
+
+typedef enum {
+    GpioAltFn5SPI2,
+    GpioAltFnUnused,
+} GpioAltFn;
+
+void furi_hal_gpio_init_ex(
+    const GpioPin* gpio,
+    const GpioMode mode,
+    const GpioPull pull,
+    const GpioSpeed speed,
+    const GpioAltFn alt_fn);
+void furi_hal_gpio_write(const GpioPin* gpio, const bool state);
+
+typedef struct {
+    const GpioPin* miso;
+    const GpioPin* mosi;
+    const GpioPin* sck;
+    const GpioPin* cs;
+} FuriHalSpiBusHandle;
+
+extern FuriHalSpiBusHandle furi_hal_spi_bus_handle_sd_fast;
+extern FuriHalSpiBusHandle furi_hal_spi_bus_handle_sd_slow;
+extern FuriHalSpiBusHandle* furi_hal_sd_spi_handle;
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle);
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle);
+bool furi_hal_spi_bus_trx(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout);
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout_ms);
+
+typedef struct {
+    uint64_t start;
+    uint64_t value;
+} FuriHalCortexTimer;
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us);
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer);
+
+void furi_hal_power_enable_external_3_3v(void);
+void furi_hal_power_disable_external_3_3v(void);
+
+void hal_sd_detect_init(void);
+void hal_sd_detect_set_low(void);
@@ -0,0 +1,329 @@
+#include "sd_card_model.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SD_CARD_MODEL_QUEUE_SIZE (SD_CARD_MODEL_BLOCK_SIZE + 64)
+// Bytes before data token: access time of a read command, gap between blocks of multiple read
+#define SD_CARD_MODEL_NAC_ACCESS 32
+#define SD_CARD_MODEL_NAC 2
+#define SD_CARD_MODEL_BUSY 4
+
+typedef enum {
+    SdCardModelStateCommand,
+    SdCardModelStateReadMultiple,
+    SdCardModelStateWriteToken,
+    SdCardModelStateWriteData,
+} SdCardModelState;
+
+struct SdCardModel {
+    uint8_t* data;
+    uint32_t blocks;
+    bool high_capacity;
+    bool selected;
+    bool idle;
+    bool app_cmd;
+    uint8_t init_attempts;
+    uint32_t fail_block;
+
+    SdCardModelState state;
+    bool read_error;
+    bool write_multiple;
+    uint32_t block;
+    uint8_t r1_pending;
+
+    uint8_t frame[6];
+    uint8_t frame_len;
+
+    uint8_t queue[SD_CARD_MODEL_QUEUE_SIZE];
+    size_t queue_head;
+    size_t queue_len;
+    uint32_t busy;
+
+    uint8_t write_buffer[SD_CARD_MODEL_BLOCK_SIZE + 2];
+    size_t write_len;
+
+    SdCardModelStats stats;
+};
+
+SdCardModel* sd_card_model_alloc(uint32_t blocks, bool high_capacity) {
+    SdCardModel* model = calloc(1, sizeof(SdCardModel));
+    model->data = calloc(blocks, SD_CARD_MODEL_BLOCK_SIZE);
+    model->blocks = blocks;
+    model->high_capacity = high_capacity;
+    model->idle = true;
+    model->fail_block = SD_CARD_MODEL_NO_BLOCK;
+    return model;
+}
+
+void sd_card_model_free(SdCardModel* model) {
+    free(model->data);
+    free(model);
+}
+
+uint8_t* sd_card_model_get_data(SdCardModel* model) {
+    return model->data;
+}
+
+SdCardModelStats* sd_card_model_get_stats(SdCardModel* model) {
+    return &model->stats;
+}
+
+void sd_card_model_set_fail_block(SdCardModel* model, uint32_t block) {
+    model->fail_block = block;
+}
+
+bool sd_card_model_is_ready(SdCardModel* model) {
+    return model->state == SdCardModelStateCommand && model->busy == 0 &&
+           model->queue_len == 0;
+}
+
+static void sd_card_model_push(SdCardModel* model, uint8_t byte) {
+    if(model->queue_len < SD_CARD_MODEL_QUEUE_SIZE) {
+        model->queue[(model->queue_head + model->queue_len) % SD_CARD_MODEL_QUEUE_SIZE] = byte;
+        model->queue_len++;
+    } else {
+        model->stats.protocol_errors++;
+    }
+}
+
+static void sd_card_model_push_r1(SdCardModel* model, uint8_t r1) {
+    // NCR: one byte before the response
+    sd_card_model_push(model, 0xFF);
+    sd_card_model_push(model, r1);
+}
+
+static bool sd_card_model_get_block(SdCardModel* model, uint32_t arg, uint32_t* block) {
+    if(model->high_capacity) {
+        *block = arg;
+    } else {
+        if(arg % SD_CARD_MODEL_BLOCK_SIZE) return false;
+        *block = arg / SD_CARD_MODEL_BLOCK_SIZE;
+    }
+    return *block < model->blocks;
+}
+
+static void sd_card_model_push_block(SdCardModel* model, bool first) {
+    if(model->read_error) return;
+
+    for(size_t i = 0; i < (first ? SD_CARD_MODEL_NAC_ACCESS : SD_CARD_MODEL_NAC); i++) {
+        sd_card_model_push(model, 0xFF);
+    }
+
+    // Error token instead of data, multiple block read still has to be stopped
+    if(model->block >= model->blocks) {
+        sd_card_model_push(model, 0x08);
+        model->r1_pending = 0x20;
+        model->read_error = true;
+        return;
+    }
+    if(model->block == model->fail_block) {
+        sd_card_model_push(model, 0x04);
+        model->read_error = true;
+        return;
+    }
+
+    sd_card_model_push(model, 0xFE);
+    uint8_t* data = &model->data[model->block * SD_CARD_MODEL_BLOCK_SIZE];
+    for(size_t i = 0; i < SD_CARD_MODEL_BLOCK_SIZE; i++) {
+        sd_card_model_push(model, data[i]);
+    }
+    // CRC is not checked in SPI mode by default
+    sd_card_model_push(model, 0x00);
+    sd_card_model_push(model, 0x00);
+    model->stats.blocks_read++;
+    model->block++;
+}
+
+static void sd_card_model_command(SdCardModel* model) {
+    uint8_t cmd = model->frame[0] & 0x3F;
+    uint32_t arg = ((uint32_t)model->frame[1] << 24) | ((uint32_t)model->frame[2] << 16) |
+                   ((uint32_t)model->frame[3] << 8) | model->frame[4];
+    bool app_cmd = model->app_cmd;
+    model->app_cmd = false;
+    uint8_t r1_idle = model->idle ? 0x01 : 0x00;
+
+    if(app_cmd) {
+        model->stats.acmd[cmd]++;
+    } else {
+        model->stats.cmd[cmd]++;
+    }
+
+    if(cmd == 12) {
+        // Stop reading, stuff byte and R1b, data of the stopped block is dropped
+        if(model->state != SdCardModelStateReadMultiple) {
+            sd_card_model_push_r1(model, 0x04);
+            return;
+        }
+        model->queue_len = 0;
+        model->read_error = false;
+        sd_card_model_push(model, 0x5A);
+        sd_card_model_push(model, model->r1_pending);
+        model->r1_pending = 0;
+        model->state = SdCardModelStateCommand;
+        model->busy = SD_CARD_MODEL_BUSY;
+        return;
+    }
+
+    if(model->state != SdCardModelStateCommand) {
+        model->stats.protocol_errors++;
+        return;
+    }
+
+    uint32_t block;
+    if(app_cmd && cmd == 41) {
+        if(++model->init_attempts > 2) model->idle = false;
+        sd_card_model_push_r1(model, model->idle ? 0x01 : 0x00);
+    } else if(app_cmd && cmd == 23) {
+        model->stats.erase_count = arg;
+        sd_card_model_push_r1(model, 0x00);
+    } else if(cmd == 0) {
+        model->idle = true;
+        model->init_attempts = 0;
+        sd_card_model_push_r1(model, 0x01);
+    } else if(cmd == 8) {
+        // SDSC cards of version 1 don't know CMD8
+        if(!model->high_capacity) {
+            sd_card_model_push_r1(model, r1_idle | 0x04);
+            return;
+        }
+        sd_card_model_push_r1(model, r1_idle);
+        sd_card_model_push(model, 0x00);
+        sd_card_model_push(model, 0x00);
+        sd_card_model_push(model, (arg >> 8) & 0x0F);
+        sd_card_model_push(model, arg & 0xFF);
+    } else if(cmd == 55) {
+        model->app_cmd = true;
+        sd_card_model_push_r1(model, r1_idle);
+    } else if(cmd == 58) {
+        sd_card_model_push_r1(model, r1_idle);
+        sd_card_model_push(model, (model->idle ? 0x00 : 0x80) | (model->high_capacity ? 0x40 : 0));
+        sd_card_model_push(model, 0xFF);
+        sd_card_model_push(model, 0x80);
+        sd_card_model_push(model, 0x00);
+    } else if(model->idle) {
+        sd_card_model_push_r1(model, 0x01 | 0x04);
+    } else if(cmd == 13) {
+        sd_card_model_push_r1(model, 0x00);
+        sd_card_model_push(model, 0x00);
+    } else if(cmd == 16) {
+        sd_card_model_push_r1(model, arg == SD_CARD_MODEL_BLOCK_SIZE ? 0x00 : 0x40);
+    } else if(cmd == 17 || cmd == 18) {
+        if(!sd_card_model_get_block(model, arg, &block)) {
+            sd_card_model_push_r1(model, 0x20);
+            return;
+        }
+        sd_card_model_push_r1(model, 0x00);
+        model->block = block;
+        model->state = (cmd == 17) ? SdCardModelStateCommand : SdCardModelStateReadMultiple;
+        sd_card_model_push_block(model, true);
+        if(cmd == 17) {
+            model->read_error = false;
+            model->r1_pending = 0;
+        }
+    } else if(cmd == 24 || cmd == 25) {
+        if(!sd_card_model_get_block(model, arg, &block)) {
+            sd_card_model_push_r1(model, 0x20);
+            return;
+        }
+        sd_card_model_push_r1(model, 0x00);
+        model->block = block;
+        model->write_multiple = (cmd == 25);
+        model->state = SdCardModelStateWriteToken;
+    } else {
+        sd_card_model_push_r1(model, 0x04);
+    }
+}
+
+static void sd_card_model_write_byte(SdCardModel* model, uint8_t mosi) {
+    if(model->state == SdCardModelStateWriteToken) {
+        if(mosi == 0xFF) return;
+        if(mosi == (model->write_multiple ? 0xFC : 0xFE)) {
+            model->write_len = 0;
+            model->state = SdCardModelStateWriteData;
+        } else if(model->write_multiple && mosi == 0xFD) {
+            // Stop token, one byte before busy
+            sd_card_model_push(model, 0xFF);
+            model->busy = SD_CARD_MODEL_BUSY;
+            model->state = SdCardModelStateCommand;
+        } else {
+            model->stats.protocol_errors++;
+        }
+        return;
+    }
+
+    model->write_buffer[model->write_len++] = mosi;
+    if(model->write_len < sizeof(model->write_buffer)) return;
+
+    bool ok = model->block < model->blocks && model->block != model->fail_block;
+    if(ok) {
+        memcpy(
+            &model->data[model->block * SD_CARD_MODEL_BLOCK_SIZE],
+            model->write_buffer,
+            SD_CARD_MODEL_BLOCK_SIZE);
+        model->stats.blocks_written++;
+        model->block++;
+    }
+    // Data response: xxx0 sss1, 010 accepted, 110 write error
+    sd_card_model_push(model, ok ? 0xE5 : 0xED);
+    model->busy = SD_CARD_MODEL_BUSY;
+    // Multiple block write ends with stop token even after an error
+    model->state = model->write_multiple ? SdCardModelStateWriteToken : SdCardModelStateCommand;
+}
+
+void sd_card_model_select(SdCardModel* model, bool selected) {
+    if(model->selected && !selected) {
+        // Card stops driving MISO, command in progress is lost, busy goes on
+        model->frame_len = 0;
+        if(model->state != SdCardModelStateReadMultiple) {
+            model->queue_len = 0;
+        }
+    }
+    model->selected = selected;
+}
+
+uint8_t sd_card_model_exchange(SdCardModel* model, uint8_t mosi) {
+    if(!model->selected) return 0xFF;
+
+    uint8_t miso = 0xFF;
+    if(model->queue_len) {
+        miso = model->queue[model->queue_head];
+        model->queue_head = (model->queue_head + 1) % SD_CARD_MODEL_QUEUE_SIZE;
+        model->queue_len--;
+    } else if(model->busy) {
+        miso = 0x00;
+        model->busy--;
+    }
+
+    if(model->state == SdCardModelStateWriteToken || model->state == SdCardModelStateWriteData) {
+        if(model->queue_len == 0 && model->busy == 0) {
+            sd_card_model_write_byte(model, mosi);
+        }
+        return miso;
+    }
+
+    if(model->frame_len == 0) {
+        if((mosi & 0xC0) == 0x40) {
+            model->frame[model->frame_len++] = mosi;
+        } else if(mosi != 0xFF) {
+            model->stats.protocol_errors++;
+        }
+    } else {
+        model->frame[model->frame_len++] = mosi;
+        if(model->frame_len == sizeof(model->frame)) {
+            model->frame_len = 0;
+            if(model->busy) {
+                // Command during busy is ignored by the card
+                model->stats.protocol_errors++;
+            } else {
+                sd_card_model_command(model);
+            }
+        }
+    }
+
+    if(model->state == SdCardModelStateReadMultiple && model->queue_len == 0) {
+        sd_card_model_push_block(model, false);
+    }
+
+    return miso;
+}
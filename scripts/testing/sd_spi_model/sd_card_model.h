@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/** SD card in SPI mode, byte level model
+ *
+ * Follows "Part 1 Physical Layer Simplified Specification", SPI mode chapter:
+ * command frames, R1/R1b/R2/R3/R7 responses, data tokens, data responses and
+ * busy signaling. Only commands used by the firmware driver are implemented.
+ */
+
+#define SD_CARD_MODEL_BLOCK_SIZE 512
+#define SD_CARD_MODEL_NO_BLOCK UINT32_MAX
+
+typedef struct SdCardModel SdCardModel;
+
+typedef struct {
+    uint32_t cmd[64];
+    uint32_t acmd[64];
+    uint32_t blocks_read;
+    uint32_t blocks_written;
+    uint32_t erase_count;
+    uint32_t protocol_errors;
+} SdCardModelStats;
+
+/** Allocate card model
+ *
+ * @param blocks        - card capacity in blocks
+ * @param high_capacity - SDHC card with block addressing, byte addressing otherwise
+ * @return SdCardModel*
+ */
+SdCardModel* sd_card_model_alloc(uint32_t blocks, bool high_capacity);
+
+void sd_card_model_free(SdCardModel* model);
+
+/** Change chip select, card ignores bus and releases MISO when not selected */
+void sd_card_model_select(SdCardModel* model, bool selected);
+
+/** Exchange one byte
+ *
+ * @param model - SdCardModel instance
+ * @param mosi  - byte from host
+ * @return byte from card
+ */
+uint8_t sd_card_model_exchange(SdCardModel* model, uint8_t mosi);
+
+/** Card memory, capacity * SD_CARD_MODEL_BLOCK_SIZE bytes */
+uint8_t* sd_card_model_get_data(SdCardModel* model);
+
+SdCardModelStats* sd_card_model_get_stats(SdCardModel* model);
+
+/** Fail reads and writes of the block, SD_CARD_MODEL_NO_BLOCK to disable */
+void sd_card_model_set_fail_block(SdCardModel* model, uint32_t block);
+
+/** Check that card waits for a command and is not busy */
+bool sd_card_model_is_ready(SdCardModel* model);
@@ -0,0 +1,278 @@
+/**
+ * Host test of the SD SPI driver protocol against the card model
+ *
+ *   cc -Iinclude -I../../../firmware/targets/f7/fatfs -o sd_spi_model_test \
+ *       sd_spi_model_test.c sd_card_model.c ../../../firmware/targets/f7/fatfs/sd_spi_io.c
+ *   ./sd_spi_model_test
+ *
+ * SPI bus and GPIO of the firmware HAL are replaced with the card model,
+ * time is counted in bus bytes, so timeouts are deterministic.
+ */
+#include <furi.h>
+#include <furi_hal.h>
+#include <sd_spi_io.h>
+
+#include "sd_card_model.h"
+
+#define TEST_CARD_BLOCKS 1024
+
+static SdCardModel* card = NULL;
+static uint64_t bus_bytes = 0;
+
+static const GpioPin gpio_sd_cs = {.pin = 1};
+static const GpioPin gpio_spi_pins = {.pin = 0};
+
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_sd_fast = {
+    .miso = &gpio_spi_pins,
+    .mosi = &gpio_spi_pins,
+    .sck = &gpio_spi_pins,
+    .cs = &gpio_sd_cs,
+};
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_sd_slow = {
+    .miso = &gpio_spi_pins,
+    .mosi = &gpio_spi_pins,
+    .sck = &gpio_spi_pins,
+    .cs = &gpio_sd_cs,
+};
+FuriHalSpiBusHandle* furi_hal_sd_spi_handle = NULL;
+
+void furi_delay_us(uint32_t microseconds) {
+    UNUSED(microseconds);
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    UNUSED(milliseconds);
+}
+
+void furi_hal_gpio_init_ex(
+    const GpioPin* gpio,
+    const GpioMode mode,
+    const GpioPull pull,
+    const GpioSpeed speed,
+    const GpioAltFn alt_fn) {
+    UNUSED(gpio);
+    UNUSED(mode);
+    UNUSED(pull);
+    UNUSED(speed);
+    UNUSED(alt_fn);
+}
+
+void furi_hal_gpio_write(const GpioPin* gpio, const bool state) {
+    if(gpio == &gpio_sd_cs) {
+        sd_card_model_select(card, !state);
+    }
+}
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle) {
+    UNUSED(handle);
+}
+
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle) {
+    UNUSED(handle);
+}
+
+bool furi_hal_spi_bus_trx(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    furi_check(handle == furi_hal_sd_spi_handle);
+
+    for(size_t i = 0; i < size; i++) {
+        uint8_t miso = sd_card_model_exchange(card, tx_buffer ? tx_buffer[i] : 0xFF);
+        if(rx_buffer) rx_buffer[i] = miso;
+        bus_bytes++;
+    }
+    return true;
+}
+
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout_ms) {
+    return furi_hal_spi_bus_trx(handle, tx_buffer, rx_buffer, size, timeout_ms);
+}
+
+FuriHalCortexTimer furi_hal_cortex_timer_get(uint32_t timeout_us) {
+    FuriHalCortexTimer timer = {.start = bus_bytes, .value = timeout_us};
+    return timer;
+}
+
+bool furi_hal_cortex_timer_is_expired(FuriHalCortexTimer cortex_timer) {
+    // One byte on the bus is one microsecond
+    return (bus_bytes - cortex_timer.start) >= cortex_timer.value;
+}
+
+void furi_hal_power_enable_external_3_3v(void) {
+}
+
+void furi_hal_power_disable_external_3_3v(void) {
+}
+
+void hal_sd_detect_init(void) {
+}
+
+void hal_sd_detect_set_low(void) {
+}
+
+void sector_cache_init(void) {
+}
+
+static int failures = 0;
+
+#define test_check(__e)                                                      \
+    do {                                                                     \
+        if(!(__e)) {                                                         \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #__e);            \
+            failures++;                                                      \
+        }                                                                    \
+    } while(0)
+
+static void test_card_setup(bool high_capacity) {
+    if(card) sd_card_model_free(card);
+    card = sd_card_model_alloc(TEST_CARD_BLOCKS, high_capacity);
+    test_check(sd_init(false) == SdSpiStatusOK);
+    memset(sd_card_model_get_stats(card), 0, sizeof(SdCardModelStats));
+}
+
+static SdSpiStatus test_read(uint32_t* data, uint32_t address, uint32_t blocks) {
+    furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
+    SdSpiStatus status = sd_read_blocks(data, address, blocks, SD_TIMEOUT_MS);
+    furi_hal_sd_spi_handle = NULL;
+    return status;
+}
+
+static SdSpiStatus test_write(uint32_t* data, uint32_t address, uint32_t blocks) {
+    furi_hal_sd_spi_handle = &furi_hal_spi_bus_handle_sd_fast;
+    SdSpiStatus status = sd_write_blocks(data, address, blocks, SD_TIMEOUT_MS);
+    furi_hal_sd_spi_handle = NULL;
+    return status;
+}
+
+static void test_fill(uint8_t* data, size_t size, uint8_t seed) {
+    for(size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)(i * 31 + seed + (i >> 9));
+    }
+}
+
+static void test_read_write(bool high_capacity) {
+    static uint32_t write_buffer[16 * SD_BLOCK_SIZE / 4];
+    static uint32_t read_buffer[16 * SD_BLOCK_SIZE / 4];
+    test_card_setup(high_capacity);
+    SdCardModelStats* stats = sd_card_model_get_stats(card);
+    uint8_t* card_data = sd_card_model_get_data(card);
+
+    // Multiple block write is one CMD25 with pre-erase
+    test_fill((uint8_t*)write_buffer, sizeof(write_buffer), 1);
+    test_check(test_write(write_buffer, 100, 16) == SdSpiStatusOK);
+    test_check(memcmp(&card_data[100 * SD_BLOCK_SIZE], write_buffer, sizeof(write_buffer)) == 0);
+    test_check(stats->cmd[25] == 1 && stats->cmd[24] == 0);
+    test_check(stats->acmd[23] == 1 && stats->erase_count == 16);
+    test_check(stats->blocks_written == 16);
+    test_check(sd_card_model_is_ready(card));
+
+    // Multiple block read is one CMD18 with CMD12
+    memset(read_buffer, 0, sizeof(read_buffer));
+    test_check(test_read(read_buffer, 100, 16) == SdSpiStatusOK);
+    test_check(memcmp(read_buffer, write_buffer, sizeof(write_buffer)) == 0);
+    test_check(stats->cmd[18] == 1 && stats->cmd[12] == 1 && stats->cmd[17] == 0);
+    test_check(sd_card_model_is_ready(card));
+
+    // Single block goes with single block commands
+    test_fill((uint8_t*)write_buffer, SD_BLOCK_SIZE, 7);
+    test_check(test_write(write_buffer, TEST_CARD_BLOCKS - 1, 1) == SdSpiStatusOK);
+    test_check(test_read(read_buffer, TEST_CARD_BLOCKS - 1, 1) == SdSpiStatusOK);
+    test_check(memcmp(read_buffer, write_buffer, SD_BLOCK_SIZE) == 0);
+    test_check(stats->cmd[24] == 1 && stats->cmd[17] == 1);
+    test_check(stats->cmd[25] == 1 && stats->cmd[18] == 1);
+
+    // Two blocks read back into the middle of data written by one transaction
+    test_check(test_read(read_buffer, 107, 2) == SdSpiStatusOK);
+    test_fill((uint8_t*)write_buffer, sizeof(write_buffer), 1);
+    test_check(memcmp(read_buffer, &write_buffer[7 * SD_BLOCK_SIZE / 4], 2 * SD_BLOCK_SIZE) == 0);
+
+    test_check(stats->protocol_errors == 0);
+    test_check(sd_card_model_is_ready(card));
+}
+
+static void test_errors(void) {
+    static uint32_t buffer[8 * SD_BLOCK_SIZE / 4];
+    test_card_setup(true);
+    SdCardModelStats* stats = sd_card_model_get_stats(card);
+
+    // Read error in the middle, transmission is stopped anyway
+    sd_card_model_set_fail_block(card, 203);
+    test_check(test_read(buffer, 200, 8) != SdSpiStatusOK);
+    test_check(stats->cmd[12] == 1);
+    test_check(sd_card_model_is_ready(card));
+
+    // Write error in the middle, blocks before are written, transfer is stopped with token
+    test_fill((uint8_t*)buffer, sizeof(buffer), 3);
+    test_check(test_write(buffer, 200, 8) != SdSpiStatusOK);
+    test_check(stats->blocks_written == 3);
+    test_check(memcmp(&sd_card_model_get_data(card)[200 * SD_BLOCK_SIZE], buffer, 3 * 512) == 0);
+    test_check(sd_card_model_is_ready(card));
+
+    // Read over the end of card
+    sd_card_model_set_fail_block(card, SD_CARD_MODEL_NO_BLOCK);
+    test_check(test_read(buffer, TEST_CARD_BLOCKS - 2, 4) != SdSpiStatusOK);
+    test_check(sd_card_model_is_ready(card));
+
+    // Card works after errors
+    test_check(test_read(buffer, 200, 8) == SdSpiStatusOK);
+    test_check(test_write(buffer, 300, 8) == SdSpiStatusOK);
+
+    test_check(stats->protocol_errors == 0);
+    test_check(sd_card_model_is_ready(card));
+}
+
+static void test_bus_usage(void) {
+    static uint32_t buffer[64 * SD_BLOCK_SIZE / 4];
+    test_card_setup(true);
+
+    uint64_t start = bus_bytes;
+    for(uint32_t i = 0; i < 64; i++) {
+        test_check(test_read(&buffer[i * SD_BLOCK_SIZE / 4], i, 1) == SdSpiStatusOK);
+    }
+    uint64_t single_read = bus_bytes - start;
+
+    start = bus_bytes;
+    test_check(test_read(buffer, 0, 64) == SdSpiStatusOK);
+    uint64_t multiple_read = bus_bytes - start;
+
+    start = bus_bytes;
+    for(uint32_t i = 0; i < 64; i++) {
+        test_check(test_write(&buffer[i * SD_BLOCK_SIZE / 4], i, 1) == SdSpiStatusOK);
+    }
+    uint64_t single_write = bus_bytes - start;
+
+    start = bus_bytes;
+    test_check(test_write(buffer, 0, 64) == SdSpiStatusOK);
+    uint64_t multiple_write = bus_bytes - start;
+
+    printf(
+        "64 blocks, bus bytes: read %llu single / %llu multiple\n",
+        (unsigned long long)single_read,
+        (unsigned long long)multiple_read);
+    printf(
+        "64 blocks, bus bytes: write %llu single / %llu multiple\n",
+        (unsigned long long)single_write,
+        (unsigned long long)multiple_write);
+    test_check(multiple_read < single_read);
+    test_check(multiple_write < single_write);
+}
+
+int main(void) {
+    test_read_write(true);
+    test_read_write(false);
+    test_errors();
+    test_bus_usage();
+
+    sd_card_model_free(card);
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+/* Host shim of furi.h for the sector cache test, only what the cache uses */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNUSED(X) (void)(X)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+
+#define furi_check(__e)                                                             \
+    do {                                                                            \
+        if(!(__e)) {                                                                \
+            fprintf(stderr, "furi_check failed: %s, %s:%d\n", #__e, __FILE__, __LINE__); \
+            abort();                                                                \
+        }                                                                           \
+    } while(0)
+
+#define furi_assert(__e) furi_check(__e)
+
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+
+void* memmgr_alloc_from_pool(size_t size);
+size_t memmgr_pool_get_max_block(void);
@@ -0,0 +1,2 @@
+#pragma once
+/* Host shim of furi_hal_memory.h, pool allocator is declared in furi.h */
@@ -0,0 +1,308 @@
+/**
+ * Host test of the SD sector cache write-back
+ *
+ *   cc -g -fsanitize=address,undefined -Iinclude -I../../../firmware/targets/f7/fatfs \
+ *       -o sector_cache_test sector_cache_test.c ../../../firmware/targets/f7/fatfs/sector_cache.c
+ *   ./sector_cache_test
+ *
+ * Card is a sector array, reads and writes go the same way as in user_diskio.c:
+ * metadata through the cache, write back through the callback. Time is a counter.
+ */
+#include <furi.h>
+#include <sector_cache.h>
+
+#define TEST_SECTOR_SIZE 512
+#define TEST_CARD_SECTORS 256
+#define TEST_CACHE_WAYS 4
+#define TEST_CACHE_SETS 8
+#define TEST_DIRTY_MAX 8
+#define TEST_DIRTY_TIMEOUT_MS 2000
+
+static uint8_t card[TEST_CARD_SECTORS][TEST_SECTOR_SIZE];
+static uint32_t card_writes[TEST_CARD_SECTORS * 2];
+static uint32_t card_write_count = 0;
+static bool card_write_fail = false;
+static uint32_t tick = 0;
+
+uint32_t furi_get_tick(void) {
+    return tick;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+void* memmgr_alloc_from_pool(size_t size) {
+    return malloc(size);
+}
+
+size_t memmgr_pool_get_max_block(void) {
+    // Enough for the largest cache
+    return 128 * 1024;
+}
+
+static int failures = 0;
+
+#define test_check(__e)                                                      \
+    do {                                                                     \
+        if(!(__e)) {                                                         \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #__e);            \
+            failures++;                                                      \
+        }                                                                    \
+    } while(0)
+
+static bool test_write_back(uint32_t n_sector, const uint8_t* data, void* context) {
+    UNUSED(context);
+    if(card_write_fail) return false;
+    furi_check(n_sector < TEST_CARD_SECTORS);
+    memcpy(card[n_sector], data, TEST_SECTOR_SIZE);
+    card_writes[card_write_count++] = n_sector;
+    return true;
+}
+
+/* Same as driver_write for a single window sector */
+static void test_meta_write(uint32_t n_sector, uint8_t fill) {
+    uint8_t data[TEST_SECTOR_SIZE];
+    memset(data, fill, TEST_SECTOR_SIZE);
+    if(!sector_cache_write(n_sector, data, test_write_back, NULL)) {
+        test_write_back(n_sector, data, NULL);
+        sector_cache_put(n_sector, data, true, test_write_back, NULL);
+    }
+}
+
+/* Same as driver_read, single sector goes through the cache */
+static void test_read(uint32_t n_sector, uint32_t count, bool meta, uint8_t* data) {
+    if(count == 1) {
+        uint8_t* cached = sector_cache_get(n_sector);
+        if(cached) {
+            memcpy(data, cached, TEST_SECTOR_SIZE);
+            return;
+        }
+    }
+
+    memcpy(data, card[n_sector], count * TEST_SECTOR_SIZE);
+    if(count == 1) {
+        sector_cache_put(n_sector, data, meta, test_write_back, NULL);
+    } else {
+        sector_cache_read_dirty(n_sector, count, data);
+    }
+}
+
+static bool test_sector_is(const uint8_t* data, uint8_t fill) {
+    for(size_t i = 0; i < TEST_SECTOR_SIZE; i++) {
+        if(data[i] != fill) return false;
+    }
+    return true;
+}
+
+/* Same Fibonacci hash as the cache, used to fill one set */
+static uint32_t test_set(uint32_t n_sector) {
+    return (uint32_t)(n_sector * 2654435769U) >> (32 - __builtin_ctz(TEST_CACHE_SETS));
+}
+
+static void test_same_set(uint32_t first, uint32_t* sectors, uint32_t count) {
+    uint32_t found = 0;
+    for(uint32_t n_sector = first; n_sector < TEST_CARD_SECTORS && found < count; n_sector++) {
+        if(test_set(n_sector) == test_set(first)) sectors[found++] = n_sector;
+    }
+    furi_check(found == count);
+}
+
+static void test_reset(void) {
+    sector_cache_discard();
+    sector_cache_init();
+    memset(card, 0, sizeof(card));
+    card_write_count = 0;
+    card_write_fail = false;
+}
+
+static SectorCacheStats test_stats(void) {
+    SectorCacheStats stats;
+    sector_cache_get_stats(&stats);
+    return stats;
+}
+
+static void test_coalesce(void) {
+    test_reset();
+    SectorCacheStats before = test_stats();
+    test_check(before.sectors == TEST_CACHE_SETS * TEST_CACHE_WAYS);
+
+    test_meta_write(10, 0x11);
+    test_meta_write(10, 0x22);
+    test_meta_write(10, 0x33);
+
+    SectorCacheStats stats = test_stats();
+    test_check(stats.dirty == 1);
+    test_check(stats.coalesced - before.coalesced == 2);
+    // Nothing is on the card until sync
+    test_check(card_write_count == 0);
+    test_check(test_sector_is(card[10], 0x00));
+}
+
+static void test_read_dirty(void) {
+    test_reset();
+    test_meta_write(10, 0x5A);
+
+    uint8_t data[TEST_SECTOR_SIZE * 8];
+    SectorCacheStats before = test_stats();
+    test_read(10, 1, true, data);
+    test_check(test_sector_is(data, 0x5A));
+    test_check(test_stats().hits - before.hits == 1);
+
+    // Multi-sector read comes from the card, dirty sector is copied over it
+    memset(card[9], 0x09, TEST_SECTOR_SIZE);
+    test_read(8, 8, false, data);
+    test_check(test_sector_is(&data[1 * TEST_SECTOR_SIZE], 0x09));
+    test_check(test_sector_is(&data[2 * TEST_SECTOR_SIZE], 0x5A));
+    test_check(test_sector_is(&data[3 * TEST_SECTOR_SIZE], 0x00));
+    test_check(test_stats().dirty == 1);
+}
+
+static void test_eviction(void) {
+    test_reset();
+    uint32_t sectors[TEST_CACHE_WAYS + 2];
+    test_same_set(1, sectors, TEST_CACHE_WAYS + 2);
+
+    for(uint32_t i = 0; i < TEST_CACHE_WAYS; i++) {
+        test_meta_write(sectors[i], 0x40 + i);
+    }
+    test_check(test_stats().dirty == TEST_CACHE_WAYS);
+
+    // Data sectors never evict dirty metadata
+    uint8_t data[TEST_SECTOR_SIZE];
+    test_read(sectors[TEST_CACHE_WAYS], 1, false, data);
+    test_check(sector_cache_get(sectors[TEST_CACHE_WAYS]) == NULL);
+    test_check(card_write_count == 0);
+
+    // Least recently used dirty sector is written back to make room
+    SectorCacheStats before = test_stats();
+    test_read(sectors[0], 1, true, data);
+    test_meta_write(sectors[TEST_CACHE_WAYS], 0x50);
+    test_check(card_write_count == 1 && card_writes[0] == sectors[1]);
+    test_check(test_sector_is(card[sectors[1]], 0x41));
+    test_check(test_stats().written_back - before.written_back == 1);
+    test_check(test_stats().dirty == TEST_CACHE_WAYS);
+
+    // Evicted sector reads back from the card
+    test_read(sectors[1], 1, true, data);
+    test_check(test_sector_is(data, 0x41));
+
+    // Victim that can't be written back stays, the caller writes to the card itself
+    test_meta_write(sectors[1], 0x42);
+    card_write_fail = true;
+    uint32_t dirty = test_stats().dirty;
+    test_check(!sector_cache_write(sectors[TEST_CACHE_WAYS + 1], data, test_write_back, NULL));
+    test_check(test_stats().dirty == dirty);
+    test_check(sector_cache_get(sectors[TEST_CACHE_WAYS + 1]) == NULL);
+    card_write_fail = false;
+}
+
+static void test_sync(void) {
+    test_reset();
+    const uint32_t sectors[] = {200, 3, 97, 40};
+    for(size_t i = 0; i < COUNT_OF(sectors); i++) {
+        test_meta_write(sectors[i], 0x60 + i);
+    }
+
+    // Failed write back keeps everything dirty for the next CTRL_SYNC
+    card_write_fail = true;
+    test_check(!sector_cache_flush(test_write_back, NULL));
+    test_check(test_stats().dirty == COUNT_OF(sectors));
+    card_write_fail = false;
+
+    // CTRL_SYNC writes every dirty sector once, in sector order
+    test_check(sector_cache_flush(test_write_back, NULL));
+    test_check(test_stats().dirty == 0);
+    test_check(card_write_count == COUNT_OF(sectors));
+    test_check(card_writes[0] == 3 && card_writes[1] == 40);
+    test_check(card_writes[2] == 97 && card_writes[3] == 200);
+    for(size_t i = 0; i < COUNT_OF(sectors); i++) {
+        test_check(test_sector_is(card[sectors[i]], 0x60 + i));
+    }
+
+    // Clean sectors stay cached and are not written again
+    uint8_t data[TEST_SECTOR_SIZE];
+    test_read(97, 1, true, data);
+    test_check(test_sector_is(data, 0x62));
+    test_check(sector_cache_flush(test_write_back, NULL));
+    test_check(card_write_count == COUNT_OF(sectors));
+}
+
+static void test_unmount(void) {
+    test_reset();
+    test_meta_write(7, 0x70);
+    test_meta_write(8, 0x80);
+    uint8_t data[TEST_SECTOR_SIZE];
+    test_read(9, 1, true, data);
+
+    // sd_unmount_card: sync while the card is there, then drop everything
+    test_check(sector_cache_flush(test_write_back, NULL));
+    sector_cache_discard();
+    test_check(test_stats().dirty == 0);
+    test_check(sector_cache_get(7) == NULL);
+    test_check(sector_cache_get(8) == NULL);
+    test_check(sector_cache_get(9) == NULL);
+    test_check(test_sector_is(card[7], 0x70) && test_sector_is(card[8], 0x80));
+
+    // Card is gone: dirty sectors are dropped, not written anywhere
+    test_meta_write(7, 0x71);
+    sector_cache_discard();
+    test_check(sector_cache_get(7) == NULL);
+    test_check(test_sector_is(card[7], 0x70));
+    test_check(sector_cache_flush(test_write_back, NULL));
+    test_check(card_write_count == 2);
+
+    // Card init drops clean sectors but keeps dirty ones, they are the only copy
+    test_meta_write(7, 0x72);
+    test_read(9, 1, true, data);
+    sector_cache_init();
+    test_check(sector_cache_get(9) == NULL);
+    test_check(sector_cache_get(7) != NULL && test_stats().dirty == 1);
+
+    // Written range is dropped from the cache, dirty or not
+    sector_cache_invalidate_range(0, 100);
+    test_check(sector_cache_get(7) == NULL && test_stats().dirty == 0);
+}
+
+static void test_flush_due(void) {
+    test_reset();
+    tick = 1000;
+    test_check(!sector_cache_flush_due());
+
+    // Age of the first dirty sector counts, coalesced writes don't restart it
+    test_meta_write(1, 0x01);
+    tick += TEST_DIRTY_TIMEOUT_MS - 1;
+    test_meta_write(1, 0x02);
+    test_check(!sector_cache_flush_due());
+    tick += 1;
+    test_check(sector_cache_flush_due());
+    test_check(sector_cache_flush(test_write_back, NULL));
+    test_check(!sector_cache_flush_due());
+
+    // Too many dirty sectors are flushed right away
+    for(uint32_t i = 0; i < TEST_DIRTY_MAX - 1; i++) {
+        test_meta_write(100 + i, 0x10);
+    }
+    test_check(!sector_cache_flush_due());
+    test_meta_write(100 + TEST_DIRTY_MAX, 0x10);
+    test_check(sector_cache_flush_due());
+    test_check(sector_cache_flush(test_write_back, NULL));
+
+    // Tick counter wraps
+    tick = UINT32_MAX - 10;
+    test_meta_write(1, 0x03);
+    tick += TEST_DIRTY_TIMEOUT_MS;
+    test_check(sector_cache_flush_due());
+}
+
+int main(void) {
+    test_coalesce();
+    test_read_dirty();
+    test_eviction();
+    test_sync();
+    test_unmount();
+    test_flush_due();
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
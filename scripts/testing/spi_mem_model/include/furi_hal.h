@@ -0,0 +1,28 @@
+#pragma once
+/* Host shim of furi_hal.h for the SPI Mem worker test, only what the worker uses */
+#include <furi.h>
+
+typedef struct {
+    uint8_t id;
+} FuriHalSpiBusHandle;
+
+extern FuriHalSpiBusHandle furi_hal_spi_bus_handle_external;
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle);
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle);
+bool furi_hal_spi_bus_tx(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* buffer,
+    size_t size,
+    uint32_t timeout);
+bool furi_hal_spi_bus_rx(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* buffer,
+    size_t size,
+    uint32_t timeout);
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout_ms);
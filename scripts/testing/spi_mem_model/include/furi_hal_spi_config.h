@@ -0,0 +1,3 @@
+#pragma once
+/* Host shim of furi_hal_spi_config.h, bus handles are declared in furi_hal.h */
+#include <furi_hal.h>
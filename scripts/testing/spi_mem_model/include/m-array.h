@@ -0,0 +1,37 @@
+#pragma once
+/* Host shim of M*LIB m-array.h, plain growable array of POD elements */
+#include <stdlib.h>
+
+#define ARRAY_DEF(name, type, oplist)                                              \
+    typedef struct {                                                               \
+        type* data;                                                                \
+        size_t size;                                                               \
+        size_t alloc;                                                              \
+    } name##_s;                                                                    \
+    typedef name##_s name##_t[1];                                                  \
+                                                                                   \
+    static inline void name##_init(name##_t array) {                               \
+        array->data = NULL;                                                        \
+        array->size = 0;                                                           \
+        array->alloc = 0;                                                          \
+    }                                                                              \
+    static inline void name##_clear(name##_t array) {                              \
+        free(array->data);                                                         \
+        name##_init(array);                                                        \
+    }                                                                              \
+    static inline void name##_reset(name##_t array) {                              \
+        array->size = 0;                                                           \
+    }                                                                              \
+    static inline size_t name##_size(const name##_t array) {                       \
+        return array->size;                                                        \
+    }                                                                              \
+    static inline type* name##_get(const name##_t array, size_t index) {           \
+        return &array->data[index];                                                \
+    }                                                                              \
+    static inline void name##_push_back(name##_t array, type value) {              \
+        if(array->size == array->alloc) {                                          \
+            array->alloc = array->alloc ? array->alloc * 2 : 4;                    \
+            array->data = realloc(array->data, array->alloc * sizeof(type));      \
+        }                                                                          \
+        array->data[array->size++] = value;                                        \
+    }
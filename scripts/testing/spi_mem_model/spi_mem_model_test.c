@@ -0,0 +1,500 @@
+/**
+ * Host test of the SPI Mem worker modes against the NOR flash model
+ *
+ *   SPI_MEM=../../../applications/external/spi_mem_manager
+ *   cc -Iinclude -I$SPI_MEM/lib/spi -I$SPI_MEM -pthread -o spi_mem_model_test \
+ *       spi_mem_model_test.c spi_nor_model.c $SPI_MEM/lib/spi/spi_mem_worker.c \
+ *       $SPI_MEM/lib/spi/spi_mem_worker_modes.c $SPI_MEM/lib/spi/spi_mem_pipe.c \
+ *       $SPI_MEM/lib/spi/spi_mem_tools.c $SPI_MEM/lib/spi/spi_mem_chip.c \
+ *       $SPI_MEM/lib/spi/spi_mem_chip_arr.c
+ *   ./spi_mem_model_test
+ *
+ * Worker, file pipe and chip tools are the firmware sources. Threads and
+ * message queues run on pthreads, the external SPI bus is the chip model and
+ * the dump file lives in memory.
+ */
+#include <furi.h>
+#include <furi_hal.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <spi_mem_worker_i.h>
+#include <spi_mem_chip_i.h>
+#include <spi_mem_tools.h>
+#include <spi_mem_files.h>
+
+#include "spi_nor_model.h"
+
+// W25P20 from the chip list
+#define TEST_CHIP_SIZE 262144
+#define TEST_CHIP_PAGE_SIZE 256
+static const uint8_t test_chip_jedec_id[3] = {0xEF, 0x11, 0x00};
+
+static SpiNorModel* chip = NULL;
+
+typedef struct {
+    uint32_t dma_transfers;
+    uint32_t dma_bytes;
+    uint32_t bus_bytes;
+} TestBusStats;
+
+static TestBusStats bus_stats;
+
+/* Threads, flags and message queues on pthreads */
+
+struct FuriThread {
+    pthread_t pthread;
+    FuriThreadCallback callback;
+    void* context;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint32_t flags;
+};
+
+static _Thread_local FuriThread* furi_thread_current = NULL;
+
+void furi_delay_tick(uint32_t ticks) {
+    UNUSED(ticks);
+    sched_yield();
+}
+
+FuriThread* furi_thread_alloc(void) {
+    FuriThread* thread = malloc(sizeof(FuriThread));
+    pthread_mutex_init(&thread->mutex, NULL);
+    pthread_cond_init(&thread->cond, NULL);
+    return thread;
+}
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, name);
+    furi_thread_set_stack_size(thread, stack_size);
+    furi_thread_set_callback(thread, callback);
+    furi_thread_set_context(thread, context);
+    return thread;
+}
+
+void furi_thread_free(FuriThread* thread) {
+    pthread_mutex_destroy(&thread->mutex);
+    pthread_cond_destroy(&thread->cond);
+    free(thread);
+}
+
+void furi_thread_set_name(FuriThread* thread, const char* name) {
+    UNUSED(thread);
+    UNUSED(name);
+}
+
+void furi_thread_set_stack_size(FuriThread* thread, size_t stack_size) {
+    UNUSED(thread);
+    UNUSED(stack_size);
+}
+
+void furi_thread_set_callback(FuriThread* thread, FuriThreadCallback callback) {
+    thread->callback = callback;
+}
+
+void furi_thread_set_context(FuriThread* thread, void* context) {
+    thread->context = context;
+}
+
+static void* furi_thread_body(void* context) {
+    FuriThread* thread = context;
+    furi_thread_current = thread;
+    thread->callback(thread->context);
+    return NULL;
+}
+
+void furi_thread_start(FuriThread* thread) {
+    thread->flags = 0;
+    furi_check(pthread_create(&thread->pthread, NULL, furi_thread_body, thread) == 0);
+}
+
+bool furi_thread_join(FuriThread* thread) {
+    return pthread_join(thread->pthread, NULL) == 0;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags) {
+    pthread_mutex_lock(&thread_id->mutex);
+    thread_id->flags |= flags;
+    uint32_t result = thread_id->flags;
+    pthread_cond_broadcast(&thread_id->cond);
+    pthread_mutex_unlock(&thread_id->mutex);
+    return result;
+}
+
+uint32_t furi_thread_flags_get(void) {
+    FuriThread* thread = furi_thread_current;
+    furi_check(thread);
+    pthread_mutex_lock(&thread->mutex);
+    uint32_t flags = thread->flags;
+    pthread_mutex_unlock(&thread->mutex);
+    return flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout) {
+    FuriThread* thread = furi_thread_current;
+    furi_check(thread && options == FuriFlagWaitAny && timeout == FuriWaitForever);
+    pthread_mutex_lock(&thread->mutex);
+    while(!(thread->flags & flags)) {
+        pthread_cond_wait(&thread->cond, &thread->mutex);
+    }
+    uint32_t result = thread->flags;
+    thread->flags &= ~flags;
+    pthread_mutex_unlock(&thread->mutex);
+    return result;
+}
+
+struct FuriMessageQueue {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    uint8_t* buffer;
+    uint32_t msg_count;
+    uint32_t msg_size;
+    uint32_t head;
+    uint32_t count;
+};
+
+FuriMessageQueue* furi_message_queue_alloc(uint32_t msg_count, uint32_t msg_size) {
+    FuriMessageQueue* queue = malloc(sizeof(FuriMessageQueue));
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->cond, NULL);
+    queue->buffer = malloc(msg_count * msg_size);
+    queue->msg_count = msg_count;
+    queue->msg_size = msg_size;
+    return queue;
+}
+
+void furi_message_queue_free(FuriMessageQueue* instance) {
+    pthread_mutex_destroy(&instance->mutex);
+    pthread_cond_destroy(&instance->cond);
+    free(instance->buffer);
+    free(instance);
+}
+
+FuriStatus
+    furi_message_queue_put(FuriMessageQueue* instance, const void* msg_ptr, uint32_t timeout) {
+    furi_check(timeout == FuriWaitForever);
+    pthread_mutex_lock(&instance->mutex);
+    while(instance->count == instance->msg_count) {
+        pthread_cond_wait(&instance->cond, &instance->mutex);
+    }
+    uint32_t index = (instance->head + instance->count) % instance->msg_count;
+    memcpy(&instance->buffer[index * instance->msg_size], msg_ptr, instance->msg_size);
+    instance->count++;
+    pthread_cond_broadcast(&instance->cond);
+    pthread_mutex_unlock(&instance->mutex);
+    return FuriStatusOk;
+}
+
+FuriStatus furi_message_queue_get(FuriMessageQueue* instance, void* msg_ptr, uint32_t timeout) {
+    furi_check(timeout == FuriWaitForever);
+    pthread_mutex_lock(&instance->mutex);
+    while(instance->count == 0) {
+        pthread_cond_wait(&instance->cond, &instance->mutex);
+    }
+    memcpy(msg_ptr, &instance->buffer[instance->head * instance->msg_size], instance->msg_size);
+    instance->head = (instance->head + 1) % instance->msg_count;
+    instance->count--;
+    pthread_cond_broadcast(&instance->cond);
+    pthread_mutex_unlock(&instance->mutex);
+    return FuriStatusOk;
+}
+
+/* External SPI bus wired to the chip model */
+
+FuriHalSpiBusHandle furi_hal_spi_bus_handle_external = {.id = 1};
+
+void furi_hal_spi_acquire(FuriHalSpiBusHandle* handle) {
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    spi_nor_model_select(chip, true);
+}
+
+void furi_hal_spi_release(FuriHalSpiBusHandle* handle) {
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    spi_nor_model_select(chip, false);
+}
+
+static void test_bus_exchange(const uint8_t* tx_buffer, uint8_t* rx_buffer, size_t size) {
+    for(size_t i = 0; i < size; i++) {
+        uint8_t miso = spi_nor_model_exchange(chip, tx_buffer ? tx_buffer[i] : 0xFF);
+        if(rx_buffer) rx_buffer[i] = miso;
+    }
+    bus_stats.bus_bytes += size;
+}
+
+bool furi_hal_spi_bus_tx(
+    FuriHalSpiBusHandle* handle,
+    const uint8_t* buffer,
+    size_t size,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    test_bus_exchange(buffer, NULL, size);
+    return true;
+}
+
+bool furi_hal_spi_bus_rx(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* buffer,
+    size_t size,
+    uint32_t timeout) {
+    UNUSED(timeout);
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    test_bus_exchange(NULL, buffer, size);
+    return true;
+}
+
+bool furi_hal_spi_bus_trx_dma(
+    FuriHalSpiBusHandle* handle,
+    uint8_t* tx_buffer,
+    uint8_t* rx_buffer,
+    size_t size,
+    uint32_t timeout_ms) {
+    UNUSED(timeout_ms);
+    furi_check(handle == &furi_hal_spi_bus_handle_external);
+    test_bus_exchange(tx_buffer, rx_buffer, size);
+    bus_stats.dma_transfers++;
+    bus_stats.dma_bytes += size;
+    return true;
+}
+
+/* Dump file in memory */
+
+struct SPIMemApp {
+    uint8_t file[TEST_CHIP_SIZE];
+    size_t file_size;
+    size_t position;
+    size_t preallocated;
+    bool opened;
+    FuriMessageQueue* events;
+    uint32_t blocks;
+};
+
+bool spi_mem_file_create_open(SPIMemApp* app) {
+    furi_check(!app->opened);
+    app->opened = true;
+    app->file_size = 0;
+    app->position = 0;
+    return true;
+}
+
+bool spi_mem_file_open(SPIMemApp* app) {
+    furi_check(!app->opened);
+    app->opened = true;
+    app->position = 0;
+    return true;
+}
+
+void spi_mem_file_preallocate(SPIMemApp* app, size_t size) {
+    app->preallocated = size;
+}
+
+bool spi_mem_file_write_block(SPIMemApp* app, uint8_t* data, size_t size) {
+    furi_check(app->opened);
+    if(app->position + size > sizeof(app->file)) return false;
+    memcpy(&app->file[app->position], data, size);
+    app->position += size;
+    app->file_size = MAX(app->file_size, app->position);
+    return true;
+}
+
+bool spi_mem_file_read_block(SPIMemApp* app, uint8_t* data, size_t size) {
+    furi_check(app->opened);
+    if(app->position + size > app->file_size) return false;
+    memcpy(data, &app->file[app->position], size);
+    app->position += size;
+    return true;
+}
+
+void spi_mem_file_close(SPIMemApp* app) {
+    // Worker closes the file on every exit path, even when open failed
+    app->opened = false;
+}
+
+size_t spi_mem_file_get_size(SPIMemApp* app) {
+    return app->file_size;
+}
+
+/* Tests */
+
+static int failures = 0;
+
+#define test_check(__e)                                                      \
+    do {                                                                     \
+        if(!(__e)) {                                                         \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #__e);            \
+            failures++;                                                      \
+        }                                                                    \
+    } while(0)
+
+typedef void (*TestWorkerStart)(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context);
+
+static SPIMemApp* app = NULL;
+static SPIMemChip chip_info;
+
+// Worker hands the app to the callback, same as to the file calls
+static void test_worker_callback(void* context, SPIMemCustomEventWorker event) {
+    SPIMemApp* app = context;
+    if(event == SPIMemCustomEventWorkerBlockReaded) {
+        app->blocks++;
+    } else {
+        furi_check(furi_message_queue_put(app->events, &event, FuriWaitForever) == FuriStatusOk);
+    }
+}
+
+// Run one worker mode to its final event
+static SPIMemCustomEventWorker test_worker_run(TestWorkerStart start) {
+    SPIMemWorker* worker = spi_mem_worker_alloc();
+    spi_mem_worker_start_thread(worker);
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    memset(spi_nor_model_get_stats(chip), 0, sizeof(SpiNorModelStats));
+    app->blocks = 0;
+
+    start(&chip_info, worker, test_worker_callback, app);
+    SPIMemCustomEventWorker event;
+    furi_check(furi_message_queue_get(app->events, &event, FuriWaitForever) == FuriStatusOk);
+
+    spi_mem_worker_stop_thread(worker);
+    spi_mem_worker_free(worker);
+    return event;
+}
+
+static void test_chip_detect_start(
+    SPIMemChip* chip_info,
+    SPIMemWorker* worker,
+    SPIMemWorkerCallback callback,
+    void* context) {
+    static found_chips_t found_chips;
+    found_chips_init(found_chips);
+    spi_mem_worker_chip_detect_start(chip_info, &found_chips, worker, callback, context);
+}
+
+static void test_chip_detect(void) {
+    found_chips_t found_chips;
+    memset(&chip_info, 0, sizeof(chip_info));
+    found_chips_init(found_chips);
+
+    test_check(test_worker_run(test_chip_detect_start) == SPIMemCustomEventWorkerChipIdentified);
+    test_check(spi_mem_chip_find_all(&chip_info, found_chips));
+    test_check(found_chips_size(found_chips) == 1);
+    spi_mem_chip_copy_chip_info(&chip_info, *found_chips_get(found_chips, 0));
+    test_check(strcmp(spi_mem_chip_get_model_name(&chip_info), "W25P20") == 0);
+    test_check(spi_mem_chip_get_size(&chip_info) == TEST_CHIP_SIZE);
+    test_check(spi_mem_chip_get_page_size(&chip_info) == TEST_CHIP_PAGE_SIZE);
+    found_chips_clear(found_chips);
+}
+
+static void test_read_verify(void) {
+    uint8_t* chip_data = spi_nor_model_get_data(chip);
+    for(size_t i = 0; i < TEST_CHIP_SIZE; i++) {
+        chip_data[i] = rand();
+    }
+
+    test_check(test_worker_run(spi_mem_worker_read_start) == SPIMemCustomEventWorkerDone);
+    test_check(app->file_size == TEST_CHIP_SIZE && app->preallocated == TEST_CHIP_SIZE);
+    test_check(memcmp(app->file, chip_data, TEST_CHIP_SIZE) == 0);
+    test_check(app->blocks == TEST_CHIP_SIZE / SPI_MEM_FILE_BUFFER_SIZE);
+    // Every block goes in one DMA transfer
+    test_check(bus_stats.dma_transfers == TEST_CHIP_SIZE / SPI_MEM_FILE_BUFFER_SIZE);
+    test_check(bus_stats.dma_bytes == TEST_CHIP_SIZE);
+    test_check(spi_nor_model_get_stats(chip)->bytes_read == TEST_CHIP_SIZE);
+
+    test_check(test_worker_run(spi_mem_worker_verify_start) == SPIMemCustomEventWorkerDone);
+    test_check(app->blocks == TEST_CHIP_SIZE / SPI_MEM_FILE_BUFFER_SIZE);
+
+    app->file[TEST_CHIP_SIZE - 1] ^= 0x01;
+    test_check(test_worker_run(spi_mem_worker_verify_start) == SPIMemCustomEventWorkerVerifyFail);
+    app->file[TEST_CHIP_SIZE - 1] ^= 0x01;
+
+    // Dump shorter than chip is verified up to its end
+    app->file_size = TEST_CHIP_SIZE / 2 + 100;
+    test_check(test_worker_run(spi_mem_worker_verify_start) == SPIMemCustomEventWorkerDone);
+    test_check(app->blocks == TEST_CHIP_SIZE / 2 / SPI_MEM_FILE_BUFFER_SIZE + 1);
+    app->file_size = TEST_CHIP_SIZE;
+
+    test_check(spi_nor_model_get_stats(chip)->protocol_errors == 0);
+}
+
+static void test_erase_write(void) {
+    uint8_t* chip_data = spi_nor_model_get_data(chip);
+
+    test_check(test_worker_run(spi_mem_worker_erase_start) == SPIMemCustomEventWorkerDone);
+    test_check(spi_nor_model_get_stats(chip)->chip_erases == 1);
+    test_check(spi_nor_model_is_idle(chip));
+    for(size_t i = 0; i < TEST_CHIP_SIZE; i++) {
+        if(chip_data[i] != 0xFF) {
+            test_check(chip_data[i] == 0xFF);
+            break;
+        }
+    }
+
+    for(size_t i = 0; i < TEST_CHIP_SIZE; i++) {
+        app->file[i] = rand();
+    }
+    test_check(test_worker_run(spi_mem_worker_write_start) == SPIMemCustomEventWorkerDone);
+    test_check(memcmp(app->file, chip_data, TEST_CHIP_SIZE) == 0);
+    test_check(spi_nor_model_get_stats(chip)->pages_programmed == TEST_CHIP_SIZE / 256);
+    test_check(spi_nor_model_get_stats(chip)->protocol_errors == 0);
+    test_check(spi_nor_model_is_idle(chip));
+}
+
+static void test_write_diff(void) {
+    uint8_t* chip_data = spi_nor_model_get_data(chip);
+    SpiNorModelStats* stats = spi_nor_model_get_stats(chip);
+    // Program is enough for the first one, second one needs a sector erase
+    size_t program_only = 5 * SPI_MEM_SECTOR_SIZE + 2 * TEST_CHIP_PAGE_SIZE + 7;
+    size_t erase_needed = 9 * SPI_MEM_SECTOR_SIZE + 11;
+
+    for(size_t i = 0; i < TEST_CHIP_SIZE; i++) {
+        app->file[i] = rand();
+    }
+    app->file[program_only] = 0x5A;
+    app->file[erase_needed] = 0x5A;
+    memcpy(chip_data, app->file, TEST_CHIP_SIZE);
+
+    test_check(test_worker_run(spi_mem_worker_write_diff_start) == SPIMemCustomEventWorkerDone);
+    test_check(stats->sector_erases == 0 && stats->pages_programmed == 0);
+    test_check(stats->bytes_read == TEST_CHIP_SIZE);
+
+    chip_data[program_only] = 0xFF;
+    chip_data[erase_needed] = 0x00;
+    test_check(test_worker_run(spi_mem_worker_write_diff_start) == SPIMemCustomEventWorkerDone);
+    test_check(memcmp(app->file, chip_data, TEST_CHIP_SIZE) == 0);
+    test_check(app->blocks == TEST_CHIP_SIZE / SPI_MEM_SECTOR_SIZE);
+    // Erased sector gets all of its pages back, random data has no blank pages
+    test_check(stats->sector_erases == 1);
+    test_check(stats->pages_programmed == 1 + SPI_MEM_SECTOR_SIZE / TEST_CHIP_PAGE_SIZE);
+    test_check(stats->chip_erases == 0 && stats->protocol_errors == 0);
+    test_check(spi_nor_model_is_idle(chip));
+}
+
+int main(void) {
+    srand(1);
+    chip = spi_nor_model_alloc(test_chip_jedec_id, TEST_CHIP_SIZE);
+    app = malloc(sizeof(SPIMemApp));
+    app->events = furi_message_queue_alloc(1, sizeof(SPIMemCustomEventWorker));
+
+    test_chip_detect();
+    test_read_verify();
+    test_erase_write();
+    test_write_diff();
+
+    furi_message_queue_free(app->events);
+    free(app);
+    spi_nor_model_free(chip);
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
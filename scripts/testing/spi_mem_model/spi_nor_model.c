@@ -0,0 +1,204 @@
+#include "spi_nor_model.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    SpiNorModelCmdReadData = 0x03,
+    SpiNorModelCmdPageProgram = 0x02,
+    SpiNorModelCmdWriteDisable = 0x04,
+    SpiNorModelCmdReadStatus = 0x05,
+    SpiNorModelCmdWriteEnable = 0x06,
+    SpiNorModelCmdSectorErase = 0x20,
+    SpiNorModelCmdJedecId = 0x9F,
+    SpiNorModelCmdChipErase = 0xC7,
+} SpiNorModelCmd;
+
+#define SPI_NOR_MODEL_STATUS_BUSY (0x01 << 0)
+#define SPI_NOR_MODEL_STATUS_WEL (0x01 << 1)
+#define SPI_NOR_MODEL_ADDRESS_SIZE 3
+
+struct SpiNorModel {
+    uint8_t* data;
+    size_t size;
+    uint8_t jedec_id[3];
+    bool present;
+    bool selected;
+    bool write_enabled;
+    uint32_t busy;
+    uint32_t busy_program;
+    uint32_t busy_erase;
+
+    uint8_t cmd;
+    size_t count;
+    uint32_t address;
+
+    uint8_t page[SPI_NOR_MODEL_PAGE_SIZE];
+    size_t page_len;
+
+    SpiNorModelStats stats;
+};
+
+SpiNorModel* spi_nor_model_alloc(const uint8_t jedec_id[3], size_t size) {
+    SpiNorModel* model = calloc(1, sizeof(SpiNorModel));
+    model->data = malloc(size);
+    memset(model->data, 0xFF, size);
+    model->size = size;
+    memcpy(model->jedec_id, jedec_id, sizeof(model->jedec_id));
+    model->present = true;
+    model->busy_program = 2;
+    model->busy_erase = 8;
+    return model;
+}
+
+void spi_nor_model_free(SpiNorModel* model) {
+    free(model->data);
+    free(model);
+}
+
+// Commands that are latched by CS going high
+static void spi_nor_model_execute(SpiNorModel* model) {
+    size_t address_end = 1 + SPI_NOR_MODEL_ADDRESS_SIZE;
+    uint32_t address = model->address % model->size;
+
+    switch(model->cmd) {
+    case SpiNorModelCmdWriteEnable:
+        model->write_enabled = true;
+        break;
+    case SpiNorModelCmdWriteDisable:
+        model->write_enabled = false;
+        break;
+    case SpiNorModelCmdReadStatus:
+        if(model->busy) model->busy--;
+        break;
+    case SpiNorModelCmdPageProgram:
+        if(!model->write_enabled || model->count <= address_end) {
+            model->stats.protocol_errors++;
+            break;
+        }
+        // Page buffer is indexed by column, bytes past the page end wrap to its start
+        address -= address % SPI_NOR_MODEL_PAGE_SIZE;
+        for(size_t column = 0; column < SPI_NOR_MODEL_PAGE_SIZE; column++) {
+            model->data[address + column] &= model->page[column];
+        }
+        model->stats.pages_programmed++;
+        model->write_enabled = false;
+        model->busy = model->busy_program;
+        break;
+    case SpiNorModelCmdSectorErase:
+        if(!model->write_enabled || model->count != address_end) {
+            model->stats.protocol_errors++;
+            break;
+        }
+        address -= address % SPI_NOR_MODEL_SECTOR_SIZE;
+        memset(&model->data[address], 0xFF, SPI_NOR_MODEL_SECTOR_SIZE);
+        model->stats.sector_erases++;
+        model->write_enabled = false;
+        model->busy = model->busy_erase;
+        break;
+    case SpiNorModelCmdChipErase:
+        if(!model->write_enabled || model->count != 1) {
+            model->stats.protocol_errors++;
+            break;
+        }
+        memset(model->data, 0xFF, model->size);
+        model->stats.chip_erases++;
+        model->write_enabled = false;
+        model->busy = model->busy_erase;
+        break;
+    default:
+        break;
+    }
+}
+
+void spi_nor_model_select(SpiNorModel* model, bool selected) {
+    if(model->selected == selected) return;
+    model->selected = selected;
+    if(!selected && model->count) {
+        spi_nor_model_execute(model);
+    }
+    model->count = 0;
+    model->address = 0;
+    model->page_len = 0;
+}
+
+static uint8_t spi_nor_model_status(SpiNorModel* model) {
+    uint8_t status = 0;
+    if(model->busy) status |= SPI_NOR_MODEL_STATUS_BUSY;
+    if(model->write_enabled) status |= SPI_NOR_MODEL_STATUS_WEL;
+    return status;
+}
+
+static uint8_t spi_nor_model_data_byte(SpiNorModel* model, uint8_t mosi, size_t index) {
+    switch(model->cmd) {
+    case SpiNorModelCmdJedecId:
+        return index < sizeof(model->jedec_id) ? model->jedec_id[index] : 0xFF;
+    case SpiNorModelCmdReadData:
+        model->stats.bytes_read++;
+        return model->data[(model->address + index) % model->size];
+    case SpiNorModelCmdPageProgram:
+        if(model->page_len == 0) memset(model->page, 0xFF, sizeof(model->page));
+        model->page[(model->address + index) % SPI_NOR_MODEL_PAGE_SIZE] = mosi;
+        // Real chips keep the last page worth of bytes, the firmware never sends more
+        if(++model->page_len > SPI_NOR_MODEL_PAGE_SIZE) model->stats.protocol_errors++;
+        return 0xFF;
+    default:
+        return 0xFF;
+    }
+}
+
+uint8_t spi_nor_model_exchange(SpiNorModel* model, uint8_t mosi) {
+    if(!model->present || !model->selected) return 0xFF;
+
+    size_t index = model->count++;
+    if(index == 0) {
+        model->cmd = mosi;
+        if(model->cmd == SpiNorModelCmdJedecId) model->stats.jedec_reads++;
+        if(model->cmd == SpiNorModelCmdReadStatus) {
+            model->stats.status_reads++;
+        } else if(model->busy) {
+            // Only status register is accessible while program or erase is running
+            model->stats.protocol_errors++;
+            model->cmd = 0xFF;
+        }
+        return 0xFF;
+    }
+
+    switch(model->cmd) {
+    case SpiNorModelCmdReadStatus:
+        return spi_nor_model_status(model);
+    case SpiNorModelCmdJedecId:
+        return spi_nor_model_data_byte(model, mosi, index - 1);
+    case SpiNorModelCmdReadData:
+    case SpiNorModelCmdPageProgram:
+    case SpiNorModelCmdSectorErase:
+        if(index <= SPI_NOR_MODEL_ADDRESS_SIZE) {
+            model->address = (model->address << 8) | mosi;
+            return 0xFF;
+        }
+        return spi_nor_model_data_byte(model, mosi, index - 1 - SPI_NOR_MODEL_ADDRESS_SIZE);
+    default:
+        return 0xFF;
+    }
+}
+
+uint8_t* spi_nor_model_get_data(SpiNorModel* model) {
+    return model->data;
+}
+
+SpiNorModelStats* spi_nor_model_get_stats(SpiNorModel* model) {
+    return &model->stats;
+}
+
+void spi_nor_model_set_busy_reads(SpiNorModel* model, uint32_t program, uint32_t erase) {
+    model->busy_program = program;
+    model->busy_erase = erase;
+}
+
+void spi_nor_model_set_present(SpiNorModel* model, bool present) {
+    model->present = present;
+}
+
+bool spi_nor_model_is_idle(SpiNorModel* model) {
+    return !model->busy && !model->write_enabled;
+}
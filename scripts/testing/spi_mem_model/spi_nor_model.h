@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/** SPI NOR flash, byte level model
+ *
+ * Commands used by the SPI Mem Manager: JEDEC ID (0x9F), read (0x03),
+ * write enable/disable (0x06/0x04), read status (0x05), page program (0x02),
+ * sector erase (0x20) and chip erase (0xC7), with 3 byte addresses.
+ * Program only clears bits and wraps inside its page, erase sets bits.
+ * Program and erase run when CS goes high, then the chip stays busy
+ * for a configured number of status reads.
+ */
+
+#define SPI_NOR_MODEL_PAGE_SIZE 256
+#define SPI_NOR_MODEL_SECTOR_SIZE 4096
+
+typedef struct SpiNorModel SpiNorModel;
+
+typedef struct {
+    uint32_t jedec_reads;
+    uint32_t status_reads;
+    uint32_t bytes_read;
+    uint32_t pages_programmed;
+    uint32_t sector_erases;
+    uint32_t chip_erases;
+    uint32_t protocol_errors;
+} SpiNorModelStats;
+
+/** Allocate chip model, memory is erased
+ *
+ * @param jedec_id - manufacturer, memory type and capacity bytes
+ * @param size     - capacity in bytes, multiple of SPI_NOR_MODEL_SECTOR_SIZE
+ * @return SpiNorModel*
+ */
+SpiNorModel* spi_nor_model_alloc(const uint8_t jedec_id[3], size_t size);
+
+void spi_nor_model_free(SpiNorModel* model);
+
+/** Change chip select, command is executed when chip is deselected */
+void spi_nor_model_select(SpiNorModel* model, bool selected);
+
+/** Exchange one byte
+ *
+ * @param model - SpiNorModel instance
+ * @param mosi  - byte from host
+ * @return byte from chip, 0xFF when chip is removed or not selected
+ */
+uint8_t spi_nor_model_exchange(SpiNorModel* model, uint8_t mosi);
+
+/** Chip memory, size bytes */
+uint8_t* spi_nor_model_get_data(SpiNorModel* model);
+
+SpiNorModelStats* spi_nor_model_get_stats(SpiNorModel* model);
+
+/** Status reads that report busy after program and erase */
+void spi_nor_model_set_busy_reads(SpiNorModel* model, uint32_t program, uint32_t erase);
+
+/** Removed chip leaves MISO pulled up */
+void spi_nor_model_set_present(SpiNorModel* model, bool present);
+
+/** Check that chip is idle and write is disabled */
+bool spi_nor_model_is_idle(SpiNorModel* model);